@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+#include "nuto/math/BlockSparseMatrix.h"
+#include "nuto/mechanics/constitutive/LinearElastic.h"
+#include "nuto/mechanics/integrands/MomentumBalance.h"
+#include "nuto/mechanics/integrationtypes/IntegrationTypeTensorProduct.h"
+#include "nuto/mechanics/mesh/MeshFemDofConvert.h"
+#include "nuto/mechanics/mesh/UnitMeshFem.h"
+#include "nuto/mechanics/tools/CellStorage.h"
+#include "nuto/mechanics/tools/TimeDependentProblem.h"
+
+/*
+ * Matrix vector products of the 3D elasticity like matrix of a structured n x n x n node grid, where each node
+ * couples with its 26 neighbors via dense 3x3 blocks
+ *   - Eigen::SparseMatrix: one column index per scalar entry
+ *   - BlockSparseMatrix: one column index per 3x3 block
+ *
+ * Repeated assembly of the Hessian0 of a linear elastic n x n x n brick mesh into the memoized nonzero patterns
+ *   - TimeDependentProblem::Hessian0: scalar compressed matrix
+ *   - TimeDependentProblem::Hessian0Blocked: BlockSparseMatrix with 3x3 blocks
+ */
+
+using namespace NuTo;
+
+Eigen::SparseMatrix<double> Grid3D(int n)
+{
+    const int blockSize = 3;
+    auto node = [n](int x, int y, int z) { return x + n * (y + n * z); };
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(n * n * n * 27 * blockSize * blockSize);
+    for (int z = 0; z < n; ++z)
+        for (int y = 0; y < n; ++y)
+            for (int x = 0; x < n; ++x)
+                for (int dz = std::max(z - 1, 0); dz < std::min(z + 2, n); ++dz)
+                    for (int dy = std::max(y - 1, 0); dy < std::min(y + 2, n); ++dy)
+                        for (int dx = std::max(x - 1, 0); dx < std::min(x + 2, n); ++dx)
+                            for (int i = 0; i < blockSize; ++i)
+                                for (int j = 0; j < blockSize; ++j)
+                                    triplets.emplace_back(node(x, y, z) * blockSize + i,
+                                                          node(dx, dy, dz) * blockSize + j, 1. + i + j);
+    const int numDofs = n * n * n * blockSize;
+    Eigen::SparseMatrix<double> m(numDofs, numDofs);
+    m.setFromTriplets(triplets.begin(), triplets.end());
+    return m;
+}
+
+static void EigenCSC(benchmark::State& state)
+{
+    const Eigen::SparseMatrix<double> m = Grid3D(state.range(0));
+    const Eigen::VectorXd x = Eigen::VectorXd::Random(m.cols());
+    for (auto _ : state)
+    {
+        Eigen::VectorXd y = m * x;
+        benchmark::DoNotOptimize(y.data());
+    }
+}
+BENCHMARK(EigenCSC)->Arg(10)->Arg(20)->Arg(40);
+
+static void EigenCSR(benchmark::State& state)
+{
+    const Eigen::SparseMatrix<double, Eigen::RowMajor> m = Grid3D(state.range(0));
+    const Eigen::VectorXd x = Eigen::VectorXd::Random(m.cols());
+    for (auto _ : state)
+    {
+        Eigen::VectorXd y = m * x;
+        benchmark::DoNotOptimize(y.data());
+    }
+}
+BENCHMARK(EigenCSR)->Arg(10)->Arg(20)->Arg(40);
+
+static void Blocked(benchmark::State& state)
+{
+    const BlockSparseMatrix m(Grid3D(state.range(0)), 3);
+    const Eigen::VectorXd x = Eigen::VectorXd::Random(m.cols());
+    for (auto _ : state)
+    {
+        Eigen::VectorXd y = m * x;
+        benchmark::DoNotOptimize(y.data());
+    }
+}
+BENCHMARK(Blocked)->Arg(10)->Arg(20)->Arg(40);
+
+struct ElasticBricks
+{
+    ElasticBricks(int n)
+        : mesh(UnitMeshFem::CreateBricks(n, n, n))
+        , disp("Displacements", 3)
+        , law(30000., 0.2)
+        , momentumBalance(disp, law)
+        , integrationType(2, eIntegrationMethod::GAUSS)
+        , problem(&mesh)
+    {
+        AddDofInterpolation(&mesh, disp);
+        problem.AddHessian0Function(
+                cells.AddCells(mesh.ElementsTotal(), integrationType),
+                TimeDependentProblem::Bind_dt(momentumBalance, &Integrands::MomentumBalance<3>::Hessian0));
+        dofValues = problem.RenumberDofs(Constraint::Constraints(), {disp}, DofVector<double>());
+    }
+
+    MeshFem mesh;
+    DofType disp;
+    Laws::LinearElastic<3> law;
+    Integrands::MomentumBalance<3> momentumBalance;
+    IntegrationTypeTensorProduct<3> integrationType;
+    CellStorage cells;
+    TimeDependentProblem problem;
+    DofVector<double> dofValues;
+};
+
+static void AssembleScalar(benchmark::State& state)
+{
+    ElasticBricks bricks(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(bricks.problem.Hessian0(bricks.dofValues, {bricks.disp}, 0, 0));
+}
+BENCHMARK(AssembleScalar)->Arg(10)->Arg(20)->Unit(benchmark::kMillisecond);
+
+static void AssembleBlocked(benchmark::State& state)
+{
+    ElasticBricks bricks(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(bricks.problem.Hessian0Blocked(bricks.dofValues, bricks.disp, 0, 0));
+}
+BENCHMARK(AssembleBlocked)->Arg(10)->Arg(20)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -1,5 +1,6 @@
 #include <benchmark/benchmark.h>
 #include "nuto/mechanics/dofs/DofMatrixSparseConvertEigen.h"
+#include "nuto/mechanics/dofs/DofVectorConvertEigen.h"
 #include <iostream>
 
 using namespace NuTo;
@@ -75,4 +76,41 @@ static void OneDofFast(benchmark::State& s)
 }
 BENCHMARK(OneDofFast)->RangeMultiplier(10)->Range(10, 1e6)->Complexity();
 
+struct TestVector
+{
+    DofType dof0 = DofType("dof0", 1);
+    DofType dof1 = DofType("dof1", 1);
+    DofVector<double> v;
+    ContiguousDofVector<double> contiguous;
+
+    TestVector(int n)
+    {
+        v[dof0] = Eigen::VectorXd::Constant(n, 42.);
+        v[dof1] = Eigen::VectorXd::Constant(n, 42.);
+        contiguous = ContiguousDofVector<double>(v, {dof0, dof1});
+    }
+};
+
+//! @brief exports two dof types of a DofVector, this copies all values
+static void VectorTwoDofs(benchmark::State& s)
+{
+    TestVector t(s.range(0));
+    for (auto _ : s)
+        benchmark::DoNotOptimize(ToEigen(t.v, {t.dof0, t.dof1}));
+
+    s.SetComplexityN(s.range(0));
+}
+BENCHMARK(VectorTwoDofs)->RangeMultiplier(10)->Range(10, 1e6)->Complexity();
+
+//! @brief exports two dof types of a ContiguousDofVector, this only maps the buffer
+static void ContiguousVectorTwoDofs(benchmark::State& s)
+{
+    TestVector t(s.range(0));
+    for (auto _ : s)
+        benchmark::DoNotOptimize(ToEigen(t.contiguous, {t.dof0, t.dof1}).data());
+
+    s.SetComplexityN(s.range(0));
+}
+BENCHMARK(ContiguousVectorTwoDofs)->RangeMultiplier(10)->Range(10, 1e6)->Complexity();
+
 BENCHMARK_MAIN();
@@ -61,7 +61,30 @@ static void Transform(benchmark::State& state)
     }
     state.SetComplexityN(n * n);
 }
+//! @brief Measures time to gather the node values of all coordinate elements, viewed in the shared connectivity of
+//! the mesh (state.range(1) == 0) or copied to standalone elements with their own node lists (state.range(1) == 1)
+static void ExtractNodeValues(benchmark::State& state)
+{
+    const int n = state.range(0);
+    NuTo::MeshFem mesh = NuTo::UnitMeshFem::CreateTriangles(n, n);
+    std::vector<NuTo::ElementFem> elements;
+    for (auto& element : mesh.Elements)
+    {
+        const NuTo::ElementFem& view = element.CoordinateElement();
+        std::vector<NuTo::NodeSimple*> nodes;
+        for (int i = 0; i < view.GetNumNodes(); ++i)
+            nodes.push_back(const_cast<NuTo::NodeSimple*>(&view.GetNode(i)));
+        elements.push_back(state.range(1) == 0 ? view : NuTo::ElementFem(nodes, view.Interpolation()));
+    }
+
+    for (auto _ : state)
+        for (const auto& element : elements)
+            benchmark::DoNotOptimize(element.ExtractNodeValues());
+    state.SetComplexityN(n * n);
+}
+
 BENCHMARK(Create)->RangeMultiplier(2)->Range(16, 1024)->Complexity();
 BENCHMARK(Convert)->RangeMultiplier(2)->Range(16, 1024)->Complexity();
 BENCHMARK(Transform)->RangeMultiplier(2)->Range(16, 1024)->Complexity();
+BENCHMARK(ExtractNodeValues)->Args({256, 0})->Args({256, 1});
 BENCHMARK_MAIN();
@@ -1,11 +1,18 @@
 #include <benchmark/benchmark.h>
 
-#include "nuto/mechanics/elements/ElementShapeFunctions.h"
 #include "nuto/math/NaturalCoordinateMemoizer.h"
+#include "nuto/mechanics/cell/Cell.h"
+#include "nuto/mechanics/constitutive/LinearElastic.h"
+#include "nuto/mechanics/integrands/MomentumBalance.h"
+#include "nuto/mechanics/integrationtypes/IntegrationTypeTensorProduct.h"
+#include "nuto/mechanics/interpolation/InterpolationBrickQuadratic.h"
+#include "nuto/mechanics/mesh/MeshFemDofConvert.h"
+#include "nuto/mechanics/mesh/UnitMeshFem.h"
 
 #include <memory>
 #include <vector>
 #include <unordered_map>
+#include <boost/ptr_container/ptr_vector.hpp>
 
 /*
  * Benchmarks various implementations of the ShapeFunctionMemoization based on
@@ -15,6 +22,9 @@
  *  - unordered_map
  *      Requires a not obvious hash function floating point coordinates and is not faster that the much simpler map ...
  *  - map
+ *  - ShapeFunctionTable
+ *      Looks up the values by integration point index instead of by coordinates. This is what NuTo::Cell uses, see
+ *      CellGradient for the effect on the integration of a whole mesh.
  *
  */
 
@@ -109,7 +119,10 @@ struct Lobatto
     }
 };
 
-auto testFunction = NuTo::ShapeFunctions3D::DerivativeShapeFunctionsTetrahedronOrder2;
+const NuTo::InterpolationBrickQuadratic brickQuadratic;
+auto testFunction = [](Eigen::Vector3d ip) -> Eigen::MatrixXd {
+    return brickQuadratic.GetDerivativeShapeFunctions(ip);
+};
 
 template <typename TMemoizer>
 void Run(benchmark::State& state)
@@ -198,4 +211,56 @@ BENCHMARK_TEMPLATE(Run, NaturalCoordinateMemoizer<Eigen::MatrixXd, Eigen::Vector
 BENCHMARK_TEMPLATE(Run, NuTo::NaturalCoordinateMemoizerMap<Eigen::MatrixXd, Eigen::Vector3d>);
 BENCHMARK_TEMPLATE(Run, NaturalCoordinateMemoizerUnorderedMap<Eigen::MatrixXd, Eigen::Vector3d>);
 
+//! @brief lookup of the same derivatives by the index of the integration points
+struct ShapeFunctionTableLookup
+{
+    ShapeFunctionTableLookup()
+        : integrationType(5, NuTo::eIntegrationMethod::LOBATTO)
+    {
+    }
+
+    NuTo::IntegrationTypeTensorProduct<3> integrationType;
+};
+
+static void RunShapeFunctionTable(benchmark::State& state)
+{
+    ShapeFunctionTableLookup lookup;
+    NuTo::ShapeFunctionTable table(brickQuadratic, lookup.integrationType);
+    for (auto _ : state)
+        for (int iIP = 0; iIP < table.GetNumIntegrationPoints(); ++iIP)
+            benchmark::DoNotOptimize(table.DerivativeShapeFunctions(iIP).data());
+}
+BENCHMARK(RunShapeFunctionTable);
+
+/*
+ * Linear elastic gradient of all cells of a quadratic brick mesh
+ *   - state.range(0) = 0: virtual interpolation calls in each integration point
+ *   - state.range(0) = 1: shared ShapeFunctionTable, as used by NuTo::CellStorage
+ */
+static void CellGradient(benchmark::State& state)
+{
+    NuTo::MeshFem mesh = NuTo::UnitMeshFem::CreateBricks(5, 5, 5);
+    NuTo::DofType disp("Displacements", 3);
+    NuTo::InterpolationBrickQuadratic interpolation;
+    NuTo::AddDofInterpolation(&mesh, disp, interpolation);
+    NuTo::IntegrationTypeTensorProduct<3> integrationType(3, NuTo::eIntegrationMethod::GAUSS);
+    NuTo::Laws::LinearElastic<3> law(20000, 0.2);
+    NuTo::Integrands::MomentumBalance<3> momentumBalance(disp, law);
+
+    NuTo::ShapeFunctionTables registry;
+    boost::ptr_vector<NuTo::Cell> cells;
+    for (auto& element : mesh.Elements)
+    {
+        cells.push_back(new NuTo::Cell(element, integrationType, cells.size()));
+        if (state.range(0) == 1)
+            cells.back().EnableShapeFunctionTables(&registry);
+    }
+
+    auto Gradient = [&](const NuTo::CellIpData& cellIpData) { return momentumBalance.Gradient(cellIpData, 0); };
+    for (auto _ : state)
+        for (auto& cell : cells)
+            benchmark::DoNotOptimize(cell.Integrate(Gradient));
+}
+BENCHMARK(CellGradient)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,127 @@
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include <random>
+#include "nuto/mechanics/cell/SimpleAssembler.h"
+#include "nuto/mechanics/constitutive/LinearElastic.h"
+#include "nuto/mechanics/dofs/DofMatrixSparseConvertEigen.h"
+#include "nuto/mechanics/dofs/DofNumbering.h"
+#include "nuto/mechanics/integrands/MomentumBalance.h"
+#include "nuto/mechanics/integrationtypes/IntegrationTypeTensorProduct.h"
+#include "nuto/mechanics/mesh/MeshFemDofConvert.h"
+#include "nuto/mechanics/mesh/MeshFemReorder.h"
+#include "nuto/mechanics/mesh/UnitMeshFem.h"
+#include "nuto/mechanics/tools/CellStorage.h"
+
+/*
+ * Linear elastic assembly and Hessian0 product on a 3D brick mesh whose elements are stored in
+ *   - state.range(1) = 0: random order, e.g. the output of a mesh generator
+ *   - state.range(1) = 1: Morton order, see ReorderAlongCurve
+ *   - state.range(1) = 2: Hilbert order, see ReorderAlongCurve
+ *
+ * The counter `dofJump` is the mean distance between the first dof numbers of consecutive cells, a proxy for the
+ * cache misses in the gather/scatter operations. Use `perf stat -e cache-misses` for the hardware counters.
+ */
+
+using namespace NuTo;
+
+class Structure
+{
+public:
+    Structure(int n, int order)
+        : mMesh(UnitMeshFem::CreateBricks(n, n, n))
+        , mDof("Displacements", 3)
+        , mLaw(30000., 0.2)
+        , mMomentumBalance(mDof, mLaw)
+        , mIntegration(2, eIntegrationMethod::GAUSS)
+    {
+        std::vector<int> shuffle(mMesh.Elements.Size());
+        std::iota(shuffle.begin(), shuffle.end(), 0);
+        std::shuffle(shuffle.begin(), shuffle.end(), std::mt19937(6174));
+        mMesh.Elements.Reorder(shuffle);
+
+        if (order == 1)
+            ReorderAlongCurve(&mMesh, eSpaceFillingCurve::MORTON);
+        if (order == 2)
+            ReorderAlongCurve(&mMesh, eSpaceFillingCurve::HILBERT);
+
+        AddDofInterpolation(&mMesh, mDof);
+        mCellGroup = mCells.AddCells(mMesh.ElementsTotal(), mIntegration);
+        mAssembler.SetDofInfo(DofNumbering::Build(mMesh.NodesTotal(mDof), mDof, Constraint::Constraints()));
+    }
+
+    double MeanDofJump() const
+    {
+        double sum = 0;
+        for (size_t i = 1; i < mMesh.Elements.Size(); ++i)
+            sum += std::abs(FirstDof(mMesh.Elements[i]) - FirstDof(mMesh.Elements[i - 1]));
+        return sum / (mMesh.Elements.Size() - 1);
+    }
+
+    DofVector<double> Gradient()
+    {
+        return mAssembler.BuildVector(mCellGroup, {mDof}, [&](const CellIpData& cellIpData) {
+            return mMomentumBalance.Gradient(cellIpData, 0);
+        });
+    }
+
+    DofMatrixSparse<double> Hessian0()
+    {
+        return mAssembler.BuildMatrix(mCellGroup, {mDof}, [&](const CellIpData& cellIpData) {
+            return mMomentumBalance.Hessian0(cellIpData, 0);
+        });
+    }
+
+    Eigen::SparseMatrix<double> Hessian0Eigen()
+    {
+        return ToEigen(Hessian0(), {mDof});
+    }
+
+private:
+    int FirstDof(const ElementCollectionFem& element) const
+    {
+        return element.DofElement(mDof).GetNode(0).GetDofNumber(0);
+    }
+
+    MeshFem mMesh;
+    DofType mDof;
+    Laws::LinearElastic<3> mLaw;
+    Integrands::MomentumBalance<3> mMomentumBalance;
+    IntegrationTypeTensorProduct<3> mIntegration;
+    CellStorage mCells;
+    Group<CellInterface> mCellGroup;
+    SimpleAssembler mAssembler;
+};
+
+static void Gradient(benchmark::State& state)
+{
+    Structure s(state.range(0), state.range(1));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(s.Gradient());
+    state.counters["dofJump"] = s.MeanDofJump();
+}
+BENCHMARK(Gradient)->Args({20, 0})->Args({20, 1})->Args({20, 2})->Unit(benchmark::kMillisecond);
+
+static void Hessian0(benchmark::State& state)
+{
+    Structure s(state.range(0), state.range(1));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(s.Hessian0());
+    state.counters["dofJump"] = s.MeanDofJump();
+}
+BENCHMARK(Hessian0)->Args({20, 0})->Args({20, 1})->Args({20, 2})->Unit(benchmark::kMillisecond);
+
+static void Hessian0Product(benchmark::State& state)
+{
+    Structure s(state.range(0), state.range(1));
+    const Eigen::SparseMatrix<double> K = s.Hessian0Eigen();
+    const Eigen::VectorXd x = Eigen::VectorXd::Random(K.cols());
+    for (auto _ : state)
+    {
+        Eigen::VectorXd y = K * x;
+        benchmark::DoNotOptimize(y.data());
+    }
+    state.counters["dofJump"] = s.MeanDofJump();
+}
+BENCHMARK(Hessian0Product)->Args({40, 0})->Args({40, 1})->Args({40, 2});
+
+BENCHMARK_MAIN();
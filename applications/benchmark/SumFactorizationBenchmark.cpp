@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+#include "nuto/mechanics/cell/Cell.h"
+#include "nuto/mechanics/integrands/MomentumBalance.h"
+#include "nuto/mechanics/interpolation/InterpolationBrickLobatto.h"
+#include "test/tools/LobattoElement.h"
+
+/*
+ * Compares the residual and the Hessian0 product of a single linear elastic Lobatto brick of order state.range(0)
+ *   - current NuTo implementation: Cell::Integrate with the dense B matrices (and the dense Hessian0)
+ *   - SumFactorizedCell: 1D contractions without element matrices
+ */
+
+using namespace NuTo;
+
+//! @brief undistorted Lobatto brick of the sum factorization unit test, evaluated via Cell and SumFactorizedCell
+struct Brick : Test::LobattoElement<3, InterpolationBrickLobatto>
+{
+    Brick(int order)
+        : Test::LobattoElement<3, InterpolationBrickLobatto>(order)
+        , momentumBalance(disp, law)
+        , cell(*elements, integrationType, 0)
+        , sumFactorizedCell(kernel, elements->CoordinateElement())
+        , u(elements->DofElement(disp).ExtractNodeValues())
+        , x(Eigen::VectorXd::Random(u.rows()))
+    {
+    }
+
+    Integrands::MomentumBalance<3> momentumBalance;
+    Cell cell;
+    SumFactorizedCell<3> sumFactorizedCell;
+
+    Eigen::VectorXd u;
+    Eigen::VectorXd x;
+};
+
+static void GradientCell(benchmark::State& state)
+{
+    Brick brick(state.range(0));
+    auto Gradient = [&](const CellIpData& cellIpData) { return brick.momentumBalance.Gradient(cellIpData, 0); };
+    for (auto _ : state)
+        benchmark::DoNotOptimize(brick.cell.Integrate(Gradient));
+}
+BENCHMARK(GradientCell)->DenseRange(1, 5);
+
+static void GradientSumFactorization(benchmark::State& state)
+{
+    Brick brick(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(brick.sumFactorizedCell.MomentumBalanceGradient(brick.u, brick.law, 0));
+}
+BENCHMARK(GradientSumFactorization)->DenseRange(1, 5);
+
+static void Hessian0ProductCell(benchmark::State& state)
+{
+    Brick brick(state.range(0));
+    auto Hessian0 = [&](const CellIpData& cellIpData) { return brick.momentumBalance.Hessian0(cellIpData, 0); };
+    for (auto _ : state)
+    {
+        Eigen::VectorXd result = brick.cell.Integrate(Hessian0)(brick.disp, brick.disp) * brick.x;
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(Hessian0ProductCell)->DenseRange(1, 4);
+
+static void Hessian0ProductSumFactorization(benchmark::State& state)
+{
+    Brick brick(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(
+                brick.sumFactorizedCell.MomentumBalanceHessian0Apply(brick.u, brick.x, brick.law, 0));
+}
+BENCHMARK(Hessian0ProductSumFactorization)->DenseRange(1, 4);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,55 @@
+#include "BoostUnitTest.h"
+#include "ElasticPlate.h"
+
+#include "nuto/math/AmgPreconditioner.h"
+
+#include "nuto/mechanics/solver/ConstraintElimination.h"
+#include "nuto/mechanics/solver/RigidBodyModes.h"
+#include "nuto/mechanics/solver/Solve.h"
+
+using namespace NuTo;
+
+using Test::ElasticPlate;
+
+BOOST_FIXTURE_TEST_CASE(RigidBodyModesAmg, ElasticPlate)
+{
+    const DofMatrixSparse<double> K = problem.Hessian0(dofValues, {disp}, 0, 0);
+    const std::vector<DofVector<double>> modes = RigidBodyModes(mesh, {disp});
+    BOOST_CHECK_EQUAL(modes.size(), 3);
+    for (const DofVector<double>& mode : modes)
+        BOOST_CHECK_SMALL((K(disp, disp) * mode[disp]).norm(), 1.e-8);
+
+    DofVector<double> f = dofValues;
+    f[disp].setRandom();
+    const DofVector<double> expected = Solve(K, f, constraints, {disp}, "EigenSparseLU");
+    ConstrainedSystemSolver solver(constraints, {disp}, "AmgCG");
+    solver.SetNearNullspace(modes);
+    BoostUnitTest::CheckEigenMatrix(solver.Solve(K, f)[disp], expected[disp], 1.e-8);
+
+    // several levels on this small mesh, the rigid body modes need fewer iterations than the translations only
+    const Eigen::SparseMatrix<double> Kmod = C.transpose() * K(disp, disp) * C;
+    const Eigen::VectorXd rhs = Eigen::VectorXd::Random(C.cols());
+    ConstraintElimination elimination(constraints, {disp}, dofValues);
+    AmgPreconditioner::Options options;
+    options.maxCoarseSize = 10;
+    std::vector<int> numIterations;
+    for (int numModes : {2, 3})
+    {
+        Eigen::MatrixXd nearNullspace(Kmod.rows(), numModes);
+        for (int i = 0; i < numModes; ++i)
+            nearNullspace.col(i) = elimination.SelectIndependent(modes[i][disp]);
+
+        AmgConjugateGradient cg;
+        cg.setTolerance(1.e-10);
+        cg.preconditioner().SetOptions(options);
+        cg.preconditioner().SetNearNullspace(nearNullspace);
+        cg.compute(Kmod);
+        BOOST_CHECK_GT(cg.preconditioner().NumLevels(), 1);
+        Eigen::VectorXd x = cg.solve(rhs);
+        BOOST_CHECK_SMALL((Kmod * x - rhs).norm(), 1.e-6);
+        numIterations.push_back(cg.iterations());
+    }
+    BOOST_TEST_MESSAGE("AMG iterations, translations: " << numIterations[0] << ", rigid body modes: "
+                                                          << numIterations[1]);
+    BOOST_CHECK_LE(numIterations[1], numIterations[0]);
+}
@@ -0,0 +1,47 @@
+#include "BoostUnitTest.h"
+#include "ElasticPlate.h"
+
+#include "nuto/math/ConjugateGradient.h"
+#include "nuto/math/EigenSparseSolve.h"
+#include "nuto/math/JacobiPreconditioner.h"
+
+#include "nuto/mechanics/tools/BlockedHessian0.h"
+
+using namespace NuTo;
+
+using Test::ElasticPlate;
+
+BOOST_FIXTURE_TEST_CASE(BlockedAssembly, ElasticPlate)
+{
+    const Eigen::SparseMatrix<double> K = problem.Hessian0(dofValues, {disp}, 0, 0)(disp, disp);
+
+    // the second call reuses the nonzero pattern
+    for (int i = 0; i < 2; ++i)
+    {
+        const BlockSparseMatrix KBlocked = problem.Hessian0Blocked(dofValues, disp, 0, 0);
+        BOOST_CHECK_EQUAL(KBlocked.BlockSize(), 2);
+        BOOST_CHECK_EQUAL(4 * KBlocked.NonZeroBlocks(), K.nonZeros());
+        BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(KBlocked.ToEigen()), Eigen::MatrixXd(K));
+
+        const Eigen::VectorXd x = Eigen::VectorXd::Random(K.cols());
+        BoostUnitTest::CheckEigenMatrix(KBlocked * x, K * x);
+        BoostUnitTest::CheckEigenMatrix(KBlocked.diagonal(), Eigen::VectorXd(K.diagonal()));
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(BlockedSolve, ElasticPlate)
+{
+    const Eigen::SparseMatrix<double> K = problem.Hessian0(dofValues, {disp}, 0, 0)(disp, disp);
+    const Eigen::SparseMatrix<double> Kmod = C.transpose() * K * C;
+    const Eigen::VectorXd rhs = Eigen::VectorXd::Random(C.cols());
+    const Eigen::VectorXd expected = EigenSparseSolve(Kmod, rhs, "EigenSparseLU");
+
+    BlockedHessian0 A(problem, dofValues, disp, 0, 0);
+    A.SetConstraintMatrix(C);
+    BOOST_CHECK_EQUAL(A.rows(), Kmod.rows());
+
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(C.cols());
+    const int numIterations = ConjugateGradient<BlockedHessian0, JacobiPreconditioner>(A, rhs, x, 1000, 1.e-12);
+    BOOST_CHECK_LT(numIterations, 1000);
+    BoostUnitTest::CheckEigenMatrix(x, expected, 1.e-6);
+}
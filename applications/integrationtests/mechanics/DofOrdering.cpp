@@ -0,0 +1,42 @@
+#include "BoostUnitTest.h"
+#include "ElasticPlate.h"
+
+#include "nuto/base/Exception.h"
+#include "nuto/mechanics/solver/Solve.h"
+
+using namespace NuTo;
+
+using Test::ElasticPlate;
+
+BOOST_FIXTURE_TEST_CASE(DofOrdering, ElasticPlate)
+{
+    const DofMatrixSparse<double> K = problem.Hessian0(dofValues, {disp}, 0, 0);
+    DofVector<double> f = dofValues;
+    f[disp].setRandom();
+    const DofVector<double> u = Solve(K, f, constraints, {disp}, "EigenSparseLU");
+
+    // RenumberDofs transfers the values of the previous numbering to the new one
+    DofVector<double> values = dofValues;
+    for (auto ordering : {eDofOrdering::RCM, eDofOrdering::NESTED_DISSECTION, eDofOrdering::NATURAL})
+    {
+        values = problem.RenumberDofs(constraints, {disp}, values, ordering);
+        const std::vector<int>& permutation = problem.DofPermutation(disp);
+        const Eigen::PermutationMatrix<Eigen::Dynamic> P(
+                Eigen::Map<const Eigen::VectorXi>(permutation.data(), permutation.size()));
+        BoostUnitTest::CheckEigenMatrix(values[disp], P * dofValues[disp]);
+
+        const DofMatrixSparse<double> KOrdered = problem.Hessian0(values, {disp}, 0, 0);
+        BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(KOrdered(disp, disp)),
+                                        P * Eigen::MatrixXd(K(disp, disp)) * P.transpose());
+
+        DofVector<double> fOrdered = f;
+        fOrdered[disp] = P * f[disp];
+        const DofVector<double> uOrdered = Solve(KOrdered, fOrdered, constraints, {disp}, "EigenSparseLU");
+        BoostUnitTest::CheckEigenMatrix(uOrdered[disp], P * u[disp], 1.e-8);
+    }
+
+    const std::vector<int>& permutation = problem.DofPermutation(disp);
+    for (size_t i = 0; i < permutation.size(); ++i)
+        BOOST_CHECK_EQUAL(permutation[i], i);
+    BOOST_CHECK_THROW(problem.DofPermutation(DofType("Temperature", 1)), Exception);
+}
@@ -0,0 +1,63 @@
+#include "BoostUnitTest.h"
+#include "ElasticPlate.h"
+
+#include "nuto/math/ConjugateGradient.h"
+#include "nuto/math/EigenSparseSolve.h"
+#include "nuto/math/GeometricMultigrid.h"
+#include "nuto/math/JacobiPreconditioner.h"
+#include "nuto/math/Smoothers.h"
+
+#include "nuto/mechanics/mesh/StructuredMeshHierarchy.h"
+#include "nuto/mechanics/solver/ConstraintElimination.h"
+#include "nuto/mechanics/solver/Solve.h"
+#include "nuto/mechanics/tools/MatrixFreeHessian0.h"
+
+using namespace NuTo;
+
+using Test::ElasticPlate;
+
+BOOST_FIXTURE_TEST_CASE(GeometricMultigridHierarchy, ElasticPlate)
+{
+    StructuredMeshHierarchy hierarchy(mesh, {6, 4}, {disp});
+    BOOST_CHECK_EQUAL(hierarchy.NumLevels(), 2);
+
+    const DofMatrixSparse<double> K = problem.Hessian0(dofValues, {disp}, 0, 0);
+    DofVector<double> f = dofValues;
+    f[disp].setRandom();
+    const DofVector<double> expected = Solve(K, f, constraints, {disp}, "EigenSparseLU");
+
+    ConstrainedSystemSolver solver(constraints, {disp}, "GmgCG");
+    solver.SetProlongators(hierarchy.Prolongators(), dofValues);
+    BoostUnitTest::CheckEigenMatrix(solver.Solve(K, f)[disp], expected[disp], 1.e-8);
+
+    // matrix-free conjugate gradient method with the Chebyshev smoother as preconditioner
+    const Eigen::SparseMatrix<double> Kmod = C.transpose() * K(disp, disp) * C;
+    const Eigen::VectorXd rhs = Eigen::VectorXd::Random(C.cols());
+    const Eigen::VectorXd expectedMod = EigenSparseSolve(Kmod, rhs, "EigenSparseLU");
+
+    MatrixFreeHessian0 A(problem, dofValues, {disp}, 0, 0, true);
+    A.SetConstraintMatrix(C);
+    Eigen::VectorXd xJacobi = Eigen::VectorXd::Zero(C.cols());
+    const int numJacobi =
+            ConjugateGradient<MatrixFreeHessian0, JacobiPreconditioner>(A, rhs, xJacobi, 1000, 1.e-12);
+    Eigen::VectorXd xChebyshev = Eigen::VectorXd::Zero(C.cols());
+    const int numChebyshev = ConjugateGradient<MatrixFreeHessian0, ChebyshevPreconditioner<MatrixFreeHessian0>>(
+            A, rhs, xChebyshev, 1000, 1.e-12);
+    BoostUnitTest::CheckEigenMatrix(xChebyshev, expectedMod, 1.e-6);
+    BOOST_TEST_MESSAGE("CG iterations, Jacobi: " << numJacobi << ", Chebyshev: " << numChebyshev);
+    BOOST_CHECK_LT(numChebyshev, numJacobi);
+
+    // the multigrid V-cycle as preconditioner of the assembled system, the coarse dofs of the fixed boundary remain as
+    // they interpolate the neighbouring fine dofs
+    GmgConjugateGradient cg;
+    cg.setTolerance(1.e-10);
+    ConstraintElimination elimination(constraints, {disp}, dofValues);
+    cg.preconditioner().SetProlongators({elimination.SelectIndependentRows(hierarchy.Prolongator(0))});
+    cg.compute(Kmod);
+    BOOST_CHECK_EQUAL(cg.preconditioner().NumLevels(), 2);
+    BOOST_CHECK_EQUAL(cg.preconditioner().Size(1), 4 * 3 * 2);
+    Eigen::VectorXd x = cg.solve(rhs);
+    BoostUnitTest::CheckEigenMatrix(x, expectedMod, 1.e-6);
+    BOOST_TEST_MESSAGE("CG iterations with GMG: " << cg.iterations());
+    BOOST_CHECK_LT(cg.iterations(), numChebyshev);
+}
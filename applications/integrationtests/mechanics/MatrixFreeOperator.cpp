@@ -0,0 +1,178 @@
+#include "BoostUnitTest.h"
+#include "ElasticPlate.h"
+
+#include "nuto/math/ConjugateGradient.h"
+#include "nuto/math/EigenSparseSolve.h"
+#include "nuto/math/Gmres.h"
+#include "nuto/math/JacobiPreconditioner.h"
+
+#include "nuto/mechanics/cell/CellBatch.h"
+#include "nuto/mechanics/cell/SumFactorization.h"
+#include "nuto/mechanics/constitutive/LinearElastic.h"
+#include "nuto/mechanics/constraints/ConstraintCompanion.h"
+#include "nuto/mechanics/dofs/DofVectorConvertEigen.h"
+#include "nuto/mechanics/integrands/MomentumBalance.h"
+#include "nuto/mechanics/integrationtypes/IntegrationTypeTensorProduct.h"
+#include "nuto/mechanics/interpolation/InterpolationQuadLobatto.h"
+#include "nuto/mechanics/mesh/MeshFemDofConvert.h"
+#include "nuto/mechanics/mesh/UnitMeshFem.h"
+#include "nuto/mechanics/solver/Solve.h"
+#include "nuto/mechanics/tools/CellStorage.h"
+#include "nuto/mechanics/tools/MatrixFreeHessian0.h"
+
+using namespace NuTo;
+
+using Test::ElasticPlate;
+
+BOOST_FIXTURE_TEST_CASE(MatrixFreeProduct, ElasticPlate)
+{
+    const Eigen::SparseMatrix<double> K = problem.Hessian0(dofValues, {disp}, 0, 0)(disp, disp);
+
+    DofVector<double> x = dofValues;
+    x[disp].setRandom();
+
+    for (bool cacheTangents : {false, true})
+    {
+        MatrixFreeHessian0 A(problem, dofValues, {disp}, 0, 0, cacheTangents);
+        BoostUnitTest::CheckEigenMatrix(A.Apply(x)[disp], K * x[disp]);
+        BoostUnitTest::CheckEigenMatrix(A.Diagonal()[disp], Eigen::VectorXd(K.diagonal()));
+
+        BOOST_CHECK_EQUAL(A.rows(), K.rows());
+        BoostUnitTest::CheckEigenMatrix(A * x[disp], K * x[disp]);
+
+        A.SetConstraintMatrix(C);
+        const Eigen::SparseMatrix<double> Kmod = C.transpose() * K * C;
+        const Eigen::VectorXd xmod = Eigen::VectorXd::Random(C.cols());
+        BOOST_CHECK_EQUAL(A.rows(), Kmod.rows());
+        BoostUnitTest::CheckEigenMatrix(A * xmod, Kmod * xmod);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(MatrixFreeSolve, ElasticPlate)
+{
+    const Eigen::SparseMatrix<double> K = problem.Hessian0(dofValues, {disp}, 0, 0)(disp, disp);
+    const Eigen::SparseMatrix<double> Kmod = C.transpose() * K * C;
+    const Eigen::VectorXd rhs = Eigen::VectorXd::Random(C.cols());
+    const Eigen::VectorXd expected = EigenSparseSolve(Kmod, rhs, "EigenSparseLU");
+
+    MatrixFreeHessian0 A(problem, dofValues, {disp}, 0, 0, true);
+    A.SetConstraintMatrix(C);
+
+    // the diagonal of Kmod differs from the approximation only by the couplings via the dependent dofs
+    BOOST_CHECK_EQUAL(A.diagonal().rows(), Kmod.rows());
+
+    Eigen::VectorXd xCG = Eigen::VectorXd::Zero(C.cols());
+    const int numIterations = ConjugateGradient<MatrixFreeHessian0, JacobiPreconditioner>(A, rhs, xCG, 1000, 1.e-12);
+    BOOST_CHECK_LT(numIterations, 1000);
+    BoostUnitTest::CheckEigenMatrix(xCG, expected, 1.e-6);
+
+    Eigen::VectorXd xGmres = Eigen::VectorXd::Zero(C.cols());
+    Gmres<MatrixFreeHessian0, JacobiPreconditioner>(A, rhs, xGmres, 100, 1.e-12, 50);
+    BoostUnitTest::CheckEigenMatrix(xGmres, expected, 1.e-6);
+}
+
+BOOST_FIXTURE_TEST_CASE(SymmetricStorage, ElasticPlate)
+{
+    BOOST_CHECK(momentumBalance.IsHessian0Symmetric());
+    BOOST_CHECK(problem.Hessian0Storage() == eMatrixStorage::FULL);
+
+    TimeDependentProblem symmetricProblem(&mesh);
+    symmetricProblem.AddHessian0Function(
+            cellGroup, TimeDependentProblem::Bind_dt(momentumBalance, &Integrands::MomentumBalance<2>::Hessian0),
+            momentumBalance.IsHessian0Symmetric());
+    BOOST_CHECK(symmetricProblem.Hessian0Storage() == eMatrixStorage::UPPER);
+    symmetricProblem.RenumberDofs(constraints, {disp}, DofVector<double>());
+
+    const DofMatrixSparse<double> K = problem.Hessian0(dofValues, {disp}, 0, 0);
+    const Eigen::MatrixXd KE = Eigen::MatrixXd(K(disp, disp));
+
+    // first call via triplets, second call via the scatter maps
+    for (int i = 0; i < 2; ++i)
+    {
+        const DofMatrixSparse<double> KUpper = symmetricProblem.Hessian0(dofValues, {disp}, 0, 0);
+        BOOST_CHECK_LT(KUpper(disp, disp).nonZeros(), K(disp, disp).nonZeros());
+        const Eigen::SparseMatrix<double> KFull = KUpper(disp, disp).selfadjointView<Eigen::Upper>();
+        BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(KFull), KE);
+
+        DofVector<double> f = dofValues;
+        f[disp].setRandom();
+        const DofVector<double> expected = Solve(K, f, constraints, {disp}, "EigenSparseLU");
+        ConstrainedSystemSolver solver(constraints, {disp}, "EigenSparseLU", eMatrixStorage::UPPER);
+        BoostUnitTest::CheckEigenMatrix(solver.Solve(KUpper, f)[disp], expected[disp], 1.e-8);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(BatchedCells, ElasticPlate)
+{
+    const Eigen::SparseMatrix<double> K = problem.Hessian0(dofValues, {disp}, 0, 0)(disp, disp);
+
+    CellBatch<2, 4, 4> batch(mesh.ElementsTotal(), integrationType, disp, law);
+    TimeDependentProblem batchProblem(&mesh);
+    batchProblem.AddBatch(batch);
+    BOOST_CHECK(batchProblem.Hessian0Storage() == eMatrixStorage::UPPER);
+    batchProblem.RenumberDofs(constraints, {disp}, DofVector<double>());
+
+    // first call via triplets, second call into the existing nonzero pattern
+    for (int i = 0; i < 2; ++i)
+    {
+        const Eigen::SparseMatrix<double> KUpper = batchProblem.Hessian0(dofValues, {disp}, 0, 0)(disp, disp);
+        const Eigen::SparseMatrix<double> KFull = KUpper.selfadjointView<Eigen::Upper>();
+        BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(KFull), Eigen::MatrixXd(K));
+
+        // linear elastic: the gradient is K u
+        const auto gradientAndHessian0 = batchProblem.GradientAndHessian0(dofValues, {disp}, 0, 0);
+        BoostUnitTest::CheckEigenMatrix(gradientAndHessian0.first[disp], K * dofValues[disp]);
+        BoostUnitTest::CheckEigenMatrix(batchProblem.Gradient(dofValues, {disp}, 0, 0)[disp], K * dofValues[disp]);
+    }
+
+    DofVector<double> x = dofValues;
+    x[disp].setRandom();
+    BoostUnitTest::CheckEigenMatrix(batchProblem.Hessian0Product(dofValues, x, {disp}, 0, 0)[disp], K * x[disp]);
+    const ContiguousDofVector<double> xContiguous(x, {disp});
+    BoostUnitTest::CheckEigenMatrix(batchProblem.Hessian0Product(dofValues, xContiguous, {disp}, 0, 0).Values(),
+                                    K * x[disp]);
+    BoostUnitTest::CheckEigenMatrix(batchProblem.Hessian0Diagonal(dofValues, {disp}, 0, 0)[disp],
+                                    Eigen::VectorXd(K.diagonal()));
+    BOOST_CHECK_THROW(batchProblem.Hessian0Blocked(dofValues, disp, 0, 0), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(SumFactorizedCells)
+{
+    // linear geometry with quadratic Lobatto displacements, the batch interpolates the geometry to the Lobatto nodes
+    MeshFem mesh = UnitMeshFem::Transform(UnitMeshFem::CreateQuads(3, 2), [](Eigen::VectorXd x) {
+        return Eigen::Vector2d(3 * x[0], x[1] + 0.2 * x[0]);
+    });
+    DofType disp("Displacements", 2);
+    AddDofInterpolation(&mesh, disp, mesh.CreateInterpolation(InterpolationQuadLobatto(2)));
+    Laws::LinearElastic<2> law(20000, 0.2);
+    Integrands::MomentumBalance<2> momentumBalance(disp, law);
+    IntegrationTypeTensorProduct<2> integrationType(3, eIntegrationMethod::GAUSS);
+
+    CellStorage cells;
+    TimeDependentProblem problem(&mesh);
+    auto cellGroup = cells.AddCells(mesh.ElementsTotal(), integrationType);
+    problem.AddHessian0Function(
+            cellGroup, TimeDependentProblem::Bind_dt(momentumBalance, &Integrands::MomentumBalance<2>::Hessian0));
+    DofVector<double> dofValues = problem.RenumberDofs(Constraint::Constraints(), {disp}, DofVector<double>());
+    dofValues[disp].setRandom();
+    const Eigen::SparseMatrix<double> K = problem.Hessian0(dofValues, {disp}, 0, 0)(disp, disp);
+
+    SumFactorization<2> kernel(2, integrationType);
+    SumFactorizedBatch<2> batch(mesh.ElementsTotal(), kernel, disp, law);
+    TimeDependentProblem batchProblem(&mesh);
+    batchProblem.AddBatch(batch);
+    batchProblem.RenumberDofs(Constraint::Constraints(), {disp}, DofVector<double>());
+
+    const Eigen::SparseMatrix<double> KUpper = batchProblem.Hessian0(dofValues, {disp}, 0, 0)(disp, disp);
+    const Eigen::SparseMatrix<double> KFull = KUpper.selfadjointView<Eigen::Upper>();
+    BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(KFull), Eigen::MatrixXd(K), 1.e-8);
+    BoostUnitTest::CheckEigenMatrix(batchProblem.Gradient(dofValues, {disp}, 0, 0)[disp], K * dofValues[disp],
+                                    1.e-8);
+
+    DofVector<double> x = dofValues;
+    x[disp].setRandom();
+    BoostUnitTest::CheckEigenMatrix(batchProblem.Hessian0Product(dofValues, x, {disp}, 0, 0)[disp], K * x[disp],
+                                    1.e-8);
+    BoostUnitTest::CheckEigenMatrix(batchProblem.Hessian0Diagonal(dofValues, {disp}, 0, 0)[disp],
+                                    Eigen::VectorXd(K.diagonal()), 1.e-8);
+}
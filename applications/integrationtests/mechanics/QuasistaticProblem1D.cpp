@@ -8,6 +8,7 @@
 #include "nuto/mechanics/integrands/MomentumBalance.h"
 #include "nuto/mechanics/integrands/Bind.h"
 #include "nuto/mechanics/integrationtypes/IntegrationTypeTensorProduct.h"
+#include "nuto/mechanics/cell/CellTBatch.h"
 #include "nuto/mechanics/constraints/ConstraintCompanion.h"
 #include "nuto/mechanics/mesh/UnitMeshFem.h"
 #include "nuto/mechanics/mesh/MeshFemDofConvert.h"
@@ -19,12 +20,35 @@
 #include "nuto/mechanics/constitutive/damageLaws/DamageLawExponential.h"
 #include "nuto/mechanics/constitutive/ModifiedMisesStrainNorm.h"
 
+#include <boost/test/data/test_case.hpp>
+
+namespace bdata = boost::unit_test::data;
+
 using namespace NuTo;
 
+//! @brief variants of the assembly of LocalDamageTruss, the defaults add separate functions for the cell group
+struct TrussOptions
+{
+    //! @brief use Integrands::MomentumBalance::GradientAndHessian0 instead of separate functions
+    bool fused = false;
+
+    //! @brief read the node values from the dof vector, see TimeDependentProblem::EnableDirectNodeValues()
+    bool directNodeValues = false;
+
+    //! @brief add the separate functions with the cell ranges of the storage instead of the cell group
+    bool cellRanges = false;
+
+    //! @brief cache the reference geometry of the cells, see CellStorage::EnableGeometryCache(...)
+    bool geometryCache = false;
+
+    //! @brief evaluate compile time specialized cells with the fixed size kernels of a CellTBatch
+    bool fixedSize = false;
+};
+
 class LocalDamageTruss
 {
 public:
-    LocalDamageTruss(int numElements, Material::Softening m)
+    LocalDamageTruss(int numElements, Material::Softening m, TrussOptions options = TrussOptions())
         : mMesh(UnitMeshFem::CreateLines(numElements))
         , mDof("Dispacement", 1)
         , mLaw(m)
@@ -35,20 +59,14 @@ public:
     {
         AddDofInterpolation(&mMesh, mDof);
 
-        mCellGroup = mCells.AddCells(mMesh.ElementsTotal(), mIntegrationType);
+        if (options.geometryCache)
+            mCells.EnableGeometryCache({mDof});
+        if (options.fixedSize)
+            AddFixedSizeBatch();
+        else
+            AddCellFunctions(options);
         mLaw.mEvolution.ResizeHistoryData(mCellGroup.Size(), mIntegrationType.GetNumIntegrationPoints());
 
-
-        auto Gradient = TimeDependentProblem::Bind_dt(mMomentumBalance, &Integrands::MomentumBalance<1>::Gradient);
-        auto Hessian0 = TimeDependentProblem::Bind_dt(mMomentumBalance, &Integrands::MomentumBalance<1>::Hessian0);
-        TimeDependentProblem::UpdateFunction UpdateHistory = [&](const CellIpData& cellIpData, double, double dt) {
-            mLaw.Update(cellIpData.Apply(mDof, Nabla::Strain()), dt, cellIpData.Ids());
-        };
-
-        mEquations.AddGradientFunction(mCellGroup, Gradient);
-        mEquations.AddHessian0Function(mCellGroup, Hessian0);
-        mEquations.AddUpdateFunction(mCellGroup, UpdateHistory);
-
         auto constraints = DefineConstraints(mMesh, mDof);
 
         mProblem.SetConstraints(constraints);
@@ -61,6 +79,11 @@ public:
         mLaw.mEvolution.mKappas(imperfectionCell, 0) = kappaImperfection;
     }
 
+    void SetTangentUpdate(NewtonRaphson::TangentUpdate update)
+    {
+        mProblem.SetTangentUpdate(update);
+    }
+
     void Solve(double tEnd)
     {
         auto doStep = [&](double t) { return mProblem.DoStep(t, "EigenSparseLU"); };
@@ -86,6 +109,11 @@ public:
         return damage;
     }
 
+    size_t GeometryCacheBytes() const
+    {
+        return mCells.GeometryCacheBytes();
+    }
+
 private:
     MeshFem mMesh;
 
@@ -99,6 +127,55 @@ private:
     IntegrationTypeTensorProduct<1> mIntegrationType;
     CellStorage mCells;
     Group<CellInterface> mCellGroup;
+    std::unique_ptr<CellBatchInterface> mBatch;
+
+    //! @brief adds the dynamic cells and their gradient, hessian and update functions
+    void AddCellFunctions(TrussOptions options)
+    {
+        mCellGroup = mCells.AddCells(mMesh.ElementsTotal(), mIntegrationType);
+        auto Gradient = TimeDependentProblem::Bind_dt(mMomentumBalance, &Integrands::MomentumBalance<1>::Gradient);
+        auto Hessian0 = TimeDependentProblem::Bind_dt(mMomentumBalance, &Integrands::MomentumBalance<1>::Hessian0);
+        TimeDependentProblem::UpdateFunction UpdateHistory = [&](const CellIpData& cellIpData, double, double dt) {
+            mLaw.Update(cellIpData.Apply(mDof, Nabla::Strain()), dt, cellIpData.Ids());
+        };
+
+        if (options.fused)
+            mEquations.AddGradientAndHessian0Function(
+                    mCellGroup, TimeDependentProblem::Bind_dt(mMomentumBalance,
+                                                              &Integrands::MomentumBalance<1>::GradientAndHessian0));
+        else if (options.cellRanges)
+        {
+            mEquations.AddGradientFunction(mCells.Ranges(2), Gradient);
+            mEquations.AddHessian0Function(mCells.Ranges(2), Hessian0);
+        }
+        else
+        {
+            mEquations.AddGradientFunction(mCellGroup, Gradient);
+            mEquations.AddHessian0Function(mCellGroup, Hessian0);
+        }
+        mEquations.AddUpdateFunction(mCellGroup, UpdateHistory);
+        if (options.directNodeValues)
+            mEquations.EnableDirectNodeValues();
+    }
+
+    //! @brief adds compile time specialized cells and a batch of their fixed size kernels
+    void AddFixedSizeBatch()
+    {
+        using FixedSizeCell = CellT<1, 2, 2>;
+        Group<FixedSizeCell> cells = mCells.AddCellsT<1, 2, 2>(mMesh.ElementsTotal(), mIntegrationType);
+        for (FixedSizeCell& cell : cells)
+            mCellGroup.Add(cell);
+
+        auto batch = MakeCellTBatch(
+                cells, {mDof},
+                [&](const FixedSizeCell::IpData& data, double dt) { return mMomentumBalance.GradientT(data, dt); },
+                [&](const FixedSizeCell::IpData& data, double dt) { return mMomentumBalance.Hessian0T(data, dt); });
+        batch.SetUpdateFunction([&](const FixedSizeCell::IpData& data, double dt) {
+            mLaw.Update(data.Strain(mDof), dt, data.Ids());
+        });
+        mBatch = std::make_unique<decltype(batch)>(std::move(batch));
+        mEquations.AddBatch(*mBatch);
+    }
 
     Constraint::Constraints DefineConstraints(MeshFem& mesh, DofType disp)
     {
@@ -153,3 +230,114 @@ BOOST_AUTO_TEST_CASE(LocalDamage1DWithImperfection)
             BOOST_CHECK_SMALL(damageField[i], 1.e-5);
     }
 }
+
+//! @return options that differ from the defaults only in the variant `name`
+TrussOptions Variant(const std::string& name)
+{
+    TrussOptions options;
+    options.fused = name == "fused";
+    options.directNodeValues = name == "directNodeValues";
+    options.cellRanges = name == "cellRanges";
+    options.geometryCache = name == "geometryCache";
+    options.fixedSize = name == "fixedSize";
+    return options;
+}
+
+auto trussVariants = {"fused", "directNodeValues", "cellRanges", "geometryCache", "fixedSize"};
+
+BOOST_DATA_TEST_CASE(LocalDamage1DVariants, bdata::make(trussVariants), variant)
+{
+    auto material = Material::DefaultConcrete();
+    material.fMin = 0.;
+    LocalDamageTruss reference(5, material);
+    reference.SetImperfection(0.001);
+    reference.Solve(1);
+
+    LocalDamageTruss truss(5, material, Variant(variant));
+    truss.SetImperfection(0.001);
+    truss.Solve(1);
+
+    // only the geometry cache variant leaves the default uncached evaluation
+    BOOST_CHECK_EQUAL(reference.GeometryCacheBytes(), 0);
+    BOOST_CHECK_EQUAL(truss.GeometryCacheBytes() > 0, Variant(variant).geometryCache);
+
+    auto damageReference = reference.DamageField();
+    auto damage = truss.DamageField();
+    BOOST_CHECK_EQUAL_COLLECTIONS(damage.begin(), damage.end(), damageReference.begin(), damageReference.end());
+}
+
+BOOST_AUTO_TEST_CASE(DirectNodeValuesOutliveProblem)
+{
+    MeshFem mesh = UnitMeshFem::CreateLines(2);
+    DofType dof("Displacement", 1);
+    AddDofInterpolation(&mesh, dof);
+    for (auto& node : mesh.NodesTotal(dof))
+        node.SetValue(0, 42.);
+
+    IntegrationTypeTensorProduct<1> integrationType(2, eIntegrationMethod::GAUSS);
+    CellStorage cells;
+    Group<CellInterface> cellGroup = cells.AddCells(mesh.ElementsTotal(), integrationType);
+    {
+        TimeDependentProblem equations(&mesh);
+        equations.AddGradientFunction(cellGroup, [&](const CellIpData& cellIpData, double, double) {
+            DofVector<double> gradient;
+            gradient[dof] = cellIpData.N(dof).transpose();
+            return gradient;
+        });
+        equations.EnableDirectNodeValues();
+    }
+
+    // the cells keep the dof value source of the destroyed problem, nothing is bound, so they read the nodes
+    auto Value = [&](const CellIpData& cellIpData) { return cellIpData.Value(dof); };
+    for (auto& cell : cellGroup)
+        for (const Eigen::VectorXd& value : cell.Eval(Value))
+            BOOST_CHECK_CLOSE(value[0], 42., 1.e-10);
+}
+
+BOOST_AUTO_TEST_CASE(Hessian0ReturnsMemoizedMatrix)
+{
+    MeshFem mesh = UnitMeshFem::CreateLines(2);
+    DofType dof("Displacement", 1);
+    AddDofInterpolation(&mesh, dof);
+
+    IntegrationTypeTensorProduct<1> integrationType(2, eIntegrationMethod::GAUSS);
+    CellStorage cells;
+    Group<CellInterface> cellGroup = cells.AddCells(mesh.ElementsTotal(), integrationType);
+
+    TimeDependentProblem equations(&mesh);
+    equations.AddHessian0Function(cellGroup, [&](const CellIpData& cellIpData, double t, double) {
+        DofMatrix<double> hessian0;
+        hessian0(dof, dof) = t * cellIpData.B(dof, Nabla::Strain()).transpose() * cellIpData.B(dof, Nabla::Strain());
+        return hessian0;
+    });
+    DofVector<double> dofValues = equations.RenumberDofs(Constraint::Constraints(), {dof}, DofVector<double>());
+
+    // the first call defines the pattern, the following ones reuse the matrix instead of copying it
+    const Eigen::SparseMatrix<double> K1 = equations.Hessian0(dofValues, {dof}, 1, 0)(dof, dof);
+    const DofMatrixSparse<double>& K2 = equations.Hessian0(dofValues, {dof}, 2, 0);
+    BOOST_CHECK_EQUAL(&equations.Hessian0(dofValues, {dof}, 2, 0), &K2);
+    BOOST_CHECK_EQUAL(&equations.GradientAndHessian0(dofValues, {dof}, 2, 0).second, &K2);
+    BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(K2(dof, dof)), Eigen::MatrixXd(2 * K1));
+}
+
+BOOST_AUTO_TEST_CASE(LocalDamage1DTangentUpdates)
+{
+    auto material = Material::DefaultConcrete();
+    material.fMin = 0.;
+    LocalDamageTruss full(5, material);
+    full.SetImperfection(0.001);
+    full.Solve(1);
+    auto damageFull = full.DamageField();
+
+    for (auto update : {NewtonRaphson::ModifiedNewton(0, 0.5, true),
+                        NewtonRaphson::QuasiNewton(NewtonRaphson::eQuasiNewton::BROYDEN, 0, 0.9, true)})
+    {
+        LocalDamageTruss modified(5, material);
+        modified.SetImperfection(0.001);
+        modified.SetTangentUpdate(update);
+        modified.Solve(1);
+        auto damageModified = modified.DamageField();
+        for (size_t i = 0; i < damageFull.size(); ++i)
+            BOOST_CHECK_SMALL(damageModified[i] - damageFull[i], 1.e-6);
+    }
+}
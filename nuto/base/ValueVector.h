@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
 #include <memory>
 #include <boost/iterator/indirect_iterator.hpp>
@@ -13,10 +15,14 @@ namespace NuTo
 //! the nice value semantics for free. However, there is an issue regarding move.
 //!         https://stackoverflow.com/questions/44130076/moving-a-boostptr-vector
 //! Therefore, here is a custom implementation with only the basic features.
+//! @remark The values are stored contiguously in chunks instead of one allocation per value. The capacity of a new
+//! chunk equals the number of values so far, up to MaxChunkSize, so small containers allocate little and large ones
+//! few times. A chunk is never reallocated, so the references stay valid. The order of the container is a separate
+//! list of pointers.
 template <typename T>
 class ValueVector
 {
-    using Data = std::vector<std::unique_ptr<T>>;
+    using Data = std::vector<T*>;
     //! @brief indirect (dereferencing) iterator to provide value semantics for the iterators
     typedef boost::indirect_iterator<typename Data::iterator> IndirectIterator;
     typedef boost::indirect_iterator<typename Data::const_iterator> ConstIndirectIterator;
@@ -25,14 +31,12 @@ public:
     template <typename... TArgs>
     T& Add(TArgs&&... args)
     {
-        mData.push_back(std::make_unique<T>(std::forward<TArgs>(args)...));
-        return *mData.back();
+        return Emplace(std::forward<TArgs>(args)...);
     }
 
     T& Add(T&& t)
     {
-        mData.push_back(std::make_unique<T>(std::move(t)));
-        return *mData.back();
+        return Emplace(std::move(t));
     }
 
     IndirectIterator begin()
@@ -69,6 +73,7 @@ public:
         return *mData[i];
     }
 
+    //! @remark Erased values stay in their chunk until the container is destroyed.
     IndirectIterator Erase(IndirectIterator it)
     {
         return mData.erase(it.base());
@@ -79,7 +84,40 @@ public:
         return mData.erase(from.base(), to.base());
     }
 
+    //! @brief rearranges the values such that the i-th value is the previous `order[i]`-th value
+    //! @param order permutation of [0, Size()), references to the values stay valid
+    void Reorder(const std::vector<int>& order)
+    {
+        assert(order.size() == mData.size());
+        Data reordered;
+        reordered.reserve(mData.size());
+        for (int i : order)
+            reordered.push_back(mData[i]);
+        mData = std::move(reordered);
+    }
+
 private:
+    static constexpr size_t MaxChunkSize = 256;
+
+    template <typename... TArgs>
+    T& Emplace(TArgs&&... args)
+    {
+        if (mChunks.empty() or mChunks.back().size() == mChunks.back().capacity())
+        {
+            size_t numValues = 0;
+            for (const auto& chunk : mChunks)
+                numValues += chunk.size();
+            mChunks.emplace_back();
+            mChunks.back().reserve(std::min(std::max(numValues, size_t(1)), MaxChunkSize));
+        }
+        mChunks.back().emplace_back(std::forward<TArgs>(args)...);
+        mData.push_back(&mChunks.back().back());
+        return *mData.back();
+    }
+
+    //! @brief storage of the values, the capacity of each chunk is reserved once
+    std::vector<std::vector<T>> mChunks;
+    //! @brief values in the order of the container
     Data mData;
 };
 } /* NuTo */
@@ -0,0 +1,310 @@
+#include "nuto/math/AmgPreconditioner.h"
+#include <algorithm>
+#include <cmath>
+#include <Eigen/QR>
+#include "nuto/base/Exception.h"
+#include "nuto/base/Timer.h"
+#include "nuto/base/Logger.h"
+#include "nuto/math/Smoothers.h"
+
+using namespace NuTo;
+
+namespace
+{
+
+using RowMatrix = Eigen::SparseMatrix<double, Eigen::RowMajor>;
+
+//! @brief assembles a row major matrix from its sorted rows
+RowMatrix FromRows(int numColumns, const std::vector<std::vector<int>>& columns,
+                   const std::vector<std::vector<double>>& values)
+{
+    const int numRows = columns.size();
+    std::vector<int> offsets(numRows + 1, 0);
+    for (int i = 0; i < numRows; ++i)
+        offsets[i + 1] = offsets[i] + columns[i].size();
+
+    RowMatrix matrix(numRows, numColumns);
+    matrix.resizeNonZeros(offsets.back());
+    std::copy(offsets.begin(), offsets.end(), matrix.outerIndexPtr());
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < numRows; ++i)
+    {
+        std::copy(columns[i].begin(), columns[i].end(), matrix.innerIndexPtr() + offsets[i]);
+        std::copy(values[i].begin(), values[i].end(), matrix.valuePtr() + offsets[i]);
+    }
+    return matrix;
+}
+
+//! @brief A B, the rows are computed in parallel with a dense accumulator per thread
+RowMatrix SparseProduct(const RowMatrix& A, const RowMatrix& B)
+{
+    const int numRows = A.rows();
+    std::vector<std::vector<int>> columns(numRows);
+    std::vector<std::vector<double>> values(numRows);
+#pragma omp parallel
+    {
+        std::vector<double> accumulator(B.cols(), 0.);
+        std::vector<int> marker(B.cols(), -1);
+#pragma omp for schedule(dynamic, 256)
+        for (int i = 0; i < numRows; ++i)
+        {
+            std::vector<int>& rowColumns = columns[i];
+            for (RowMatrix::InnerIterator a(A, i); a; ++a)
+                for (RowMatrix::InnerIterator b(B, a.index()); b; ++b)
+                {
+                    const int j = b.index();
+                    if (marker[j] != i)
+                    {
+                        marker[j] = i;
+                        accumulator[j] = 0.;
+                        rowColumns.push_back(j);
+                    }
+                    accumulator[j] += a.value() * b.value();
+                }
+            std::sort(rowColumns.begin(), rowColumns.end());
+            values[i].reserve(rowColumns.size());
+            for (int j : rowColumns)
+                values[i].push_back(accumulator[j]);
+        }
+    }
+    return FromRows(B.cols(), columns, values);
+}
+
+//! @return strong off diagonal connections of each row, |a_ij| >= threshold * sqrt(|a_ii a_jj|)
+std::vector<std::vector<int>> StrongConnections(const RowMatrix& A, double threshold)
+{
+    const Eigen::VectorXd diagonal = A.diagonal().cwiseAbs();
+    std::vector<std::vector<int>> strong(A.rows());
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int i = 0; i < A.rows(); ++i)
+        for (RowMatrix::InnerIterator it(A, i); it; ++it)
+            if (it.index() != i and std::abs(it.value()) >= threshold * std::sqrt(diagonal[i] * diagonal[it.index()]))
+                strong[i].push_back(it.index());
+    return strong;
+}
+
+//! @brief greedy aggregation of Vanek et al.
+//! @return aggregate of each row
+std::vector<int> Aggregate(const std::vector<std::vector<int>>& strong, int* numAggregates)
+{
+    const int numRows = strong.size();
+    std::vector<int> aggregate(numRows, -1);
+    int count = 0;
+
+    // 1: rows whose strong neighborhood is still free form an aggregate with it
+    for (int i = 0; i < numRows; ++i)
+    {
+        if (aggregate[i] != -1)
+            continue;
+        if (std::any_of(strong[i].begin(), strong[i].end(), [&](int j) { return aggregate[j] != -1; }))
+            continue;
+        aggregate[i] = count;
+        for (int j : strong[i])
+            aggregate[j] = count;
+        ++count;
+    }
+
+    // 2: the remaining rows join an aggregate of their strong neighborhood
+    const std::vector<int> rootAggregate = aggregate;
+    for (int i = 0; i < numRows; ++i)
+    {
+        if (aggregate[i] != -1)
+            continue;
+        for (int j : strong[i])
+            if (rootAggregate[j] != -1)
+            {
+                aggregate[i] = rootAggregate[j];
+                break;
+            }
+    }
+
+    // 3: the rest forms new aggregates with its free strong neighbors
+    for (int i = 0; i < numRows; ++i)
+    {
+        if (aggregate[i] != -1)
+            continue;
+        aggregate[i] = count;
+        for (int j : strong[i])
+            if (aggregate[j] == -1)
+                aggregate[j] = count;
+        ++count;
+    }
+
+    *numAggregates = count;
+    return aggregate;
+}
+
+//! @brief tentative prolongator T with orthonormal columns per aggregate and T coarseB = B
+//! @remark each aggregate gets as many coarse dofs as the rank of B restricted to it
+RowMatrix TentativeProlongator(const std::vector<int>& aggregate, int numAggregates, const Eigen::MatrixXd& B,
+                               Eigen::MatrixXd* coarseB)
+{
+    std::vector<std::vector<int>> members(numAggregates);
+    for (size_t i = 0; i < aggregate.size(); ++i)
+        members[aggregate[i]].push_back(i);
+
+    const int numModes = B.cols();
+    std::vector<Eigen::MatrixXd> Q(numAggregates);
+    std::vector<Eigen::MatrixXd> R(numAggregates);
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int a = 0; a < numAggregates; ++a)
+    {
+        const int numMembers = members[a].size();
+        Eigen::MatrixXd localB(numMembers, numModes);
+        for (int i = 0; i < numMembers; ++i)
+            localB.row(i) = B.row(members[a][i]);
+
+        Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(localB);
+        const int rank = qr.rank();
+        Q[a] = qr.householderQ() * Eigen::MatrixXd::Identity(numMembers, rank);
+        Eigen::MatrixXd upper = qr.matrixR().topRows(rank).triangularView<Eigen::Upper>();
+        R[a] = upper * qr.colsPermutation().transpose();
+    }
+
+    std::vector<int> offsets(numAggregates + 1, 0);
+    for (int a = 0; a < numAggregates; ++a)
+        offsets[a + 1] = offsets[a] + Q[a].cols();
+
+    coarseB->resize(offsets.back(), numModes);
+    std::vector<std::vector<int>> columns(aggregate.size());
+    std::vector<std::vector<double>> values(aggregate.size());
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int a = 0; a < numAggregates; ++a)
+    {
+        coarseB->middleRows(offsets[a], R[a].rows()) = R[a];
+        for (size_t i = 0; i < members[a].size(); ++i)
+            for (int c = 0; c < Q[a].cols(); ++c)
+            {
+                columns[members[a][i]].push_back(offsets[a] + c);
+                values[members[a][i]].push_back(Q[a](i, c));
+            }
+    }
+    return FromRows(offsets.back(), columns, values);
+}
+} // namespace
+
+AmgPreconditioner::AmgPreconditioner(const Eigen::SparseMatrix<double>& A)
+{
+    compute(A);
+}
+
+void AmgPreconditioner::SetOptions(Options options)
+{
+    mOptions = options;
+}
+
+void AmgPreconditioner::SetNearNullspace(Eigen::MatrixXd nearNullspace)
+{
+    mNearNullspace = nearNullspace;
+}
+
+void AmgPreconditioner::Setup(const Eigen::SparseMatrix<double>& A)
+{
+    Timer timer(__PRETTY_FUNCTION__, true, Log::Debug);
+    if (A.rows() != A.cols())
+        throw Exception(__PRETTY_FUNCTION__, "The matrix has to be square.");
+
+    mLevels.clear();
+    RowMatrix current = A;
+    Eigen::MatrixXd B = mNearNullspace.rows() == A.rows() ? mNearNullspace : Eigen::MatrixXd::Ones(A.rows(), 1);
+
+    while (current.rows() > mOptions.maxCoarseSize and static_cast<int>(mLevels.size()) + 1 < mOptions.maxNumLevels)
+    {
+        int numAggregates = 0;
+        const std::vector<int> aggregate =
+                Aggregate(StrongConnections(current, mOptions.strengthThreshold), &numAggregates);
+
+        Eigen::MatrixXd coarseB;
+        const RowMatrix T = TentativeProlongator(aggregate, numAggregates, B, &coarseB);
+        if (T.cols() == 0 or T.cols() >= current.rows())
+            break;
+
+        // P = (I - omega / rho D^-1 A) T
+        const Eigen::VectorXd inverseDiagonal = InverseDiagonal(current);
+        const double omega = mOptions.prolongatorDamping / EstimateMaxEigenvalue(current, inverseDiagonal, 15);
+        const RowMatrix AT = SparseProduct(current, T);
+        const RowMatrix DAT = (omega * inverseDiagonal).asDiagonal() * AT;
+
+        Level level;
+        level.P = T - DAT;
+        level.R = level.P.transpose();
+        RowMatrix coarse = SparseProduct(level.R, SparseProduct(current, level.P));
+        level.A = std::move(current);
+        mLevels.push_back(std::move(level));
+
+        current = std::move(coarse);
+        B = std::move(coarseB);
+    }
+    Level coarsest;
+    coarsest.A = std::move(current);
+    mLevels.push_back(std::move(coarsest));
+    Finalize();
+}
+
+void AmgPreconditioner::Update(const Eigen::SparseMatrix<double>& A)
+{
+    if (mLevels.empty() or mLevels.front().A.rows() != A.rows())
+    {
+        Setup(A);
+        return;
+    }
+    Timer timer(__PRETTY_FUNCTION__, true, Log::Debug);
+    mLevels.front().A = A;
+    for (size_t i = 0; i + 1 < mLevels.size(); ++i)
+        mLevels[i + 1].A = SparseProduct(mLevels[i].R, SparseProduct(mLevels[i].A, mLevels[i].P));
+    Finalize();
+}
+
+void AmgPreconditioner::Finalize()
+{
+    for (size_t i = 0; i + 1 < mLevels.size(); ++i)
+    {
+        Level& level = mLevels[i];
+        const Eigen::VectorXd inverseDiagonal = InverseDiagonal(level.A);
+        const double lambdaMax = EstimateMaxEigenvalue(level.A, inverseDiagonal, 15);
+        level.smoother = mOptions.smootherDamping / lambdaMax * inverseDiagonal;
+    }
+    mCoarseSolver.compute(Eigen::SparseMatrix<double>(mLevels.back().A));
+    mInfo = mCoarseSolver.info();
+    Log::Debug << "AMG with " << NumLevels() << " levels, coarse size " << Size(NumLevels() - 1) << '\n';
+}
+
+void AmgPreconditioner::VCycle(int iLevel, const Eigen::VectorXd& b, Eigen::VectorXd* x) const
+{
+    if (iLevel == NumLevels() - 1)
+    {
+        *x = mCoarseSolver.solve(b);
+        return;
+    }
+
+    const Level& level = mLevels[iLevel];
+    *x = level.smoother.cwiseProduct(b);
+    for (int i = 1; i < mOptions.numSmoothingSteps; ++i)
+        *x += level.smoother.cwiseProduct(b - level.A * *x);
+
+    Eigen::VectorXd coarseX;
+    VCycle(iLevel + 1, level.R * (b - level.A * *x), &coarseX);
+    *x += level.P * coarseX;
+
+    for (int i = 0; i < mOptions.numSmoothingSteps; ++i)
+        *x += level.smoother.cwiseProduct(b - level.A * *x);
+}
+
+Eigen::VectorXd AmgPreconditioner::solve(const Eigen::VectorXd& b) const
+{
+    if (mLevels.empty())
+        throw Exception(__PRETTY_FUNCTION__, "The preconditioner is not set up. Call compute(A) first.");
+    Eigen::VectorXd x;
+    VCycle(0, b, &x);
+    return x;
+}
+
+int AmgPreconditioner::NumLevels() const
+{
+    return mLevels.size();
+}
+
+int AmgPreconditioner::Size(int level) const
+{
+    return mLevels.at(level).A.rows();
+}
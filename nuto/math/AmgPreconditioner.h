@@ -0,0 +1,129 @@
+#pragma once
+
+#include <vector>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <Eigen/IterativeLinearSolvers>
+
+namespace NuTo
+{
+
+//! @brief smoothed aggregation algebraic multigrid preconditioner for symmetric positive definite matrices, one
+//! V-cycle per solve(...)
+//! @remark Vanek, Mandel, Brezina: Algebraic multigrid by smoothed aggregation for second and fourth order elliptic
+//! problems, Computing 56 (1996). The dofs are aggregated by their strong connections, the tentative prolongator
+//! interpolates the near nullspace exactly on each aggregate and is smoothed by one damped Jacobi step. For elasticity,
+//! the near nullspace are the rigid body modes, see SetNearNullspace(...). Without it, the constant vector is used,
+//! which suits scalar problems like heat conduction or the nonlocal equivalent strains.
+//!
+//! The prolongators are built by compute(A) or the first factorize(A) after analyzePattern(A). Further calls of
+//! factorize(A) only recompute the coarse matrices, the smoothers and the coarse factorization with these
+//! prolongators. Thus, the aggregation is reused for matrices with the same pattern, e.g. the tangents of the Newton
+//! iterations, see EigenSparseSolver. The setup, the smoothers and the sparse matrix products run in parallel with
+//! OpenMP.
+//!
+//! Usable as the preconditioner of the Eigen iterative solvers, see AmgConjugateGradient, and of
+//! NuTo::ConjugateGradient.
+class AmgPreconditioner
+{
+public:
+    struct Options
+    {
+        //! @brief a_ij is a strong connection if |a_ij| >= threshold * sqrt(|a_ii a_jj|)
+        double strengthThreshold = 0.08;
+
+        //! @brief damping of the prolongator smoothing, divided by the spectral radius of D^-1 A
+        double prolongatorDamping = 4. / 3.;
+
+        //! @brief damping of the Jacobi smoother, divided by the spectral radius of D^-1 A
+        double smootherDamping = 4. / 3.;
+
+        //! @brief number of pre- and post-smoothing steps, at least 1
+        int numSmoothingSteps = 2;
+
+        //! @brief matrices up to this size are factorized directly
+        int maxCoarseSize = 500;
+
+        int maxNumLevels = 10;
+    };
+
+    AmgPreconditioner() = default;
+
+    //! @brief ctor for NuTo::ConjugateGradient
+    explicit AmgPreconditioner(const Eigen::SparseMatrix<double>& A);
+
+    void SetOptions(Options options);
+
+    //! @param nearNullspace columns of the near nullspace of the matrix, e.g. the rigid body modes, used by the next
+    //! setup of the prolongators. Ignored if its number of rows differs from the matrix.
+    void SetNearNullspace(Eigen::MatrixXd nearNullspace);
+
+    //! @brief discards the prolongators, the next factorize(...) builds new ones
+    template <typename TMatrix>
+    AmgPreconditioner& analyzePattern(const TMatrix&)
+    {
+        mLevels.clear();
+        return *this;
+    }
+
+    //! @brief recomputes the coarse matrices and the smoothers with the existing prolongators, builds them first if
+    //! there are none for the size of `A`
+    template <typename TMatrix>
+    AmgPreconditioner& factorize(const TMatrix& A)
+    {
+        Update(Eigen::SparseMatrix<double>(A));
+        return *this;
+    }
+
+    //! @brief builds the aggregation and the prolongators of all levels and factorizes
+    template <typename TMatrix>
+    AmgPreconditioner& compute(const TMatrix& A)
+    {
+        Setup(Eigen::SparseMatrix<double>(A));
+        return *this;
+    }
+
+    //! @return one V-cycle applied to `b`, starting from zero
+    Eigen::VectorXd solve(const Eigen::VectorXd& b) const;
+
+    Eigen::ComputationInfo info() const
+    {
+        return mInfo;
+    }
+
+    int NumLevels() const;
+
+    //! @return number of rows of the matrix on `level`, 0 is the finest
+    int Size(int level) const;
+
+private:
+    using RowMatrix = Eigen::SparseMatrix<double, Eigen::RowMajor>;
+
+    struct Level
+    {
+        RowMatrix A;
+        //! @brief prolongator from the next coarser level
+        RowMatrix P;
+        //! @brief restriction P^T
+        RowMatrix R;
+        //! @brief damped inverse diagonal of the Jacobi smoother
+        Eigen::VectorXd smoother;
+    };
+
+    void Setup(const Eigen::SparseMatrix<double>& A);
+    void Update(const Eigen::SparseMatrix<double>& A);
+    void Finalize();
+    void VCycle(int level, const Eigen::VectorXd& b, Eigen::VectorXd* x) const;
+
+    Options mOptions;
+    Eigen::MatrixXd mNearNullspace;
+    std::vector<Level> mLevels;
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> mCoarseSolver;
+    Eigen::ComputationInfo mInfo = Eigen::Success;
+};
+
+//! @brief conjugate gradient method with the AmgPreconditioner, multithreaded via Lower|Upper
+using AmgConjugateGradient =
+        Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower | Eigen::Upper, AmgPreconditioner>;
+
+} // namespace NuTo
@@ -0,0 +1,183 @@
+#include "nuto/math/BlockSparseMatrix.h"
+#include <algorithm>
+#include "nuto/base/Exception.h"
+
+using namespace NuTo;
+
+BlockSparseMatrix::BlockSparseMatrix(int blockSize, int numBlockRows, int numBlockCols,
+                                     std::vector<std::vector<int>> blockColumns)
+    : mBlockSize(blockSize)
+    , mNumBlockRows(numBlockRows)
+    , mNumBlockCols(numBlockCols)
+{
+    if (blockSize < 1)
+        throw Exception(__PRETTY_FUNCTION__, "The block size has to be positive.");
+    if (static_cast<int>(blockColumns.size()) != numBlockRows)
+        throw Exception(__PRETTY_FUNCTION__, "Expected block columns for " + std::to_string(numBlockRows) +
+                                                     " block rows, got " + std::to_string(blockColumns.size()) + ".");
+
+    mRowOffsets.resize(numBlockRows + 1);
+    for (int iRow = 0; iRow < numBlockRows; ++iRow)
+    {
+        std::vector<int>& columns = blockColumns[iRow];
+        std::sort(columns.begin(), columns.end());
+        columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+        if (not columns.empty() and (columns.front() < 0 or columns.back() >= numBlockCols))
+            throw Exception(__PRETTY_FUNCTION__, "Block column index out of range in block row " +
+                                                         std::to_string(iRow) + ".");
+        mRowOffsets[iRow + 1] = mRowOffsets[iRow] + columns.size();
+    }
+
+    mBlockColumns.reserve(mRowOffsets.back());
+    for (const auto& columns : blockColumns)
+        mBlockColumns.insert(mBlockColumns.end(), columns.begin(), columns.end());
+    mValues.resize(mBlockColumns.size() * blockSize * blockSize, 0.);
+}
+
+namespace
+{
+
+//! @brief block columns of all the blocks of `m` that contain stored entries
+std::vector<std::vector<int>> BlockColumns(const Eigen::SparseMatrix<double>& m, int blockSize)
+{
+    if (blockSize < 1 or m.rows() % blockSize != 0 or m.cols() % blockSize != 0)
+        throw Exception(__PRETTY_FUNCTION__, "The dimensions " + std::to_string(m.rows()) + "x" +
+                                                     std::to_string(m.cols()) + " are no multiples of the block size " +
+                                                     std::to_string(blockSize) + ".");
+
+    std::vector<std::vector<int>> blockColumns(m.rows() / blockSize);
+    for (int iCol = 0; iCol < m.outerSize(); ++iCol)
+        for (Eigen::SparseMatrix<double>::InnerIterator it(m, iCol); it; ++it)
+        {
+            std::vector<int>& columns = blockColumns[it.row() / blockSize];
+            const int blockCol = iCol / blockSize;
+            if (columns.empty() or columns.back() != blockCol) // the columns are visited in ascending order
+                columns.push_back(blockCol);
+        }
+    return blockColumns;
+}
+} // namespace
+
+BlockSparseMatrix::BlockSparseMatrix(const Eigen::SparseMatrix<double>& m, int blockSize)
+    : BlockSparseMatrix(blockSize, m.rows() / std::max(blockSize, 1), m.cols() / std::max(blockSize, 1),
+                        BlockColumns(m, blockSize))
+{
+    for (int iCol = 0; iCol < m.outerSize(); ++iCol)
+        for (Eigen::SparseMatrix<double>::InnerIterator it(m, iCol); it; ++it)
+        {
+            const int offset = BlockOffset(it.row() / blockSize, iCol / blockSize);
+            BlockData(offset)[it.row() % blockSize + (iCol % blockSize) * blockSize] += it.value();
+        }
+}
+
+int BlockSparseMatrix::BlockOffset(int blockRow, int blockCol) const
+{
+    const int* rowBegin = mBlockColumns.data() + mRowOffsets[blockRow];
+    const int* rowEnd = mBlockColumns.data() + mRowOffsets[blockRow + 1];
+    const int* entry = std::lower_bound(rowBegin, rowEnd, blockCol);
+    if (entry == rowEnd or *entry != blockCol)
+    {
+        const std::string block = "(" + std::to_string(blockRow) + ", " + std::to_string(blockCol) + ")";
+        throw Exception(__PRETTY_FUNCTION__, "The block " + block + " is not part of the nonzero pattern.");
+    }
+    return entry - mBlockColumns.data();
+}
+
+int BlockSparseMatrix::ValueOffset(int row, int col) const
+{
+    const int offset = BlockOffset(row / mBlockSize, col / mBlockSize);
+    return offset * mBlockSize * mBlockSize + row % mBlockSize + (col % mBlockSize) * mBlockSize;
+}
+
+void BlockSparseMatrix::SetZero()
+{
+    std::fill(mValues.begin(), mValues.end(), 0.);
+}
+
+namespace
+{
+
+//! @brief y = A x for blocks of a fixed size, the block rows are independent and processed in parallel
+//! @tparam TSize compile time block size, Eigen::Dynamic for all other sizes
+template <int TSize>
+void Multiply(int blockSize, int numBlockRows, const std::vector<int>& rowOffsets,
+              const std::vector<int>& blockColumns, const std::vector<double>& values, const Eigen::VectorXd& x,
+              Eigen::VectorXd* rY)
+{
+    using Block = Eigen::Matrix<double, TSize, TSize>;
+    using Vector = Eigen::Matrix<double, TSize, 1>;
+    const int blockEntries = blockSize * blockSize;
+
+#pragma omp parallel for
+    for (int iRow = 0; iRow < numBlockRows; ++iRow)
+    {
+        Vector y = Vector::Zero(blockSize);
+        for (int offset = rowOffsets[iRow]; offset < rowOffsets[iRow + 1]; ++offset)
+        {
+            Eigen::Map<const Block> block(values.data() + offset * blockEntries, blockSize, blockSize);
+            y.noalias() += block * x.segment<TSize>(blockColumns[offset] * blockSize, blockSize);
+        }
+        rY->segment<TSize>(iRow * blockSize, blockSize) = y;
+    }
+}
+
+} // namespace
+
+Eigen::VectorXd BlockSparseMatrix::operator*(const Eigen::VectorXd& x) const
+{
+    if (x.rows() != cols())
+        throw Exception(__PRETTY_FUNCTION__, "Vector size " + std::to_string(x.rows()) + " does not match the " +
+                                                     std::to_string(cols()) + " columns.");
+
+    Eigen::VectorXd y(rows());
+    switch (mBlockSize)
+    {
+    case 1:
+        Multiply<1>(mBlockSize, mNumBlockRows, mRowOffsets, mBlockColumns, mValues, x, &y);
+        break;
+    case 2:
+        Multiply<2>(mBlockSize, mNumBlockRows, mRowOffsets, mBlockColumns, mValues, x, &y);
+        break;
+    case 3:
+        Multiply<3>(mBlockSize, mNumBlockRows, mRowOffsets, mBlockColumns, mValues, x, &y);
+        break;
+    default:
+        Multiply<Eigen::Dynamic>(mBlockSize, mNumBlockRows, mRowOffsets, mBlockColumns, mValues, x, &y);
+    }
+    return y;
+}
+
+Eigen::VectorXd BlockSparseMatrix::diagonal() const
+{
+    Eigen::VectorXd d = Eigen::VectorXd::Zero(std::min(rows(), cols()));
+    for (int iRow = 0; iRow < std::min(mNumBlockRows, mNumBlockCols); ++iRow)
+    {
+        const int* rowBegin = mBlockColumns.data() + mRowOffsets[iRow];
+        const int* rowEnd = mBlockColumns.data() + mRowOffsets[iRow + 1];
+        const int* entry = std::lower_bound(rowBegin, rowEnd, iRow);
+        if (entry == rowEnd or *entry != iRow)
+            continue;
+        const double* block = BlockData(entry - mBlockColumns.data());
+        for (int i = 0; i < mBlockSize; ++i)
+            d[iRow * mBlockSize + i] = block[i + i * mBlockSize];
+    }
+    return d;
+}
+
+Eigen::SparseMatrix<double> BlockSparseMatrix::ToEigen() const
+{
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(mValues.size());
+    for (int iRow = 0; iRow < mNumBlockRows; ++iRow)
+        for (int offset = mRowOffsets[iRow]; offset < mRowOffsets[iRow + 1]; ++offset)
+        {
+            const double* block = BlockData(offset);
+            for (int j = 0; j < mBlockSize; ++j)
+                for (int i = 0; i < mBlockSize; ++i)
+                    triplets.emplace_back(iRow * mBlockSize + i, mBlockColumns[offset] * mBlockSize + j,
+                                          block[i + j * mBlockSize]);
+        }
+    Eigen::SparseMatrix<double> m(rows(), cols());
+    m.setFromTriplets(triplets.begin(), triplets.end());
+    return m;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+namespace NuTo
+{
+//! @brief Sparse matrix in block compressed row storage (BSR) with dense, square blocks of a fixed size
+//!
+//! Vector valued dofs, like the displacements, have 2 or 3 components per node that couple with all the components
+//! of the neighboring nodes. Storing one column index per node block instead of one per scalar entry reduces the
+//! index storage by blockSize^2 and the memory traffic of the matrix vector product accordingly.
+//!
+//! The blocks are stored contiguously in column major order, block row by block row. The block columns of each
+//! block row are sorted.
+class BlockSparseMatrix
+{
+public:
+    BlockSparseMatrix() = default;
+
+    //! @brief ctor that defines the nonzero pattern, all blocks are set to zero
+    //! @param blockSize number of rows (and columns) of a single block
+    //! @param numBlockRows number of block rows, the matrix has numBlockRows * blockSize rows
+    //! @param numBlockCols number of block columns, the matrix has numBlockCols * blockSize columns
+    //! @param blockColumns block column indices for each block row, may be unsorted and contain duplicates
+    BlockSparseMatrix(int blockSize, int numBlockRows, int numBlockCols,
+                      std::vector<std::vector<int>> blockColumns);
+
+    //! @brief conversion from a scalar sparse matrix. A block is stored if any of its entries is stored in `m`.
+    //! @param m sparse matrix whose number of rows and columns are multiples of `blockSize`
+    //! @param blockSize number of rows (and columns) of a single block
+    BlockSparseMatrix(const Eigen::SparseMatrix<double>& m, int blockSize);
+
+    int BlockSize() const
+    {
+        return mBlockSize;
+    }
+
+    int rows() const
+    {
+        return mNumBlockRows * mBlockSize;
+    }
+
+    int cols() const
+    {
+        return mNumBlockCols * mBlockSize;
+    }
+
+    //! @return number of stored blocks
+    int NonZeroBlocks() const
+    {
+        return static_cast<int>(mBlockColumns.size());
+    }
+
+    //! @return position of the block (blockRow, blockCol) in the block storage, see BlockData(...)
+    //! @remark throws if the block is not part of the nonzero pattern
+    int BlockOffset(int blockRow, int blockCol) const;
+
+    //! @return pointer to the column major values of the `offset`-th stored block
+    double* BlockData(int offset)
+    {
+        return mValues.data() + offset * mBlockSize * mBlockSize;
+    }
+
+    const double* BlockData(int offset) const
+    {
+        return mValues.data() + offset * mBlockSize * mBlockSize;
+    }
+
+    //! @return position of the scalar entry (row, col) in Values(), e.g. to memoize the scatter positions of local
+    //! matrices
+    //! @remark throws if the entry is not part of the nonzero pattern
+    int ValueOffset(int row, int col) const;
+
+    //! @return values of all blocks, one block after the other, see ValueOffset(...)
+    double* Values()
+    {
+        return mValues.data();
+    }
+
+    //! @brief sets all stored values to zero and keeps the nonzero pattern
+    void SetZero();
+
+    //! @brief matrix vector product y = A x
+    Eigen::VectorXd operator*(const Eigen::VectorXd& x) const;
+
+    //! @return diagonal of the matrix, e.g. for the JacobiPreconditioner
+    Eigen::VectorXd diagonal() const;
+
+    //! @brief conversion to a scalar sparse matrix, e.g. for the direct solvers of EigenSparseSolve(...)
+    Eigen::SparseMatrix<double> ToEigen() const;
+
+private:
+    int mBlockSize = 1;
+    int mNumBlockRows = 0;
+    int mNumBlockCols = 0;
+
+    //! position of the first block of each block row in mBlockColumns, numBlockRows + 1 entries
+    std::vector<int> mRowOffsets = {0};
+    //! block column index of each stored block
+    std::vector<int> mBlockColumns;
+    //! values of all blocks, blockSize^2 entries per block
+    std::vector<double> mValues;
+};
+} /* NuTo */
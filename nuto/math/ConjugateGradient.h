@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Eigen/Sparse>
+#include <Eigen/Core>
+
+
+namespace NuTo
+{
+
+/// \brief Preconditioned conjugate gradient method for symmetric positive definite operators
+/// \tparam T operator type that provides rows() and operator*(const Eigen::VectorXd&), e.g. an Eigen matrix or
+/// NuTo::MatrixFreeHessian0
+/// \tparam Preconditioner preconditioner type, constructible from `const T&` and provides solve(...)
+/// \param A symmetric positive definite operator
+/// \param rhs right hand side
+/// \param x initial guess on input, solution on output
+/// \param maxNumIterations maximum number of iterations
+/// \param tolerance relative tolerance with respect to the norm of the right hand side
+/// \return number of iterations
+template <class T, class Preconditioner = Eigen::DiagonalPreconditioner<double>>
+int ConjugateGradient(const T& A, const Eigen::VectorXd& rhs, Eigen::VectorXd& x, const int maxNumIterations,
+                      const double tolerance)
+{
+    using VectorType = Eigen::VectorXd;
+
+    Preconditioner precond(A);
+
+    double rhsNorm = rhs.norm();
+    if (rhsNorm < 1.e-5)
+        rhsNorm = 1.0;
+
+    VectorType r = rhs - A * x;
+    if (r.norm() <= tolerance * rhsNorm)
+        return 0;
+
+    VectorType z = precond.solve(r);
+    VectorType p = z;
+    double rz = r.dot(z);
+
+    for (int i = 0; i < maxNumIterations; ++i)
+    {
+        const VectorType Ap = A * p;
+        const double alpha = rz / p.dot(Ap);
+        x += alpha * p;
+        r -= alpha * Ap;
+
+        if (r.norm() <= tolerance * rhsNorm)
+            return i + 1;
+
+        z = precond.solve(r);
+        const double rzNew = r.dot(z);
+        p = z + (rzNew / rz) * p;
+        rz = rzNew;
+    }
+    return maxNumIterations;
+}
+
+} // namespace NuTo
@@ -1,7 +1,11 @@
 #include "EigenSparseSolve.h"
+#include <algorithm>
+#include <cassert>
 #include "nuto/base/Exception.h"
 #include "nuto/base/Timer.h"
 #include "nuto/base/Logger.h"
+#include "nuto/math/AmgPreconditioner.h"
+#include "nuto/math/GeometricMultigrid.h"
 #include <Eigen/SparseLU>
 #include <Eigen/SparseQR>
 #include <Eigen/SparseCholesky>
@@ -19,42 +23,149 @@
 namespace NuTo
 {
 
+//! @brief SparseFactorization with the Eigen solver interface analyzePattern/factorize/solve
 template <typename TSolver>
-Eigen::VectorXd SolveWithSolver(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& b)
+class SparseFactorizationT : public SparseFactorization
+{
+public:
+    void AnalyzePattern(const Eigen::SparseMatrix<double>& A) override
+    {
+        Timer t(__FUNCTION__, true, Log::Debug);
+        mSolver.analyzePattern(A);
+    }
+
+    void Factorize(const Eigen::SparseMatrix<double>& A) override
+    {
+        Timer t(__FUNCTION__, true, Log::Debug);
+        mSolver.factorize(A);
+    }
+
+    Eigen::VectorXd Solve(const Eigen::VectorXd& b) const override
+    {
+        return mSolver.solve(b);
+    }
+
+private:
+    TSolver mSolver;
+};
+
+namespace
+{
+
+//! @brief near nullspace of the preconditioners that do not use one
+template <typename TPreconditioner>
+void SetNearNullspaceOf(TPreconditioner&, const Eigen::MatrixXd&)
 {
-    Timer t(__FUNCTION__, true, Log::Debug);
-    TSolver solver;
-    solver.analyzePattern(A);
-    solver.factorize(A);
-    return solver.solve(b);
 }
 
-Eigen::VectorXd EigenSparseSolve(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& b, std::string solver)
+void SetNearNullspaceOf(AmgPreconditioner& preconditioner, const Eigen::MatrixXd& nearNullspace)
+{
+    preconditioner.SetNearNullspace(nearNullspace);
+}
+
+//! @brief prolongators of the preconditioners that do not use them
+template <typename TPreconditioner>
+void SetProlongatorsOf(TPreconditioner&, const std::vector<Eigen::SparseMatrix<double>>&)
+{
+}
+
+void SetProlongatorsOf(GeometricMultigrid& preconditioner, const std::vector<Eigen::SparseMatrix<double>>& prolongators)
+{
+    preconditioner.SetProlongators(prolongators);
+}
+} // namespace
+
+//! @brief SparseFactorization for the Eigen iterative solvers
+//! @remark The Eigen iterative solvers only keep a reference to the matrix, the copy in mMatrix keeps it alive for the
+//! calls of Solve(...).
+template <typename TSolver>
+class IterativeSolverT : public SparseFactorization
+{
+public:
+    IterativeSolverT(double tolerance = Eigen::NumTraits<double>::epsilon())
+    {
+        mSolver.setTolerance(tolerance);
+    }
+
+    void AnalyzePattern(const Eigen::SparseMatrix<double>& A) override
+    {
+        Timer t(__FUNCTION__, true, Log::Debug);
+        mMatrix = A;
+        mSolver.analyzePattern(mMatrix);
+    }
+
+    void Factorize(const Eigen::SparseMatrix<double>& A) override
+    {
+        Timer t(__FUNCTION__, true, Log::Debug);
+        mMatrix = A;
+        mSolver.factorize(mMatrix);
+    }
+
+    Eigen::VectorXd Solve(const Eigen::VectorXd& b) const override
+    {
+        Eigen::VectorXd x = mSolver.solve(b);
+        Log::Debug << "Iterative solver: " << mSolver.iterations() << " iterations, error " << mSolver.error()
+                   << '\n';
+        return x;
+    }
+
+    void SetNearNullspace(const Eigen::MatrixXd& nearNullspace) override
+    {
+        SetNearNullspaceOf(mSolver.preconditioner(), nearNullspace);
+    }
+
+    void SetProlongators(const std::vector<Eigen::SparseMatrix<double>>& prolongators) override
+    {
+        SetProlongatorsOf(mSolver.preconditioner(), prolongators);
+    }
+
+private:
+    TSolver mSolver;
+    Eigen::SparseMatrix<double> mMatrix;
+};
+
+template <typename TSolver>
+std::unique_ptr<SparseFactorization> Create()
+{
+    return std::make_unique<SparseFactorizationT<TSolver>>();
+}
+
+template <typename TSolver>
+std::unique_ptr<SparseFactorization> CreateIterative(double tolerance = Eigen::NumTraits<double>::epsilon())
+{
+    return std::make_unique<IterativeSolverT<TSolver>>(tolerance);
+}
+
+std::unique_ptr<SparseFactorization> CreateSparseFactorization(std::string solver)
 {
     // direct solvers
     if (solver == "EigenSparseLU")
-        return SolveWithSolver<Eigen::SparseLU<Eigen::SparseMatrix<double>>>(A, b);
+        return Create<Eigen::SparseLU<Eigen::SparseMatrix<double>>>();
     if (solver == "EigenSparseQR")
-        return SolveWithSolver<Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>>>(A, b);
+        return Create<Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>>>();
     if (solver == "EigenSimplicialLLT")
-        return SolveWithSolver<Eigen::SimplicialLLT<Eigen::SparseMatrix<double>>>(A, b);
+        return Create<Eigen::SimplicialLLT<Eigen::SparseMatrix<double>>>();
     if (solver == "EigenSimplicialLDLT")
-        return SolveWithSolver<Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>>>(A, b);
+        return Create<Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>>>();
 
     // iterative solvers
     if (solver == "EigenConjugateGradient")
-        return SolveWithSolver<Eigen::ConjugateGradient<Eigen::SparseMatrix<double>>>(A, b);
+        return CreateIterative<Eigen::ConjugateGradient<Eigen::SparseMatrix<double>>>();
     if (solver == "EigenLeastSquaresConjugateGradient")
-        return SolveWithSolver<Eigen::LeastSquaresConjugateGradient<Eigen::SparseMatrix<double>>>(A, b);
+        return CreateIterative<Eigen::LeastSquaresConjugateGradient<Eigen::SparseMatrix<double>>>();
     if (solver == "EigenBiCGSTAB")
-        return SolveWithSolver<Eigen::BiCGSTAB<Eigen::SparseMatrix<double>>>(A, b);
+        return CreateIterative<Eigen::BiCGSTAB<Eigen::SparseMatrix<double>>>();
+    if (solver == "AmgCG")
+        return CreateIterative<AmgConjugateGradient>(1.e-12);
+    if (solver == "GmgCG")
+        return CreateIterative<GmgConjugateGradient>(1.e-12);
 
 // external solvers
 #ifdef HAVE_SUITESPARSE
     if (solver == "SuiteSparseLU")
-        return SolveWithSolver<Eigen::UmfPackLU<Eigen::SparseMatrix<double>>>(A, b);
+        return Create<Eigen::UmfPackLU<Eigen::SparseMatrix<double>>>();
     if (solver == "SuiteSparseSupernodalLLT")
-        return SolveWithSolver<Eigen::CholmodSupernodalLLT<Eigen::SparseMatrix<double>>>(A, b);
+        return Create<Eigen::CholmodSupernodalLLT<Eigen::SparseMatrix<double>>>();
 #else
     if (solver == "SuiteSparseLU" or solver == "SuiteSparseSupernodalLLT")
         throw Exception("NuTo has not been compiled with SuiteSparse.");
@@ -62,9 +173,9 @@ Eigen::VectorXd EigenSparseSolve(const Eigen::SparseMatrix<double>& A, const Eig
 
 #ifdef HAVE_MUMPS
     if (solver == "MumpsLU")
-        return SolveWithSolver<Eigen::MUMPSLU<Eigen::SparseMatrix<double>>>(A, b);
+        return Create<Eigen::MUMPSLU<Eigen::SparseMatrix<double>>>();
     if (solver == "MumpsLDLT")
-        return SolveWithSolver<Eigen::MUMPSLDLT<Eigen::SparseMatrix<double>, Eigen::Upper>>(A, b);
+        return Create<Eigen::MUMPSLDLT<Eigen::SparseMatrix<double>, Eigen::Upper>>();
 #else
     if (solver == "MumpsLU" or solver == "MUMPSLDLT")
         throw Exception("NuTo has not been compiled with MUMPS.");
@@ -72,15 +183,154 @@ Eigen::VectorXd EigenSparseSolve(const Eigen::SparseMatrix<double>& A, const Eig
     throw Exception("Unknown solver. Are you sure you spelled it correctly?");
 }
 
+Eigen::VectorXd EigenSparseSolve(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& b, std::string solver)
+{
+    Timer t(__FUNCTION__, true, Log::Debug);
+    std::unique_ptr<SparseFactorization> factorization = CreateSparseFactorization(solver);
+    factorization->AnalyzePattern(A);
+    factorization->Factorize(A);
+    return factorization->Solve(b);
+}
+
+SparsePattern::SparsePattern(const Eigen::SparseMatrix<double>& A)
+    : mRows(A.rows())
+    , mCols(A.cols())
+    , mOuterIndices(A.outerIndexPtr(), A.outerIndexPtr() + A.outerSize() + 1)
+    , mInnerIndices(A.innerIndexPtr(), A.innerIndexPtr() + A.nonZeros())
+{
+    assert(A.isCompressed());
+}
+
+bool SparsePattern::Matches(const Eigen::SparseMatrix<double>& A) const
+{
+    assert(A.isCompressed());
+    if (A.rows() != mRows or A.cols() != mCols or A.nonZeros() != static_cast<Eigen::Index>(mInnerIndices.size()))
+        return false;
+    return std::equal(mOuterIndices.begin(), mOuterIndices.end(), A.outerIndexPtr()) and
+           std::equal(mInnerIndices.begin(), mInnerIndices.end(), A.innerIndexPtr());
+}
+
+std::string SymmetricSolver(std::string solver)
+{
+    if (solver != "EigenSparseLU" and solver != "EigenSparseQR" and solver != "SuiteSparseLU" and solver != "MumpsLU")
+        return solver;
+#ifdef HAVE_SUITESPARSE
+    return "SuiteSparseSupernodalLLT";
+#else
+    return "EigenSimplicialLDLT";
+#endif
+}
 
 EigenSparseSolver::EigenSparseSolver(std::string solver)
     : mSolver(solver)
 {
 }
 
+EigenSparseSolver::EigenSparseSolver(const EigenSparseSolver& other)
+    : mSolver(other.mSolver)
+    , mReuseFactorization(other.mReuseFactorization)
+    , mNearNullspace(other.mNearNullspace)
+    , mProlongators(other.mProlongators)
+{
+}
+
+EigenSparseSolver::EigenSparseSolver(EigenSparseSolver&&) = default;
+
+EigenSparseSolver::~EigenSparseSolver() = default;
+
 Eigen::VectorXd EigenSparseSolver::Solve(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& b) const
 {
-    return EigenSparseSolve(A, b, mSolver);
+    if (not(mReuseFactorization and mHasFactorization))
+        Factorize(A);
+    return SolveFactorized(b);
+}
+
+void EigenSparseSolver::Factorize(const Eigen::SparseMatrix<double>& A) const
+{
+    if (not A.isCompressed())
+    {
+        Factorize(Eigen::SparseMatrix<double>(A));
+        return;
+    }
+    if (mFactorization == nullptr or not mPattern.Matches(A))
+    {
+        mFactorization = CreateSparseFactorization(mSolver);
+        mHasFactorization = false;
+        if (mNearNullspace.size() != 0)
+            mFactorization->SetNearNullspace(mNearNullspace);
+        if (not mProlongators.empty())
+            mFactorization->SetProlongators(mProlongators);
+        mFactorization->AnalyzePattern(A);
+        mPattern = SparsePattern(A);
+        mNumAnalyses++;
+    }
+    Refactorize(A);
+}
+
+void EigenSparseSolver::Refactorize(const Eigen::SparseMatrix<double>& A) const
+{
+    if (mFactorization == nullptr)
+        throw Exception(__PRETTY_FUNCTION__, "There is no symbolic analysis to reuse. Call Factorize(A) first.");
+    mHasFactorization = false;
+    mFactorization->Factorize(A);
+    mHasFactorization = true;
+    mNumFactorizations++;
+}
+
+Eigen::VectorXd EigenSparseSolver::SolveFactorized(const Eigen::VectorXd& b) const
+{
+    if (not mHasFactorization)
+        throw Exception(__PRETTY_FUNCTION__, "There is no factorization. Call Factorize(A) first.");
+    return mFactorization->Solve(b);
+}
+
+void EigenSparseSolver::ReuseFactorization(bool reuse)
+{
+    mReuseFactorization = reuse;
+}
+
+bool EigenSparseSolver::ReusesFactorization() const
+{
+    return mReuseFactorization;
+}
+
+bool EigenSparseSolver::HasFactorization() const
+{
+    return mHasFactorization;
+}
+
+void EigenSparseSolver::Reset()
+{
+    mFactorization.reset();
+    mHasFactorization = false;
+    mPattern = SparsePattern();
+}
+
+void EigenSparseSolver::SetNearNullspace(Eigen::MatrixXd nearNullspace)
+{
+    mNearNullspace = nearNullspace;
+    Reset();
+}
+
+void EigenSparseSolver::SetProlongators(std::vector<Eigen::SparseMatrix<double>> prolongators)
+{
+    mProlongators = prolongators;
+    Reset();
+}
+
+int EigenSparseSolver::NumAnalyses() const
+{
+    return mNumAnalyses;
+}
+
+int EigenSparseSolver::NumFactorizations() const
+{
+    return mNumFactorizations;
+}
+
+const std::string& EigenSparseSolver::SolverName() const
+{
+    return mSolver;
 }
 
 } // namespace NuTo
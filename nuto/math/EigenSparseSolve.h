@@ -1,5 +1,7 @@
 #pragma once
+#include <memory>
 #include <string>
+#include <vector>
 #include "Eigen/Sparse"
 
 namespace NuTo
@@ -23,6 +25,11 @@ namespace NuTo
 //! - `EigenConjugateGradient`
 //! - `EigenLeastSquaresConjugateGradient`
 //! - `EigenBiCGSTAB`
+//! - `AmgCG`: conjugate gradient method with the AmgPreconditioner, relative tolerance 1e-12, for symmetric positive
+//! definite matrices
+//! - `GmgCG`: conjugate gradient method with the GeometricMultigrid preconditioner, relative tolerance 1e-12, for
+//! symmetric positive definite matrices. Needs the prolongators of a mesh hierarchy, see
+//! EigenSparseSolver::SetProlongators(...).
 //!
 //! ## External (need to be installed seperately)
 //! ### [SuiteSparse](http://faculty.cse.tamu.edu/davis/suitesparse.html) solvers:
@@ -34,15 +41,124 @@ namespace NuTo
 //! - `MumpsLDLT`
 Eigen::VectorXd EigenSparseSolve(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& b, std::string solver);
 
+//! @brief routes general direct solvers to a Cholesky type solver for symmetric matrices
+//! @return `SuiteSparseSupernodalLLT` if available, `EigenSimplicialLDLT` otherwise, for the LU and QR solvers.
+//! All other solvers are returned unchanged, they are either symmetric already or iterative.
+std::string SymmetricSolver(std::string solver);
+
+//! @brief copy of the dimensions and the nonzero pattern of a compressed sparse matrix, e.g. to detect changes of the
+//! pattern between two matrices
+class SparsePattern
+{
+public:
+    SparsePattern() = default;
+
+    //! @param A compressed matrix
+    explicit SparsePattern(const Eigen::SparseMatrix<double>& A);
+
+    //! @return true if the compressed matrix `A` has exactly this dimensions and nonzero pattern
+    bool Matches(const Eigen::SparseMatrix<double>& A) const;
+
+private:
+    Eigen::Index mRows = -1;
+    Eigen::Index mCols = -1;
+    std::vector<int> mOuterIndices;
+    std::vector<int> mInnerIndices;
+};
+
+//! @brief factorization of a sparse matrix by one of the solvers of EigenSparseSolve(...)
+class SparseFactorization
+{
+public:
+    virtual ~SparseFactorization() = default;
+    virtual void AnalyzePattern(const Eigen::SparseMatrix<double>& A) = 0;
+    virtual void Factorize(const Eigen::SparseMatrix<double>& A) = 0;
+    virtual Eigen::VectorXd Solve(const Eigen::VectorXd& b) const = 0;
+
+    //! @brief near nullspace for the next AnalyzePattern(...), only used by multigrid preconditioners
+    virtual void SetNearNullspace(const Eigen::MatrixXd&)
+    {
+    }
+
+    //! @brief prolongators for the next Factorize(...), only used by geometric multigrid preconditioners
+    virtual void SetProlongators(const std::vector<Eigen::SparseMatrix<double>>&)
+    {
+    }
+};
+
+//! @brief creates the solver `solver`, see EigenSparseSolve(...), without analyzing or factorizing a matrix
+std::unique_ptr<SparseFactorization> CreateSparseFactorization(std::string solver);
+
 //! Solver usable by NewtonRaphson::Solve(...)
+//! @remark The solver keeps its factorization between the calls to Solve(...). The symbolic analysis (ordering,
+//! elimination tree) is only repeated if the nonzero pattern of the matrix changes, e.g. each Newton iteration with the
+//! same dof numbering only pays for the numerical factorization. The factorization is a cache and thus mutable, copies
+//! start without a factorization.
 class EigenSparseSolver
 {
 public:
     EigenSparseSolver(std::string solver);
+    EigenSparseSolver(const EigenSparseSolver& other);
+    EigenSparseSolver(EigenSparseSolver&&);
+    ~EigenSparseSolver();
+
+    //! @brief solves A x = b
+    //! @remark factorizes A via Factorize(A) first, unless the factorization is reused, see ReuseFactorization(...)
     Eigen::VectorXd Solve(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& b) const;
 
+    //! @brief computes the numerical factorization of A and its symbolic analysis, if the nonzero pattern of A differs
+    //! from the last analyzed one
+    void Factorize(const Eigen::SparseMatrix<double>& A) const;
+
+    //! @brief computes the numerical factorization of A only, with the symbolic analysis of the last factorization
+    //! @remark Skips the comparison of the nonzero patterns. A must have the pattern of the last analyzed matrix.
+    void Refactorize(const Eigen::SparseMatrix<double>& A) const;
+
+    //! @brief solves with the current factorization
+    Eigen::VectorXd SolveFactorized(const Eigen::VectorXd& b) const;
+
+    //! @param reuse true: Solve(A, b) solves with the current factorization and ignores A, if there is one. This is
+    //! e.g. the modified Newton method.
+    void ReuseFactorization(bool reuse);
+
+    bool ReusesFactorization() const;
+
+    //! @brief true if there is a factorization to solve with
+    bool HasFactorization() const;
+
+    //! @brief discards the factorization and the symbolic analysis
+    void Reset();
+
+    //! @param nearNullspace columns of the near nullspace of the matrices, e.g. the rigid body modes, for the
+    //! multigrid preconditioner of `AmgCG`
+    //! @remark discards the factorization, the next one uses the near nullspace
+    void SetNearNullspace(Eigen::MatrixXd nearNullspace);
+
+    //! @param prolongators prolongators of a mesh hierarchy, the finest first, for the multigrid preconditioner of
+    //! `GmgCG`, see GeometricMultigrid::SetProlongators(...)
+    //! @remark discards the factorization, the next one uses the prolongators
+    void SetProlongators(std::vector<Eigen::SparseMatrix<double>> prolongators);
+
+    //! @return number of symbolic analyses, e.g. to check the reuse
+    int NumAnalyses() const;
+
+    //! @return number of numerical factorizations
+    int NumFactorizations() const;
+
+    const std::string& SolverName() const;
+
 private:
     std::string mSolver;
+    bool mReuseFactorization = false;
+    Eigen::MatrixXd mNearNullspace;
+    std::vector<Eigen::SparseMatrix<double>> mProlongators;
+
+    mutable std::unique_ptr<SparseFactorization> mFactorization;
+    //! @brief pattern of the last symbolic analysis
+    mutable SparsePattern mPattern;
+    mutable bool mHasFactorization = false;
+    mutable int mNumAnalyses = 0;
+    mutable int mNumFactorizations = 0;
 };
 
 } // namespace NuTo
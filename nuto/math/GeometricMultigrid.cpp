@@ -0,0 +1,137 @@
+#include "nuto/math/GeometricMultigrid.h"
+#include <string>
+#include "nuto/base/Exception.h"
+#include "nuto/base/Timer.h"
+#include "nuto/base/Logger.h"
+#include "nuto/math/Smoothers.h"
+
+using namespace NuTo;
+
+namespace
+{
+
+//! @return matrix that selects the nonzero columns of `P`
+Eigen::SparseMatrix<double> NonZeroColumns(const Eigen::SparseMatrix<double>& P)
+{
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int j = 0; j < P.outerSize(); ++j)
+        for (Eigen::SparseMatrix<double>::InnerIterator it(P, j); it; ++it)
+            if (it.value() != 0.)
+            {
+                triplets.emplace_back(j, triplets.size(), 1.);
+                break;
+            }
+    Eigen::SparseMatrix<double> selection(P.cols(), triplets.size());
+    selection.setFromTriplets(triplets.begin(), triplets.end());
+    return selection;
+}
+} // namespace
+
+GeometricMultigrid::GeometricMultigrid(const Eigen::SparseMatrix<double>& A)
+{
+    compute(A);
+}
+
+void GeometricMultigrid::SetOptions(Options options)
+{
+    mOptions = options;
+}
+
+void GeometricMultigrid::SetProlongators(std::vector<Eigen::SparseMatrix<double>> prolongators)
+{
+    mProlongators = prolongators;
+}
+
+void GeometricMultigrid::Setup(const Eigen::SparseMatrix<double>& A)
+{
+    Timer timer(__PRETTY_FUNCTION__, true, Log::Debug);
+    if (A.rows() != A.cols())
+        throw Exception(__PRETTY_FUNCTION__, "The matrix has to be square.");
+
+    mLevels.clear();
+    Eigen::SparseMatrix<double> current = A;
+    Eigen::SparseMatrix<double> selection;
+    for (size_t i = 0; i < mProlongators.size(); ++i)
+    {
+        // drop the rows of the coarse dofs that were dropped on the previous level
+        Eigen::SparseMatrix<double> P = i == 0 ? mProlongators[i] : selection.transpose() * mProlongators[i];
+        if (P.rows() != current.rows())
+            throw Exception(__PRETTY_FUNCTION__, "The prolongator of level " + std::to_string(i) + " has " +
+                                                         std::to_string(P.rows()) + " rows, the matrix has " +
+                                                         std::to_string(current.rows()) + ".");
+        selection = NonZeroColumns(P);
+        P = P * selection;
+        if (P.cols() == 0)
+            break;
+
+        Level level;
+        level.P = P;
+        level.R = P.transpose();
+        Eigen::SparseMatrix<double> coarse = level.R * (current * level.P);
+        level.A = std::move(current);
+        mLevels.push_back(std::move(level));
+        current = std::move(coarse);
+    }
+    Level coarsest;
+    coarsest.A = std::move(current);
+    mLevels.push_back(std::move(coarsest));
+
+    for (size_t i = 0; i + 1 < mLevels.size(); ++i)
+    {
+        Level& level = mLevels[i];
+        level.inverseDiagonal = InverseDiagonal(level.A);
+        level.lambdaMax = EstimateMaxEigenvalue(level.A, level.inverseDiagonal);
+    }
+    mCoarseSolver.compute(mLevels.back().A);
+    mInfo = mCoarseSolver.info();
+    Log::Debug << "Geometric multigrid with " << NumLevels() << " levels, coarse size " << Size(NumLevels() - 1)
+               << '\n';
+}
+
+void GeometricMultigrid::Smooth(const Level& level, const Eigen::VectorXd& b, Eigen::VectorXd* x) const
+{
+    if (mOptions.smoother == eSmoother::CHEBYSHEV)
+        ChebyshevSmooth(level.A, level.inverseDiagonal, level.lambdaMax, mOptions.smoothingRange,
+                        mOptions.numSmoothingSteps, b, x);
+    else
+        JacobiSmooth(level.A, mOptions.jacobiDamping / level.lambdaMax * level.inverseDiagonal,
+                     mOptions.numSmoothingSteps, b, x);
+}
+
+void GeometricMultigrid::VCycle(int iLevel, const Eigen::VectorXd& b, Eigen::VectorXd* x) const
+{
+    if (iLevel == NumLevels() - 1)
+    {
+        *x = mCoarseSolver.solve(b);
+        return;
+    }
+
+    const Level& level = mLevels[iLevel];
+    x->resize(0);
+    Smooth(level, b, x);
+
+    Eigen::VectorXd coarseX;
+    VCycle(iLevel + 1, level.R * (b - level.A * *x), &coarseX);
+    *x += level.P * coarseX;
+
+    Smooth(level, b, x);
+}
+
+Eigen::VectorXd GeometricMultigrid::solve(const Eigen::VectorXd& b) const
+{
+    if (mLevels.empty())
+        throw Exception(__PRETTY_FUNCTION__, "The preconditioner is not set up. Call compute(A) first.");
+    Eigen::VectorXd x;
+    VCycle(0, b, &x);
+    return x;
+}
+
+int GeometricMultigrid::NumLevels() const
+{
+    return mLevels.size();
+}
+
+int GeometricMultigrid::Size(int level) const
+{
+    return mLevels.at(level).A.rows();
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <vector>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <Eigen/IterativeLinearSolvers>
+
+namespace NuTo
+{
+
+enum class eSmoother
+{
+    JACOBI,
+    CHEBYSHEV
+};
+
+//! @brief multigrid preconditioner for symmetric positive definite matrices with given prolongators, one V-cycle per
+//! solve(...)
+//!
+//! The prolongators come from a hierarchy of meshes, e.g. StructuredMeshHierarchy::Prolongators(), and interpolate
+//! the coarse solution on the finer mesh. The coarse matrices are the Galerkin products P^T A P. Unlike a
+//! rediscretization on the coarse meshes, this needs no coarse integrands and no history data, e.g. of damage laws,
+//! and the coarse problems inherit the constraints of the fine one. Coarse dofs without any fine dof, e.g. at a
+//! boundary with Dirichlet constraints, are dropped. The coarsest level is factorized directly.
+//!
+//! The Jacobi and Chebyshev smoothers only need products with the matrices and their diagonals, see Smoothers.h.
+//! Without prolongators, solve(...) is a direct solve.
+//!
+//! Usable as the preconditioner of the Eigen iterative solvers, see GmgConjugateGradient, and of
+//! NuTo::ConjugateGradient.
+class GeometricMultigrid
+{
+public:
+    struct Options
+    {
+        eSmoother smoother = eSmoother::CHEBYSHEV;
+
+        //! @brief degree of the Chebyshev polynomial or number of Jacobi steps, for the pre- and post-smoothing
+        int numSmoothingSteps = 2;
+
+        //! @brief the Chebyshev smoother damps the eigenvalues of D^-1 A in [lambdaMax / smoothingRange, lambdaMax],
+        //! the coarser levels resolve the smaller ones. 4 suits the coarsening by 2 in each direction.
+        double smoothingRange = 4.;
+
+        //! @brief damping of the Jacobi smoother, divided by the largest eigenvalue of D^-1 A
+        double jacobiDamping = 4. / 3.;
+    };
+
+    GeometricMultigrid() = default;
+
+    //! @brief ctor for NuTo::ConjugateGradient, without prolongators
+    explicit GeometricMultigrid(const Eigen::SparseMatrix<double>& A);
+
+    void SetOptions(Options options);
+
+    //! @param prolongators prolongator of each level from the next coarser one, the finest first. The rows of the
+    //! first one have to match the matrix, the rows of each other one the columns of its predecessor.
+    void SetProlongators(std::vector<Eigen::SparseMatrix<double>> prolongators);
+
+    template <typename TMatrix>
+    GeometricMultigrid& analyzePattern(const TMatrix&)
+    {
+        return *this;
+    }
+
+    //! @brief computes the coarse matrices, the smoothers and the factorization of the coarsest matrix
+    template <typename TMatrix>
+    GeometricMultigrid& factorize(const TMatrix& A)
+    {
+        Setup(Eigen::SparseMatrix<double>(A));
+        return *this;
+    }
+
+    template <typename TMatrix>
+    GeometricMultigrid& compute(const TMatrix& A)
+    {
+        Setup(Eigen::SparseMatrix<double>(A));
+        return *this;
+    }
+
+    //! @return one V-cycle applied to `b`, starting from zero
+    Eigen::VectorXd solve(const Eigen::VectorXd& b) const;
+
+    Eigen::ComputationInfo info() const
+    {
+        return mInfo;
+    }
+
+    int NumLevels() const;
+
+    //! @return number of rows of the matrix on `level`, 0 is the finest
+    int Size(int level) const;
+
+private:
+    struct Level
+    {
+        Eigen::SparseMatrix<double> A;
+        //! @brief prolongator from the next coarser level, without the dropped coarse dofs
+        Eigen::SparseMatrix<double> P;
+        //! @brief restriction P^T
+        Eigen::SparseMatrix<double> R;
+        Eigen::VectorXd inverseDiagonal;
+        double lambdaMax = 1.;
+    };
+
+    void Setup(const Eigen::SparseMatrix<double>& A);
+    void Smooth(const Level& level, const Eigen::VectorXd& b, Eigen::VectorXd* x) const;
+    void VCycle(int level, const Eigen::VectorXd& b, Eigen::VectorXd* x) const;
+
+    Options mOptions;
+    std::vector<Eigen::SparseMatrix<double>> mProlongators;
+    std::vector<Level> mLevels;
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> mCoarseSolver;
+    Eigen::ComputationInfo mInfo = Eigen::Success;
+};
+
+//! @brief conjugate gradient method with the GeometricMultigrid preconditioner, multithreaded via Lower|Upper
+using GmgConjugateGradient =
+        Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower | Eigen::Upper, GeometricMultigrid>;
+
+} // namespace NuTo
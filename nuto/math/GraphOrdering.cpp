@@ -0,0 +1,222 @@
+#include "nuto/math/GraphOrdering.h"
+#include <algorithm>
+#include <numeric>
+#include "nuto/base/Exception.h"
+
+using namespace NuTo;
+
+namespace
+{
+
+//! @brief breadth first searches and orderings restricted to the vertices with the same label
+class GraphOrdering
+{
+public:
+    GraphOrdering(const AdjacencyList& adjacency)
+        : mAdjacency(adjacency)
+        , mLabel(adjacency.size(), 0)
+        , mStamp(adjacency.size(), 0)
+        , mLevel(adjacency.size(), 0)
+        , mNumbered(adjacency.size(), false)
+    {
+        for (const auto& neighbors : adjacency)
+            for (int neighbor : neighbors)
+                if (neighbor < 0 or neighbor >= static_cast<int>(adjacency.size()))
+                    throw Exception(__PRETTY_FUNCTION__, "Vertex index " + std::to_string(neighbor) +
+                                                                 " out of range.");
+    }
+
+    //! @brief appends the reverse Cuthill-McKee order of `vertices` to mOrder
+    void AppendReverseCuthillMcKee(const std::vector<int>& vertices)
+    {
+        NewLabel(vertices);
+        const size_t begin = mOrder.size();
+        for (int vertex : vertices)
+        {
+            if (mNumbered[vertex])
+                continue;
+            for (const auto& level : PseudoPeripheralLevels(vertex))
+                for (int v : level)
+                {
+                    mOrder.push_back(v);
+                    mNumbered[v] = true;
+                }
+        }
+        std::reverse(mOrder.begin() + begin, mOrder.end());
+    }
+
+    //! @brief appends the nested dissection order of `vertices` to mOrder
+    void AppendNestedDissection(const std::vector<int>& vertices, size_t leafSize)
+    {
+        if (vertices.size() <= leafSize)
+        {
+            AppendReverseCuthillMcKee(vertices);
+            return;
+        }
+
+        const int label = NewLabel(vertices);
+        const auto levels = PseudoPeripheralLevels(vertices.front());
+
+        std::vector<int> reached;
+        for (const auto& level : levels)
+            reached.insert(reached.end(), level.begin(), level.end());
+        if (reached.size() < vertices.size())
+        {
+            // disconnected, the components are independent without a separator
+            std::vector<int> rest;
+            for (int vertex : vertices)
+                if (mStamp[vertex] != mCurrentStamp)
+                    rest.push_back(vertex);
+            AppendNestedDissection(reached, leafSize);
+            AppendNestedDissection(rest, leafSize);
+            return;
+        }
+
+        if (levels.size() < 3)
+        {
+            AppendReverseCuthillMcKee(vertices);
+            return;
+        }
+
+        // the middle level splits the vertices in halves
+        int middle = 0;
+        for (size_t count = levels[0].size(); 2 * count < vertices.size(); count += levels[middle].size())
+            ++middle;
+        middle = std::max(1, std::min(middle, static_cast<int>(levels.size()) - 2));
+
+        std::vector<int> partA, partB, separator;
+        for (int iLevel = 0; iLevel < static_cast<int>(levels.size()); ++iLevel)
+        {
+            auto& part = iLevel < middle ? partA : partB;
+            if (iLevel != middle)
+                part.insert(part.end(), levels[iLevel].begin(), levels[iLevel].end());
+        }
+        // vertices of the middle level without neighbors in the next level do not separate anything
+        for (int vertex : levels[middle])
+        {
+            const auto& neighbors = mAdjacency[vertex];
+            const bool separates = std::any_of(neighbors.begin(), neighbors.end(), [&](int neighbor) {
+                return mLabel[neighbor] == label and mLevel[neighbor] == middle + 1;
+            });
+            (separates ? separator : partA).push_back(vertex);
+        }
+
+        AppendNestedDissection(partA, leafSize);
+        AppendNestedDissection(partB, leafSize);
+        for (int vertex : separator)
+        {
+            mOrder.push_back(vertex);
+            mNumbered[vertex] = true;
+        }
+    }
+
+    std::vector<int> mOrder;
+
+private:
+    //! @brief assigns a new label to `vertices`, the searches do not leave these vertices
+    int NewLabel(const std::vector<int>& vertices)
+    {
+        ++mNumLabels;
+        for (int vertex : vertices)
+            mLabel[vertex] = mNumLabels;
+        return mNumLabels;
+    }
+
+    //! @brief breadth first search from `root`, the neighbors are visited in order of increasing degree
+    //! @return level structure, levels[i] contains the vertices with distance i to `root`
+    std::vector<std::vector<int>> Levels(int root)
+    {
+        ++mCurrentStamp;
+        const int label = mLabel[root];
+        std::vector<std::vector<int>> levels = {{root}};
+        mStamp[root] = mCurrentStamp;
+        mLevel[root] = 0;
+        std::vector<int> neighbors;
+        while (true)
+        {
+            std::vector<int> next;
+            for (int vertex : levels.back())
+            {
+                neighbors.clear();
+                for (int neighbor : mAdjacency[vertex])
+                    if (mLabel[neighbor] == label and mStamp[neighbor] != mCurrentStamp)
+                    {
+                        mStamp[neighbor] = mCurrentStamp;
+                        mLevel[neighbor] = levels.size();
+                        neighbors.push_back(neighbor);
+                    }
+                std::sort(neighbors.begin(), neighbors.end(), [&](int a, int b) { return Degree(a) < Degree(b); });
+                next.insert(next.end(), neighbors.begin(), neighbors.end());
+            }
+            if (next.empty())
+                return levels;
+            levels.push_back(std::move(next));
+        }
+    }
+
+    //! @return level structure of a pseudo-peripheral vertex in the component of `start`
+    std::vector<std::vector<int>> PseudoPeripheralLevels(int start)
+    {
+        auto levels = Levels(start);
+        while (true)
+        {
+            const auto& last = levels.back();
+            const int candidate =
+                    *std::min_element(last.begin(), last.end(), [&](int a, int b) { return Degree(a) < Degree(b); });
+            auto candidateLevels = Levels(candidate);
+            if (candidateLevels.size() <= levels.size())
+                return Levels(levels.front().front()); // restore mStamp and mLevel
+            levels = std::move(candidateLevels);
+        }
+    }
+
+    int Degree(int vertex) const
+    {
+        return mAdjacency[vertex].size();
+    }
+
+    const AdjacencyList& mAdjacency;
+    std::vector<int> mLabel;
+    int mNumLabels = 0;
+    std::vector<int> mStamp;
+    int mCurrentStamp = 0;
+    std::vector<int> mLevel;
+    std::vector<bool> mNumbered;
+};
+
+std::vector<int> AllVertices(const AdjacencyList& adjacency)
+{
+    std::vector<int> vertices(adjacency.size());
+    std::iota(vertices.begin(), vertices.end(), 0);
+    return vertices;
+}
+} // namespace
+
+std::vector<int> NuTo::ReverseCuthillMcKee(const AdjacencyList& adjacency)
+{
+    GraphOrdering ordering(adjacency);
+    ordering.AppendReverseCuthillMcKee(AllVertices(adjacency));
+    return ordering.mOrder;
+}
+
+std::vector<int> NuTo::NestedDissection(const AdjacencyList& adjacency, int leafSize)
+{
+    GraphOrdering ordering(adjacency);
+    ordering.AppendNestedDissection(AllVertices(adjacency), std::max(leafSize, 1));
+    return ordering.mOrder;
+}
+
+int NuTo::Bandwidth(const AdjacencyList& adjacency, const std::vector<int>& order)
+{
+    if (order.size() != adjacency.size())
+        throw Exception(__PRETTY_FUNCTION__, "The permutation does not match the number of vertices.");
+    std::vector<int> position(order.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        position[order[i]] = i;
+
+    int bandwidth = 0;
+    for (size_t vertex = 0; vertex < adjacency.size(); ++vertex)
+        for (int neighbor : adjacency[vertex])
+            bandwidth = std::max(bandwidth, std::abs(position[vertex] - position[neighbor]));
+    return bandwidth;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+
+namespace NuTo
+{
+//! @brief undirected graph, adjacency[i] contains the neighbors of the vertex i
+using AdjacencyList = std::vector<std::vector<int>>;
+
+//! @brief reverse Cuthill-McKee ordering, reduces the bandwidth and the profile of the matrices with the sparsity
+//! pattern of `adjacency`
+//! @remark Each connected component starts at a pseudo-peripheral vertex, see A. George, J. W. H. Liu, "An
+//! implementation of a pseudoperipheral node finder", ACM TOMS 5 (1979)
+//! @return permutation `order`, the new i-th vertex is the old order[i]-th vertex
+std::vector<int> ReverseCuthillMcKee(const AdjacencyList& adjacency);
+
+//! @brief nested dissection ordering, reduces the fill-in of direct factorizations
+//!
+//! The graph is recursively split by the middle level of a breadth first search from a pseudo-peripheral vertex. The
+//! separators are numbered after the two parts they separate.
+//! @param leafSize parts with at most `leafSize` vertices are not split any further and ordered via
+//! ReverseCuthillMcKee
+//! @return permutation `order`, the new i-th vertex is the old order[i]-th vertex
+std::vector<int> NestedDissection(const AdjacencyList& adjacency, int leafSize = 64);
+
+//! @return maximal distance |i - j| of the new numbers i and j of two adjacent vertices
+//! @param order permutation, the new i-th vertex is the old order[i]-th vertex
+int Bandwidth(const AdjacencyList& adjacency, const std::vector<int>& order);
+} /* NuTo */
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Eigen/Core>
+
+namespace NuTo
+{
+
+/// \brief Jacobi (diagonal) preconditioner for NuTo::Gmres and NuTo::ConjugateGradient
+/// \remark In contrast to Eigen::DiagonalPreconditioner, this only requires `A.diagonal()` and thus also works for
+/// matrix-free operators like NuTo::MatrixFreeHessian0. Zero diagonal entries are treated as ones.
+class JacobiPreconditioner
+{
+public:
+    template <typename T>
+    JacobiPreconditioner(const T& A)
+        : mInverseDiagonal(A.diagonal())
+    {
+        for (int i = 0; i < mInverseDiagonal.rows(); ++i)
+            mInverseDiagonal[i] = mInverseDiagonal[i] == 0. ? 1. : 1. / mInverseDiagonal[i];
+    }
+
+    Eigen::VectorXd solve(const Eigen::VectorXd& x) const
+    {
+        return mInverseDiagonal.cwiseProduct(x);
+    }
+
+private:
+    Eigen::VectorXd mInverseDiagonal;
+};
+
+} // namespace NuTo
@@ -32,7 +32,7 @@ public:
     //! benchmarking. Dunno why, but the a previous version that avoids the return arguments and returns various values
     //! in a std::tuple was significantly slower (10%) in a benchmark for a scalar function
     //! @param problem class that implements NormFunction, ResidualFunction and mTolerance
-    //! @param r residual, return argument, see remark
+    //! @param r residual at `x`, return argument, see remark
     //! @param x value of the argument x, return argument, see remark
     //! @param dx dx from the solver
     template <typename TProblem, typename TX>
@@ -41,7 +41,7 @@ public:
         double alpha = 1.;
         int lineSearchStep = 0;
         const auto x0 = *x;
-        const auto previousNorm = problem.Norm(problem.Residual(*x));
+        const auto previousNorm = problem.Norm(*r);
         while (lineSearchStep < mMaxNumLineSearchStep)
         {
             *x = x0 - alpha * dx;
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <type_traits>
+#include <utility>
 #include <Eigen/Sparse>
 #include "nuto/base/Exception.h"
 #include "nuto/math/LineSearch.h"
+#include "nuto/math/TangentUpdate.h"
 
 namespace NuTo
 {
@@ -52,16 +55,107 @@ auto DefineProblem(TR residual, TDR derivative, TNorm norm, TTol tolerance, TInf
     return Problem<TR, TDR, TNorm, TTol, TInfo>({residual, derivative, norm, tolerance, info});
 }
 
-//! @brief solves the Problem using the newton raphson iteration with linesearch
-//! @param problem type of the nonlinear problem
-//! @param x0 of the initial value for the iteration
-//! @param solver solver that provides a TX = solver.Solve(TNonlinearProblem::DR, TNonlinearProblem::R)
-//! @param maxIterations default = 20
-//! @param lineSearch line search algorithm, default = NoLineSearch, alternatively use NuTo::LineSearch()
-//! @param numIterations optionally returns the number of iterations required
-template <typename TNonlinearProblem, typename TX, typename TSolver, typename TLineSearchAlgorithm = NoLineSearch>
-auto Solve(TNonlinearProblem&& problem, TX&& x0, TSolver&& solver, int maxIterations = 20,
-           TLineSearchAlgorithm&& lineSearch = NoLineSearch(), int* numIterations = nullptr)
+//! @brief detects if TProblem provides `ResidualAndDerivative(x)` that returns the pair (Residual(x), Derivative(x))
+template <typename TProblem, typename TX, typename = void>
+struct HasResidualAndDerivative : std::false_type
+{
+};
+
+template <typename TProblem, typename TX>
+struct HasResidualAndDerivative<TProblem, TX, decltype(void(std::declval<TProblem&>().ResidualAndDerivative(
+                                                      std::declval<const TX&>())))> : std::true_type
+{
+};
+
+//! @brief keeps the derivative of a fused evaluation until it is used, see FusedProblem
+template <typename TDerivative>
+struct FusedDerivative
+{
+    void Set(TDerivative derivative)
+    {
+        mDerivative = std::move(derivative);
+    }
+
+    TDerivative Get()
+    {
+        return std::move(mDerivative);
+    }
+
+    TDerivative mDerivative{};
+};
+
+//! @brief keeps a reference to a derivative that is stored by the problem, e.g.
+//! TimeDependentProblem::GradientAndHessian0(...), instead of copying it
+template <typename TDerivative>
+struct FusedDerivative<TDerivative&>
+{
+    void Set(TDerivative& derivative)
+    {
+        mDerivative = &derivative;
+    }
+
+    TDerivative& Get()
+    {
+        return *mDerivative;
+    }
+
+    TDerivative* mDerivative = nullptr;
+};
+
+//! @brief wraps a problem with a fused `ResidualAndDerivative(x)`. Each residual evaluation calculates the derivative
+//! as well and keeps it for the following `Derivative(x)` call.
+//! @remark The derivatives of rejected line search steps and of the converged state are calculated in vain. This pays
+//! off if the fused evaluation is significantly cheaper than the separate ones, e.g. if both evaluate the same
+//! constitutive law.
+template <typename TProblem, typename TX>
+class FusedProblem
+{
+public:
+    FusedProblem(TProblem& problem)
+        : mProblem(problem)
+        , mTolerance(problem.mTolerance)
+    {
+    }
+
+    auto Residual(const TX& x)
+    {
+        auto residualAndDerivative = mProblem.ResidualAndDerivative(x);
+        mDerivative.Set(std::move(residualAndDerivative.second));
+        return std::move(residualAndDerivative.first);
+    }
+
+    //! @return derivative of the last Residual(x) call, `x` is expected to be the same
+    decltype(auto) Derivative(const TX&)
+    {
+        return mDerivative.Get();
+    }
+
+    template <typename TR>
+    auto Norm(TR&& r) const
+    {
+        return mProblem.Norm(std::forward<TR>(r));
+    }
+
+    template <typename... TArgs>
+    void Info(TArgs&&... args) const
+    {
+        mProblem.Info(std::forward<TArgs>(args)...);
+    }
+
+private:
+    TProblem& mProblem;
+    FusedDerivative<decltype(std::declval<TProblem&>().ResidualAndDerivative(std::declval<const TX&>()).second)>
+            mDerivative;
+
+public:
+    //! tolerance of the wrapped problem, public member because it is part of NuTo::NewtonRaphson::Problem
+    decltype(std::declval<TProblem&>().mTolerance) mTolerance;
+};
+
+//! @brief newton raphson iteration with separate evaluations of the residual and its derivative
+template <typename TNonlinearProblem, typename TX, typename TSolver, typename TLineSearchAlgorithm>
+auto Solve(std::false_type, TNonlinearProblem&& problem, TX&& x0, TSolver&& solver, int maxIterations,
+           TLineSearchAlgorithm&& lineSearch, int* numIterations, const TangentUpdate& tangentUpdate)
 {
     auto x = x0;
     auto r = problem.Residual(x);
@@ -72,13 +166,20 @@ auto Solve(TNonlinearProblem&& problem, TX&& x0, TSolver&& solver, int maxIterat
     if (problem.Norm(r) < problem.mTolerance)
         return x;
 
+    using X = decltype(x);
+    TangentSolver<std::remove_reference_t<TSolver>, X, std::decay_t<decltype(problem.Derivative(x))>> tangent(
+            solver, tangentUpdate);
+    double norm = problem.Norm(r);
+    double previousNorm = norm;
+
     while (iteration < maxIterations)
     {
-        auto dr = problem.Derivative(x);
-        auto dx = solver.Solve(dr, r);
+        X dx = tangent.NewDerivative(iteration, norm, previousNorm) ? tangent.Solve(problem.Derivative(x), r)
+                                                                    : tangent.Solve(r);
 
         ++iteration;
 
+        tangent.BeginIteration(x, r);
         if (lineSearch(problem, &r, &x, dx))
         {
             if (numIterations)
@@ -87,10 +188,48 @@ auto Solve(TNonlinearProblem&& problem, TX&& x0, TSolver&& solver, int maxIterat
             return x;
         }
         problem.Info(iteration, x, r);
+
+        tangent.Update(x, r);
+        if (not tangentUpdate.IsFullNewton())
+        {
+            previousNorm = norm;
+            norm = problem.Norm(r);
+        }
     }
     if (numIterations)
         *numIterations = iteration;
     throw NoConvergence(__PRETTY_FUNCTION__, "No convergence after " + std::to_string(iteration) + " iterations.");
 }
+
+//! @brief newton raphson iteration with the fused evaluation of the residual and its derivative, see FusedProblem
+template <typename TNonlinearProblem, typename TX, typename TSolver, typename TLineSearchAlgorithm>
+auto Solve(std::true_type, TNonlinearProblem&& problem, TX&& x0, TSolver&& solver, int maxIterations,
+           TLineSearchAlgorithm&& lineSearch, int* numIterations, const TangentUpdate& tangentUpdate)
+{
+    FusedProblem<std::remove_reference_t<TNonlinearProblem>, std::decay_t<TX>> fusedProblem(problem);
+    return Solve(std::false_type(), fusedProblem, std::forward<TX>(x0), std::forward<TSolver>(solver), maxIterations,
+                 std::forward<TLineSearchAlgorithm>(lineSearch), numIterations, tangentUpdate);
+}
+
+//! @brief solves the Problem using the newton raphson iteration with linesearch
+//! @param problem type of the nonlinear problem
+//! @param x0 of the initial value for the iteration
+//! @param solver solver that provides a TX = solver.Solve(TNonlinearProblem::DR, TNonlinearProblem::R)
+//! @param maxIterations default = 20
+//! @param lineSearch line search algorithm, default = NoLineSearch, alternatively use NuTo::LineSearch()
+//! @param numIterations optionally returns the number of iterations required
+//! @param tangentUpdate when to evaluate a new derivative, default: every iteration, see TangentUpdate
+//! @remark If the problem provides `ResidualAndDerivative(x)`, it is used instead of separate Residual(x) and
+//! Derivative(x) calls, see FusedProblem. Its derivative is then assembled with each residual, the `tangentUpdate` only
+//! saves the factorizations.
+template <typename TNonlinearProblem, typename TX, typename TSolver, typename TLineSearchAlgorithm = NoLineSearch>
+auto Solve(TNonlinearProblem&& problem, TX&& x0, TSolver&& solver, int maxIterations = 20,
+           TLineSearchAlgorithm&& lineSearch = NoLineSearch(), int* numIterations = nullptr,
+           const TangentUpdate& tangentUpdate = FullNewton())
+{
+    return Solve(HasResidualAndDerivative<std::decay_t<TNonlinearProblem>, std::decay_t<TX>>(),
+                 std::forward<TNonlinearProblem>(problem), std::forward<TX>(x0), std::forward<TSolver>(solver),
+                 maxIterations, std::forward<TLineSearchAlgorithm>(lineSearch), numIterations, tangentUpdate);
+}
 } /* NewtonRaphson */
 } /* NuTo */
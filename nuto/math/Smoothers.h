@@ -0,0 +1,135 @@
+#pragma once
+
+#include <random>
+#include <Eigen/Core>
+
+namespace NuTo
+{
+
+//! @brief smoothers for the multigrid methods that only need the products `A * x`, `A.rows()` and `A.diagonal()` of
+//! the operator. They thus work for Eigen matrices as well as for matrix-free operators like
+//! NuTo::MatrixFreeHessian0.
+
+//! @return 1 / a_ii, zero diagonal entries are treated as ones
+template <typename TOperator>
+Eigen::VectorXd InverseDiagonal(const TOperator& A)
+{
+    Eigen::VectorXd inverseDiagonal = A.diagonal();
+    for (int i = 0; i < inverseDiagonal.rows(); ++i)
+        inverseDiagonal[i] = inverseDiagonal[i] == 0. ? 1. : 1. / inverseDiagonal[i];
+    return inverseDiagonal;
+}
+
+//! @brief estimates the largest eigenvalue of D^-1 A by power iterations
+//! @remark The estimate converges from below, the smoothers thus add a safety margin. The start vector is perturbed by
+//! a local engine with a fixed seed instead of Eigen's Random() (std::rand), the estimate is thus reproducible and
+//! thread safe.
+template <typename TOperator>
+double EstimateMaxEigenvalue(const TOperator& A, const Eigen::VectorXd& inverseDiagonal, int numIterations = 10)
+{
+    std::minstd_rand engine(42);
+    std::uniform_real_distribution<double> perturbation(-0.5, 0.5);
+    Eigen::VectorXd v(A.rows());
+    for (int i = 0; i < v.rows(); ++i)
+        v[i] = 1. + perturbation(engine);
+    double lambda = 1.;
+    for (int i = 0; i < numIterations; ++i)
+    {
+        v /= v.norm();
+        Eigen::VectorXd w = inverseDiagonal.cwiseProduct(A * v);
+        lambda = w.norm();
+        if (lambda == 0.)
+            return 1.;
+        v = w;
+    }
+    return lambda;
+}
+
+//! @brief damped Jacobi iterations x += omega D^-1 (b - A x)
+//! @param dampedInverseDiagonal omega D^-1, stable for omega < 2 / lambdaMax(D^-1 A)
+//! @param x initial guess on input, empty for zero, smoothed solution on output
+template <typename TOperator>
+void JacobiSmooth(const TOperator& A, const Eigen::VectorXd& dampedInverseDiagonal, int numSteps,
+                  const Eigen::VectorXd& b, Eigen::VectorXd* x)
+{
+    int step = 0;
+    if (x->rows() == 0)
+    {
+        *x = dampedInverseDiagonal.cwiseProduct(b);
+        ++step;
+    }
+    for (; step < numSteps; ++step)
+        *x += dampedInverseDiagonal.cwiseProduct(b - A * *x);
+}
+
+//! @brief Chebyshev iteration of D^-1 A with `degree` products of A, damps the eigenvalues of D^-1 A in
+//! [lambdaMax / smoothingRange, lambdaMax]
+//! @remark Adams, Brezina, Hu, Tuminaro: Parallel multigrid smoothing: polynomial versus Gauss-Seidel, Journal of
+//! Computational Physics 188 (2003). The Chebyshev recursion of Saad, Iterative Methods for Sparse Linear Systems,
+//! Algorithm 12.1. Unlike Gauss-Seidel, it is symmetric and only needs operator products, and the polynomial is
+//! positive on the spectrum. Thus, it is a valid preconditioner for the conjugate gradient method.
+//! @param lambdaMax estimate of the largest eigenvalue of D^-1 A, enlarged by 10 percent
+//! @param x initial guess on input, empty for zero, smoothed solution on output
+template <typename TOperator>
+void ChebyshevSmooth(const TOperator& A, const Eigen::VectorXd& inverseDiagonal, double lambdaMax,
+                     double smoothingRange, int degree, const Eigen::VectorXd& b, Eigen::VectorXd* x)
+{
+    const double upper = 1.1 * lambdaMax;
+    const double lower = upper / smoothingRange;
+    const double theta = 0.5 * (upper + lower);
+    const double delta = 0.5 * (upper - lower);
+    const double sigma = theta / delta;
+    double rho = 1. / sigma;
+
+    Eigen::VectorXd r = b;
+    if (x->rows() == 0)
+        *x = Eigen::VectorXd::Zero(b.rows());
+    else
+        r -= A * *x;
+
+    Eigen::VectorXd d = inverseDiagonal.cwiseProduct(r) / theta;
+    for (int k = 0; k < degree; ++k)
+    {
+        *x += d;
+        if (k + 1 == degree)
+            break;
+        r -= A * d;
+        const double rhoNew = 1. / (2. * sigma - rho);
+        d = rhoNew * rho * d + 2. * rhoNew / delta * inverseDiagonal.cwiseProduct(r);
+        rho = rhoNew;
+    }
+}
+
+//! @brief Chebyshev polynomial preconditioner for NuTo::ConjugateGradient and NuTo::Gmres, see ChebyshevSmooth(...)
+//! @remark Like the NuTo::JacobiPreconditioner, it only needs `A.diagonal()` and the products with A and is thus
+//! suitable for matrix-free operators. Each solve(...) costs `degree` products.
+template <typename TOperator>
+class ChebyshevPreconditioner
+{
+public:
+    //! @param A operator that outlives the preconditioner
+    ChebyshevPreconditioner(const TOperator& A, int degree = 3, double smoothingRange = 30.)
+        : mA(A)
+        , mInverseDiagonal(InverseDiagonal(A))
+        , mLambdaMax(EstimateMaxEigenvalue(A, mInverseDiagonal))
+        , mDegree(degree)
+        , mSmoothingRange(smoothingRange)
+    {
+    }
+
+    Eigen::VectorXd solve(const Eigen::VectorXd& b) const
+    {
+        Eigen::VectorXd x;
+        ChebyshevSmooth(mA, mInverseDiagonal, mLambdaMax, mSmoothingRange, mDegree, b, &x);
+        return x;
+    }
+
+private:
+    const TOperator& mA;
+    Eigen::VectorXd mInverseDiagonal;
+    double mLambdaMax;
+    int mDegree;
+    double mSmoothingRange;
+};
+
+} // namespace NuTo
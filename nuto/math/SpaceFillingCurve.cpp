@@ -0,0 +1,110 @@
+#include "nuto/math/SpaceFillingCurve.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include "nuto/base/Exception.h"
+
+using namespace NuTo;
+
+namespace
+{
+
+//! @brief transforms the coordinates of a point of the Hilbert curve such that interleaving their bits gives the
+//! Hilbert key
+//! @remark J. Skilling, "Programming the Hilbert curve", AIP Conference Proceedings 707, 381 (2004)
+void HilbertTranspose(uint32_t* x, int bits, int dim)
+{
+    const uint32_t m = 1u << (bits - 1);
+
+    // inverse undo excess work
+    for (uint32_t q = m; q > 1; q >>= 1)
+    {
+        const uint32_t p = q - 1;
+        for (int i = 0; i < dim; ++i)
+        {
+            if (x[i] & q)
+                x[0] ^= p; // invert
+            else
+            {
+                const uint32_t t = (x[0] ^ x[i]) & p; // exchange
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+
+    // gray encode
+    for (int i = 1; i < dim; ++i)
+        x[i] ^= x[i - 1];
+    uint32_t t = 0;
+    for (uint32_t q = m; q > 1; q >>= 1)
+        if (x[dim - 1] & q)
+            t ^= q - 1;
+    for (int i = 0; i < dim; ++i)
+        x[i] ^= t;
+}
+} // namespace
+
+uint64_t NuTo::SpaceFillingCurveKey(Eigen::VectorXi coordinates, int bits, eSpaceFillingCurve curve)
+{
+    const int dim = coordinates.rows();
+    if (dim < 1 or dim > 3)
+        throw Exception(__PRETTY_FUNCTION__, "Only 1D, 2D and 3D points are supported.");
+    if (bits < 1 or bits > 31 or bits * dim > 64)
+        throw Exception(__PRETTY_FUNCTION__, std::to_string(bits) + " bits per coordinate are not supported in " +
+                                                     std::to_string(dim) + "D.");
+
+    uint32_t x[3];
+    for (int i = 0; i < dim; ++i)
+        x[i] = static_cast<uint32_t>(coordinates[i]);
+
+    if (curve == eSpaceFillingCurve::HILBERT)
+    {
+        // HilbertTranspose treats x[0] as the most significant axis, the interleaving below the last one
+        std::reverse(x, x + dim);
+        HilbertTranspose(x, bits, dim);
+        std::reverse(x, x + dim);
+    }
+
+    // interleave the bits, most significant first
+    uint64_t key = 0;
+    for (int bit = bits - 1; bit >= 0; --bit)
+        for (int i = dim - 1; i >= 0; --i)
+            key = (key << 1) | ((x[i] >> bit) & 1u);
+    return key;
+}
+
+std::vector<int> NuTo::SpaceFillingCurveOrder(const std::vector<Eigen::VectorXd>& points, eSpaceFillingCurve curve)
+{
+    std::vector<int> order(points.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (points.empty())
+        return order;
+
+    const int dim = points.front().rows();
+    // 30 bits fit into the int coordinates, 21 bits into 3 * 21 = 63 bits of the key
+    const int bits = dim == 3 ? 21 : 30;
+    const double maxCoordinate = std::ldexp(1., bits) - 1.;
+
+    Eigen::VectorXd min = points.front();
+    Eigen::VectorXd max = points.front();
+    for (const auto& point : points)
+    {
+        if (point.rows() != dim)
+            throw Exception(__PRETTY_FUNCTION__, "All points need the same dimension.");
+        min = min.cwiseMin(point);
+        max = max.cwiseMax(point);
+    }
+    const Eigen::VectorXd extent = (max - min).cwiseMax(std::numeric_limits<double>::min());
+
+    std::vector<uint64_t> keys(points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const Eigen::VectorXd scaled = (points[i] - min).cwiseQuotient(extent) * maxCoordinate;
+        keys[i] = SpaceFillingCurveKey(scaled.array().round().cast<int>(), bits, curve);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return keys[a] < keys[b]; });
+    return order;
+}
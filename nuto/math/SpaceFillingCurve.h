@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <Eigen/Core>
+
+namespace NuTo
+{
+enum class eSpaceFillingCurve
+{
+    //! z-order, interleaves the bits of the coordinates, see MortonOrder
+    MORTON,
+    //! Hilbert curve, consecutive cells of the underlying grid are always neighbors
+    HILBERT
+};
+
+//! @brief key of an integer point along a space filling curve through the grid [0, 2^bits)^dim
+//! @param coordinates integer coordinates of the point, each in [0, 2^bits)
+//! @param bits number of bits per coordinate, at most 31 and bits * dim must not exceed 64
+uint64_t SpaceFillingCurveKey(Eigen::VectorXi coordinates, int bits, eSpaceFillingCurve curve);
+
+//! @brief sorts `points` along a space filling curve through their bounding box
+//! @param points points of the same dimension (1, 2 or 3), e.g. element centroids
+//! @return permutation `order`, such that points[order[0]], points[order[1]], ... follow the curve. Points with the
+//! same key keep their relative order.
+std::vector<int> SpaceFillingCurveOrder(const std::vector<Eigen::VectorXd>& points,
+                                        eSpaceFillingCurve curve = eSpaceFillingCurve::HILBERT);
+} /* NuTo */
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <Eigen/Core>
+
+namespace NuTo
+{
+namespace NewtonRaphson
+{
+
+//! @brief update of the inverse derivative in the iterations without a new derivative
+enum class eQuasiNewton
+{
+    NONE, //!< solves with the last derivative, modified newton method
+    BROYDEN, //!< "good" Broyden update, for general derivatives
+    BFGS //!< BFGS update, for symmetric derivatives
+};
+
+//! @brief decides when NewtonRaphson::Solve(...) evaluates and factorizes a new derivative
+//! @remark In the iterations without a new derivative, the solver reuses the factorization of the last derivative,
+//! optionally improved by a quasi-newton update. This requires a solver that provides `SolveFactorized(r)` and
+//! `HasFactorization()`, like EigenSparseSolver. Other solvers solve with the last derivative again.
+struct TangentUpdate
+{
+    //! @brief new derivative in every `interval`-th iteration, 1 is the full newton method, 0 only evaluates it once
+    int interval = 1;
+
+    //! @brief new derivative if the norm of the residual decreased by less than this factor in the last iteration
+    double stagnation = std::numeric_limits<double>::infinity();
+
+    //! @brief true: the first iteration solves with the existing factorization of the solver, if there is one, e.g.
+    //! the one of the trial state of a time step. Combined with `interval` = 0, the derivative is then only
+    //! evaluated upon stagnation.
+    bool reuseInitial = false;
+
+    eQuasiNewton quasiNewton = eQuasiNewton::NONE;
+
+    //! @brief new derivative after this number of quasi-newton updates
+    int maxNumUpdates = 20;
+
+    bool IsFullNewton() const
+    {
+        return interval == 1;
+    }
+};
+
+//! @brief evaluates and factorizes the derivative in each iteration
+inline TangentUpdate FullNewton()
+{
+    return TangentUpdate();
+}
+
+//! @brief modified newton method that keeps the factorized derivative
+//! @param interval new derivative in every `interval`-th iteration, 0 only evaluates it once
+//! @param stagnation new derivative if the norm of the residual decreased by less than this factor
+//! @param reuseInitial true: starts with the existing factorization of the solver, see TangentUpdate::reuseInitial
+inline TangentUpdate ModifiedNewton(int interval = 0, double stagnation = 0.5, bool reuseInitial = false)
+{
+    TangentUpdate update;
+    update.interval = interval;
+    update.stagnation = stagnation;
+    update.reuseInitial = reuseInitial;
+    return update;
+}
+
+//! @brief modified newton method with quasi-newton updates on top of the factorized derivative
+//! @param quasiNewton update type, eQuasiNewton::BFGS requires a symmetric derivative
+//! @param interval new derivative in every `interval`-th iteration, 0 only evaluates it once
+//! @param stagnation new derivative if the norm of the residual decreased by less than this factor
+//! @param reuseInitial true: starts with the existing factorization of the solver, see TangentUpdate::reuseInitial
+inline TangentUpdate QuasiNewton(eQuasiNewton quasiNewton, int interval = 0, double stagnation = 0.9,
+                                 bool reuseInitial = false)
+{
+    TangentUpdate update = ModifiedNewton(interval, stagnation, reuseInitial);
+    update.quasiNewton = quasiNewton;
+    return update;
+}
+
+//! @brief scalar products for the quasi-newton updates, vector types like DofVector provide theirs via ADL
+inline double Dot(double a, double b)
+{
+    return a * b;
+}
+
+//! @remark not conjugated, the scalar Broyden update is then the complex secant method
+template <typename T>
+std::complex<T> Dot(const std::complex<T>& a, const std::complex<T>& b)
+{
+    return a * b;
+}
+
+template <typename TDerived>
+auto Dot(const Eigen::MatrixBase<TDerived>& a, const Eigen::MatrixBase<TDerived>& b)
+{
+    return a.dot(b);
+}
+
+//! @brief detects if TSolver provides `SolveFactorized(r)` that solves with its existing factorization
+template <typename TSolver, typename TX, typename = void>
+struct HasSolveFactorized : std::false_type
+{
+};
+
+template <typename TSolver, typename TX>
+struct HasSolveFactorized<TSolver, TX, decltype(void(std::declval<TSolver&>().SolveFactorized(
+                                               std::declval<const TX&>())))> : std::true_type
+{
+};
+
+//! @brief solves for the newton increments according to a TangentUpdate
+//! @tparam TSolver solver, see NewtonRaphson::Solve(...)
+//! @tparam TX type of the residual and the increments
+//! @tparam TDerivative type of the derivative
+template <typename TSolver, typename TX, typename TDerivative>
+class TangentSolver
+{
+public:
+    TangentSolver(TSolver& solver, const TangentUpdate& update)
+        : mSolver(solver)
+        , mUpdate(update)
+    {
+    }
+
+    //! @param iteration number of finished iterations
+    //! @param norm norm of the current residual
+    //! @param previousNorm norm of the residual before the last iteration
+    //! @return true if the next increment requires a new derivative, see Solve(derivative, r)
+    bool NewDerivative(int iteration, double norm, double previousNorm) const
+    {
+        if (iteration == 0)
+            return not(mUpdate.reuseInitial and HasFactorization(HasSolveFactorized<TSolver, TX>()));
+        if (mUpdate.interval > 0 and iteration % mUpdate.interval == 0)
+            return true;
+        if (norm > mUpdate.stagnation * previousNorm)
+            return true;
+        return IsQuasiNewton() and static_cast<int>(mS.size()) >= mUpdate.maxNumUpdates;
+    }
+
+    //! @brief solves with the new `derivative` and discards the quasi-newton updates
+    //! @remark The derivative is only copied if it is needed again, i.e. for solvers without `SolveFactorized(r)` and
+    //! tangent updates other than the full newton method.
+    template <typename TNewDerivative>
+    TX Solve(TNewDerivative&& derivative, const TX& r)
+    {
+        mS.clear();
+        mV.clear();
+        mRho.clear();
+        return SolveDerivative(HasSolveFactorized<TSolver, TX>(), std::forward<TNewDerivative>(derivative), r);
+    }
+
+    //! @brief solves with the last derivative and the quasi-newton updates
+    TX Solve(const TX& r) const
+    {
+        switch (mUpdate.quasiNewton)
+        {
+        case eQuasiNewton::BROYDEN:
+            return SolveBroyden(r);
+        case eQuasiNewton::BFGS:
+            return SolveBFGS(r);
+        default:
+            return SolveFactorized(HasSolveFactorized<TSolver, TX>(), r);
+        }
+    }
+
+    bool IsQuasiNewton() const
+    {
+        return mUpdate.quasiNewton != eQuasiNewton::NONE;
+    }
+
+    //! @brief keeps the state before an iteration for the quasi-newton update, see Update(x, r)
+    //! @param x state before the iteration
+    //! @param r residual of `x`
+    void BeginIteration(const TX& x, const TX& r)
+    {
+        if (not IsQuasiNewton())
+            return;
+        mXOld = x;
+        mROld = r;
+    }
+
+    //! @brief quasi-newton update with the increments of x and r since BeginIteration(...)
+    //! @param x state after the iteration
+    //! @param r residual of `x`
+    void Update(const TX& x, const TX& r)
+    {
+        if (not IsQuasiNewton())
+            return;
+        AddUpdate(x - mXOld, r - mROld);
+    }
+
+private:
+    using Scalar = decltype(Dot(std::declval<const TX&>(), std::declval<const TX&>()));
+
+    //! @brief adds a quasi-newton update
+    //! @param s increment of x, x_new - x_old
+    //! @param y increment of the residual, r_new - r_old
+    void AddUpdate(const TX& s, const TX& y)
+    {
+        if (mUpdate.quasiNewton == eQuasiNewton::BROYDEN)
+        {
+            // H_new = H + (s - H y) s^T H / (s^T H y), stored as H_new q = H q + v (s^T H q)
+            TX z = SolveBroyden(y);
+            const auto sz = Dot(s, z);
+            if (IsDegenerate(sz, s, z))
+                return;
+            mS.push_back(s);
+            mV.push_back((1. / sz) * (s - z));
+        }
+        if (mUpdate.quasiNewton == eQuasiNewton::BFGS)
+        {
+            const auto ys = Dot(y, s);
+            if (IsDegenerate(ys, s, y))
+                return;
+            mS.push_back(s);
+            mV.push_back(y);
+            mRho.push_back(1. / ys);
+        }
+    }
+
+    bool HasFactorization(std::true_type) const
+    {
+        return mSolver.HasFactorization();
+    }
+
+    bool HasFactorization(std::false_type) const
+    {
+        return false;
+    }
+
+    template <typename TNewDerivative>
+    TX SolveDerivative(std::true_type, TNewDerivative&& derivative, const TX& r)
+    {
+        return mSolver.Solve(derivative, r);
+    }
+
+    template <typename TNewDerivative>
+    TX SolveDerivative(std::false_type, TNewDerivative&& derivative, const TX& r)
+    {
+        // the full newton method evaluates a new derivative in each iteration and never solves with the last one
+        if (mUpdate.IsFullNewton())
+            return mSolver.Solve(derivative, r);
+        mDerivative = std::forward<TNewDerivative>(derivative);
+        return mSolver.Solve(mDerivative, r);
+    }
+
+    TX SolveFactorized(std::true_type, const TX& r) const
+    {
+        return mSolver.SolveFactorized(r);
+    }
+
+    TX SolveFactorized(std::false_type, const TX& r) const
+    {
+        return mSolver.Solve(mDerivative, r);
+    }
+
+    TX SolveBroyden(const TX& r) const
+    {
+        TX z = SolveFactorized(HasSolveFactorized<TSolver, TX>(), r);
+        for (size_t i = 0; i < mS.size(); ++i)
+            z += Dot(mS[i], z) * mV[i];
+        return z;
+    }
+
+    //! @brief two loop recursion with mV = y
+    TX SolveBFGS(const TX& r) const
+    {
+        TX q = r;
+        std::vector<Scalar> alpha(mS.size());
+        for (int i = static_cast<int>(mS.size()) - 1; i >= 0; --i)
+        {
+            alpha[i] = mRho[i] * Dot(mS[i], q);
+            q -= alpha[i] * mV[i];
+        }
+        TX z = SolveFactorized(HasSolveFactorized<TSolver, TX>(), q);
+        for (size_t i = 0; i < mS.size(); ++i)
+            z += (alpha[i] - mRho[i] * Dot(mV[i], z)) * mS[i];
+        return z;
+    }
+
+    //! @return true if `denominator` = a^T b is too small for an update
+    static bool IsDegenerate(Scalar denominator, const TX& a, const TX& b)
+    {
+        using std::abs;
+        using std::sqrt;
+        return abs(denominator) <= 1.e-12 * sqrt(abs(Dot(a, a)) * abs(Dot(b, b)));
+    }
+
+    TSolver& mSolver;
+    TangentUpdate mUpdate;
+
+    //! @brief last derivative, only kept for solvers without SolveFactorized(r)
+    TDerivative mDerivative{};
+
+    //! @brief state and residual of BeginIteration(...), only kept for quasi-newton updates
+    TX mXOld{};
+    TX mROld{};
+
+    std::vector<TX> mS;
+    std::vector<TX> mV;
+    std::vector<Scalar> mRho;
+};
+
+} /* NewtonRaphson */
+} /* NuTo */
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <sstream>
 
 #include "nuto/mechanics/cell/CellInterface.h"
@@ -8,6 +9,10 @@
 #include "nuto/mechanics/integrationtypes/IntegrationTypeBase.h"
 #include "nuto/mechanics/cell/CellData.h"
 #include "nuto/mechanics/cell/CellIpData.h"
+#include "nuto/mechanics/cell/CellGeometry.h"
+#include "nuto/mechanics/cell/ShapeFunctionTable.h"
+#include "nuto/mechanics/cell/CellWorkspace.h"
+#include "nuto/mechanics/cell/DofValueSource.h"
 
 namespace NuTo
 {
@@ -44,17 +49,20 @@ public:
         return IntegrateGeneric(f, double{0});
     }
 
+    std::pair<DofVector<double>, DofMatrix<double>> Integrate(VectorMatrixFunction f) override
+    {
+        std::pair<DofVector<double>, DofMatrix<double>> result;
+        ForEachIntegrationPoint([&](const CellIpData& cellIpData, double detJw) {
+            auto ipResult = f(cellIpData);
+            result.first.AddScaled(ipResult.first, detJw);
+            result.second.AddScaled(ipResult.second, detJw);
+        });
+        return result;
+    }
+
     void Apply(VoidFunction f) override
     {
-        CellData cellData(mElements, Id());
-        for (int iIP = 0; iIP < mIntegrationType.GetNumIntegrationPoints(); ++iIP)
-        {
-            auto ipCoords = mIntegrationType.GetLocalIntegrationPointCoordinates(iIP);
-            Jacobian jacobian(mElements.CoordinateElement().ExtractNodeValues(),
-                              mElements.CoordinateElement().GetDerivativeShapeFunctions(ipCoords));
-            CellIpData cellipData(cellData, jacobian, ipCoords, iIP);
-            f(cellipData);
-        }
+        ForEachIntegrationPoint([&](const CellIpData& cellIpData, double) { f(cellIpData); });
     }
 
     Eigen::VectorXi DofNumbering(DofType dof) override
@@ -62,6 +70,11 @@ public:
         return mElements.DofElement(dof).GetDofNumbering();
     }
 
+    bool Has(DofType dof) const override
+    {
+        return mElements.Has(dof);
+    }
+
     int Id() const
     {
         return mId;
@@ -79,16 +92,8 @@ public:
 
     std::vector<Eigen::VectorXd> Eval(EvalFunction f) const override
     {
-        CellData cellData(mElements, Id());
         std::vector<Eigen::VectorXd> result;
-        for (int iIP = 0; iIP < mIntegrationType.GetNumIntegrationPoints(); ++iIP)
-        {
-            auto ipCoords = mIntegrationType.GetLocalIntegrationPointCoordinates(iIP);
-            Jacobian jacobian(mElements.CoordinateElement().ExtractNodeValues(),
-                              mElements.CoordinateElement().GetDerivativeShapeFunctions(ipCoords));
-            CellIpData cellipData(cellData, jacobian, ipCoords, iIP);
-            result.push_back(f(cellipData));
-        }
+        ForEachIntegrationPoint([&](const CellIpData& cellIpData, double) { result.push_back(f(cellIpData)); });
         return result;
     }
 
@@ -97,7 +102,136 @@ public:
         return mShape;
     }
 
+    //! @brief enables the caching of the reference geometry (inverse jacobians, detJ * w, dN/dx) of all integration
+    //! points
+    //! @param rBudget memory budget, possibly shared with other cells. The cache is only kept if it fits.
+    //! @param dofTypes dof types whose global shape function derivatives dN/dx are cached
+    //! @remark The cache is filled on the first evaluation. It is only valid as long as the nodal coordinates do not
+    //! change.
+    void EnableGeometryCache(GeometryCacheBudget* rBudget, std::vector<DofType> dofTypes)
+    {
+        DisableGeometryCache();
+        mGeometryBudget = rBudget;
+        mGeometryDofs = dofTypes;
+    }
+
+    //! @brief disables the geometry cache and returns its memory to the budget
+    void DisableGeometryCache()
+    {
+        if (mGeometry)
+            mGeometryBudget->Release(mGeometryBytes);
+        mGeometry.reset();
+        mGeometryBytes = 0;
+        mGeometryBudget = nullptr;
+    }
+
+    //! @brief returns true if the reference geometry is currently cached
+    bool HasGeometryCache() const
+    {
+        return mGeometry != nullptr;
+    }
+
+    //! @brief evaluates the shape functions and their derivatives via precomputed tables instead of the virtual
+    //! interpolation calls in each integration point
+    //! @param rRegistry tables shared with other cells, nullptr disables the tables
+    void EnableShapeFunctionTables(ShapeFunctionTables* rRegistry)
+    {
+        mShapeFunctionTables.reset();
+        if (rRegistry)
+            mShapeFunctionTables = std::make_unique<CellShapeFunctionTables>(*rRegistry, mElements, mIntegrationType);
+    }
+
+    //! @brief reads the node values of the dof types bound to `source` directly from the bound dof values instead of
+    //! the nodes, see DofValueSource
+    //! @param source dof value source, possibly shared with other cells, nullptr reads all node values from the nodes.
+    //! The cell keeps the source alive.
+    void SetDofValueSource(std::shared_ptr<const DofValueSource> source)
+    {
+        mDofValues.reset();
+        if (source)
+            mDofValues = std::make_unique<CellDofValues>(std::move(source), mElements);
+    }
+
+protected:
+    //! @return dof values of the cell, nullptr if there is no dof value source
+    const CellDofValues* DofValues() const
+    {
+        return mDofValues.get();
+    }
+
+    //! @brief returns the cached geometry and fills it on the first call
+    //! @return nullptr if the cache is disabled or does not fit into the budget
+    const CellGeometry* Geometry() const
+    {
+        if (mGeometry or mGeometryBudget == nullptr)
+            return mGeometry.get();
+
+        // reserve the memory before anything is allocated
+        const size_t bytes = GeometryBytes();
+        if (not mGeometryBudget->Reserve(bytes))
+        {
+            mGeometryBudget = nullptr; // budget exhausted, do not try again
+            return nullptr;
+        }
+        mGeometry = std::make_unique<CellGeometry>(CalculateGeometry());
+        mGeometryBytes = bytes;
+        return mGeometry.get();
+    }
+
 private:
+    //! @return memory usage of the geometry cache, see CellGeometry::Bytes(...)
+    size_t GeometryBytes() const
+    {
+        std::vector<int> numDofNodes;
+        for (DofType dof : mGeometryDofs)
+            if (mElements.Has(dof))
+                numDofNodes.push_back(mElements.DofElement(dof).GetNumNodes());
+        return CellGeometry::Bytes(mIntegrationType.GetNumIntegrationPoints(),
+                                   mIntegrationType.GetLocalIntegrationPointCoordinates(0).rows(),
+                                   mElements.CoordinateElement().GetDofDimension(), numDofNodes);
+    }
+
+    CellGeometry CalculateGeometry() const
+    {
+        const int numIps = mIntegrationType.GetNumIntegrationPoints();
+        const Eigen::VectorXd coordinates = mElements.CoordinateElement().ExtractNodeValues();
+
+        CellGeometry geometry;
+        geometry.detJw.resize(numIps);
+        for (int iIP = 0; iIP < numIps; ++iIP)
+        {
+            const Jacobian jacobian = IpJacobian(coordinates, iIP);
+            const int cols = jacobian.Inv().cols();
+            if (iIP == 0)
+                geometry.inverseJacobians.resize(jacobian.Inv().rows(), cols * numIps);
+            geometry.inverseJacobians.middleCols(iIP * cols, cols) = jacobian.Inv();
+            geometry.detJw[iIP] = jacobian.Det() * mIntegrationType.GetIntegrationPointWeight(iIP);
+        }
+
+        for (DofType dof : mGeometryDofs)
+        {
+            if (not mElements.Has(dof))
+                continue;
+            const ElementInterface& dofElement = mElements.DofElement(dof);
+            const ShapeFunctionTable* table = mShapeFunctionTables ? mShapeFunctionTables->Dof(dof) : nullptr;
+            Eigen::MatrixXd& dNdX = geometry.derivativeShapeFunctionsGlobal[dof];
+            const int cols = geometry.GlobalDimension();
+            dNdX.resize(dofElement.GetNumNodes(), cols * numIps);
+            for (int iIP = 0; iIP < numIps; ++iIP)
+            {
+                if (table)
+                    dNdX.middleCols(iIP * cols, cols).noalias() =
+                            table->DerivativeShapeFunctions(iIP) * geometry.InverseJacobian(iIP);
+                else
+                    dNdX.middleCols(iIP * cols, cols).noalias() =
+                            dofElement.GetDerivativeShapeFunctions(
+                                    mIntegrationType.GetLocalIntegrationPointCoordinates(iIP)) *
+                            geometry.InverseJacobian(iIP);
+            }
+        }
+        return geometry;
+    }
+
     //! @brief integrates various operations with various return types
     //! @param f operation to perform
     //! @param result result value. It is not clear how to properly initialize an arbitrary TResult to zero. Thus, the
@@ -105,17 +239,72 @@ private:
     template <typename TOperation, typename TReturn>
     TReturn IntegrateGeneric(TOperation&& f, TReturn result)
     {
-        CellData cellData(mElements, Id());
+        ForEachIntegrationPoint(
+                [&](const CellIpData& cellIpData, double detJw) { AddScaled(&result, f(cellIpData), detJw); });
+        return result;
+    }
+
+    //! @brief result += value * scalar without a temporary for the scaled value
+    template <typename TReturn>
+    static void AddScaled(TReturn* result, const TReturn& value, double scalar)
+    {
+        result->AddScaled(value, scalar);
+    }
+
+    static void AddScaled(double* result, double value, double scalar)
+    {
+        *result += value * scalar;
+    }
+
+    //! @brief jacobian of the integration point `iIP`
+    //! @param coordinates node values of the coordinate element
+    Jacobian IpJacobian(const Eigen::VectorXd& coordinates, int iIP) const
+    {
+        const ShapeFunctionTable* table = mShapeFunctionTables ? mShapeFunctionTables->Coordinates() : nullptr;
+        if (table)
+            return Jacobian(coordinates, table->DerivativeShapeFunctions(iIP));
+        return Jacobian(coordinates, mElements.CoordinateElement().GetDerivativeShapeFunctions(
+                                             mIntegrationType.GetLocalIntegrationPointCoordinates(iIP)));
+    }
+
+    //! @brief natural coordinates of the integration point `iIP`
+    NaturalCoords IpCoordinates(int iIP) const
+    {
+        const ShapeFunctionTable* table = mShapeFunctionTables ? mShapeFunctionTables->Coordinates() : nullptr;
+        if (table)
+            return table->IntegrationPointCoordinates(iIP);
+        return mIntegrationType.GetLocalIntegrationPointCoordinates(iIP);
+    }
+
+    //! @brief calls f(cellIpData, detJ * w) for each integration point
+    //! @remark The memoized quantities of CellData and CellIpData are stored in a thread local workspace that is reused
+    //! for all integration points of all cells. Together with the shape function tables, this avoids heap allocations
+    //! in the loop over the integration points.
+    template <typename TFunction>
+    void ForEachIntegrationPoint(TFunction&& f) const
+    {
+        ScopedCellWorkspace workspace;
+        CellData cellData(mElements, Id(), mShapeFunctionTables.get(), &workspace.Get().nodeValues, DofValues());
+        IpWorkspace& ipWorkspace = workspace.Get().ip;
+        const CellGeometry* geometry = Geometry();
+        Eigen::VectorXd coordinates;
+        if (not geometry)
+            coordinates = mElements.CoordinateElement().ExtractNodeValues();
         for (int iIP = 0; iIP < mIntegrationType.GetNumIntegrationPoints(); ++iIP)
         {
-            auto ipCoords = mIntegrationType.GetLocalIntegrationPointCoordinates(iIP);
+            ipWorkspace.Invalidate();
+            NaturalCoords ipCoords = IpCoordinates(iIP);
+            if (geometry)
+            {
+                CellIpData cellipData(cellData, *geometry, ipCoords, iIP, &ipWorkspace);
+                f(cellipData, geometry->detJw[iIP]);
+                continue;
+            }
             auto ipWeight = mIntegrationType.GetIntegrationPointWeight(iIP);
-            Jacobian jacobian(mElements.CoordinateElement().ExtractNodeValues(),
-                              mElements.CoordinateElement().GetDerivativeShapeFunctions(ipCoords));
-            CellIpData cellipData(cellData, jacobian, ipCoords, iIP);
-            result += f(cellipData) * jacobian.Det() * ipWeight;
+            const Jacobian jacobian = IpJacobian(coordinates, iIP);
+            CellIpData cellipData(cellData, jacobian, ipCoords, iIP, &ipWorkspace);
+            f(cellipData, jacobian.Det() * ipWeight);
         }
-        return result;
     }
 
 private:
@@ -123,5 +312,13 @@ private:
     const IntegrationTypeBase& mIntegrationType;
     const int mId;
     const Shape& mShape;
+
+    mutable GeometryCacheBudget* mGeometryBudget = nullptr;
+    std::vector<DofType> mGeometryDofs;
+    mutable std::unique_ptr<CellGeometry> mGeometry;
+    mutable size_t mGeometryBytes = 0;
+
+    std::unique_ptr<CellShapeFunctionTables> mShapeFunctionTables;
+    std::unique_ptr<CellDofValues> mDofValues;
 };
 } /* NuTo */
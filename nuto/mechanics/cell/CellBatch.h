@@ -0,0 +1,421 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <Eigen/StdVector>
+#include <Eigen/SparseCore>
+#include "nuto/base/Exception.h"
+#include "nuto/base/Group.h"
+#include "nuto/mechanics/cell/CellBatchInterface.h"
+#include "nuto/mechanics/cell/CellIds.h"
+#include "nuto/mechanics/cell/DifferentialOperators.h"
+#include "nuto/mechanics/constitutive/MechanicsInterface.h"
+#include "nuto/mechanics/dofs/DofMatrixSparse.h"
+#include "nuto/mechanics/dofs/DofVector.h"
+#include "nuto/mechanics/elements/ElementCollection.h"
+#include "nuto/mechanics/integrationtypes/IntegrationTypeBase.h"
+
+namespace NuTo
+{
+//! @brief Integrates the momentum balance of up to TPack isoparametric cells simultaneously
+//! @tparam TDim global dimension, equal to the dimension of the elements
+//! @tparam TNumNodes number of nodes of the coordinate element and of the displacement element
+//! @tparam TNumIps number of integration points
+//! @tparam TPack number of cells per pack, 4 or 8 match the AVX/AVX-512 registers
+//! @remark All cells share the same interpolation and integration type. Their node coordinates and displacements are
+//! stored as structure of arrays: each scalar quantity (a coordinate component, an entry of the jacobian, of dN/dx, of
+//! the strain, ...) is a fixed size Eigen array with one entry per cell of a pack. The jacobians, B u and B^T sigma are
+//! thus evaluated for the whole pack with SIMD instructions. Only the constitutive law is called cell by cell, through
+//! its virtual interface. The last pack is padded with copies of its first cell that are neither evaluated by the law
+//! nor scattered.
+template <int TDim, int TNumNodes, int TNumIps, int TPack = 4>
+class CellBatch : public CellBatchInterface
+{
+public:
+    using Lanes = Eigen::Array<double, TPack, 1>;
+    using LocalVector = Eigen::Matrix<double, TDim * TNumNodes, 1>;
+    using LocalMatrix = Eigen::Matrix<double, TDim * TNumNodes, TDim * TNumNodes>;
+
+    //! ctor
+    //! @param elements group of isoparametric elements with TNumNodes nodes and a `dofType` element each
+    //! @param integrationType integration type with TNumIps integration points
+    //! @param dofType displacement dof type with TDim components
+    //! @param law constitutive law, called with the same CellIds as the cells created by
+    //! CellStorage::AddCells(elements, integrationType, cellStartId)
+    //! @param cellStartId start id of the continous cell numbering
+    //! @remark The node coordinates are gathered once in the ctor, the displacements on each evaluation.
+    CellBatch(Group<ElementCollectionFem> elements, const IntegrationTypeBase& integrationType, DofType dofType,
+              const Laws::MechanicsInterface<TDim>& law, int cellStartId = 0)
+        : mDofType(dofType)
+        , mLaw(law)
+    {
+        if (integrationType.GetNumIntegrationPoints() != TNumIps)
+            throw Exception(__PRETTY_FUNCTION__, "The integration type has " +
+                                                         std::to_string(integrationType.GetNumIntegrationPoints()) +
+                                                         " integration points, expected " + std::to_string(TNumIps) +
+                                                         ".");
+        if (dofType.GetNum() != TDim)
+            throw Exception(__PRETTY_FUNCTION__, "The dof type " + dofType.GetName() + " must have " +
+                                                         std::to_string(TDim) + " components.");
+
+        for (int iIP = 0; iIP < TNumIps; ++iIP)
+            mWeights[iIP] = integrationType.GetIntegrationPointWeight(iIP);
+
+        const InterpolationSimple* interpolation = nullptr;
+        int cellId = cellStartId;
+        for (auto& element : elements)
+        {
+            const ElementFem& coordinateElement = element.CoordinateElement();
+            const ElementFem& dofElement = element.DofElement(dofType);
+            if (interpolation == nullptr)
+            {
+                interpolation = &coordinateElement.Interpolation();
+                for (int iIP = 0; iIP < TNumIps; ++iIP)
+                    mDerivativeShapeFunctionsNatural[iIP] = interpolation->GetDerivativeShapeFunctions(
+                            integrationType.GetLocalIntegrationPointCoordinates(iIP));
+            }
+            if (&coordinateElement.Interpolation() != interpolation or &dofElement.Interpolation() != interpolation)
+                throw Exception(__PRETTY_FUNCTION__, "All elements of a batch must share the same interpolation.");
+            if (coordinateElement.GetNumNodes() != TNumNodes or coordinateElement.GetDofDimension() != TDim)
+                throw Exception(__PRETTY_FUNCTION__, "The coordinate element does not match the template arguments.");
+
+            if (mPacks.empty() or mPacks.back().numCells == TPack)
+                mPacks.emplace_back();
+            Pack& pack = mPacks.back();
+            const int lane = pack.numCells++;
+            pack.elements[lane] = &element;
+            pack.cellIds[lane] = cellId++;
+            for (int iNode = 0; iNode < TNumNodes; ++iNode)
+                for (int iDim = 0; iDim < TDim; ++iDim)
+                    pack.coordinates[iNode * TDim + iDim][lane] = coordinateElement.GetNode(iNode).GetValues()[iDim];
+        }
+
+        if (not mPacks.empty())
+        {
+            Pack& pack = mPacks.back();
+            for (int lane = pack.numCells; lane < TPack; ++lane)
+            {
+                pack.elements[lane] = pack.elements[0];
+                pack.cellIds[lane] = pack.cellIds[0];
+                for (Lanes& coordinate : pack.coordinates)
+                    coordinate[lane] = coordinate[0];
+            }
+        }
+    }
+
+    //! @return number of cells in the batch
+    int NumCells() const
+    {
+        return mPacks.empty() ? 0 : (mPacks.size() - 1) * TPack + mPacks.back().numCells;
+    }
+
+    //! @brief calculates the local gradients B^T sigma of all cells
+    //! @param f callable `void(const ElementCollectionFem&, const LocalVector&)`, called once per cell
+    template <typename TFunction>
+    void Gradient(double deltaT, TFunction&& f) const
+    {
+        for (const Pack& pack : mPacks)
+        {
+            const Displacements u = GatherDisplacements(pack);
+            std::array<Lanes, TDim * TNumNodes> gradient;
+            for (Lanes& entry : gradient)
+                entry.setZero();
+
+            for (int iIP = 0; iIP < TNumIps; ++iIP)
+            {
+                DerivativeShapeFunctions dNdX;
+                const Lanes detJw = DerivativeShapeFunctionsGlobal(pack, iIP, &dNdX) * mWeights[iIP];
+
+                const VoigtLanes strain = Strain(dNdX, u);
+                VoigtLanes stress;
+                for (int lane = 0; lane < TPack; ++lane)
+                {
+                    if (lane >= pack.numCells)
+                    {
+                        for (Lanes& entry : stress)
+                            entry[lane] = 0;
+                        continue;
+                    }
+                    EngineeringStrain<TDim> strainLane;
+                    for (int i = 0; i < Voigt::Dim(TDim); ++i)
+                        strainLane[i] = strain[i][lane];
+                    const EngineeringStress<TDim> stressLane =
+                            mLaw.Stress(strainLane, deltaT, CellIds{pack.cellIds[lane], iIP});
+                    for (int i = 0; i < Voigt::Dim(TDim); ++i)
+                        stress[i][lane] = stressLane[i];
+                }
+                for (Lanes& entry : stress)
+                    entry *= detJw;
+
+                for (int iNode = 0; iNode < TNumNodes; ++iNode)
+                    for (const auto& entry : Nabla::StrainPattern<TDim>::Entries())
+                        gradient[iNode * TDim + entry[1]] += dNdX[iNode * TDim + entry[2]] * stress[entry[0]];
+            }
+
+            for (int lane = 0; lane < pack.numCells; ++lane)
+            {
+                LocalVector local;
+                for (int i = 0; i < TDim * TNumNodes; ++i)
+                    local[i] = gradient[i][lane];
+                f(*pack.elements[lane], local);
+            }
+        }
+    }
+
+    //! @brief calculates the local hessians B^T C B of all cells
+    //! @param f callable `void(const ElementCollectionFem&, const LocalMatrix&)`, called once per cell
+    template <typename TFunction>
+    void Hessian0(double deltaT, TFunction&& f) const
+    {
+        constexpr int numDofs = TDim * TNumNodes;
+        constexpr int voigtDim = Voigt::Dim(TDim);
+        for (const Pack& pack : mPacks)
+        {
+            const Displacements u = GatherDisplacements(pack);
+            std::vector<Lanes, Eigen::aligned_allocator<Lanes>> hessian(numDofs * numDofs, Lanes::Zero());
+            std::array<Lanes, voigtDim * numDofs> CB;
+
+            for (int iIP = 0; iIP < TNumIps; ++iIP)
+            {
+                DerivativeShapeFunctions dNdX;
+                const Lanes detJw = DerivativeShapeFunctionsGlobal(pack, iIP, &dNdX) * mWeights[iIP];
+
+                const VoigtLanes strain = Strain(dNdX, u);
+                std::array<Lanes, voigtDim * voigtDim> tangent;
+                for (int lane = 0; lane < TPack; ++lane)
+                {
+                    if (lane >= pack.numCells)
+                    {
+                        for (Lanes& entry : tangent)
+                            entry[lane] = 0;
+                        continue;
+                    }
+                    EngineeringStrain<TDim> strainLane;
+                    for (int i = 0; i < voigtDim; ++i)
+                        strainLane[i] = strain[i][lane];
+                    const EngineeringTangent<TDim> tangentLane =
+                            mLaw.Tangent(strainLane, deltaT, CellIds{pack.cellIds[lane], iIP});
+                    for (int i = 0; i < voigtDim; ++i)
+                        for (int j = 0; j < voigtDim; ++j)
+                            tangent[i * voigtDim + j][lane] = tangentLane(i, j);
+                }
+                for (Lanes& entry : tangent)
+                    entry *= detJw;
+
+                // CB = C * B, using the sparsity of B
+                for (Lanes& entry : CB)
+                    entry.setZero();
+                for (int iNode = 0; iNode < TNumNodes; ++iNode)
+                    for (const auto& entry : Nabla::StrainPattern<TDim>::Entries())
+                    {
+                        const int column = iNode * TDim + entry[1];
+                        const Lanes& dN = dNdX[iNode * TDim + entry[2]];
+                        for (int i = 0; i < voigtDim; ++i)
+                            CB[i * numDofs + column] += tangent[i * voigtDim + entry[0]] * dN;
+                    }
+
+                // hessian += B^T * CB
+                for (int iNode = 0; iNode < TNumNodes; ++iNode)
+                    for (const auto& entry : Nabla::StrainPattern<TDim>::Entries())
+                    {
+                        const int row = iNode * TDim + entry[1];
+                        const Lanes& dN = dNdX[iNode * TDim + entry[2]];
+                        for (int j = 0; j < numDofs; ++j)
+                            hessian[row + j * numDofs] += dN * CB[entry[0] * numDofs + j];
+                    }
+            }
+
+            for (int lane = 0; lane < pack.numCells; ++lane)
+            {
+                LocalMatrix local;
+                for (int i = 0; i < numDofs * numDofs; ++i)
+                    local.data()[i] = hessian[i][lane];
+                f(*pack.elements[lane], local);
+            }
+        }
+    }
+
+    DofType GetDofType() const override
+    {
+        return mDofType;
+    }
+
+    bool IsHessian0Symmetric() const override
+    {
+        return mLaw.HasSymmetricTangent();
+    }
+
+    void AddGradient(DofVector<double>* rGradient, double deltaT) const override
+    {
+        Eigen::VectorXd& gradient = (*rGradient)[mDofType];
+        Gradient(deltaT, [&](const ElementCollectionFem& element, const LocalVector& local) {
+            const Eigen::VectorXi numbering = element.DofElement(mDofType).GetDofNumbering();
+            for (int i = 0; i < numbering.rows(); ++i)
+                gradient[numbering[i]] += local[i];
+        });
+    }
+
+    void AddHessian0(DofMatrixSparse<double>* rHessian, double deltaT,
+                     eMatrixStorage storage = eMatrixStorage::FULL) const override
+    {
+        Eigen::SparseMatrix<double>& hessian = (*rHessian)(mDofType, mDofType);
+        std::vector<Eigen::Triplet<double>> triplets;
+        triplets.reserve(NumCells() * TDim * TNumNodes * TDim * TNumNodes);
+        Hessian0(deltaT, [&](const ElementCollectionFem& element, const LocalMatrix& local) {
+            const Eigen::VectorXi numbering = element.DofElement(mDofType).GetDofNumbering();
+            for (int j = 0; j < numbering.rows(); ++j)
+                for (int i = 0; i < numbering.rows(); ++i)
+                    if (storage == eMatrixStorage::FULL or numbering[i] <= numbering[j])
+                        triplets.push_back({numbering[i], numbering[j], local(i, j)});
+        });
+        Eigen::SparseMatrix<double> cellHessians(hessian.rows(), hessian.cols());
+        cellHessians.setFromTriplets(triplets.begin(), triplets.end());
+        hessian += cellHessians;
+    }
+
+    void AddHessian0Product(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::Ref<Eigen::VectorXd> rProduct,
+                            double deltaT) const override
+    {
+        Hessian0(deltaT, [&](const ElementCollectionFem& element, const LocalMatrix& local) {
+            const Eigen::VectorXi numbering = element.DofElement(mDofType).GetDofNumbering();
+            LocalVector localX;
+            for (int i = 0; i < numbering.rows(); ++i)
+                localX[i] = x[numbering[i]];
+            const LocalVector localProduct = local * localX;
+            for (int i = 0; i < numbering.rows(); ++i)
+                rProduct[numbering[i]] += localProduct[i];
+        });
+    }
+
+    void AddHessian0Diagonal(Eigen::Ref<Eigen::VectorXd> rDiagonal, double deltaT) const override
+    {
+        Hessian0(deltaT, [&](const ElementCollectionFem& element, const LocalMatrix& local) {
+            const Eigen::VectorXi numbering = element.DofElement(mDofType).GetDofNumbering();
+            for (int i = 0; i < numbering.rows(); ++i)
+                rDiagonal[numbering[i]] += local(i, i);
+        });
+    }
+
+private:
+    using Displacements = std::array<Lanes, TDim * TNumNodes>;
+    using DerivativeShapeFunctions = std::array<Lanes, TNumNodes * TDim>;
+    using VoigtLanes = std::array<Lanes, Voigt::Dim(TDim)>;
+
+    struct Pack
+    {
+        //! node coordinates (x0 y0 x1 y1 ...), each for all cells of the pack
+        std::array<Lanes, TDim * TNumNodes> coordinates;
+        std::array<const ElementCollectionFem*, TPack> elements;
+        std::array<int, TPack> cellIds;
+        int numCells = 0;
+
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    };
+
+    Displacements GatherDisplacements(const Pack& pack) const
+    {
+        Displacements u;
+        for (int lane = 0; lane < TPack; ++lane)
+        {
+            const ElementFem& dofElement = pack.elements[lane]->DofElement(mDofType);
+            for (int iNode = 0; iNode < TNumNodes; ++iNode)
+            {
+                const Eigen::VectorXd& nodeValues = dofElement.GetNode(iNode).GetValues();
+                for (int iDim = 0; iDim < TDim; ++iDim)
+                    u[iNode * TDim + iDim][lane] = nodeValues[iDim];
+            }
+        }
+        return u;
+    }
+
+    //! @brief calculates dN/dx (stored as dN0/dx dN0/dy dN1/dx ...) at the integration point `iIP` for the whole pack
+    //! @return determinants of the jacobians
+    Lanes DerivativeShapeFunctionsGlobal(const Pack& pack, int iIP, DerivativeShapeFunctions* rDerivatives) const
+    {
+        const Eigen::MatrixXd& dNdXi = mDerivativeShapeFunctionsNatural[iIP];
+
+        // J(i, j) = sum_n x_i(n) dN(n)/dxi_j
+        std::array<Lanes, TDim * TDim> J;
+        for (int i = 0; i < TDim; ++i)
+            for (int j = 0; j < TDim; ++j)
+            {
+                Lanes& Jij = J[i * TDim + j];
+                Jij = pack.coordinates[i] * dNdXi(0, j);
+                for (int iNode = 1; iNode < TNumNodes; ++iNode)
+                    Jij += pack.coordinates[iNode * TDim + i] * dNdXi(iNode, j);
+            }
+
+        std::array<Lanes, TDim * TDim> invJ;
+        const Lanes detJ = Inverse(J, &invJ);
+
+        // dN/dx(n, i) = sum_j dN(n)/dxi_j * invJ(j, i)
+        for (int iNode = 0; iNode < TNumNodes; ++iNode)
+            for (int i = 0; i < TDim; ++i)
+            {
+                Lanes& dN = (*rDerivatives)[iNode * TDim + i];
+                dN = dNdXi(iNode, 0) * invJ[i];
+                for (int j = 1; j < TDim; ++j)
+                    dN += dNdXi(iNode, j) * invJ[j * TDim + i];
+            }
+        return detJ;
+    }
+
+    //! @brief inverts the row major TDim x TDim matrices `J` lane by lane
+    //! @return determinants
+    static Lanes Inverse(const std::array<Lanes, 1>& J, std::array<Lanes, 1>* rInvJ)
+    {
+        (*rInvJ)[0] = J[0].inverse();
+        return J[0];
+    }
+
+    static Lanes Inverse(const std::array<Lanes, 4>& J, std::array<Lanes, 4>* rInvJ)
+    {
+        const Lanes det = J[0] * J[3] - J[1] * J[2];
+        const Lanes invDet = det.inverse();
+        (*rInvJ)[0] = J[3] * invDet;
+        (*rInvJ)[1] = -J[1] * invDet;
+        (*rInvJ)[2] = -J[2] * invDet;
+        (*rInvJ)[3] = J[0] * invDet;
+        return det;
+    }
+
+    static Lanes Inverse(const std::array<Lanes, 9>& J, std::array<Lanes, 9>* rInvJ)
+    {
+        const Lanes c0 = J[4] * J[8] - J[5] * J[7];
+        const Lanes c1 = J[5] * J[6] - J[3] * J[8];
+        const Lanes c2 = J[3] * J[7] - J[4] * J[6];
+        const Lanes det = J[0] * c0 + J[1] * c1 + J[2] * c2;
+        const Lanes invDet = det.inverse();
+        std::array<Lanes, 9>& invJ = *rInvJ;
+        invJ[0] = c0 * invDet;
+        invJ[1] = (J[2] * J[7] - J[1] * J[8]) * invDet;
+        invJ[2] = (J[1] * J[5] - J[2] * J[4]) * invDet;
+        invJ[3] = c1 * invDet;
+        invJ[4] = (J[0] * J[8] - J[2] * J[6]) * invDet;
+        invJ[5] = (J[2] * J[3] - J[0] * J[5]) * invDet;
+        invJ[6] = c2 * invDet;
+        invJ[7] = (J[1] * J[6] - J[0] * J[7]) * invDet;
+        invJ[8] = (J[0] * J[4] - J[1] * J[3]) * invDet;
+        return det;
+    }
+
+    //! @return engineering strains B u for the whole pack
+    static VoigtLanes Strain(const DerivativeShapeFunctions& dNdX, const Displacements& u)
+    {
+        VoigtLanes strain;
+        for (Lanes& entry : strain)
+            entry.setZero();
+        for (int iNode = 0; iNode < TNumNodes; ++iNode)
+            for (const auto& entry : Nabla::StrainPattern<TDim>::Entries())
+                strain[entry[0]] += dNdX[iNode * TDim + entry[2]] * u[iNode * TDim + entry[1]];
+        return strain;
+    }
+
+    DofType mDofType;
+    const Laws::MechanicsInterface<TDim>& mLaw;
+
+    std::array<Eigen::MatrixXd, TNumIps> mDerivativeShapeFunctionsNatural;
+    std::array<double, TNumIps> mWeights;
+    std::vector<Pack, Eigen::aligned_allocator<Pack>> mPacks;
+};
+} /* NuTo */
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include "nuto/mechanics/dofs/DofVector.h"
+#include "nuto/mechanics/dofs/DofMatrixSparse.h"
+
+namespace NuTo
+{
+//! @brief interface of CellBatch, independent of its template arguments, for the assembly of batched cells
+class CellBatchInterface
+{
+public:
+    virtual ~CellBatchInterface() = default;
+
+    //! @return dof type of the gradient and the hessian
+    virtual DofType GetDofType() const = 0;
+
+    //! @return all dof types of the gradient and the hessian, starting with GetDofType()
+    //! @remark The local contributions of a batch with several dof types are coupled. It is only assembled together
+    //! with all its dof types and does not support the matrix-free products.
+    virtual std::vector<DofType> GetDofTypes() const
+    {
+        return {GetDofType()};
+    }
+
+    //! @return true if the local hessians are symmetric for all states
+    virtual bool IsHessian0Symmetric() const = 0;
+
+    //! @brief adds the gradients of all cells to `rGradient`
+    //! @param rGradient properly sized gradient, e.g. zero initialized with the number of dofs of the dof numbering
+    virtual void AddGradient(DofVector<double>* rGradient, double deltaT) const = 0;
+
+    //! @brief adds the hessians of all cells to `rHessian`
+    //! @param rHessian properly sized hessian, only the block (dofType, dofType) is modified
+    //! @param storage eMatrixStorage::UPPER only adds the upper triangle of the local hessians
+    virtual void AddHessian0(DofMatrixSparse<double>* rHessian, double deltaT, eMatrixStorage storage) const = 0;
+
+    //! @brief adds the products of the local hessians of all cells with `x` to `rProduct`
+    //! @param x values of the dof type in the dof numbering, e.g. DofVector<double>::operator[](dofType)
+    //! @param rProduct values of the dof type in the dof numbering
+    virtual void AddHessian0Product(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::Ref<Eigen::VectorXd> rProduct,
+                                    double deltaT) const = 0;
+
+    //! @brief adds the diagonals of the local hessians of all cells to `rDiagonal`
+    virtual void AddHessian0Diagonal(Eigen::Ref<Eigen::VectorXd> rDiagonal, double deltaT) const = 0;
+
+    //! @brief updates the history data of all cells with the node values of the converged state
+    //! @remark The default does nothing, e.g. for batches whose constitutive laws are updated by separate functions.
+    virtual void UpdateHistory(double) const
+    {
+    }
+};
+} /* NuTo */
@@ -1,7 +1,10 @@
 #pragma once
 
-#include "nuto/mechanics/dofs/DofContainer.h"
+#include <memory>
 #include "nuto/mechanics/elements/ElementCollection.h"
+#include "nuto/mechanics/cell/ShapeFunctionTable.h"
+#include "nuto/mechanics/cell/CellWorkspace.h"
+#include "nuto/mechanics/cell/DofValueSource.h"
 
 namespace NuTo
 {
@@ -14,9 +17,20 @@ namespace NuTo
 class CellData
 {
 public:
-    CellData(const ElementCollection& elements, int cellId)
+    //! @param shapeFunctionTables optional precomputed shape functions of the integration points of the cell, see
+    //! Cell::EnableShapeFunctionTables(...)
+    //! @param workspace optional storage for the node values, reused by the cells of a thread, see
+    //! ScopedCellWorkspace. Its entries have to be invalidated before. A new workspace is created on first use if none
+    //! is provided.
+    //! @param dofValues optional source of the node values of instance 0, see Cell::SetDofValueSource(...)
+    CellData(const ElementCollection& elements, int cellId,
+             const CellShapeFunctionTables* shapeFunctionTables = nullptr,
+             NodeValuesWorkspace* workspace = nullptr, const CellDofValues* dofValues = nullptr)
         : mElements(elements)
         , mCellId(cellId)
+        , mShapeFunctionTables(shapeFunctionTables)
+        , mWorkspace(workspace)
+        , mDofValues(dofValues)
     {
     }
 
@@ -32,14 +46,15 @@ public:
 
     const Eigen::VectorXd& GetNodeValues(DofType dofType, int instance = 0) const
     {
-        if (instance >= static_cast<int>(mNodeValues[dofType].size()))
-            mNodeValues[dofType].resize(instance + 1);
-
-        Eigen::VectorXd& nodeValues = mNodeValues[dofType][instance];
-        if (nodeValues.size() == 0)
-            nodeValues = mElements.DofElement(dofType).ExtractNodeValues(instance);
-
-        return nodeValues;
+        NodeValuesWorkspace::Entry& nodeValues = Workspace().Get(dofType, instance);
+        if (not nodeValues.hasValues)
+        {
+            const bool gathered = instance == 0 and mDofValues and mDofValues->Gather(dofType, &nodeValues.values);
+            if (not gathered)
+                nodeValues.values = mElements.DofElement(dofType).ExtractNodeValues(instance);
+            nodeValues.hasValues = true;
+        }
+        return nodeValues.values;
     }
 
     const ElementCollection& Elements() const
@@ -47,9 +62,29 @@ public:
         return mElements;
     }
 
+    //! @return shape function tables of the cell, nullptr if they are not enabled
+    const CellShapeFunctionTables* GetShapeFunctionTables() const
+    {
+        return mShapeFunctionTables;
+    }
+
 private:
-    mutable DofContainer<std::vector<Eigen::VectorXd>> mNodeValues;
+    //! @return workspace passed to the ctor or an own workspace, created on the first call
+    NodeValuesWorkspace& Workspace() const
+    {
+        if (mWorkspace == nullptr)
+        {
+            mOwnWorkspace = std::make_unique<NodeValuesWorkspace>();
+            mWorkspace = mOwnWorkspace.get();
+        }
+        return *mWorkspace;
+    }
+
     const ElementCollection& mElements;
     int mCellId;
+    const CellShapeFunctionTables* mShapeFunctionTables;
+    mutable NodeValuesWorkspace* mWorkspace;
+    mutable std::unique_ptr<NodeValuesWorkspace> mOwnWorkspace;
+    const CellDofValues* mDofValues;
 };
 } /* NuTo */
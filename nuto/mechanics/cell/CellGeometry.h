@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <limits>
+#include <vector>
+#include "nuto/mechanics/cell/Jacobian.h"
+#include "nuto/mechanics/dofs/DofContainer.h"
+
+namespace NuTo
+{
+
+//! @brief memory budget that is shared by the geometry caches of multiple cells
+//! @remark thread-safe, the caches of different cells may be filled concurrently
+class GeometryCacheBudget
+{
+public:
+    //! @param maxBytes maximal number of bytes all the caches together may use
+    GeometryCacheBudget(size_t maxBytes = std::numeric_limits<size_t>::max())
+        : mMaxBytes(maxBytes)
+        , mUsedBytes(0)
+    {
+    }
+
+    //! @brief reserves `bytes` if they fit into the remaining budget
+    //! @return true if the bytes were reserved, false otherwise
+    bool Reserve(size_t bytes)
+    {
+        size_t usedBytes = mUsedBytes.load();
+        do
+        {
+            if (bytes > mMaxBytes - usedBytes)
+                return false;
+        } while (not mUsedBytes.compare_exchange_weak(usedBytes, usedBytes + bytes));
+        return true;
+    }
+
+    //! @brief returns previously reserved `bytes` to the budget
+    void Release(size_t bytes)
+    {
+        mUsedBytes -= bytes;
+    }
+
+    size_t UsedBytes() const
+    {
+        return mUsedBytes.load();
+    }
+
+    size_t MaxBytes() const
+    {
+        return mMaxBytes;
+    }
+
+private:
+    const size_t mMaxBytes;
+    std::atomic<size_t> mUsedBytes;
+};
+
+//! @brief geometry of all integration points of a cell that only depends on the reference configuration
+//! @remark All values are stored in flat arrays, one allocation each, the integration points side by side.
+struct CellGeometry
+{
+    //! @brief inverse jacobians of all integration points. The columns `iIP * globalDim` to
+    //! `iIP * globalDim + globalDim - 1` belong to the integration point `iIP`.
+    Eigen::MatrixXd inverseJacobians;
+
+    //! @brief determinant of the jacobian times the integration point weight of each integration point
+    Eigen::VectorXd detJw;
+
+    //! @brief global derivatives of the shape functions dN/dx of all integration points, stored contiguously. The
+    //! columns `iIP * globalDim` to `iIP * globalDim + globalDim - 1` belong to the integration point `iIP`.
+    DofContainer<Eigen::MatrixXd> derivativeShapeFunctionsGlobal;
+
+    //! @return inverse jacobian of the integration point `iIP`, a view into inverseJacobians
+    Eigen::Map<const Eigen::MatrixXd> InverseJacobian(int iIP) const
+    {
+        const int rows = inverseJacobians.rows();
+        const int cols = GlobalDimension();
+        return Eigen::Map<const Eigen::MatrixXd>(inverseJacobians.data() + iIP * rows * cols, rows, cols);
+    }
+
+    //! @return number of columns of the inverse jacobians, i.e. the global dimension
+    int GlobalDimension() const
+    {
+        return detJw.rows() == 0 ? 0 : inverseJacobians.cols() / detJw.rows();
+    }
+
+    //! @brief memory usage in bytes of a cache with the given sizes, to check the budget before the allocation
+    //! @param numDofNodes number of nodes of each cached dof type
+    static size_t Bytes(int numIps, int localDimension, int globalDimension, const std::vector<int>& numDofNodes)
+    {
+        size_t numValues = numIps * (1 + localDimension * globalDimension);
+        for (int numNodes : numDofNodes)
+            numValues += numNodes * globalDimension * numIps;
+        return sizeof(CellGeometry) + numValues * sizeof(double);
+    }
+
+    //! @brief memory usage in bytes
+    size_t Bytes() const
+    {
+        size_t numValues = inverseJacobians.size() + detJw.size();
+        for (const auto& dNdX : derivativeShapeFunctionsGlobal)
+            numValues += dNdX.second.size();
+        return sizeof(CellGeometry) + numValues * sizeof(double);
+    }
+};
+} /* NuTo */
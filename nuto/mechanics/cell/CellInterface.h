@@ -1,5 +1,6 @@
 #pragma once
 
+#include <utility>
 #include <vector>
 #include "nuto/mechanics/dofs/DofVector.h"
 #include "nuto/mechanics/dofs/DofMatrix.h"
@@ -18,6 +19,7 @@ public:
     using ScalarFunction = std::function<double(const CellIpData&)>;
     using VectorFunction = std::function<DofVector<double>(const CellIpData&)>;
     using MatrixFunction = std::function<DofMatrix<double>(const CellIpData&)>;
+    using VectorMatrixFunction = std::function<std::pair<DofVector<double>, DofMatrix<double>>(const CellIpData&)>;
 
     using VoidFunction = std::function<void(const CellIpData&)>;
     using EvalFunction = std::function<Eigen::VectorXd(const CellIpData&)>;
@@ -25,12 +27,20 @@ public:
     virtual double Integrate(ScalarFunction) = 0;
     virtual DofVector<double> Integrate(VectorFunction) = 0;
     virtual DofMatrix<double> Integrate(MatrixFunction) = 0;
+
+    //! @brief integrates a vector and a matrix that are calculated together in a single pass over the integration
+    //! points, e.g. a gradient and its hessian
+    virtual std::pair<DofVector<double>, DofMatrix<double>> Integrate(VectorMatrixFunction) = 0;
+
     virtual void Apply(VoidFunction) = 0;
 
     virtual std::vector<Eigen::VectorXd> Eval(EvalFunction f) const = 0;
 
     virtual Eigen::VectorXi DofNumbering(DofType dof) = 0;
 
+    //! @brief returns true if the cell has an interpolation for `dof`
+    virtual bool Has(DofType dof) const = 0;
+
     //! Coordinate interpolation
     virtual Eigen::VectorXd Interpolate(Eigen::VectorXd naturalCoords) const = 0;
     //! Dof interpolation
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <memory>
+#include <boost/optional.hpp>
 #include "nuto/mechanics/dofs/DofContainer.h"
 #include "nuto/mechanics/cell/CellData.h"
+#include "nuto/mechanics/cell/CellWorkspace.h"
 #include "nuto/mechanics/cell/Jacobian.h"
+#include "nuto/mechanics/cell/CellGeometry.h"
 #include "nuto/mechanics/cell/DifferentialOperators.h"
 #include "nuto/mechanics/cell/CellIds.h"
 
@@ -16,14 +20,37 @@ class CellIpData
 public:
     //! ctor
     //! @param cellData cell data that is constant for all integration points of a cell (cellId, node values)
-    //! @param jacobian transformation from the natural (xi, eta,...) system to the global system (x,y,..)
+    //! @param jacobian transformation from the natural (xi, eta,...) system to the global system (x,y,..), has to
+    //! outlive this object
     //! @param ipCoords coordinates of the current integration point
     //! @param ipId id of the current integration point
-    CellIpData(const CellData& cellData, NuTo::Jacobian jacobian, NaturalCoords ipCoords, int ipId)
+    //! @param workspace optional storage for the memoized N and B, reused by the integration points of a thread, see
+    //! ScopedCellWorkspace. Its entries have to be invalidated before. A new workspace is created on first use if none
+    //! is provided.
+    CellIpData(const CellData& cellData, const NuTo::Jacobian& jacobian, NaturalCoords ipCoords, int ipId,
+               IpWorkspace* workspace = nullptr)
         : mCellData(cellData)
-        , mJacobian(std::move(jacobian))
+        , mJacobian(&jacobian)
+        , mInverseJacobian(jacobian.Inv().data(), jacobian.Inv().rows(), jacobian.Inv().cols())
         , mIPCoords(std::move(ipCoords))
         , mIpId(ipId)
+        , mDerivativeShapeFunctionsGlobal(nullptr)
+        , mWorkspace(workspace)
+    {
+    }
+
+    //! ctor with the cached geometry of the cell, see ctor above
+    //! @param geometry inverse jacobians and dN/dx of all integration points of the cell, has to outlive this object.
+    //! Dof types that are not in CellGeometry::derivativeShapeFunctionsGlobal are calculated.
+    CellIpData(const CellData& cellData, const CellGeometry& geometry, NaturalCoords ipCoords, int ipId,
+               IpWorkspace* workspace = nullptr)
+        : mCellData(cellData)
+        , mJacobian(nullptr)
+        , mInverseJacobian(geometry.InverseJacobian(ipId))
+        , mIPCoords(std::move(ipCoords))
+        , mIpId(ipId)
+        , mDerivativeShapeFunctionsGlobal(&geometry.derivativeShapeFunctionsGlobal)
+        , mWorkspace(workspace)
     {
     }
 
@@ -50,9 +77,18 @@ public:
         return N(dofType) * NodeValueVector(dofType, instance);
     }
 
+    //! @remark With a geometry cache, the jacobian is only calculated on demand.
     const NuTo::Jacobian& GetJacobian() const
     {
-        return mJacobian;
+        if (mJacobian)
+            return *mJacobian;
+        if (not mCalculatedJacobian)
+        {
+            const ElementInterface& coordinates = mCellData.Elements().CoordinateElement();
+            mCalculatedJacobian.emplace(coordinates.ExtractNodeValues(),
+                                        coordinates.GetDerivativeShapeFunctions(mIPCoords));
+        }
+        return *mCalculatedJacobian;
     }
 
     double Value(ScalarDofType dofType, int instance = 0) const
@@ -76,10 +112,18 @@ public:
     //! @return N matrix
     const Eigen::MatrixXd& N(DofType dofType) const
     {
-        Eigen::MatrixXd& N = mNs[dofType];
-        if (N.size() == 0) // simplest memoization using a mutable mNs to keep it const
-            N = mCellData.Elements().DofElement(dofType).GetNMatrix(mIPCoords);
-        return N;
+        IpWorkspace::Entry& entry = Workspace().Get(dofType);
+        if (not entry.hasN)
+        {
+            const ElementInterface& element = mCellData.Elements().DofElement(dofType);
+            const ShapeFunctionTable* table = ShapeFunctionTableOf(dofType);
+            if (table)
+                Matrix::N(table->ShapeFunctions(mIpId), element.GetNumNodes(), element.GetDofDimension(), &entry.N);
+            else
+                entry.N = element.GetNMatrix(mIPCoords);
+            entry.hasN = true;
+        }
+        return entry.N;
     }
 
     //! Returns a memoized copy of the B matrix for a given dof type
@@ -88,10 +132,22 @@ public:
     //! @return B matrix
     const Eigen::MatrixXd& B(DofType dofType, const Nabla::Interface& b) const
     {
-        Eigen::MatrixXd& B = mBs[dofType];
-        if (B.size() == 0) // simplest memoization using a mutable mBs to keep it const
-            B = b(CalculateDerivativeShapeFunctionsGlobal(dofType));
-        return B;
+        IpWorkspace::Entry& entry = Workspace().Get(dofType);
+        if (not entry.hasB)
+        {
+            if (mDerivativeShapeFunctionsGlobal != nullptr and mDerivativeShapeFunctionsGlobal->Has(dofType))
+            {
+                const int dim = mInverseJacobian.cols();
+                b.Apply((*mDerivativeShapeFunctionsGlobal)[dofType].middleCols(mIpId * dim, dim), &entry.B);
+            }
+            else
+            {
+                CalculateDerivativeShapeFunctionsGlobal(dofType, &entry.derivativeShapeFunctionsGlobal);
+                b.Apply(entry.derivativeShapeFunctionsGlobal, &entry.B);
+            }
+            entry.hasB = true;
+        }
+        return entry.B;
     }
 
     //! Returns memoized nodal values
@@ -103,21 +159,50 @@ public:
     }
 
 private:
+    //! @return workspace passed to the ctor or an own workspace, created on the first call
+    IpWorkspace& Workspace() const
+    {
+        if (mWorkspace == nullptr)
+        {
+            mOwnWorkspace = std::make_unique<IpWorkspace>();
+            mWorkspace = mOwnWorkspace.get();
+        }
+        return *mWorkspace;
+    }
+
     //! Transforms the derivative shape functions from the natural coordinate system (dN_d(xi, eta, ...)) to the global
     //! coordinate system (dN_d(x,y,...))
-    Eigen::MatrixXd CalculateDerivativeShapeFunctionsGlobal(DofType dofType) const
+    void CalculateDerivativeShapeFunctionsGlobal(DofType dofType, Eigen::MatrixXd* rDerivativeShapeFunctions) const
     {
+        const ShapeFunctionTable* table = ShapeFunctionTableOf(dofType);
+        if (table)
+        {
+            rDerivativeShapeFunctions->noalias() = table->DerivativeShapeFunctions(mIpId) * mInverseJacobian;
+            return;
+        }
         Eigen::MatrixXd dShapeNatural =
                 mCellData.Elements().DofElement(dofType).GetDerivativeShapeFunctions(mIPCoords);
-        return mJacobian.TransformDerivativeShapeFunctions(dShapeNatural);
+        rDerivativeShapeFunctions->noalias() = dShapeNatural * mInverseJacobian;
+    }
+
+    //! @return precomputed shape functions of `dofType` if available, nullptr otherwise
+    const ShapeFunctionTable* ShapeFunctionTableOf(DofType dofType) const
+    {
+        const CellShapeFunctionTables* tables = mCellData.GetShapeFunctionTables();
+        return tables ? tables->Dof(dofType) : nullptr;
     }
 
     const CellData& mCellData;
-    NuTo::Jacobian mJacobian;
+
+    //! @brief jacobian of the integration point, nullptr with a geometry cache
+    const NuTo::Jacobian* mJacobian;
+    Eigen::Map<const Eigen::MatrixXd> mInverseJacobian;
+    mutable boost::optional<NuTo::Jacobian> mCalculatedJacobian;
+
     NaturalCoords mIPCoords;
     int mIpId;
-
-    mutable DofContainer<Eigen::MatrixXd> mBs;
-    mutable DofContainer<Eigen::MatrixXd> mNs;
+    const DofContainer<Eigen::MatrixXd>* mDerivativeShapeFunctionsGlobal;
+    mutable IpWorkspace* mWorkspace;
+    mutable std::unique_ptr<IpWorkspace> mOwnWorkspace;
 };
 } /* NuTo */
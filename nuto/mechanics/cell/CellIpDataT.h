@@ -0,0 +1,178 @@
+#pragma once
+
+#include <Eigen/Core>
+#include "nuto/mechanics/cell/CellData.h"
+#include "nuto/mechanics/cell/CellIds.h"
+#include "nuto/mechanics/constitutive/EngineeringStrain.h"
+#include "nuto/mechanics/constitutive/Voigt.h"
+
+namespace NuTo
+{
+namespace Nabla
+{
+//! @brief fixed size version of Nabla::Strain, maps dN/dx (numNodes x dim) to the engineering strain operator B
+template <int TDim, int TNumNodes>
+struct StrainT;
+
+template <int TNumNodes>
+struct StrainT<1, TNumNodes>
+{
+    static Eigen::Matrix<double, 1, TNumNodes> Apply(const Eigen::Matrix<double, TNumNodes, 1>& dNdX)
+    {
+        return dNdX.transpose();
+    }
+};
+
+template <int TNumNodes>
+struct StrainT<2, TNumNodes>
+{
+    static Eigen::Matrix<double, 3, 2 * TNumNodes> Apply(const Eigen::Matrix<double, TNumNodes, 2>& dNdX)
+    {
+        Eigen::Matrix<double, 3, 2 * TNumNodes> B = Eigen::Matrix<double, 3, 2 * TNumNodes>::Zero();
+        for (int iNode = 0, iColumn = 0; iNode < TNumNodes; ++iNode, iColumn += 2)
+        {
+            B(0, iColumn) = dNdX(iNode, 0);
+            B(1, iColumn + 1) = dNdX(iNode, 1);
+            B(2, iColumn) = dNdX(iNode, 1);
+            B(2, iColumn + 1) = dNdX(iNode, 0);
+        }
+        return B;
+    }
+};
+
+template <int TNumNodes>
+struct StrainT<3, TNumNodes>
+{
+    static Eigen::Matrix<double, 6, 3 * TNumNodes> Apply(const Eigen::Matrix<double, TNumNodes, 3>& dNdX)
+    {
+        // same layout as Nabla::Strain
+        Eigen::Matrix<double, 6, 3 * TNumNodes> B = Eigen::Matrix<double, 6, 3 * TNumNodes>::Zero();
+        for (int iNode = 0, iColumn = 0; iNode < TNumNodes; ++iNode, iColumn += 3)
+        {
+            B(0, iColumn) = dNdX(iNode, 0);
+            B(1, iColumn + 1) = dNdX(iNode, 1);
+            B(2, iColumn + 2) = dNdX(iNode, 2);
+
+            B(3, iColumn + 1) = dNdX(iNode, 2);
+            B(3, iColumn + 2) = dNdX(iNode, 1);
+
+            B(4, iColumn) = dNdX(iNode, 2);
+            B(4, iColumn + 2) = dNdX(iNode, 0);
+
+            B(5, iColumn) = dNdX(iNode, 1);
+            B(5, iColumn + 1) = dNdX(iNode, 0);
+        }
+        return B;
+    }
+};
+} /* Nabla */
+
+//! @brief Fixed size counterpart of NuTo::CellIpData for the compile time specialized NuTo::CellT
+//! @tparam TDim global dimension
+//! @tparam TNumNodes number of nodes of the coordinate element and of all dof elements (isoparametric cells)
+//! @remark All the matrices (N, B, dN/dx) have compile time sizes and are thus allocated on the stack.
+template <int TDim, int TNumNodes>
+class CellIpDataT
+{
+public:
+    using ShapeFunctions = Eigen::Matrix<double, 1, TNumNodes>;
+    using DerivativeShapeFunctions = Eigen::Matrix<double, TNumNodes, TDim>;
+
+    template <int TNumComponents>
+    using NodeValues = Eigen::Matrix<double, TNumComponents * TNumNodes, 1>;
+
+    //! ctor
+    //! @param cellData cell data that is constant for all integration points of a cell (cellId, node values)
+    //! @param shapeFunctions shape functions evaluated at the integration point
+    //! @param dNdX derivatives of the shape functions with respect to the global coordinates
+    //! @param ipId id of the current integration point
+    CellIpDataT(const CellData& cellData, const ShapeFunctions& shapeFunctions, const DerivativeShapeFunctions& dNdX,
+                int ipId)
+        : mCellData(cellData)
+        , mShapeFunctions(shapeFunctions)
+        , mDerivativeShapeFunctions(dNdX)
+        , mIpId(ipId)
+    {
+    }
+
+    //! Access to the cellId and ipId, compressed in CellIds
+    //! @return named pair of cellId and ipId
+    CellIds Ids() const
+    {
+        return {mCellData.GetCellId(), mIpId};
+    }
+
+    //! @return shape functions N(x) of one component
+    const ShapeFunctions& Shape() const
+    {
+        return mShapeFunctions;
+    }
+
+    //! @return derivatives of the shape functions dN/dx
+    const DerivativeShapeFunctions& DerivativeShape() const
+    {
+        return mDerivativeShapeFunctions;
+    }
+
+    //! @return N matrix for a dof type with TNumComponents components, like CellIpData::N(...)
+    template <int TNumComponents>
+    Eigen::Matrix<double, TNumComponents, TNumComponents * TNumNodes> N() const
+    {
+        Eigen::Matrix<double, TNumComponents, TNumComponents * TNumNodes> n =
+                Eigen::Matrix<double, TNumComponents, TNumComponents * TNumNodes>::Zero();
+        for (int iNode = 0; iNode < TNumNodes; ++iNode)
+            for (int iComponent = 0; iComponent < TNumComponents; ++iComponent)
+                n(iComponent, iNode * TNumComponents + iComponent) = mShapeFunctions[iNode];
+        return n;
+    }
+
+    //! @return gradient operator of a scalar dof type, like CellIpData::B(dof, Nabla::Gradient())
+    Eigen::Matrix<double, TDim, TNumNodes> BGradient() const
+    {
+        return mDerivativeShapeFunctions.transpose();
+    }
+
+    //! @return strain operator of a displacement dof type, like CellIpData::B(dof, Nabla::Strain())
+    Eigen::Matrix<double, Voigt::Dim(TDim), TDim * TNumNodes> BStrain() const
+    {
+        return Nabla::StrainT<TDim, TNumNodes>::Apply(mDerivativeShapeFunctions);
+    }
+
+    //! @return memoized nodal values of `dofType` as fixed size vector
+    //! @tparam TNumComponents number of components of `dofType`
+    template <int TNumComponents>
+    Eigen::Map<const NodeValues<TNumComponents>> NodeValueVector(DofType dofType, int instance = 0) const
+    {
+        const Eigen::VectorXd& nodeValues = mCellData.GetNodeValues(dofType, instance);
+        if (nodeValues.rows() != TNumComponents * TNumNodes)
+            throw Exception(__PRETTY_FUNCTION__, "The dof element of " + dofType.GetName() + " has " +
+                                                         std::to_string(nodeValues.rows()) + " node values, expected " +
+                                                         std::to_string(TNumComponents * TNumNodes) + ".");
+        return Eigen::Map<const NodeValues<TNumComponents>>(nodeValues.data());
+    }
+
+    //! @return value of a scalar dof type at the integration point
+    double Value(ScalarDofType dofType, int instance = 0) const
+    {
+        return (mShapeFunctions * NodeValueVector<1>(dofType, instance)).value();
+    }
+
+    //! @return gradient of a scalar dof type at the integration point
+    Eigen::Matrix<double, TDim, 1> Gradient(ScalarDofType dofType, int instance = 0) const
+    {
+        return BGradient() * NodeValueVector<1>(dofType, instance);
+    }
+
+    //! @return engineering strain of a displacement dof type at the integration point
+    EngineeringStrain<TDim> Strain(DofType dofType, int instance = 0) const
+    {
+        return BStrain() * NodeValueVector<TDim>(dofType, instance);
+    }
+
+private:
+    const CellData& mCellData;
+    const ShapeFunctions& mShapeFunctions;
+    DerivativeShapeFunctions mDerivativeShapeFunctions;
+    int mIpId;
+};
+} /* NuTo */
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cassert>
+#include <iterator>
+#include <type_traits>
+
+namespace NuTo
+{
+class Cell;
+
+//! @brief contiguous range of cells of the same type, e.g. one chunk of a CellPool
+//! @tparam TCell Cell for mutable access, const Cell for read only access
+//! @remark The cells are visited by a constant byte stride (the size of their type) instead of a pointer per cell.
+//! Different ranges may contain different cell types, e.g. Cell and CellT. Iteration is by reference to the base
+//! class Cell. Include Cell.h to use the cells.
+template <typename TCell>
+class CellRangeT
+{
+    static_assert(std::is_same<std::remove_const_t<TCell>, Cell>::value, "TCell must be Cell or const Cell");
+    using Byte = std::conditional_t<std::is_const<TCell>::value, const char, char>;
+
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::remove_const_t<TCell>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TCell*;
+        using reference = TCell&;
+
+        Iterator(Byte* position, std::ptrdiff_t stride)
+            : mPosition(position)
+            , mStride(stride)
+        {
+        }
+
+        TCell& operator*() const
+        {
+            return *reinterpret_cast<TCell*>(mPosition);
+        }
+
+        Iterator& operator++()
+        {
+            mPosition += mStride;
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            return mPosition == other.mPosition;
+        }
+
+        bool operator!=(const Iterator& other) const
+        {
+            return mPosition != other.mPosition;
+        }
+
+    private:
+        Byte* mPosition;
+        std::ptrdiff_t mStride;
+    };
+
+    //! @param first first cell of an array of `size` cells of type TDerived
+    template <typename TDerived>
+    CellRangeT(TDerived* first, int size)
+        : mFirst(reinterpret_cast<Byte*>(static_cast<TCell*>(first)))
+        , mStride(sizeof(TDerived))
+        , mSize(size)
+    {
+        static_assert(std::is_base_of<Cell, std::remove_const_t<TDerived>>::value,
+                      "TDerived must be a descendant of Cell");
+    }
+
+    int Size() const
+    {
+        return mSize;
+    }
+
+    TCell& operator[](int i) const
+    {
+        assert(i < mSize);
+        return *reinterpret_cast<TCell*>(mFirst + i * mStride);
+    }
+
+    Iterator begin() const
+    {
+        return {mFirst, mStride};
+    }
+
+    Iterator end() const
+    {
+        return {mFirst + mSize * mStride, mStride};
+    }
+
+private:
+    Byte* mFirst;
+    std::ptrdiff_t mStride;
+    int mSize;
+};
+
+//! @brief range of mutable cells, e.g. for the assembly
+using CellRange = CellRangeT<Cell>;
+
+//! @brief range of read only cells
+using ConstCellRange = CellRangeT<const Cell>;
+} /* NuTo */
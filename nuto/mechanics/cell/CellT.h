@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include "nuto/mechanics/cell/Cell.h"
+#include "nuto/mechanics/cell/CellIpDataT.h"
+
+namespace NuTo
+{
+//! @brief Cell with compile time sizes for isoparametric elements
+//! @tparam TDim global dimension, equal to the dimension of the element
+//! @tparam TNumNodes number of nodes of the coordinate element and of all dof elements
+//! @tparam TNumIps number of integration points
+//! @remark The shape functions and their natural derivatives are evaluated once in the ctor. All the quantities that
+//! are calculated per integration point (jacobian, dN/dx, N, B, the integrand results) are fixed size Eigen types
+//! and the integrands are called without type erasure via IntegrateT and ApplyT. These use the inverse jacobians of the
+//! geometry cache, if enabled. The dynamic interface of Cell (with std::function and DofVector/DofMatrix) is still
+//! available as fallback. See CellTBatch to assemble the fixed size kernels of many cells.
+template <int TDim, int TNumNodes, int TNumIps>
+class CellT : public Cell
+{
+public:
+    using IpData = CellIpDataT<TDim, TNumNodes>;
+
+    CellT(const ElementCollection& elements, const IntegrationTypeBase& integrationType, const int id)
+        : Cell(elements, integrationType, id)
+        , mElements(elements)
+    {
+        const ElementInterface& coordinateElement = elements.CoordinateElement();
+        if (integrationType.GetNumIntegrationPoints() != TNumIps)
+            throw Exception(__PRETTY_FUNCTION__, "The integration type has " +
+                                                         std::to_string(integrationType.GetNumIntegrationPoints()) +
+                                                         " integration points, expected " + std::to_string(TNumIps) +
+                                                         ".");
+        if (coordinateElement.GetNumNodes() != TNumNodes or coordinateElement.GetDofDimension() != TDim)
+            throw Exception(__PRETTY_FUNCTION__, "The coordinate element does not match the template arguments.");
+
+        for (int iIP = 0; iIP < TNumIps; ++iIP)
+        {
+            auto ipCoords = integrationType.GetLocalIntegrationPointCoordinates(iIP);
+            mShapeFunctions[iIP] = coordinateElement.GetShapeFunctions(ipCoords).transpose();
+            mDerivativeShapeFunctionsNatural[iIP] = coordinateElement.GetDerivativeShapeFunctions(ipCoords);
+            mWeights[iIP] = integrationType.GetIntegrationPointWeight(iIP);
+        }
+    }
+
+    //! @brief integrates a fixed size kernel over the cell
+    //! @param kernel callable with the signature `TResult(const IpData&)`. TResult is either double or a fixed size
+    //! Eigen matrix type (not an expression)
+    //! @return sum of kernel(ipData) * detJ * w over all integration points
+    template <typename TKernel>
+    auto IntegrateT(TKernel&& kernel) -> std::decay_t<decltype(kernel(std::declval<const IpData&>()))>
+    {
+        using TResult = std::decay_t<decltype(kernel(std::declval<const IpData&>()))>;
+
+        ScopedCellWorkspace workspace;
+        CellData cellData(mElements, Id(), nullptr, &workspace.Get().nodeValues, DofValues());
+        const CellGeometry* geometry = Geometry();
+        Coordinates coordinates;
+        if (not geometry)
+            coordinates = CoordinateMatrix();
+
+        DerivativeShapeFunctions dNdX;
+        double detJw = IpDerivativeShapeFunctions(geometry, coordinates, 0, &dNdX);
+        TResult result = kernel(IpData(cellData, mShapeFunctions[0], dNdX, 0)) * detJw;
+        for (int iIP = 1; iIP < TNumIps; ++iIP)
+        {
+            detJw = IpDerivativeShapeFunctions(geometry, coordinates, iIP, &dNdX);
+            result += kernel(IpData(cellData, mShapeFunctions[iIP], dNdX, iIP)) * detJw;
+        }
+        return result;
+    }
+
+    //! @brief calls the fixed size `kernel` at every integration point, e.g. to update history data
+    //! @param kernel callable with the signature `void(const IpData&)`
+    template <typename TKernel>
+    void ApplyT(TKernel&& kernel)
+    {
+        ScopedCellWorkspace workspace;
+        CellData cellData(mElements, Id(), nullptr, &workspace.Get().nodeValues, DofValues());
+        const CellGeometry* geometry = Geometry();
+        Coordinates coordinates;
+        if (not geometry)
+            coordinates = CoordinateMatrix();
+
+        DerivativeShapeFunctions dNdX;
+        for (int iIP = 0; iIP < TNumIps; ++iIP)
+        {
+            IpDerivativeShapeFunctions(geometry, coordinates, iIP, &dNdX);
+            kernel(IpData(cellData, mShapeFunctions[iIP], dNdX, iIP));
+        }
+    }
+
+private:
+    using Coordinates = Eigen::Matrix<double, TDim, TNumNodes>;
+    using DerivativeShapeFunctions = typename IpData::DerivativeShapeFunctions;
+
+    //! @return coordinates (x0 x1 ...; y0 y1 ...; ...) of the nodes of the coordinate element
+    Coordinates CoordinateMatrix() const
+    {
+        const Eigen::VectorXd nodeValues = mElements.CoordinateElement().ExtractNodeValues();
+        return Eigen::Map<const Coordinates>(nodeValues.data());
+    }
+
+    //! @brief calculates dN/dx at the integration point `iIP`, with the cached inverse jacobian if `geometry` is not
+    //! nullptr, see Cell::EnableGeometryCache(...)
+    //! @param coordinates node coordinates, only used without `geometry`
+    //! @return determinant of the jacobian times the integration point weight
+    double IpDerivativeShapeFunctions(const CellGeometry* geometry, const Coordinates& coordinates, int iIP,
+                                      DerivativeShapeFunctions* rDerivativeShapeFunctions) const
+    {
+        if (geometry == nullptr)
+            return DerivativeShapeFunctionsGlobal(coordinates, iIP, rDerivativeShapeFunctions) * mWeights[iIP];
+
+        const Eigen::Map<const Eigen::Matrix<double, TDim, TDim>> inverseJacobian(
+                geometry->inverseJacobians.data() + iIP * TDim * TDim);
+        rDerivativeShapeFunctions->noalias() = mDerivativeShapeFunctionsNatural[iIP] * inverseJacobian;
+        return geometry->detJw[iIP];
+    }
+
+    //! @brief calculates dN/dx at the integration point `iIP`
+    //! @return determinant of the jacobian
+    double DerivativeShapeFunctionsGlobal(const Coordinates& coordinates, int iIP,
+                                          DerivativeShapeFunctions* rDerivativeShapeFunctions) const
+    {
+        const Eigen::Matrix<double, TDim, TDim> jacobian = coordinates * mDerivativeShapeFunctionsNatural[iIP];
+        *rDerivativeShapeFunctions = mDerivativeShapeFunctionsNatural[iIP] * jacobian.inverse();
+        return jacobian.determinant();
+    }
+
+    const ElementCollection& mElements;
+
+    std::array<typename IpData::ShapeFunctions, TNumIps> mShapeFunctions;
+    std::array<DerivativeShapeFunctions, TNumIps> mDerivativeShapeFunctionsNatural;
+    std::array<double, TNumIps> mWeights;
+
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+} /* NuTo */
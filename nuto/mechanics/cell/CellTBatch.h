@@ -0,0 +1,217 @@
+#pragma once
+
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include <Eigen/SparseCore>
+#include "nuto/base/Exception.h"
+#include "nuto/base/Group.h"
+#include "nuto/mechanics/cell/CellBatchInterface.h"
+#include "nuto/mechanics/cell/CellT.h"
+
+namespace NuTo
+{
+//! @brief Assembles fixed size kernels of a group of CellT like a CellBatch, e.g. via
+//! TimeDependentProblem::AddBatch(...)
+//! @tparam TCell cell type, a CellT
+//! @tparam TGradient callable `LocalVector(const TCell::IpData&, double deltaT)`, e.g. a lambda that calls
+//! Integrands::MomentumBalance::GradientT
+//! @tparam THessian0 callable `LocalMatrix(const TCell::IpData&, double deltaT)` with the same local ordering
+//! @remark The local vectors and matrices contain the node values of the first dof type, followed by the ones of the
+//! second dof type and so on, like Integrands::GradientDamage::GradientT. The kernels are integrated via
+//! CellT::IntegrateT, thus without std::function and dynamically sized Eigen types per integration point. Create the
+//! batch via MakeCellTBatch(...).
+template <typename TCell, typename TGradient, typename THessian0>
+class CellTBatch : public CellBatchInterface
+{
+public:
+    using IpData = typename TCell::IpData;
+    using LocalVector = std::decay_t<std::result_of_t<const TGradient&(const IpData&, double)>>;
+    using LocalMatrix = std::decay_t<std::result_of_t<const THessian0&(const IpData&, double)>>;
+
+    //! @brief updates the history data of an integration point, called once per time step and thus type erased
+    using UpdateFunction = std::function<void(const IpData&, double deltaT)>;
+
+    //! ctor
+    //! @param cells cells of the batch, they have to outlive the batch
+    //! @param dofTypes dof types in the order of the local vectors and matrices
+    //! @param gradient kernel of the local gradient
+    //! @param hessian0 kernel of the local hessian
+    //! @param symmetric true if all the local hessians are symmetric, see TimeDependentProblem::AddHessian0Function
+    CellTBatch(Group<TCell> cells, std::vector<DofType> dofTypes, TGradient gradient, THessian0 hessian0,
+               bool symmetric = false)
+        : mDofTypes(dofTypes)
+        , mGradient(gradient)
+        , mHessian0(hessian0)
+        , mSymmetric(symmetric)
+    {
+        if (mDofTypes.empty())
+            throw Exception(__PRETTY_FUNCTION__, "A batch needs at least one dof type.");
+        for (TCell& cell : cells)
+            mCells.push_back(&cell);
+    }
+
+    //! @brief sets the kernel of UpdateHistory(...), e.g. a lambda that calls Integrands::GradientDamage::UpdateT
+    void SetUpdateFunction(UpdateFunction update)
+    {
+        mUpdate = update;
+    }
+
+    //! @return number of cells in the batch
+    int NumCells() const
+    {
+        return mCells.size();
+    }
+
+    DofType GetDofType() const override
+    {
+        return mDofTypes.front();
+    }
+
+    std::vector<DofType> GetDofTypes() const override
+    {
+        return mDofTypes;
+    }
+
+    bool IsHessian0Symmetric() const override
+    {
+        return mSymmetric;
+    }
+
+    void AddGradient(DofVector<double>* rGradient, double deltaT) const override
+    {
+        for (TCell* cell : mCells)
+        {
+            const LocalVector local = cell->IntegrateT([&](const IpData& data) { return mGradient(data, deltaT); });
+            const Numbering numbering = LocalNumbering(*cell);
+            for (size_t iDof = 0; iDof < mDofTypes.size(); ++iDof)
+            {
+                Eigen::VectorXd& gradient = (*rGradient)[mDofTypes[iDof]];
+                for (int i = 0; i < numbering.dofNumbers[iDof].rows(); ++i)
+                    gradient[numbering.dofNumbers[iDof][i]] += local[numbering.offsets[iDof] + i];
+            }
+        }
+    }
+
+    //! @remark eMatrixStorage::UPPER is only supported for a single dof type.
+    void AddHessian0(DofMatrixSparse<double>* rHessian, double deltaT,
+                     eMatrixStorage storage = eMatrixStorage::FULL) const override
+    {
+        if (storage == eMatrixStorage::UPPER and mDofTypes.size() != 1)
+            throw Exception(__PRETTY_FUNCTION__, "The upper storage requires a batch with a single dof type.");
+
+        const int numDofTypes = mDofTypes.size();
+        std::vector<std::vector<Eigen::Triplet<double>>> triplets(numDofTypes * numDofTypes);
+        for (TCell* cell : mCells)
+        {
+            const LocalMatrix local = cell->IntegrateT([&](const IpData& data) { return mHessian0(data, deltaT); });
+            const Numbering numbering = LocalNumbering(*cell);
+            for (int iDof = 0; iDof < numDofTypes; ++iDof)
+                for (int jDof = 0; jDof < numDofTypes; ++jDof)
+                {
+                    const Eigen::VectorXi& rows = numbering.dofNumbers[iDof];
+                    const Eigen::VectorXi& cols = numbering.dofNumbers[jDof];
+                    for (int j = 0; j < cols.rows(); ++j)
+                        for (int i = 0; i < rows.rows(); ++i)
+                            if (storage == eMatrixStorage::FULL or rows[i] <= cols[j])
+                                triplets[iDof * numDofTypes + jDof].push_back(
+                                        {rows[i], cols[j],
+                                         local(numbering.offsets[iDof] + i, numbering.offsets[jDof] + j)});
+                }
+        }
+
+        for (int iDof = 0; iDof < numDofTypes; ++iDof)
+            for (int jDof = 0; jDof < numDofTypes; ++jDof)
+            {
+                Eigen::SparseMatrix<double>& hessian = (*rHessian)(mDofTypes[iDof], mDofTypes[jDof]);
+                const auto& blockTriplets = triplets[iDof * numDofTypes + jDof];
+                Eigen::SparseMatrix<double> cellHessians(hessian.rows(), hessian.cols());
+                cellHessians.setFromTriplets(blockTriplets.begin(), blockTriplets.end());
+                hessian += cellHessians;
+            }
+    }
+
+    void AddHessian0Product(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::Ref<Eigen::VectorXd> rProduct,
+                            double deltaT) const override
+    {
+        ThrowOnCoupledDofTypes(__PRETTY_FUNCTION__);
+        for (TCell* cell : mCells)
+        {
+            const LocalMatrix local = cell->IntegrateT([&](const IpData& data) { return mHessian0(data, deltaT); });
+            const Eigen::VectorXi numbering = LocalNumbering(*cell).dofNumbers.front();
+            LocalVector localX;
+            for (int i = 0; i < numbering.rows(); ++i)
+                localX[i] = x[numbering[i]];
+            const LocalVector localProduct = local * localX;
+            for (int i = 0; i < numbering.rows(); ++i)
+                rProduct[numbering[i]] += localProduct[i];
+        }
+    }
+
+    void AddHessian0Diagonal(Eigen::Ref<Eigen::VectorXd> rDiagonal, double deltaT) const override
+    {
+        ThrowOnCoupledDofTypes(__PRETTY_FUNCTION__);
+        for (TCell* cell : mCells)
+        {
+            const LocalMatrix local = cell->IntegrateT([&](const IpData& data) { return mHessian0(data, deltaT); });
+            const Eigen::VectorXi numbering = LocalNumbering(*cell).dofNumbers.front();
+            for (int i = 0; i < numbering.rows(); ++i)
+                rDiagonal[numbering[i]] += local(i, i);
+        }
+    }
+
+    void UpdateHistory(double deltaT) const override
+    {
+        if (not mUpdate)
+            return;
+        for (TCell* cell : mCells)
+            cell->ApplyT([&](const IpData& data) { mUpdate(data, deltaT); });
+    }
+
+private:
+    //! @brief dof numbers of a cell and the positions of its dof types in the local vectors
+    struct Numbering
+    {
+        std::vector<Eigen::VectorXi> dofNumbers;
+        std::vector<int> offsets;
+    };
+
+    Numbering LocalNumbering(TCell& cell) const
+    {
+        Numbering numbering;
+        int offset = 0;
+        for (DofType dof : mDofTypes)
+        {
+            numbering.dofNumbers.push_back(cell.DofNumbering(dof));
+            numbering.offsets.push_back(offset);
+            offset += numbering.dofNumbers.back().rows();
+        }
+        if (offset != LocalVector::RowsAtCompileTime)
+            throw Exception(__PRETTY_FUNCTION__, "The cell has " + std::to_string(offset) +
+                                                         " dofs, the kernels expect " +
+                                                         std::to_string(LocalVector::RowsAtCompileTime) + ".");
+        return numbering;
+    }
+
+    void ThrowOnCoupledDofTypes(std::string function) const
+    {
+        if (mDofTypes.size() != 1)
+            throw Exception(function, "The matrix-free products require a batch with a single dof type.");
+    }
+
+    std::vector<TCell*> mCells;
+    std::vector<DofType> mDofTypes;
+    TGradient mGradient;
+    THessian0 mHessian0;
+    bool mSymmetric;
+    UpdateFunction mUpdate;
+};
+
+//! @brief creates a CellTBatch and deduces the types of the kernels, see CellTBatch::CellTBatch(...)
+template <typename TCell, typename TGradient, typename THessian0>
+CellTBatch<TCell, TGradient, THessian0> MakeCellTBatch(Group<TCell> cells, std::vector<DofType> dofTypes,
+                                                       TGradient gradient, THessian0 hessian0, bool symmetric = false)
+{
+    return CellTBatch<TCell, TGradient, THessian0>(cells, dofTypes, gradient, hessian0, symmetric);
+}
+} /* NuTo */
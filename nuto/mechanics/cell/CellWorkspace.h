@@ -0,0 +1,149 @@
+#pragma once
+
+#include <deque>
+#include <Eigen/Core>
+#include "nuto/mechanics/dofs/DofType.h"
+
+namespace NuTo
+{
+
+//! @brief reusable storage of the quantities that CellIpData memoizes per dof type (N, dN/dx, B)
+//! @remark Invalidate() only marks the entries as outdated and keeps their memory. Eigen only reallocates if the size
+//! of a matrix changes, so reusing a workspace for the integration points of cells with the same element types does
+//! not allocate. References to entries stay valid, new entries are appended to a std::deque.
+class IpWorkspace
+{
+public:
+    struct Entry
+    {
+        explicit Entry(int dofId)
+            : dofId(dofId)
+        {
+        }
+
+        int dofId;
+        Eigen::MatrixXd N;
+        Eigen::MatrixXd derivativeShapeFunctionsGlobal;
+        Eigen::MatrixXd B;
+        bool hasN = false;
+        bool hasB = false;
+    };
+
+    //! @return entry of `dofType`, possibly with outdated values, see Entry::hasN, Entry::hasB
+    Entry& Get(DofType dofType)
+    {
+        for (Entry& entry : mEntries)
+            if (entry.dofId == dofType.Id())
+                return entry;
+        mEntries.emplace_back(dofType.Id());
+        return mEntries.back();
+    }
+
+    //! @brief marks all entries as outdated, e.g. for the next integration point
+    void Invalidate()
+    {
+        for (Entry& entry : mEntries)
+        {
+            entry.hasN = false;
+            entry.hasB = false;
+        }
+    }
+
+private:
+    std::deque<Entry> mEntries;
+};
+
+//! @brief reusable storage of the node values that CellData memoizes per dof type and instance
+//! @remark see IpWorkspace
+class NodeValuesWorkspace
+{
+public:
+    struct Entry
+    {
+        Entry(int dofId, int instance)
+            : dofId(dofId)
+            , instance(instance)
+        {
+        }
+
+        int dofId;
+        int instance;
+        Eigen::VectorXd values;
+        bool hasValues = false;
+    };
+
+    //! @return entry of `dofType` and `instance`, possibly with outdated values, see Entry::hasValues
+    Entry& Get(DofType dofType, int instance)
+    {
+        for (Entry& entry : mEntries)
+            if (entry.dofId == dofType.Id() and entry.instance == instance)
+                return entry;
+        mEntries.emplace_back(dofType.Id(), instance);
+        return mEntries.back();
+    }
+
+    //! @brief marks all entries as outdated, e.g. for the next cell
+    void Invalidate()
+    {
+        for (Entry& entry : mEntries)
+            entry.hasValues = false;
+    }
+
+private:
+    std::deque<Entry> mEntries;
+};
+
+//! @brief workspace for the evaluation of one cell
+struct CellWorkspace
+{
+    NodeValuesWorkspace nodeValues;
+    IpWorkspace ip;
+};
+
+//! @brief borrows a CellWorkspace from a thread local pool for the lifetime of this object
+//! @remark The workspaces are reused by all the cells evaluated by a thread. Nested evaluations, e.g. a cell that is
+//! evaluated in the integrand of another cell, borrow their own workspace from the pool.
+class ScopedCellWorkspace
+{
+public:
+    ScopedCellWorkspace()
+        : mWorkspace(Borrow())
+    {
+        mWorkspace.nodeValues.Invalidate();
+        mWorkspace.ip.Invalidate();
+    }
+
+    ~ScopedCellWorkspace()
+    {
+        --Depth();
+    }
+
+    ScopedCellWorkspace(const ScopedCellWorkspace&) = delete;
+    ScopedCellWorkspace& operator=(const ScopedCellWorkspace&) = delete;
+
+    CellWorkspace& Get()
+    {
+        return mWorkspace;
+    }
+
+private:
+    static CellWorkspace& Borrow()
+    {
+        thread_local std::deque<CellWorkspace> pool;
+        const int depth = Depth();
+        if (depth == static_cast<int>(pool.size()))
+            pool.emplace_back();
+        // only count the workspace as borrowed once nothing can throw anymore, ~ScopedCellWorkspace() gives it back
+        ++Depth();
+        return pool[depth];
+    }
+
+    static int& Depth()
+    {
+        thread_local int depth = 0;
+        return depth;
+    }
+
+    CellWorkspace& mWorkspace;
+};
+} /* NuTo */
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <Eigen/Core>
 #include "nuto/base/Exception.h"
 
@@ -11,6 +12,13 @@ namespace Nabla
 struct Interface
 {
     virtual Eigen::MatrixXd operator()(const Eigen::MatrixXd& dNdX) const = 0;
+
+    //! @brief writes the operator applied to `dNdX` into `rB`, the overrides reuse the memory of `rB` if it already
+    //! has the right size
+    virtual void Apply(const Eigen::Ref<const Eigen::MatrixXd>& dNdX, Eigen::MatrixXd* rB) const
+    {
+        *rB = (*this)(dNdX);
+    }
 };
 
 struct Gradient : Interface
@@ -19,21 +27,35 @@ struct Gradient : Interface
     {
         return dNdX.transpose();
     }
+
+    void Apply(const Eigen::Ref<const Eigen::MatrixXd>& dNdX, Eigen::MatrixXd* rB) const override
+    {
+        *rB = dNdX.transpose();
+    }
 };
 
 struct Strain : Interface
 {
     Eigen::MatrixXd operator()(const Eigen::MatrixXd& dNdX) const override
+    {
+        Eigen::MatrixXd B;
+        Apply(dNdX, &B);
+        return B;
+    }
+
+    void Apply(const Eigen::Ref<const Eigen::MatrixXd>& dNdX, Eigen::MatrixXd* rB) const override
     {
         const int dim = dNdX.cols();
         const int numNodes = dNdX.rows();
+        Eigen::MatrixXd& B = *rB;
         switch (dim)
         {
         case 1:
-            return dNdX.transpose();
+            B = dNdX.transpose();
+            return;
         case 2:
         {
-            Eigen::MatrixXd B = Eigen::MatrixXd::Zero(3, numNodes * 2);
+            B.setZero(3, numNodes * 2);
             for (int iNode = 0, iColumn = 0; iNode < numNodes; ++iNode, iColumn += 2)
             {
                 double dNdXx = dNdX(iNode, 0);
@@ -44,11 +66,11 @@ struct Strain : Interface
                 B(2, iColumn) = dNdXy;
                 B(2, iColumn + 1) = dNdXx;
             }
-            return B;
+            return;
         }
         case 3:
         {
-            Eigen::MatrixXd B = Eigen::MatrixXd::Zero(6, numNodes * 3);
+            B.setZero(6, numNodes * 3);
             for (int iNode = 0, iColumn = 0; iNode < numNodes; ++iNode, iColumn += 3)
             {
                 double dNdXx = dNdX(iNode, 0);
@@ -82,12 +104,44 @@ struct Strain : Interface
                 B(5, iColumn) = dNdXy;
                 B(5, iColumn + 1) = dNdXx;
             }
-            return B;
+            return;
         }
         default:
             throw Exception(__PRETTY_FUNCTION__, "c'mon.");
         }
     }
 };
+
+//! @brief nonzero entries of the engineering strain operator, one entry {voigtRow, component, derivative} per node,
+//! same layout as Nabla::Strain
+template <int TDim>
+struct StrainPattern;
+
+template <>
+struct StrainPattern<1>
+{
+    static std::array<std::array<int, 3>, 1> Entries()
+    {
+        return {{{0, 0, 0}}};
+    }
+};
+
+template <>
+struct StrainPattern<2>
+{
+    static std::array<std::array<int, 3>, 4> Entries()
+    {
+        return {{{0, 0, 0}, {1, 1, 1}, {2, 0, 1}, {2, 1, 0}}};
+    }
+};
+
+template <>
+struct StrainPattern<3>
+{
+    static std::array<std::array<int, 3>, 9> Entries()
+    {
+        return {{{0, 0, 0}, {1, 1, 1}, {2, 2, 2}, {3, 1, 2}, {3, 2, 1}, {4, 0, 2}, {4, 2, 0}, {5, 0, 1}, {5, 1, 0}}};
+    }
+};
 } /* B */
 } /* NuTo */
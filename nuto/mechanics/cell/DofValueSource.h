@@ -0,0 +1,129 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "nuto/base/Exception.h"
+#include "nuto/mechanics/dofs/DofVector.h"
+#include "nuto/mechanics/elements/ElementCollection.h"
+
+namespace NuTo
+{
+
+//! @brief global dof values that the cells read their node values from, instead of the values stored at the nodes
+//! @remark While a DofVector is bound, CellData gathers the node values of the bound dof types directly from it via the
+//! dof numbers of the elements. So there is no need to write the whole vector to the nodes first (NodalValueMerger).
+//! The values stored at the nodes are still used for the unbound dof types, the dof instances > 0, the coordinates and
+//! all evaluations outside of a binding, e.g. the output.
+class DofValueSource
+{
+public:
+    //! @brief binds `values` of the `dofs`, see ScopedDofValueBinding
+    //! @param values independent and dependent dof values, have to outlive the binding
+    void Bind(const DofVector<double>& values, std::vector<DofType> dofs)
+    {
+        Unbind();
+        for (DofType dof : dofs)
+            mValues[dof] = values[dof].data();
+    }
+
+    void Unbind()
+    {
+        mValues = DofContainer<const double*>();
+    }
+
+    //! @return values of `dof` indexed by dof number, nullptr if `dof` is not bound
+    const double* Values(DofType dof) const
+    {
+        return mValues.Has(dof) ? mValues[dof] : nullptr;
+    }
+
+    //! @brief marks the dof numbers memoized by the cells as outdated, call this after each renumbering
+    void InvalidateNumbering()
+    {
+        ++mNumberingStamp;
+    }
+
+    int NumberingStamp() const
+    {
+        return mNumberingStamp;
+    }
+
+private:
+    DofContainer<const double*> mValues;
+    int mNumberingStamp = 0;
+};
+
+//! @brief binds dof values to a DofValueSource for the lifetime of this object
+class ScopedDofValueBinding
+{
+public:
+    //! @param rSource source to bind to, nullptr does nothing
+    ScopedDofValueBinding(DofValueSource* rSource, const DofVector<double>& values, std::vector<DofType> dofs)
+        : mSource(rSource)
+    {
+        if (mSource)
+            mSource->Bind(values, dofs);
+    }
+
+    ~ScopedDofValueBinding()
+    {
+        if (mSource)
+            mSource->Unbind();
+    }
+
+    ScopedDofValueBinding(const ScopedDofValueBinding&) = delete;
+    ScopedDofValueBinding& operator=(const ScopedDofValueBinding&) = delete;
+
+private:
+    DofValueSource* mSource;
+};
+
+//! @brief the dof value source of one cell along with the memoized dof numbers (element dof index arrays) of its
+//! elements
+//! @remark The dof numbers are memoized on first use and recalculated after DofValueSource::InvalidateNumbering().
+//! Like the rest of the cell, this must not be used by multiple threads at once.
+class CellDofValues
+{
+public:
+    CellDofValues(std::shared_ptr<const DofValueSource> source, const ElementCollection& elements)
+        : mSource(std::move(source))
+        , mElements(elements)
+    {
+    }
+
+    //! @brief gathers the node values of `dof` from the bound dof values
+    //! @param rValues node values in the order of ElementInterface::ExtractNodeValues()
+    //! @return false if `dof` is not bound
+    bool Gather(DofType dof, Eigen::VectorXd* rValues) const
+    {
+        const double* values = mSource->Values(dof);
+        if (values == nullptr)
+            return false;
+
+        const Eigen::VectorXi& numbering = Numbering(dof);
+        rValues->resize(numbering.rows());
+        for (int i = 0; i < numbering.rows(); ++i)
+            (*rValues)[i] = values[numbering[i]];
+        return true;
+    }
+
+private:
+    const Eigen::VectorXi& Numbering(DofType dof) const
+    {
+        if (mStamp != mSource->NumberingStamp())
+        {
+            mNumbering = DofContainer<Eigen::VectorXi>();
+            mStamp = mSource->NumberingStamp();
+        }
+        if (not mNumbering.Has(dof))
+            mNumbering[dof] = mElements.DofElement(dof).GetDofNumbering();
+        return mNumbering[dof];
+    }
+
+    std::shared_ptr<const DofValueSource> mSource;
+    const ElementCollection& mElements;
+
+    mutable DofContainer<Eigen::VectorXi> mNumbering;
+    mutable int mStamp = -1;
+};
+} /* NuTo */
@@ -13,7 +13,7 @@ public:
     using Dynamic3by3 = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor, 3, 3>;
     using Dynamic3by1 = Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::ColMajor, 3, 1>;
 
-    Jacobian(const Eigen::VectorXd& nodeValues, const Eigen::MatrixXd& derivativeShapeFunctions)
+    Jacobian(const Eigen::VectorXd& nodeValues, const Eigen::Ref<const Eigen::MatrixXd>& derivativeShapeFunctions)
     {
         const int interpolationDimension = derivativeShapeFunctions.cols();
         const int numNodes = derivativeShapeFunctions.rows();
@@ -97,7 +97,7 @@ public:
         }
     }
 
-    Eigen::MatrixXd TransformDerivativeShapeFunctions(const Eigen::MatrixXd& global) const
+    Eigen::MatrixXd TransformDerivativeShapeFunctions(const Eigen::Ref<const Eigen::MatrixXd>& global) const
     {
         return global * Inv();
     }
@@ -129,12 +129,13 @@ public:
 
 private:
     template <int TSpaceDim, int TLocalDim>
-    Eigen::Matrix<double, TSpaceDim, TLocalDim> CalculateFixedSize(Eigen::VectorXd nodeValues,
-                                                                   const Eigen::MatrixXd& derivativeShapeFunctions)
+    Eigen::Matrix<double, TSpaceDim, TLocalDim>
+    CalculateFixedSize(const Eigen::VectorXd& nodeValues,
+                       const Eigen::Ref<const Eigen::MatrixXd>& derivativeShapeFunctions)
     {
         const int numShapes = derivativeShapeFunctions.rows();
-        auto nodeBlockCoordinates =
-                Eigen::Map<Eigen::Matrix<double, TSpaceDim, Eigen::Dynamic>>(nodeValues.data(), TSpaceDim, numShapes);
+        auto nodeBlockCoordinates = Eigen::Map<const Eigen::Matrix<double, TSpaceDim, Eigen::Dynamic>>(
+                nodeValues.data(), TSpaceDim, numShapes);
         // This mapping converts a vector
         // (x0 y0 z0 x1 y1 z1 x2 y2 z3 ...)^T
         // to the matrix
@@ -5,11 +5,19 @@ namespace NuTo
 {
 namespace Matrix
 {
-inline Eigen::MatrixXd N(const Eigen::VectorXd& shapeFunctions, int numNodes, int dim)
+//! @brief writes the N matrix into `rN`, reuses its memory if it already has the right size
+inline void N(const Eigen::Ref<const Eigen::VectorXd>& shapeFunctions, int numNodes, int dim, Eigen::MatrixXd* rN)
 {
-    Eigen::MatrixXd n(dim, dim * numNodes);
+    rN->setZero(dim, dim * numNodes);
     for (int i = 0; i < numNodes; ++i)
-        n.block(0, i * dim, dim, dim) = Eigen::MatrixXd::Identity(dim, dim) * shapeFunctions[i];
+        for (int d = 0; d < dim; ++d)
+            (*rN)(d, i * dim + d) = shapeFunctions[i];
+}
+
+inline Eigen::MatrixXd N(const Eigen::Ref<const Eigen::VectorXd>& shapeFunctions, int numNodes, int dim)
+{
+    Eigen::MatrixXd n;
+    N(shapeFunctions, numNodes, dim, &n);
     return n;
 }
 } /*Matrix */
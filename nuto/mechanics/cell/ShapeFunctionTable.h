@@ -0,0 +1,148 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include "nuto/mechanics/dofs/DofContainer.h"
+#include "nuto/mechanics/elements/ElementCollection.h"
+#include "nuto/mechanics/integrationtypes/IntegrationTypeBase.h"
+
+namespace NuTo
+{
+
+//! @brief shape functions N and their derivatives dN/dxi of an interpolation at all the integration points of an
+//! integration type, along with the natural coordinates of the integration points
+//! @remark The values of all integration points are stored contiguously, the accessors return views without copies.
+class ShapeFunctionTable
+{
+public:
+    ShapeFunctionTable(const InterpolationSimple& interpolation, const IntegrationTypeBase& integrationType)
+    {
+        const int numIps = integrationType.GetNumIntegrationPoints();
+        for (int iIP = 0; iIP < numIps; ++iIP)
+        {
+            const Eigen::VectorXd ipCoords = integrationType.GetLocalIntegrationPointCoordinates(iIP);
+            const Eigen::VectorXd N = interpolation.GetShapeFunctions(ipCoords);
+            const Eigen::MatrixXd dNdXi = interpolation.GetDerivativeShapeFunctions(ipCoords);
+            if (iIP == 0)
+            {
+                mDim = dNdXi.cols();
+                mIntegrationPointCoordinates.resize(ipCoords.rows(), numIps);
+                mShapeFunctions.resize(N.rows(), numIps);
+                mDerivativeShapeFunctions.resize(dNdXi.rows(), mDim * numIps);
+            }
+            mIntegrationPointCoordinates.col(iIP) = ipCoords;
+            mShapeFunctions.col(iIP) = N;
+            mDerivativeShapeFunctions.middleCols(iIP * mDim, mDim) = dNdXi;
+        }
+    }
+
+    //! @return natural coordinates of the integration point `iIP`
+    Eigen::MatrixXd::ConstColXpr IntegrationPointCoordinates(int iIP) const
+    {
+        return mIntegrationPointCoordinates.col(iIP);
+    }
+
+    //! @return shape functions N at the integration point `iIP`
+    Eigen::MatrixXd::ConstColXpr ShapeFunctions(int iIP) const
+    {
+        return mShapeFunctions.col(iIP);
+    }
+
+    //! @return derivatives of the shape functions with respect to the natural coordinates at the integration point
+    //! `iIP`, one row per node
+    Eigen::Block<const Eigen::MatrixXd, Eigen::Dynamic, Eigen::Dynamic, true> DerivativeShapeFunctions(int iIP) const
+    {
+        return mDerivativeShapeFunctions.middleCols(iIP * mDim, mDim);
+    }
+
+    int GetNumIntegrationPoints() const
+    {
+        return mShapeFunctions.cols();
+    }
+
+private:
+    int mDim = 0;
+    Eigen::MatrixXd mIntegrationPointCoordinates;
+    Eigen::MatrixXd mShapeFunctions;
+    Eigen::MatrixXd mDerivativeShapeFunctions;
+};
+
+//! @brief registry that shares one ShapeFunctionTable per (interpolation, integration type) pair among all cells
+//! @remark thread-safe. The tables are identified by the addresses of the interpolation and the integration type,
+//! both have to outlive the registry.
+class ShapeFunctionTables
+{
+public:
+    //! @return table of the interpolation of `element` at the integration points of `integrationType`, nullptr for
+    //! elements without a shared interpolation, e.g. ElementIga
+    const ShapeFunctionTable* Get(const ElementInterface& element, const IntegrationTypeBase& integrationType)
+    {
+        const auto* elementFem = dynamic_cast<const ElementFem*>(&element);
+        if (elementFem == nullptr)
+            return nullptr;
+
+        const auto key = std::make_pair(&elementFem->Interpolation(), &integrationType);
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto& table = mTables[key];
+        if (table == nullptr)
+            table = std::make_unique<ShapeFunctionTable>(elementFem->Interpolation(), integrationType);
+        return table.get();
+    }
+
+    //! @return number of distinct tables
+    size_t Size() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mTables.size();
+    }
+
+private:
+    mutable std::mutex mMutex;
+    std::map<std::pair<const InterpolationSimple*, const IntegrationTypeBase*>, std::unique_ptr<ShapeFunctionTable>>
+            mTables;
+};
+
+//! @brief the shape function tables of the elements of one cell, looked up in the registry once per element
+//! @remark The lookups are memoized on first use. Like the rest of the cell, this must not be used by multiple threads
+//! at once.
+class CellShapeFunctionTables
+{
+public:
+    CellShapeFunctionTables(ShapeFunctionTables& registry, const ElementCollection& elements,
+                            const IntegrationTypeBase& integrationType)
+        : mRegistry(registry)
+        , mElements(elements)
+        , mIntegrationType(integrationType)
+    {
+    }
+
+    //! @return table of the coordinate element, nullptr if there is none
+    const ShapeFunctionTable* Coordinates() const
+    {
+        if (not mCoordinatesResolved)
+        {
+            mCoordinates = mRegistry.Get(mElements.CoordinateElement(), mIntegrationType);
+            mCoordinatesResolved = true;
+        }
+        return mCoordinates;
+    }
+
+    //! @return table of the dof element of `dof`, nullptr if there is none
+    const ShapeFunctionTable* Dof(DofType dof) const
+    {
+        if (not mDofs.Has(dof))
+            mDofs[dof] = mRegistry.Get(mElements.DofElement(dof), mIntegrationType);
+        return mDofs[dof];
+    }
+
+private:
+    ShapeFunctionTables& mRegistry;
+    const ElementCollection& mElements;
+    const IntegrationTypeBase& mIntegrationType;
+
+    mutable const ShapeFunctionTable* mCoordinates = nullptr;
+    mutable bool mCoordinatesResolved = false;
+    mutable DofContainer<const ShapeFunctionTable*> mDofs;
+};
+} /* NuTo */
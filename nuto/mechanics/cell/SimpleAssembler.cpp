@@ -1,5 +1,8 @@
 #include "nuto/mechanics/cell/SimpleAssembler.h"
 #include "nuto/base/Exception.h"
+#include "nuto/mechanics/cell/Cell.h"
+#include <algorithm>
+#include <exception>
 
 using namespace NuTo;
 
@@ -35,6 +38,93 @@ std::vector<DofType> DofIntersection(std::vector<DofType> one, std::vector<DofTy
     return intersection;
 }
 
+namespace
+{
+
+//! @return true if the block (dofI, dofJ) is part of a matrix with the `storage` scheme w.r.t. `dofTypes`
+bool IsBlockStored(eMatrixStorage storage, const std::vector<DofType>& dofTypes, DofType dofI, DofType dofJ)
+{
+    if (storage == eMatrixStorage::FULL)
+        return true;
+    auto position = [&](DofType dof) {
+        return std::find_if(dofTypes.begin(), dofTypes.end(), [&](DofType d) { return d.Id() == dof.Id(); });
+    };
+    return position(dofI) <= position(dofJ);
+}
+
+//! @brief pointers to the data of the entries `dofTypes` of `rVector`
+//! @remark Multiple threads can write to different coefficients via these pointers. Accessing the underlying map of
+//! the DofVector via its non-const methods is not guaranteed to be thread-safe.
+DofContainer<double*> DataPtrs(DofVector<double>* rVector, const std::vector<DofType>& dofTypes)
+{
+    DofContainer<double*> dataPtrs;
+    for (DofType dof : dofTypes)
+        dataPtrs[dof] = (*rVector)[dof].data();
+    return dataPtrs;
+}
+
+//! @brief pointers to the data of the entries `dofTypes` of `rVector`, see DataPtrs(DofVector<double>*, ...)
+DofContainer<double*> DataPtrs(ContiguousDofVector<double>* rVector, const std::vector<DofType>& dofTypes)
+{
+    DofContainer<double*> dataPtrs;
+    for (DofType dof : dofTypes)
+        dataPtrs[dof] = (*rVector)[dof].data();
+    return dataPtrs;
+}
+
+//! @brief read only pointers to the data of the entries `dofTypes` of `v`
+template <typename TDofVector>
+DofContainer<const double*> ConstDataPtrs(const TDofVector& v, const std::vector<DofType>& dofTypes)
+{
+    DofContainer<const double*> dataPtrs;
+    for (DofType dof : dofTypes)
+        dataPtrs[dof] = v[dof].data();
+    return dataPtrs;
+}
+
+//! @brief adds the local vector `cellGradient` of `cell` to the vector with the data pointers `data`
+void ScatterCellVector(const DofContainer<double*>& data, CellInterface& cell, const std::vector<DofType>& dofTypes,
+                       const DofVector<double>& cellGradient)
+{
+    for (DofType dof : DofIntersection(cellGradient.DofTypes(), dofTypes))
+    {
+        Eigen::VectorXi numberingDof = cell.DofNumbering(dof);
+        const Eigen::VectorXd& cellGradientDof = cellGradient[dof];
+        double* dataDof = data[dof];
+        for (int i = 0; i < numberingDof.rows(); ++i)
+            dataDof[numberingDof[i]] += cellGradientDof[i];
+    }
+}
+
+//! @brief integrates f on `cell` and adds the result to the vector with the data pointers `data`
+void AddCellVector(const DofContainer<double*>& data, CellInterface& cell, const std::vector<DofType>& dofTypes,
+                   const CellInterface::VectorFunction& f)
+{
+    ScatterCellVector(data, cell, dofTypes, cell.Integrate(f));
+}
+
+//! @brief integrates f on `cell`, lumps the result and adds it to the vector with the data pointers `data`
+void AddCellLumpedMatrix(const DofContainer<double*>& data, CellInterface& cell, const std::vector<DofType>& dofTypes,
+                         const CellInterface::MatrixFunction& f)
+{
+    const DofMatrix<double> localMatrix = cell.Integrate(f);
+
+    for (DofType dof : DofIntersection(localMatrix.DofTypes(), dofTypes))
+    {
+        Eigen::VectorXd localDiagonalDof = localMatrix(dof, dof).diagonal();
+        double diagonalSum = localDiagonalDof.sum();
+        double fullSum = localMatrix(dof, dof).sum();
+        localDiagonalDof *= (fullSum / diagonalSum) / dof.GetNum();
+
+        Eigen::VectorXi numberingDof = cell.DofNumbering(dof);
+        double* dataDof = data[dof];
+
+        for (int i = 0; i < numberingDof.rows(); ++i)
+            dataDof[numberingDof[i]] += localDiagonalDof[i];
+    }
+}
+} // namespace
+
 DofVector<double> SimpleAssembler::BuildVector(const Group<CellInterface>& cells, std::vector<DofType> dofTypes,
                                                CellInterface::VectorFunction f) const
 {
@@ -45,21 +135,152 @@ DofVector<double> SimpleAssembler::BuildVector(const Group<CellInterface>& cells
 #pragma omp parallel
     {
         DofVector<double> threadlocalgradient = ProperlyResizedVector(dofTypes);
+        const DofContainer<double*> threadlocalData = DataPtrs(&threadlocalgradient, dofTypes);
 #pragma omp for nowait
         for (auto cellit = cells.begin(); cellit < cells.end(); cellit++)
+            AddCellVector(threadlocalData, *cellit, dofTypes, f);
+#pragma omp critical
+        gradient += threadlocalgradient;
+    }
+    return gradient;
+}
+
+DofVector<double> SimpleAssembler::BuildVector(const Group<CellInterface>& cells, std::vector<DofType> dofTypes,
+                                               CellInterface::VectorFunction f, const Coloring& coloring) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    DofVector<double> gradient = ProperlyResizedVector(dofTypes);
+    const DofContainer<double*> data = DataPtrs(&gradient, dofTypes);
+
+    for (const std::vector<int>& color : coloring)
+    {
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(color.size()); ++i)
+            AddCellVector(data, cells.begin()[color[i]], dofTypes, f);
+    }
+    return gradient;
+}
+
+namespace
+{
+
+//! @brief greedy first fit coloring of the cells, see SimpleAssembler::BuildColoring(...)
+//! @param forEachCell calls its argument for each cell to be colored, in the order of the cell indices
+template <typename TForEachCell>
+SimpleAssembler::Coloring GreedyColoring(TForEachCell forEachCell, const DofInfo& dofInfo,
+                                         const std::vector<DofType>& dofTypes)
+{
+    // The dof numbers of all dof types are merged into a single range of keys.
+    DofContainer<int> keyOffsets;
+    int numKeys = 0;
+    for (DofType dof : dofTypes)
+    {
+        keyOffsets[dof] = numKeys;
+        numKeys += dofInfo.numIndependentDofs[dof] + dofInfo.numDependentDofs[dof];
+    }
+
+    // keyColors[key] are the colors of all the cells that were already colored and contain `key`
+    std::vector<std::vector<int>> keyColors(numKeys);
+    // blockedBy[color] == iCell marks a color as not available for the cell iCell
+    std::vector<int> blockedBy;
+    SimpleAssembler::Coloring coloring;
+
+    int iCell = 0;
+    forEachCell([&](CellInterface& cell) {
+        std::vector<int> keys;
+        for (DofType dof : dofTypes)
         {
-            const DofVector<double> cellGradient = cellit->Integrate(f);
+            if (not cell.Has(dof))
+                continue;
+            Eigen::VectorXi numberingDof = cell.DofNumbering(dof);
+            for (int i = 0; i < numberingDof.rows(); ++i)
+                keys.push_back(keyOffsets[dof] + numberingDof[i]);
+        }
 
-            for (DofType dof : DofIntersection(cellGradient.DofTypes(), dofTypes))
-            {
-                Eigen::VectorXi numberingDof = cellit->DofNumbering(dof);
-                const Eigen::VectorXd& cellGradientDof = cellGradient[dof];
-                for (int i = 0; i < numberingDof.rows(); ++i)
-                    threadlocalgradient[dof](numberingDof[i]) += cellGradientDof[i];
-            }
+        for (int key : keys)
+            for (int color : keyColors[key])
+                blockedBy[color] = iCell;
+
+        // first fit: lowest available color or a new one
+        size_t color = 0;
+        while (color < blockedBy.size() and blockedBy[color] == iCell)
+            ++color;
+        if (color == blockedBy.size())
+        {
+            blockedBy.push_back(-1);
+            coloring.emplace_back();
         }
-#pragma omp critical
-        gradient += threadlocalgradient;
+
+        coloring[color].push_back(iCell);
+        for (int key : keys)
+            keyColors[key].push_back(color);
+        ++iCell;
+    });
+    return coloring;
+}
+
+//! @return start indices of the `ranges` in the concatenation of their cells
+std::vector<int> RangeOffsets(const std::vector<CellRange>& ranges)
+{
+    std::vector<int> offsets;
+    int offset = 0;
+    for (const CellRange& range : ranges)
+    {
+        offsets.push_back(offset);
+        offset += range.Size();
+    }
+    return offsets;
+}
+
+//! @return cell with the index `iCell` in the concatenation of the cells of `ranges`
+//! @param offsets RangeOffsets(ranges)
+Cell& CellAt(const std::vector<CellRange>& ranges, const std::vector<int>& offsets, int iCell)
+{
+    const size_t iRange = std::upper_bound(offsets.begin(), offsets.end(), iCell) - offsets.begin() - 1;
+    return ranges[iRange][iCell - offsets[iRange]];
+}
+} // namespace
+
+SimpleAssembler::Coloring SimpleAssembler::BuildColoring(const Group<CellInterface>& cells,
+                                                         std::vector<DofType> dofTypes) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+    return GreedyColoring(
+            [&](auto colorCell) {
+                for (auto& cell : cells)
+                    colorCell(cell);
+            },
+            mDofInfo, dofTypes);
+}
+
+SimpleAssembler::Coloring SimpleAssembler::BuildColoring(const std::vector<CellRange>& ranges,
+                                                         std::vector<DofType> dofTypes) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+    return GreedyColoring(
+            [&](auto colorCell) {
+                for (const CellRange& range : ranges)
+                    for (Cell& cell : range)
+                        colorCell(cell);
+            },
+            mDofInfo, dofTypes);
+}
+
+DofVector<double> SimpleAssembler::BuildVector(const std::vector<CellRange>& ranges, std::vector<DofType> dofTypes,
+                                               CellInterface::VectorFunction f, const Coloring& coloring) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    DofVector<double> gradient = ProperlyResizedVector(dofTypes);
+    const DofContainer<double*> data = DataPtrs(&gradient, dofTypes);
+    const std::vector<int> offsets = RangeOffsets(ranges);
+
+    for (const std::vector<int>& color : coloring)
+    {
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(color.size()); ++i)
+            AddCellVector(data, CellAt(ranges, offsets, color[i]), dofTypes, f);
     }
     return gradient;
 }
@@ -73,36 +294,99 @@ DofVector<double> SimpleAssembler::BuildDiagonallyLumpedMatrix(const Group<CellI
 #pragma omp parallel
     {
         DofVector<double> threadlocallumpedMatrix = ProperlyResizedVector(dofTypes);
+        const DofContainer<double*> threadlocalData = DataPtrs(&threadlocallumpedMatrix, dofTypes);
 #pragma omp for nowait
         for (auto cellit = cells.begin(); cellit < cells.end(); cellit++)
+            AddCellLumpedMatrix(threadlocalData, *cellit, dofTypes, f);
+#pragma omp critical
+        lumpedMatrix += threadlocallumpedMatrix;
+    }
+    return lumpedMatrix;
+}
+
+DofVector<double> SimpleAssembler::BuildDiagonallyLumpedMatrix(const Group<CellInterface>& cells,
+                                                               std::vector<DofType> dofTypes,
+                                                               CellInterface::MatrixFunction f,
+                                                               const Coloring& coloring) const
+{
+    DofVector<double> lumpedMatrix = ProperlyResizedVector(dofTypes);
+    const DofContainer<double*> data = DataPtrs(&lumpedMatrix, dofTypes);
+
+    for (const std::vector<int>& color : coloring)
+    {
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(color.size()); ++i)
+            AddCellLumpedMatrix(data, cells.begin()[color[i]], dofTypes, f);
+    }
+    return lumpedMatrix;
+}
+
+namespace
+{
+
+using TripletList = std::list<Eigen::Triplet<double>>;
+
+//! @brief integrates f on `cell` and adds the entries of the local matrix to `rTriplets`
+void AddCellTriplets(DofMatrixContainer<TripletList>* rTriplets, CellInterface& cell,
+                     const std::vector<DofType>& dofTypes, const CellInterface::MatrixFunction& f,
+                     eMatrixStorage storage)
+{
+    const DofMatrix<double> cellHessian = cell.Integrate(f);
+    auto dofTypesToAssemble = DofIntersection(cellHessian.DofTypes(), dofTypes);
+
+    for (DofType dofI : dofTypesToAssemble)
+    {
+        Eigen::VectorXi numberingDofI = cell.DofNumbering(dofI);
+        for (DofType dofJ : dofTypesToAssemble)
         {
-            const DofMatrix<double> localMatrix = cellit->Integrate(f);
+            if (not IsBlockStored(storage, dofTypes, dofI, dofJ))
+                continue;
+            const bool onlyUpper = storage == eMatrixStorage::UPPER and dofI.Id() == dofJ.Id();
 
-            for (DofType dof : DofIntersection(localMatrix.DofTypes(), dofTypes))
-            {
-                Eigen::VectorXd localDiagonalDof = localMatrix(dof, dof).diagonal();
-                double diagonalSum = localDiagonalDof.sum();
-                double fullSum = localMatrix(dof, dof).sum();
-                localDiagonalDof *= (fullSum / diagonalSum) / dof.GetNum();
+            Eigen::VectorXi numberingDofJ = cell.DofNumbering(dofJ);
+            const Eigen::MatrixXd& cellHessianDof = cellHessian(dofI, dofJ);
 
-                Eigen::VectorXi numberingDof = cellit->DofNumbering(dof);
+            for (int i = 0; i < numberingDofI.rows(); ++i)
+            {
+                for (int j = 0; j < numberingDofJ.rows(); ++j)
+                {
+                    const int globalDofNumberI = numberingDofI[i];
+                    const int globalDofNumberJ = numberingDofJ[j];
+                    if (onlyUpper and globalDofNumberI > globalDofNumberJ)
+                        continue;
+                    const double globalDofValue = cellHessianDof(i, j);
 
-                for (int i = 0; i < numberingDof.rows(); ++i)
-                    threadlocallumpedMatrix[dof](numberingDof[i]) += localDiagonalDof[i];
+                    (*rTriplets)(dofI, dofJ).push_back({globalDofNumberI, globalDofNumberJ, globalDofValue});
+                }
             }
         }
-#pragma omp critical
-        lumpedMatrix += threadlocallumpedMatrix;
     }
-    return lumpedMatrix;
 }
 
+//! @brief moves the triplets of `rSource` to the end of the triplets of `rTarget`
+void SpliceTriplets(DofMatrixContainer<TripletList>* rTarget, DofMatrixContainer<TripletList>* rSource,
+                    const std::vector<DofType>& dofTypes)
+{
+    for (DofType dofI : dofTypes)
+        for (DofType dofJ : dofTypes)
+            (*rTarget)(dofI, dofJ).splice((*rTarget)(dofI, dofJ).end(), (*rSource)(dofI, dofJ));
+}
+
+//! @brief sets the blocks of `rMatrix` from the `rTriplets`
+void SetFromTriplets(DofMatrixSparse<double>* rMatrix, DofMatrixContainer<TripletList>* rTriplets,
+                     const std::vector<DofType>& dofTypes)
+{
+    for (DofType dofI : dofTypes)
+        for (DofType dofJ : dofTypes)
+            (*rMatrix)(dofI, dofJ).setFromTriplets((*rTriplets)(dofI, dofJ).begin(), (*rTriplets)(dofI, dofJ).end());
+}
+} // namespace
+
 DofMatrixSparse<double> SimpleAssembler::BuildMatrix(const Group<CellInterface>& cells, std::vector<DofType> dofTypes,
-                                                     CellInterface::MatrixFunction f) const
+                                                     CellInterface::MatrixFunction f, eMatrixStorage storage) const
 {
     ThrowOnZeroDofNumbering(dofTypes);
 
-    using TripletList = std::list<Eigen::Triplet<double>>;
     DofMatrixContainer<TripletList> triplets;
 
 #pragma omp parallel
@@ -111,48 +395,666 @@ DofMatrixSparse<double> SimpleAssembler::BuildMatrix(const Group<CellInterface>&
 
 #pragma omp for nowait
         for (auto cellit = cells.begin(); cellit < cells.end(); cellit++)
+            AddCellTriplets(&localtriplets, *cellit, dofTypes, f, storage);
+#pragma omp critical
+        SpliceTriplets(&triplets, &localtriplets, dofTypes);
+    }
+    DofMatrixSparse<double> hessian = ProperlyResizedMatrix(dofTypes);
+    SetFromTriplets(&hessian, &triplets, dofTypes);
+    return hessian;
+}
+
+DofMatrixSparse<double> SimpleAssembler::BuildMatrix(const std::vector<CellRange>& ranges,
+                                                     std::vector<DofType> dofTypes, CellInterface::MatrixFunction f,
+                                                     eMatrixStorage storage) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    DofMatrixContainer<TripletList> triplets;
+
+#pragma omp parallel
+    {
+        DofMatrixContainer<TripletList> localtriplets;
+
+#pragma omp for schedule(dynamic) nowait
+        for (int iRange = 0; iRange < static_cast<int>(ranges.size()); ++iRange)
+            for (Cell& cell : ranges[iRange])
+                AddCellTriplets(&localtriplets, cell, dofTypes, f, storage);
+#pragma omp critical
+        SpliceTriplets(&triplets, &localtriplets, dofTypes);
+    }
+    DofMatrixSparse<double> hessian = ProperlyResizedMatrix(dofTypes);
+    SetFromTriplets(&hessian, &triplets, dofTypes);
+    return hessian;
+}
+
+namespace
+{
+
+//! @brief finds the positions of the entries (numberingI[i], numberingJ[j]) in the value array of `m`
+//! @param onlyUpper `m` stores only its upper triangle, the offsets of the entries below the diagonal are -1
+std::vector<int> ValueOffsets(const Eigen::SparseMatrix<double>& m, const Eigen::VectorXi& numberingI,
+                              const Eigen::VectorXi& numberingJ, bool onlyUpper)
+{
+    std::vector<int> offsets(numberingI.rows() * numberingJ.rows());
+    const int* innerIndices = m.innerIndexPtr();
+    for (int j = 0; j < numberingJ.rows(); ++j)
+    {
+        const int* columnBegin = innerIndices + m.outerIndexPtr()[numberingJ[j]];
+        const int* columnEnd = innerIndices + m.outerIndexPtr()[numberingJ[j] + 1];
+        for (int i = 0; i < numberingI.rows(); ++i)
         {
-            const DofMatrix<double> cellHessian = cellit->Integrate(f);
-            auto dofTypesToAssemble = DofIntersection(cellHessian.DofTypes(), dofTypes);
+            if (onlyUpper and numberingI[i] > numberingJ[j])
+            {
+                offsets[i + j * numberingI.rows()] = -1;
+                continue;
+            }
+            const int* entry = std::lower_bound(columnBegin, columnEnd, numberingI[i]);
+            if (entry == columnEnd or *entry != numberingI[i])
+                throw Exception(__PRETTY_FUNCTION__, "The entry (" + std::to_string(numberingI[i]) + ", " +
+                                                             std::to_string(numberingJ[j]) +
+                                                             ") is not part of the nonzero pattern.");
+            offsets[i + j * numberingI.rows()] = entry - innerIndices;
+        }
+    }
+    return offsets;
+}
 
-            for (DofType dofI : dofTypesToAssemble)
+//! @brief compresses the blocks `dofTypes` x `dofTypes` of `rMatrix` and returns pointers to their value arrays
+DofMatrixContainer<double*> ValuePtrs(DofMatrixSparse<double>* rMatrix, const std::vector<DofType>& dofTypes)
+{
+    DofMatrixContainer<double*> valuePtrs;
+    for (DofType dofI : dofTypes)
+        for (DofType dofJ : dofTypes)
+        {
+            (*rMatrix)(dofI, dofJ).makeCompressed();
+            valuePtrs(dofI, dofJ) = (*rMatrix)(dofI, dofJ).valuePtr();
+        }
+    return valuePtrs;
+}
+
+//! @brief adds the local matrix `cellHessian` of `cell` to the values of `matrix`
+//! @tparam TAtomic use atomic additions, required if other threads may write to the same entries concurrently
+//! @param values value pointers of `matrix`, the structure of `matrix` is only accessed via const methods
+//! @param rCellOffsets scatter map of `cell`, computed if empty
+//! @param storage storage scheme of `matrix`
+template <bool TAtomic>
+void ScatterCellMatrix(const DofMatrixContainer<double*>& values, const DofMatrixSparse<double>& matrix,
+                       CellInterface& cell, DofMatrixContainer<std::vector<int>>* rCellOffsets,
+                       const std::vector<DofType>& dofTypes, const DofMatrix<double>& cellHessian,
+                       eMatrixStorage storage)
+{
+    auto dofTypesToAssemble = DofIntersection(cellHessian.DofTypes(), dofTypes);
+
+    for (DofType dofI : dofTypesToAssemble)
+    {
+        for (DofType dofJ : dofTypesToAssemble)
+        {
+            if (not IsBlockStored(storage, dofTypes, dofI, dofJ))
+                continue;
+
+            // each cell is visited by exactly one thread, the lazy initialization is thus race free
+            std::vector<int>& offsets = (*rCellOffsets)(dofI, dofJ);
+            if (offsets.empty())
+                offsets = ValueOffsets(matrix(dofI, dofJ), cell.DofNumbering(dofI), cell.DofNumbering(dofJ),
+                                       storage == eMatrixStorage::UPPER and dofI.Id() == dofJ.Id());
+
+            double* valuesDof = values(dofI, dofJ);
+            const double* localValues = cellHessian(dofI, dofJ).data(); // column major, like the offsets
+            for (size_t i = 0; i < offsets.size(); ++i)
             {
-                Eigen::VectorXi numberingDofI = cellit->DofNumbering(dofI);
-                for (DofType dofJ : dofTypesToAssemble)
+                if (offsets[i] < 0)
+                    continue;
+                if (TAtomic)
                 {
-                    Eigen::VectorXi numberingDofJ = cellit->DofNumbering(dofJ);
-                    const Eigen::MatrixXd& cellHessianDof = cellHessian(dofI, dofJ);
-
-                    for (int i = 0; i < numberingDofI.rows(); ++i)
-                    {
-                        for (int j = 0; j < numberingDofJ.rows(); ++j)
-                        {
-                            const int globalDofNumberI = numberingDofI[i];
-                            const int globalDofNumberJ = numberingDofJ[j];
-                            const double globalDofValue = cellHessianDof(i, j);
-
-                            localtriplets(dofI, dofJ).push_back({globalDofNumberI, globalDofNumberJ, globalDofValue});
-                        }
-                    }
+#pragma omp atomic
+                    valuesDof[offsets[i]] += localValues[i];
                 }
+                else
+                    valuesDof[offsets[i]] += localValues[i];
             }
         }
+    }
+}
+
+//! @brief integrates f on `cell` and adds the result to the values of `matrix`, see ScatterCellMatrix(...)
+template <bool TAtomic>
+void AddCellMatrix(const DofMatrixContainer<double*>& values, const DofMatrixSparse<double>& matrix,
+                   CellInterface& cell, DofMatrixContainer<std::vector<int>>* rCellOffsets,
+                   const std::vector<DofType>& dofTypes, const CellInterface::MatrixFunction& f,
+                   eMatrixStorage storage)
+{
+    ScatterCellMatrix<TAtomic>(values, matrix, cell, rCellOffsets, dofTypes, cell.Integrate(f), storage);
+}
+} // namespace
+
+void SimpleAssembler::AddToMatrix(DofMatrixSparse<double>* rMatrix, const Group<CellInterface>& cells,
+                                  std::vector<DofType> dofTypes, CellInterface::MatrixFunction f,
+                                  ScatterMap* rScatterMap, eMatrixStorage storage) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    if (rScatterMap->size() != cells.Size())
+        *rScatterMap = ScatterMap(cells.Size());
+
+    const DofMatrixContainer<double*> values = ValuePtrs(rMatrix, dofTypes);
+    const DofMatrixSparse<double>& matrix = *rMatrix;
+
+    std::exception_ptr exception = nullptr;
+#pragma omp parallel for
+    for (auto cellit = cells.begin(); cellit < cells.end(); cellit++)
+    {
+        try
+        {
+            AddCellMatrix<true>(values, matrix, *cellit, &(*rScatterMap)[cellit - cells.begin()], dofTypes, f,
+                                storage);
+        }
+        catch (...)
+        {
 #pragma omp critical
+            exception = std::current_exception();
+        }
+    }
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void SimpleAssembler::AddToMatrix(DofMatrixSparse<double>* rMatrix, const Group<CellInterface>& cells,
+                                  std::vector<DofType> dofTypes, CellInterface::MatrixFunction f,
+                                  ScatterMap* rScatterMap, const Coloring& coloring, eMatrixStorage storage) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    if (rScatterMap->size() != cells.Size())
+        *rScatterMap = ScatterMap(cells.Size());
+
+    const DofMatrixContainer<double*> values = ValuePtrs(rMatrix, dofTypes);
+    const DofMatrixSparse<double>& matrix = *rMatrix;
+
+    std::exception_ptr exception = nullptr;
+    for (const std::vector<int>& color : coloring)
+    {
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(color.size()); ++i)
         {
-            for (DofType dofI : dofTypes)
-                for (DofType dofJ : dofTypes)
-                {
-                    triplets(dofI, dofJ).splice(triplets(dofI, dofJ).end(), localtriplets(dofI, dofJ));
-                }
+            try
+            {
+                const int iCell = color[i];
+                AddCellMatrix<false>(values, matrix, cells.begin()[iCell], &(*rScatterMap)[iCell], dofTypes, f,
+                                     storage);
+            }
+            catch (...)
+            {
+#pragma omp critical
+                exception = std::current_exception();
+            }
         }
+        if (exception)
+            std::rethrow_exception(exception);
     }
+}
+
+namespace
+{
+
+//! @return true if `batch` contributes to the assembly of `dofTypes`
+//! @remark Throws if only some of the dof types of the batch are assembled, its local contributions are coupled.
+bool IsAssembled(const CellBatchInterface& batch, const std::vector<DofType>& dofTypes)
+{
+    const std::vector<DofType> batchDofTypes = batch.GetDofTypes();
+    const size_t numAssembled = DofIntersection(dofTypes, batchDofTypes).size();
+    if (numAssembled != 0 and numAssembled != batchDofTypes.size())
+        throw Exception(__PRETTY_FUNCTION__, "A batch is only assembled together with all its dof types.");
+    return numAssembled != 0;
+}
+
+} // namespace
+
+DofVector<double> SimpleAssembler::BuildVector(const CellBatchInterface& batch, std::vector<DofType> dofTypes,
+                                               double deltaT) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    DofVector<double> gradient = ProperlyResizedVector(dofTypes);
+    if (IsAssembled(batch, dofTypes))
+        batch.AddGradient(&gradient, deltaT);
+    return gradient;
+}
+
+DofMatrixSparse<double> SimpleAssembler::BuildMatrix(const CellBatchInterface& batch, std::vector<DofType> dofTypes,
+                                                     double deltaT, eMatrixStorage storage) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
     DofMatrixSparse<double> hessian = ProperlyResizedMatrix(dofTypes);
-    for (DofType dofI : dofTypes)
-        for (DofType dofJ : dofTypes)
+    AddToMatrix(&hessian, batch, dofTypes, deltaT, storage);
+    return hessian;
+}
+
+void SimpleAssembler::AddToMatrix(DofMatrixSparse<double>* rMatrix, const CellBatchInterface& batch,
+                                  std::vector<DofType> dofTypes, double deltaT, eMatrixStorage storage) const
+{
+    if (IsAssembled(batch, dofTypes))
+        batch.AddHessian0(rMatrix, deltaT, storage);
+}
+
+DofVector<double> SimpleAssembler::BuildMatrixVectorProduct(const CellBatchInterface& batch,
+                                                            std::vector<DofType> dofTypes, const DofVector<double>& x,
+                                                            double deltaT) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    DofVector<double> product = ProperlyResizedVector(dofTypes);
+    const DofType dof = batch.GetDofType();
+    if (not DofIntersection(dofTypes, {dof}).empty())
+        batch.AddHessian0Product(x[dof], product[dof], deltaT);
+    return product;
+}
+
+ContiguousDofVector<double> SimpleAssembler::BuildMatrixVectorProduct(const CellBatchInterface& batch,
+                                                                      std::vector<DofType> dofTypes,
+                                                                      const ContiguousDofVector<double>& x,
+                                                                      double deltaT) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    ContiguousDofVector<double> product = ProperlyResizedContiguousVector(dofTypes);
+    const DofType dof = batch.GetDofType();
+    if (DofIntersection(dofTypes, {dof}).empty())
+        return product;
+    auto productSegment = product[dof];
+    batch.AddHessian0Product(x[dof], productSegment, deltaT);
+    return product;
+}
+
+DofVector<double> SimpleAssembler::BuildDiagonal(const CellBatchInterface& batch, std::vector<DofType> dofTypes,
+                                                 double deltaT) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    DofVector<double> diagonal = ProperlyResizedVector(dofTypes);
+    const DofType dof = batch.GetDofType();
+    if (not DofIntersection(dofTypes, {dof}).empty())
+        batch.AddHessian0Diagonal(diagonal[dof], deltaT);
+    return diagonal;
+}
+
+namespace
+{
+
+//! @brief calls f(iCell) for all cells, color by color
+//! @remark Exceptions thrown in f are rethrown after the current color is done.
+template <typename TFunction>
+void ForEachColored(const SimpleAssembler::Coloring& coloring, TFunction f)
+{
+    std::exception_ptr exception = nullptr;
+    for (const std::vector<int>& color : coloring)
+    {
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(color.size()); ++i)
         {
-            hessian(dofI, dofJ).setFromTriplets(triplets(dofI, dofJ).begin(), triplets(dofI, dofJ).end());
+            try
+            {
+                f(color[i]);
+            }
+            catch (...)
+            {
+#pragma omp critical
+                exception = std::current_exception();
+            }
         }
-    return hessian;
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+}
+} // namespace
+
+DofVector<double> SimpleAssembler::BuildVectorAndAddToMatrix(DofMatrixSparse<double>* rMatrix,
+                                                             const Group<CellInterface>& cells,
+                                                             std::vector<DofType> dofTypes,
+                                                             CellInterface::VectorMatrixFunction f,
+                                                             ScatterMap* rScatterMap, const Coloring& coloring,
+                                                             eMatrixStorage storage) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    if (rScatterMap->size() != cells.Size())
+        *rScatterMap = ScatterMap(cells.Size());
+
+    DofVector<double> vector = ProperlyResizedVector(dofTypes);
+    const DofContainer<double*> data = DataPtrs(&vector, dofTypes);
+    const DofMatrixContainer<double*> values = ValuePtrs(rMatrix, dofTypes);
+    const DofMatrixSparse<double>& matrix = *rMatrix;
+
+    ForEachColored(coloring, [&](int iCell) {
+        CellInterface& cell = cells.begin()[iCell];
+        const auto cellVectorAndMatrix = cell.Integrate(f);
+        ScatterCellVector(data, cell, dofTypes, cellVectorAndMatrix.first);
+        ScatterCellMatrix<false>(values, matrix, cell, &(*rScatterMap)[iCell], dofTypes, cellVectorAndMatrix.second,
+                                 storage);
+    });
+    return vector;
+}
+
+BlockSparseMatrix SimpleAssembler::BuildBlockMatrixPattern(const std::vector<Group<CellInterface>>& cellGroups,
+                                                           DofType dof) const
+{
+    ThrowOnZeroDofNumbering({dof});
+
+    const int blockSize = dof.GetNum();
+    const int numDofs = mDofInfo.numIndependentDofs[dof] + mDofInfo.numDependentDofs[dof];
+    if (numDofs % blockSize != 0)
+        throw Exception(__PRETTY_FUNCTION__, "The " + std::to_string(numDofs) + " dofs of " + dof.GetName() +
+                                                     " do not form blocks of size " + std::to_string(blockSize) + ".");
+
+    const int numBlocks = numDofs / blockSize;
+    std::vector<std::vector<int>> blockColumns(numBlocks);
+    for (const auto& cells : cellGroups)
+        for (auto& cell : cells)
+        {
+            if (not cell.Has(dof))
+                continue;
+            const Eigen::VectorXi numbering = cell.DofNumbering(dof);
+            for (int i = 0; i < numbering.rows(); ++i)
+                for (int j = 0; j < numbering.rows(); ++j)
+                    blockColumns[numbering[i] / blockSize].push_back(numbering[j] / blockSize);
+        }
+    return BlockSparseMatrix(blockSize, numBlocks, numBlocks, std::move(blockColumns));
+}
+
+namespace
+{
+
+//! @brief integrates f on `cell` and adds the (dof, dof) part of the result to the node blocked `matrix`
+//! @param values value pointer of `matrix`, the structure of `matrix` is only accessed via const methods
+//! @param rCellOffsets positions of the local entries in `values`, column major, computed if empty
+void AddCellBlockMatrix(double* values, const BlockSparseMatrix& matrix, CellInterface& cell, DofType dof,
+                        const CellInterface::MatrixFunction& f, std::vector<int>* rCellOffsets)
+{
+    if (not cell.Has(dof))
+        return;
+
+    const DofMatrix<double> cellMatrix = cell.Integrate(f);
+
+    // each cell is visited by exactly one thread, the lazy initialization is thus race free
+    std::vector<int>& offsets = *rCellOffsets;
+    if (offsets.empty())
+    {
+        const Eigen::VectorXi numbering = cell.DofNumbering(dof);
+        offsets.reserve(numbering.rows() * numbering.rows());
+        for (int j = 0; j < numbering.rows(); ++j)
+            for (int i = 0; i < numbering.rows(); ++i)
+                offsets.push_back(matrix.ValueOffset(numbering[i], numbering[j]));
+    }
+
+    const double* localValues = cellMatrix(dof, dof).data(); // column major, like the offsets
+    for (size_t i = 0; i < offsets.size(); ++i)
+        values[offsets[i]] += localValues[i];
+}
+} // namespace
+
+void SimpleAssembler::AddToBlockMatrix(BlockSparseMatrix* rMatrix, const Group<CellInterface>& cells, DofType dof,
+                                       CellInterface::MatrixFunction f, BlockScatterMap* rScatterMap,
+                                       const Coloring& coloring) const
+{
+    ThrowOnZeroDofNumbering({dof});
+    if (rMatrix->BlockSize() != dof.GetNum())
+        throw Exception(__PRETTY_FUNCTION__, "The block size " + std::to_string(rMatrix->BlockSize()) +
+                                                     " does not match the " + std::to_string(dof.GetNum()) +
+                                                     " components of " + dof.GetName() + ".");
+
+    if (rScatterMap->size() != cells.Size())
+        *rScatterMap = BlockScatterMap(cells.Size());
+
+    double* values = rMatrix->Values();
+    const BlockSparseMatrix& matrix = *rMatrix;
+    ForEachColored(coloring, [&](int iCell) {
+        AddCellBlockMatrix(values, matrix, cells.begin()[iCell], dof, f, &(*rScatterMap)[iCell]);
+    });
+}
+
+namespace
+{
+
+//! @brief adds the product of the local matrix of `cell` and the local entries of `x` to the vector with the data
+//! pointers `data`
+//! @param x data pointers of the vector that is multiplied
+void AddCellProduct(const DofContainer<double*>& data, CellInterface& cell, const std::vector<DofType>& dofTypes,
+                    const DofMatrix<double>& cellMatrix, const DofContainer<const double*>& x)
+{
+    auto dofTypesToAssemble = DofIntersection(cellMatrix.DofTypes(), dofTypes);
+
+    DofContainer<Eigen::VectorXi> numbering;
+    DofContainer<Eigen::VectorXd> localX;
+    for (DofType dof : dofTypesToAssemble)
+    {
+        numbering[dof] = cell.DofNumbering(dof);
+        const double* xDof = x[dof];
+        localX[dof].resize(numbering[dof].rows());
+        for (int i = 0; i < numbering[dof].rows(); ++i)
+            localX[dof][i] = xDof[numbering[dof][i]];
+    }
+
+    for (DofType dofI : dofTypesToAssemble)
+    {
+        Eigen::VectorXd localY = Eigen::VectorXd::Zero(numbering[dofI].rows());
+        for (DofType dofJ : dofTypesToAssemble)
+            localY += cellMatrix(dofI, dofJ) * localX[dofJ];
+
+        const Eigen::VectorXi& numberingDof = numbering[dofI];
+        double* dataDof = data[dofI];
+        for (int i = 0; i < numberingDof.rows(); ++i)
+            dataDof[numberingDof[i]] += localY[i];
+    }
+}
+
+//! @brief adds the diagonal of the local matrix of `cell` to the vector with the data pointers `data`
+void AddCellDiagonal(const DofContainer<double*>& data, CellInterface& cell, const std::vector<DofType>& dofTypes,
+                     const DofMatrix<double>& cellMatrix)
+{
+    for (DofType dof : DofIntersection(cellMatrix.DofTypes(), dofTypes))
+    {
+        const Eigen::VectorXi numberingDof = cell.DofNumbering(dof);
+        const Eigen::MatrixXd& cellMatrixDof = cellMatrix(dof, dof);
+        double* dataDof = data[dof];
+        for (int i = 0; i < numberingDof.rows(); ++i)
+            dataDof[numberingDof[i]] += cellMatrixDof(i, i);
+    }
+}
+
+//! @return tangent of the integration point `iIP` of the `iCell`-th cell
+Eigen::Map<const Eigen::MatrixXd> IpTangent(const SimpleAssembler::IpTangents& tangents, int iCell, int iIP)
+{
+    const int dim = tangents.values.rows();
+    return Eigen::Map<const Eigen::MatrixXd>(tangents.values.data() + (tangents.cellOffsets[iCell] + iIP) * dim * dim,
+                                             dim, dim);
+}
+
+//! @brief adds the integral of B^T D B x over `cell` to the vector with the data pointers `data`
+//! @param x data pointers of the vector that is multiplied
+void AddCellTangentProduct(const DofContainer<double*>& data, CellInterface& cell, int iCell, DofType dof,
+                           const SimpleAssembler::OperatorFunction& b, const SimpleAssembler::IpTangents& tangents,
+                           const DofContainer<const double*>& x)
+{
+    if (not cell.Has(dof))
+        return;
+    const Eigen::VectorXi numbering = cell.DofNumbering(dof);
+    const double* xDof = x[dof];
+    Eigen::VectorXd localX(numbering.rows());
+    for (int i = 0; i < numbering.rows(); ++i)
+        localX[i] = xDof[numbering[i]];
+
+    const DofVector<double> localY = cell.Integrate(CellInterface::VectorFunction([&](const CellIpData& cellIpData) {
+        const Eigen::MatrixXd& B = b(cellIpData);
+        DofVector<double> y;
+        y[dof] = B.transpose() * (IpTangent(tangents, iCell, cellIpData.Ids().ipId) * (B * localX));
+        return y;
+    }));
+
+    double* dataDof = data[dof];
+    for (int i = 0; i < numbering.rows(); ++i)
+        dataDof[numbering[i]] += localY[dof][i];
+}
+
+//! @brief adds the diagonal of the integral of B^T D B over `cell` to the vector with the data pointers `data`
+void AddCellTangentDiagonal(const DofContainer<double*>& data, CellInterface& cell, int iCell, DofType dof,
+                            const SimpleAssembler::OperatorFunction& b, const SimpleAssembler::IpTangents& tangents)
+{
+    if (not cell.Has(dof))
+        return;
+    const DofVector<double> localDiagonal =
+            cell.Integrate(CellInterface::VectorFunction([&](const CellIpData& cellIpData) {
+                const Eigen::MatrixXd& B = b(cellIpData);
+                DofVector<double> diagonal;
+                diagonal[dof] = (IpTangent(tangents, iCell, cellIpData.Ids().ipId) * B)
+                                        .cwiseProduct(B)
+                                        .colwise()
+                                        .sum()
+                                        .transpose();
+                return diagonal;
+            }));
+
+    const Eigen::VectorXi numbering = cell.DofNumbering(dof);
+    double* dataDof = data[dof];
+    for (int i = 0; i < numbering.rows(); ++i)
+        dataDof[numbering[i]] += localDiagonal[dof][i];
+}
+} // namespace
+
+SimpleAssembler::IpTangents SimpleAssembler::BuildIpTangents(const Group<CellInterface>& cells,
+                                                             TangentFunction tangent) const
+{
+    std::vector<std::vector<Eigen::MatrixXd>> cellTangents(cells.Size());
+#pragma omp parallel for
+    for (auto cellit = cells.begin(); cellit < cells.end(); cellit++)
+    {
+        std::vector<Eigen::MatrixXd>& ipTangents = cellTangents[cellit - cells.begin()];
+        cellit->Apply([&](const CellIpData& cellIpData) { ipTangents.push_back(tangent(cellIpData)); });
+    }
+
+    IpTangents tangents;
+    int numIps = 0;
+    int dim = 0;
+    for (const std::vector<Eigen::MatrixXd>& ipTangents : cellTangents)
+    {
+        tangents.cellOffsets.push_back(numIps);
+        numIps += ipTangents.size();
+        if (not ipTangents.empty())
+            dim = ipTangents.front().rows();
+    }
+
+    tangents.values.resize(dim, dim * numIps);
+    int column = 0;
+    for (const std::vector<Eigen::MatrixXd>& ipTangents : cellTangents)
+        for (const Eigen::MatrixXd& D : ipTangents)
+        {
+            if (D.rows() != dim or D.cols() != dim)
+                throw Exception(__PRETTY_FUNCTION__, "All tangents must be square matrices of the same size.");
+            tangents.values.middleCols(column, dim) = D;
+            column += dim;
+        }
+    return tangents;
+}
+
+DofVector<double> SimpleAssembler::BuildMatrixVectorProduct(const Group<CellInterface>& cells,
+                                                            std::vector<DofType> dofTypes,
+                                                            CellInterface::MatrixFunction f,
+                                                            const DofVector<double>& x, const Coloring& coloring) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    DofVector<double> product = ProperlyResizedVector(dofTypes);
+    const DofContainer<const double*> xData = ConstDataPtrs(x, dofTypes);
+    const DofContainer<double*> data = DataPtrs(&product, dofTypes);
+    ForEachColored(coloring, [&](int iCell) {
+        CellInterface& cell = cells.begin()[iCell];
+        AddCellProduct(data, cell, dofTypes, cell.Integrate(f), xData);
+    });
+    return product;
+}
+
+ContiguousDofVector<double> SimpleAssembler::BuildMatrixVectorProduct(const Group<CellInterface>& cells,
+                                                                      std::vector<DofType> dofTypes,
+                                                                      CellInterface::MatrixFunction f,
+                                                                      const ContiguousDofVector<double>& x,
+                                                                      const Coloring& coloring) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    ContiguousDofVector<double> product = ProperlyResizedContiguousVector(dofTypes);
+    const DofContainer<const double*> xData = ConstDataPtrs(x, dofTypes);
+    const DofContainer<double*> data = DataPtrs(&product, dofTypes);
+    ForEachColored(coloring, [&](int iCell) {
+        CellInterface& cell = cells.begin()[iCell];
+        AddCellProduct(data, cell, dofTypes, cell.Integrate(f), xData);
+    });
+    return product;
+}
+
+DofVector<double> SimpleAssembler::BuildMatrixVectorProduct(const Group<CellInterface>& cells,
+                                                            std::vector<DofType> dofTypes, DofType dof,
+                                                            OperatorFunction b, const IpTangents& tangents,
+                                                            const DofVector<double>& x, const Coloring& coloring) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    DofVector<double> product = ProperlyResizedVector(dofTypes);
+    if (DofIntersection(dofTypes, {dof}).empty())
+        return product;
+    const DofContainer<const double*> xData = ConstDataPtrs(x, {dof});
+    const DofContainer<double*> data = DataPtrs(&product, {dof});
+    ForEachColored(coloring, [&](int iCell) {
+        AddCellTangentProduct(data, cells.begin()[iCell], iCell, dof, b, tangents, xData);
+    });
+    return product;
+}
+
+ContiguousDofVector<double> SimpleAssembler::BuildMatrixVectorProduct(const Group<CellInterface>& cells,
+                                                                      std::vector<DofType> dofTypes, DofType dof,
+                                                                      OperatorFunction b, const IpTangents& tangents,
+                                                                      const ContiguousDofVector<double>& x,
+                                                                      const Coloring& coloring) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    ContiguousDofVector<double> product = ProperlyResizedContiguousVector(dofTypes);
+    if (DofIntersection(dofTypes, {dof}).empty())
+        return product;
+    const DofContainer<const double*> xData = ConstDataPtrs(x, {dof});
+    const DofContainer<double*> data = DataPtrs(&product, {dof});
+    ForEachColored(coloring, [&](int iCell) {
+        AddCellTangentProduct(data, cells.begin()[iCell], iCell, dof, b, tangents, xData);
+    });
+    return product;
+}
+
+DofVector<double> SimpleAssembler::BuildDiagonal(const Group<CellInterface>& cells, std::vector<DofType> dofTypes,
+                                                 CellInterface::MatrixFunction f, const Coloring& coloring) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    DofVector<double> diagonal = ProperlyResizedVector(dofTypes);
+    const DofContainer<double*> data = DataPtrs(&diagonal, dofTypes);
+    ForEachColored(coloring, [&](int iCell) {
+        CellInterface& cell = cells.begin()[iCell];
+        AddCellDiagonal(data, cell, dofTypes, cell.Integrate(f));
+    });
+    return diagonal;
+}
+
+DofVector<double> SimpleAssembler::BuildDiagonal(const Group<CellInterface>& cells, std::vector<DofType> dofTypes,
+                                                 DofType dof, OperatorFunction b, const IpTangents& tangents,
+                                                 const Coloring& coloring) const
+{
+    ThrowOnZeroDofNumbering(dofTypes);
+
+    DofVector<double> diagonal = ProperlyResizedVector(dofTypes);
+    if (DofIntersection(dofTypes, {dof}).empty())
+        return diagonal;
+    const DofContainer<double*> data = DataPtrs(&diagonal, {dof});
+    ForEachColored(coloring,
+                   [&](int iCell) { AddCellTangentDiagonal(data, cells.begin()[iCell], iCell, dof, b, tangents); });
+    return diagonal;
 }
 
 DofVector<double> SimpleAssembler::ProperlyResizedVector(std::vector<DofType> dofTypes) const
@@ -165,6 +1067,14 @@ DofVector<double> SimpleAssembler::ProperlyResizedVector(std::vector<DofType> do
     return v;
 }
 
+ContiguousDofVector<double> SimpleAssembler::ProperlyResizedContiguousVector(std::vector<DofType> dofTypes) const
+{
+    std::vector<int> sizes;
+    for (auto dof : dofTypes)
+        sizes.push_back(mDofInfo.numIndependentDofs[dof] + mDofInfo.numDependentDofs[dof]);
+    return ContiguousDofVector<double>(dofTypes, sizes);
+}
+
 DofMatrixSparse<double> SimpleAssembler::ProperlyResizedMatrix(std::vector<DofType> dofTypes) const
 {
     DofMatrixSparse<double> m;
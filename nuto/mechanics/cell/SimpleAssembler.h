@@ -1,9 +1,13 @@
 #pragma once
 
 #include "nuto/base/Group.h"
+#include "nuto/math/BlockSparseMatrix.h"
+#include "nuto/mechanics/cell/CellBatchInterface.h"
 #include "nuto/mechanics/cell/CellInterface.h"
+#include "nuto/mechanics/cell/CellRange.h"
 #include "nuto/mechanics/dofs/DofNumbering.h"
 #include "nuto/mechanics/dofs/DofVector.h"
+#include "nuto/mechanics/dofs/ContiguousDofVector.h"
 #include "nuto/mechanics/dofs/DofMatrixSparse.h"
 
 namespace NuTo
@@ -17,8 +21,184 @@ public:
     DofVector<double> BuildVector(const Group<CellInterface>& cells, std::vector<DofType> dofTypes,
                                   CellInterface::VectorFunction f) const;
 
+    //! @brief cell indices (positions in a Group<CellInterface>) sorted by color. Cells of the same color do not share
+    //! any dof number and can thus be assembled concurrently without synchronization.
+    using Coloring = std::vector<std::vector<int>>;
+
+    //! @brief greedy coloring of `cells` based on the dof numbers of `dofTypes`
+    //! @param cells group of cells to be colored
+    //! @param dofTypes vector of dofTypes, cells that share a dof number of one of these dof types get different colors
+    //! @return coloring that is valid as long as the group and the dof numbering do not change
+    Coloring BuildColoring(const Group<CellInterface>& cells, std::vector<DofType> dofTypes) const;
+
+    //! @brief BuildColoring(...) of the cells of contiguous ranges, e.g. CellStorage::Ranges()
+    //! @return coloring of the cell indices in the concatenation of the ranges
+    Coloring BuildColoring(const std::vector<CellRange>& ranges, std::vector<DofType> dofTypes) const;
+
+    //! @brief Assembles a vector color by color. The cells of one color write directly into the result.
+    //! @param coloring result of BuildColoring(cells, dofTypes)
+    //! @remark The summation order of each entry only depends on the coloring and not on the number of threads. The
+    //! result is thus bitwise reproducible.
+    DofVector<double> BuildVector(const Group<CellInterface>& cells, std::vector<DofType> dofTypes,
+                                  CellInterface::VectorFunction f, const Coloring& coloring) const;
+
+    //! @brief BuildVector(...) color by color over contiguous ranges of cells, e.g. CellStorage::Ranges()
+    //! @param coloring result of BuildColoring(ranges, dofTypes)
+    DofVector<double> BuildVector(const std::vector<CellRange>& ranges, std::vector<DofType> dofTypes,
+                                  CellInterface::VectorFunction f, const Coloring& coloring) const;
+
+    //! @param storage eMatrixStorage::UPPER only assembles the upper triangle w.r.t. the order of `dofTypes`. It is up
+    //! to the caller to ensure that the local matrices are symmetric.
     DofMatrixSparse<double> BuildMatrix(const Group<CellInterface>& cells, std::vector<DofType> dofTypes,
-                                        CellInterface::MatrixFunction f) const;
+                                        CellInterface::MatrixFunction f,
+                                        eMatrixStorage storage = eMatrixStorage::FULL) const;
+
+    //! @brief BuildMatrix(...) over contiguous ranges of cells, e.g. CellStorage::Ranges()
+    //! @remark Like BuildMatrix(cells, ...), this collects thread local triplet lists and is meant for the assembly
+    //! that defines the nonzero pattern. Repeated assemblies should add to that pattern via AddToMatrix(...).
+    DofMatrixSparse<double> BuildMatrix(const std::vector<CellRange>& ranges, std::vector<DofType> dofTypes,
+                                        CellInterface::MatrixFunction f,
+                                        eMatrixStorage storage = eMatrixStorage::FULL) const;
+
+    //! @brief positions of the local cell matrix entries in the value arrays of a compressed DofMatrixSparse
+    //! @remark `scatterMap[iCell](dofI, dofJ)[i + j * numRows]` is the index of the local entry (i, j) of the
+    //! `iCell`-th cell of the group in the valuePtr() array of the block (dofI, dofJ). It is valid as long as the dof
+    //! numbering and the nonzero pattern of the matrix do not change.
+    using ScatterMap = std::vector<DofMatrixContainer<std::vector<int>>>;
+
+    //! @brief Assembles the local matrices calculated by f directly into the existing nonzeros of `rMatrix`
+    //! @param rMatrix compressed matrix whose nonzero pattern contains all the entries of the local matrices, e.g. the
+    //! result of a previous BuildMatrix(...) with the same dof numbering. It is not set to zero.
+    //! @param cells group of cells to be used for assembly
+    //! @param dofTypes vector of dofTypes
+    //! @param rScatterMap memoized positions of the local entries in `rMatrix`, computed once on the first call
+    //! @param storage storage scheme of `rMatrix`, see BuildMatrix(...)
+    //! @remark This avoids building and sorting the triplet lists of BuildMatrix(...) and is meant for repeated
+    //! assemblies with an unchanged dof numbering, e.g. in each Newton iteration.
+    void AddToMatrix(DofMatrixSparse<double>* rMatrix, const Group<CellInterface>& cells,
+                     std::vector<DofType> dofTypes, CellInterface::MatrixFunction f, ScatterMap* rScatterMap,
+                     eMatrixStorage storage = eMatrixStorage::FULL) const;
+
+    //! @brief AddToMatrix(...) color by color, without atomic operations and bitwise reproducible
+    //! @param coloring result of BuildColoring(cells, dofTypes)
+    void AddToMatrix(DofMatrixSparse<double>* rMatrix, const Group<CellInterface>& cells,
+                     std::vector<DofType> dofTypes, CellInterface::MatrixFunction f, ScatterMap* rScatterMap,
+                     const Coloring& coloring, eMatrixStorage storage = eMatrixStorage::FULL) const;
+
+    //! @brief assembles the gradients of a batch of cells, see CellBatch
+    //! @remark The batch contributes nothing if its dof types are not part of `dofTypes`. Throws if only some of them
+    //! are, see CellBatchInterface::GetDofTypes().
+    DofVector<double> BuildVector(const CellBatchInterface& batch, std::vector<DofType> dofTypes,
+                                  double deltaT) const;
+
+    //! @brief assembles the hessians of a batch of cells, see BuildVector(batch, ...)
+    DofMatrixSparse<double> BuildMatrix(const CellBatchInterface& batch, std::vector<DofType> dofTypes, double deltaT,
+                                        eMatrixStorage storage = eMatrixStorage::FULL) const;
+
+    //! @brief adds the hessians of a batch of cells to `rMatrix`, see BuildVector(batch, ...)
+    void AddToMatrix(DofMatrixSparse<double>* rMatrix, const CellBatchInterface& batch, std::vector<DofType> dofTypes,
+                     double deltaT, eMatrixStorage storage = eMatrixStorage::FULL) const;
+
+    //! @brief product of the hessians of a batch of cells with `x`, see BuildVector(batch, ...)
+    DofVector<double> BuildMatrixVectorProduct(const CellBatchInterface& batch, std::vector<DofType> dofTypes,
+                                               const DofVector<double>& x, double deltaT) const;
+
+    //! @brief BuildMatrixVectorProduct(batch, ...) for contiguous vectors
+    ContiguousDofVector<double> BuildMatrixVectorProduct(const CellBatchInterface& batch,
+                                                         std::vector<DofType> dofTypes,
+                                                         const ContiguousDofVector<double>& x, double deltaT) const;
+
+    //! @brief diagonal of the hessians of a batch of cells, see BuildVector(batch, ...)
+    DofVector<double> BuildDiagonal(const CellBatchInterface& batch, std::vector<DofType> dofTypes,
+                                    double deltaT) const;
+
+    //! @brief Assembles the vectors and adds the matrices of f to `rMatrix` in a single pass over the cells
+    //! @param rMatrix compressed matrix with a valid nonzero pattern, see AddToMatrix(...). It is not set to zero.
+    //! @param rScatterMap memoized positions of the local entries in `rMatrix`, computed once on the first call
+    //! @param coloring result of BuildColoring(cells, dofTypes)
+    //! @return assembled vector of the first entries of f
+    //! @remark Each integration point is visited once, e.g. to evaluate a constitutive law once for both the gradient
+    //! and the hessian.
+    DofVector<double> BuildVectorAndAddToMatrix(DofMatrixSparse<double>* rMatrix, const Group<CellInterface>& cells,
+                                                std::vector<DofType> dofTypes, CellInterface::VectorMatrixFunction f,
+                                                ScatterMap* rScatterMap, const Coloring& coloring,
+                                                eMatrixStorage storage = eMatrixStorage::FULL) const;
+
+    //! @brief nonzero pattern of the node blocked matrix of the vector valued `dof` with zero blocks
+    //! @param cellGroups groups of cells whose local matrices are assembled via AddToBlockMatrix(...)
+    //! @remark The block size is dof.GetNum(). DofNumbering::Build numbers the components of each node
+    //! consecutively, the node block of the dof number d is thus d / dof.GetNum().
+    BlockSparseMatrix BuildBlockMatrixPattern(const std::vector<Group<CellInterface>>& cellGroups, DofType dof) const;
+
+    //! @brief positions of the local (dof, dof) entries of each cell in BlockSparseMatrix::Values(), column major
+    using BlockScatterMap = std::vector<std::vector<int>>;
+
+    //! @brief Assembles the (dof, dof) part of the local matrices calculated by f into `rMatrix`, color by color
+    //! @param rMatrix matrix with the nonzero pattern of BuildBlockMatrixPattern(...). It is not set to zero.
+    //! @param rScatterMap memoized positions of the local entries in `rMatrix`, computed once on the first call
+    //! @param coloring result of BuildColoring(cells, {dof})
+    void AddToBlockMatrix(BlockSparseMatrix* rMatrix, const Group<CellInterface>& cells, DofType dof,
+                          CellInterface::MatrixFunction f, BlockScatterMap* rScatterMap,
+                          const Coloring& coloring) const;
+
+    //! @brief differential operator B of a dof type at an integration point, e.g. cellIpData.B(dof, Nabla::Strain())
+    using OperatorFunction = std::function<const Eigen::MatrixXd&(const CellIpData&)>;
+
+    //! @brief material tangent D at an integration point, the local matrix of a cell is the integral of B^T D B
+    using TangentFunction = std::function<Eigen::MatrixXd(const CellIpData&)>;
+
+    //! @brief square tangents D of all integration points of a group of cells
+    struct IpTangents
+    {
+        //! @brief tangents of all integration points, the tangent of the integration point iIP of the iCell-th cell
+        //! of the group starts at the column (cellOffsets[iCell] + iIP) * values.rows()
+        Eigen::MatrixXd values;
+        std::vector<int> cellOffsets;
+    };
+
+    //! @brief evaluates `tangent` at all integration points of `cells`, e.g. for repeated matrix-free products
+    //! @remark This keeps one small tangent per integration point instead of one dense local matrix per cell.
+    IpTangents BuildIpTangents(const Group<CellInterface>& cells, TangentFunction tangent) const;
+
+    //! @brief Calculates the product A x with the matrix A = BuildMatrix(cells, dofTypes, f) without assembling A
+    //! @param x vector with independent and dependent dof values of all `dofTypes`
+    //! @param coloring result of BuildColoring(cells, dofTypes)
+    //! @remark The local matrices are calculated on the fly and discarded after their local product.
+    DofVector<double> BuildMatrixVectorProduct(const Group<CellInterface>& cells, std::vector<DofType> dofTypes,
+                                               CellInterface::MatrixFunction f, const DofVector<double>& x,
+                                               const Coloring& coloring) const;
+
+    //! @brief BuildMatrixVectorProduct(...) of the local matrices B^T D B of `dof` with the tangents D from
+    //! BuildIpTangents(cells, ...)
+    //! @param b differential operator of `dof`
+    //! @remark The products B^T (D (B x)) are evaluated per integration point, the local matrices are never formed.
+    DofVector<double> BuildMatrixVectorProduct(const Group<CellInterface>& cells, std::vector<DofType> dofTypes,
+                                               DofType dof, OperatorFunction b, const IpTangents& tangents,
+                                               const DofVector<double>& x, const Coloring& coloring) const;
+
+    //! @brief BuildMatrixVectorProduct(...) for contiguous vectors, e.g. for iterative solvers that work on the whole
+    //! vector at once
+    //! @return product with one segment per dof type in the order of `dofTypes`
+    ContiguousDofVector<double> BuildMatrixVectorProduct(const Group<CellInterface>& cells,
+                                                         std::vector<DofType> dofTypes, CellInterface::MatrixFunction f,
+                                                         const ContiguousDofVector<double>& x,
+                                                         const Coloring& coloring) const;
+
+    //! @brief BuildMatrixVectorProduct(...) for contiguous vectors with the tangents from BuildIpTangents(...)
+    ContiguousDofVector<double> BuildMatrixVectorProduct(const Group<CellInterface>& cells,
+                                                         std::vector<DofType> dofTypes, DofType dof,
+                                                         OperatorFunction b, const IpTangents& tangents,
+                                                         const ContiguousDofVector<double>& x,
+                                                         const Coloring& coloring) const;
+
+    //! @brief Calculates the diagonal of A = BuildMatrix(cells, dofTypes, f) without assembling A
+    //! @param coloring result of BuildColoring(cells, dofTypes)
+    DofVector<double> BuildDiagonal(const Group<CellInterface>& cells, std::vector<DofType> dofTypes,
+                                    CellInterface::MatrixFunction f, const Coloring& coloring) const;
+
+    //! @brief BuildDiagonal(...) of the local matrices B^T D B of `dof` with the tangents from BuildIpTangents(...)
+    DofVector<double> BuildDiagonal(const Group<CellInterface>& cells, std::vector<DofType> dofTypes, DofType dof,
+                                    OperatorFunction b, const IpTangents& tangents, const Coloring& coloring) const;
 
     //! @brief Assembles a diagonally lumped matrix from local matrices calculated by f
     //! @param cells group of cells to be used for assembly
@@ -31,10 +211,16 @@ public:
     DofVector<double> BuildDiagonallyLumpedMatrix(const Group<CellInterface>& cells, std::vector<DofType> dofTypes,
                                                   CellInterface::MatrixFunction f) const;
 
+    //! @brief BuildDiagonallyLumpedMatrix(...) color by color, without thread local copies and bitwise reproducible
+    //! @param coloring result of BuildColoring(cells, dofTypes)
+    DofVector<double> BuildDiagonallyLumpedMatrix(const Group<CellInterface>& cells, std::vector<DofType> dofTypes,
+                                                  CellInterface::MatrixFunction f, const Coloring& coloring) const;
+
     void SetDofInfo(DofInfo dofInfo);
 
 private:
     DofVector<double> ProperlyResizedVector(std::vector<DofType> dofTypes) const;
+    ContiguousDofVector<double> ProperlyResizedContiguousVector(std::vector<DofType> dofTypes) const;
     DofMatrixSparse<double> ProperlyResizedMatrix(std::vector<DofType> dofTypes) const;
 
     DofInfo mDofInfo;
@@ -0,0 +1,459 @@
+#include "nuto/mechanics/cell/SumFactorization.h"
+#include <Eigen/LU>
+#include "nuto/base/Exception.h"
+#include "nuto/mechanics/cell/DifferentialOperators.h"
+#include "nuto/mechanics/interpolation/InterpolationTrussLobatto.h"
+
+using namespace NuTo;
+
+template <int TDim>
+SumFactorization<TDim>::SumFactorization(int order, const IntegrationTypeTensorProduct<TDim>& integrationType)
+{
+    const Eigen::VectorXd nodes = InterpolationTrussLobatto::LocalCoords(order);
+    const std::vector<double>& ipCoords = integrationType.GetIntegrationPointCoordinates1D();
+
+    mN.resize(ipCoords.size(), nodes.rows());
+    mDN.resize(ipCoords.size(), nodes.rows());
+    for (size_t iIP = 0; iIP < ipCoords.size(); ++iIP)
+    {
+        mN.row(iIP) = InterpolationTrussLobatto::ShapeFunctions(ipCoords[iIP], nodes).transpose();
+        mDN.row(iIP) = InterpolationTrussLobatto::DerivativeShapeFunctions(ipCoords[iIP], nodes).transpose();
+    }
+    mNTransposed = mN.transpose();
+    mDNTransposed = mDN.transpose();
+
+    mNumNodes = std::pow(nodes.rows(), TDim);
+    mNumIps = integrationType.GetNumIntegrationPoints();
+    for (int iIP = 0; iIP < mNumIps; ++iIP)
+        mWeights.push_back(integrationType.GetIntegrationPointWeight(iIP));
+}
+
+template <int TDim>
+int SumFactorization<TDim>::GetNumNodes() const
+{
+    return mNumNodes;
+}
+
+template <int TDim>
+int SumFactorization<TDim>::GetNumIntegrationPoints() const
+{
+    return mNumIps;
+}
+
+template <int TDim>
+double SumFactorization<TDim>::GetIntegrationPointWeight(int iIP) const
+{
+    return mWeights[iIP];
+}
+
+template <int TDim>
+Eigen::VectorXd SumFactorization<TDim>::Contract(const std::array<const Eigen::MatrixXd*, TDim>& matrices,
+                                                 const Eigen::VectorXd& values) const
+{
+    // values are stored as a TDim dimensional array with the first index running fastest. Applying the matrix A in
+    // direction d means: for each combination of the indices after d, multiply the (pre x n) slab with A^T.
+    std::array<int, TDim> sizes;
+    for (int d = 0; d < TDim; ++d)
+        sizes[d] = matrices[d]->cols();
+
+    Eigen::VectorXd current = values;
+    Eigen::VectorXd next;
+    for (int d = 0; d < TDim; ++d)
+    {
+        const Eigen::MatrixXd& A = *matrices[d];
+        int pre = 1;
+        for (int e = 0; e < d; ++e)
+            pre *= sizes[e];
+        int post = 1;
+        for (int e = d + 1; e < TDim; ++e)
+            post *= sizes[e];
+
+        next.resize(pre * A.rows() * post);
+        for (int p = 0; p < post; ++p)
+        {
+            Eigen::Map<const Eigen::MatrixXd> in(current.data() + p * pre * A.cols(), pre, A.cols());
+            Eigen::Map<Eigen::MatrixXd> out(next.data() + p * pre * A.rows(), pre, A.rows());
+            out.noalias() = in * A.transpose();
+        }
+        sizes[d] = A.rows();
+        current.swap(next);
+    }
+    return current;
+}
+
+template <int TDim>
+Eigen::VectorXd SumFactorization<TDim>::Interpolate(const Eigen::VectorXd& nodeValues) const
+{
+    std::array<const Eigen::MatrixXd*, TDim> matrices;
+    matrices.fill(&mN);
+    return Contract(matrices, nodeValues);
+}
+
+template <int TDim>
+Eigen::MatrixXd SumFactorization<TDim>::InterpolateDerivatives(const Eigen::VectorXd& nodeValues) const
+{
+    Eigen::MatrixXd derivatives(mNumIps, TDim);
+    for (int d = 0; d < TDim; ++d)
+    {
+        std::array<const Eigen::MatrixXd*, TDim> matrices;
+        matrices.fill(&mN);
+        matrices[d] = &mDN;
+        derivatives.col(d) = Contract(matrices, nodeValues);
+    }
+    return derivatives;
+}
+
+template <int TDim>
+Eigen::VectorXd SumFactorization<TDim>::IntegrateShape(const Eigen::VectorXd& ipValues) const
+{
+    std::array<const Eigen::MatrixXd*, TDim> matrices;
+    matrices.fill(&mNTransposed);
+    return Contract(matrices, ipValues);
+}
+
+template <int TDim>
+Eigen::VectorXd SumFactorization<TDim>::IntegrateDerivatives(const Eigen::MatrixXd& ipValues) const
+{
+    Eigen::VectorXd result = Eigen::VectorXd::Zero(mNumNodes);
+    for (int d = 0; d < TDim; ++d)
+    {
+        std::array<const Eigen::MatrixXd*, TDim> matrices;
+        matrices.fill(&mNTransposed);
+        matrices[d] = &mDNTransposed;
+        result += Contract(matrices, ipValues.col(d));
+    }
+    return result;
+}
+
+namespace
+{
+//! @return the `component`-th entries of `nodeValues` that are ordered in blocks of `numComponents` per node
+Eigen::VectorXd Component(const Eigen::VectorXd& nodeValues, int component, int numComponents)
+{
+    return Eigen::Map<const Eigen::VectorXd, 0, Eigen::InnerStride<>>(nodeValues.data() + component,
+                                                                      nodeValues.rows() / numComponents,
+                                                                      Eigen::InnerStride<>(numComponents));
+}
+
+//! @brief writes `values` to the `component`-th entries of `rNodeValues`
+void SetComponent(const Eigen::VectorXd& values, int component, int numComponents, Eigen::VectorXd* rNodeValues)
+{
+    Eigen::Map<Eigen::VectorXd, 0, Eigen::InnerStride<>>(rNodeValues->data() + component, values.rows(),
+                                                         Eigen::InnerStride<>(numComponents)) = values;
+}
+
+} /* anonymous namespace */
+
+template <int TDim>
+SumFactorizedCell<TDim>::SumFactorizedCell(const SumFactorization<TDim>& kernel,
+                                           const ElementInterface& coordinateElement)
+    : SumFactorizedCell(kernel, coordinateElement.ExtractNodeValues())
+{
+    if (coordinateElement.GetNumNodes() != kernel.GetNumNodes() or coordinateElement.GetDofDimension() != TDim)
+        throw Exception(__PRETTY_FUNCTION__, "The coordinate element does not match the sum factorization.");
+}
+
+template <int TDim>
+SumFactorizedCell<TDim>::SumFactorizedCell(const SumFactorization<TDim>& kernel, const Eigen::VectorXd& coordinates)
+    : mKernel(kernel)
+{
+    if (coordinates.rows() != TDim * kernel.GetNumNodes())
+        throw Exception(__PRETTY_FUNCTION__, "The node coordinates do not match the sum factorization.");
+
+    const int numIps = kernel.GetNumIntegrationPoints();
+
+    // jacobian(q)(i, e) = dx_i / dxi_e at the integration point q
+    std::vector<Matrix, Eigen::aligned_allocator<Matrix>> jacobians(numIps);
+    for (int i = 0; i < TDim; ++i)
+    {
+        const Eigen::MatrixXd derivatives = kernel.InterpolateDerivatives(Component(coordinates, i, TDim));
+        for (int iIP = 0; iIP < numIps; ++iIP)
+            jacobians[iIP].row(i) = derivatives.row(iIP);
+    }
+
+    mInverseJacobians.resize(numIps);
+    mDetJw.resize(numIps);
+    for (int iIP = 0; iIP < numIps; ++iIP)
+    {
+        mInverseJacobians[iIP] = jacobians[iIP].inverse();
+        mDetJw[iIP] = jacobians[iIP].determinant() * kernel.GetIntegrationPointWeight(iIP);
+    }
+}
+
+template <int TDim>
+Eigen::VectorXd SumFactorizedCell<TDim>::MassApply(const Eigen::VectorXd& nodeValues, double density) const
+{
+    const int numComponents = nodeValues.rows() / mKernel.GetNumNodes();
+    Eigen::VectorXd result(nodeValues.rows());
+    for (int c = 0; c < numComponents; ++c)
+    {
+        Eigen::VectorXd ipValues = mKernel.Interpolate(Component(nodeValues, c, numComponents));
+        ipValues.array() *= density * mDetJw.array();
+        SetComponent(mKernel.IntegrateShape(ipValues), c, numComponents, &result);
+    }
+    return result;
+}
+
+template <int TDim>
+Eigen::VectorXd SumFactorizedCell<TDim>::LaplaceApply(const Eigen::VectorXd& nodeValues, double conductivity) const
+{
+    Eigen::MatrixXd derivatives = mKernel.InterpolateDerivatives(nodeValues);
+    for (int iIP = 0; iIP < derivatives.rows(); ++iIP)
+    {
+        const Matrix& invJ = mInverseJacobians[iIP];
+        const Eigen::Matrix<double, TDim, 1> gradient = invJ.transpose() * derivatives.row(iIP).transpose();
+        derivatives.row(iIP) = (conductivity * mDetJw[iIP]) * (invJ * gradient).transpose();
+    }
+    return mKernel.IntegrateDerivatives(derivatives);
+}
+
+template <int TDim>
+std::vector<Eigen::Matrix<double, TDim, TDim>, Eigen::aligned_allocator<Eigen::Matrix<double, TDim, TDim>>>
+SumFactorizedCell<TDim>::DisplacementGradients(const Eigen::VectorXd& u) const
+{
+    const int numIps = mKernel.GetNumIntegrationPoints();
+    std::vector<Matrix, Eigen::aligned_allocator<Matrix>> gradients(numIps);
+    for (int c = 0; c < TDim; ++c)
+    {
+        const Eigen::MatrixXd derivatives = mKernel.InterpolateDerivatives(Component(u, c, TDim));
+        for (int iIP = 0; iIP < numIps; ++iIP)
+            gradients[iIP].row(c) = derivatives.row(iIP) * mInverseJacobians[iIP];
+    }
+    return gradients;
+}
+
+template <int TDim>
+Eigen::VectorXd SumFactorizedCell<TDim>::IntegrateStresses(
+        const std::vector<Matrix, Eigen::aligned_allocator<Matrix>>& stresses) const
+{
+    const int numIps = mKernel.GetNumIntegrationPoints();
+    Eigen::VectorXd result(TDim * mKernel.GetNumNodes());
+    Eigen::MatrixXd naturalFluxes(numIps, TDim);
+    for (int c = 0; c < TDim; ++c)
+    {
+        for (int iIP = 0; iIP < numIps; ++iIP)
+            naturalFluxes.row(iIP) = mDetJw[iIP] * (mInverseJacobians[iIP] * stresses[iIP].row(c).transpose());
+        SetComponent(mKernel.IntegrateDerivatives(naturalFluxes), c, TDim, &result);
+    }
+    return result;
+}
+
+namespace
+{
+//! @return engineering strain of the displacement gradient `H`
+template <int TDim>
+EngineeringStrain<TDim> StrainFromGradient(const Eigen::Matrix<double, TDim, TDim>& H)
+{
+    EngineeringStrain<TDim> strain = EngineeringStrain<TDim>::Zero();
+    for (const auto& entry : Nabla::StrainPattern<TDim>::Entries())
+        strain[entry[0]] += H(entry[1], entry[2]);
+    return strain;
+}
+
+//! @return symmetric stress tensor of the stress in voigt notation
+template <int TDim>
+Eigen::Matrix<double, TDim, TDim> StressTensor(const EngineeringStress<TDim>& stress)
+{
+    Eigen::Matrix<double, TDim, TDim> S;
+    for (const auto& entry : Nabla::StrainPattern<TDim>::Entries())
+        S(entry[1], entry[2]) = stress[entry[0]];
+    return S;
+}
+
+} /* anonymous namespace */
+
+template <int TDim>
+Eigen::VectorXd SumFactorizedCell<TDim>::MomentumBalanceGradient(const Eigen::VectorXd& displacements,
+                                                                 const Laws::MechanicsInterface<TDim>& law,
+                                                                 double deltaT, int cellId) const
+{
+    std::vector<Matrix, Eigen::aligned_allocator<Matrix>> tensors = DisplacementGradients(displacements);
+    for (size_t iIP = 0; iIP < tensors.size(); ++iIP)
+    {
+        const EngineeringStress<TDim> stress =
+                law.Stress(StrainFromGradient<TDim>(tensors[iIP]), deltaT, {cellId, static_cast<int>(iIP)});
+        tensors[iIP] = StressTensor<TDim>(stress);
+    }
+    return IntegrateStresses(tensors);
+}
+
+template <int TDim>
+typename SumFactorizedCell<TDim>::Tangents
+SumFactorizedCell<TDim>::MomentumBalanceTangents(const Eigen::VectorXd& displacements,
+                                                 const Laws::MechanicsInterface<TDim>& law, double deltaT,
+                                                 int cellId) const
+{
+    const std::vector<Matrix, Eigen::aligned_allocator<Matrix>> gradients = DisplacementGradients(displacements);
+    Tangents tangents(gradients.size());
+    for (size_t iIP = 0; iIP < gradients.size(); ++iIP)
+        tangents[iIP] = law.Tangent(StrainFromGradient<TDim>(gradients[iIP]), deltaT, {cellId, static_cast<int>(iIP)});
+    return tangents;
+}
+
+template <int TDim>
+Eigen::VectorXd SumFactorizedCell<TDim>::ApplyTangents(const Tangents& tangents, const Eigen::VectorXd& x) const
+{
+    std::vector<Matrix, Eigen::aligned_allocator<Matrix>> tensors = DisplacementGradients(x);
+    for (size_t iIP = 0; iIP < tensors.size(); ++iIP)
+    {
+        const EngineeringStress<TDim> stressIncrement = tangents[iIP] * StrainFromGradient<TDim>(tensors[iIP]);
+        tensors[iIP] = StressTensor<TDim>(stressIncrement);
+    }
+    return IntegrateStresses(tensors);
+}
+
+template <int TDim>
+Eigen::VectorXd SumFactorizedCell<TDim>::MomentumBalanceHessian0Apply(const Eigen::VectorXd& displacements,
+                                                                      const Eigen::VectorXd& x,
+                                                                      const Laws::MechanicsInterface<TDim>& law,
+                                                                      double deltaT, int cellId) const
+{
+    return ApplyTangents(MomentumBalanceTangents(displacements, law, deltaT, cellId), x);
+}
+
+template <int TDim>
+Eigen::MatrixXd SumFactorizedCell<TDim>::MomentumBalanceHessian0(const Eigen::VectorXd& displacements,
+                                                                 const Laws::MechanicsInterface<TDim>& law,
+                                                                 double deltaT, int cellId) const
+{
+    const Tangents tangents = MomentumBalanceTangents(displacements, law, deltaT, cellId);
+    const int numDofs = displacements.rows();
+    Eigen::MatrixXd hessian0(numDofs, numDofs);
+    Eigen::VectorXd unit = Eigen::VectorXd::Zero(numDofs);
+    for (int j = 0; j < numDofs; ++j)
+    {
+        unit[j] = 1;
+        hessian0.col(j) = ApplyTangents(tangents, unit);
+        unit[j] = 0;
+    }
+    return hessian0;
+}
+
+template <int TDim>
+SumFactorizedBatch<TDim>::SumFactorizedBatch(Group<ElementCollectionFem> elements,
+                                             const SumFactorization<TDim>& kernel, DofType dofType,
+                                             const Laws::MechanicsInterface<TDim>& law, int cellStartId)
+    : mDofType(dofType)
+    , mLaw(law)
+    , mCellStartId(cellStartId)
+{
+    if (dofType.GetNum() != TDim)
+        throw Exception(__PRETTY_FUNCTION__, "The dof type " + dofType.GetName() + " must have " +
+                                                     std::to_string(TDim) + " components.");
+
+    mDofElements.reserve(elements.Size());
+    mCells.reserve(elements.Size());
+    for (auto& element : elements)
+    {
+        const ElementFem& dofElement = element.DofElement(dofType);
+        if (dofElement.GetNumNodes() != kernel.GetNumNodes())
+            throw Exception(__PRETTY_FUNCTION__, "The dof element does not match the sum factorization.");
+
+        Eigen::VectorXd coordinates(TDim * kernel.GetNumNodes());
+        for (int iNode = 0; iNode < kernel.GetNumNodes(); ++iNode)
+            coordinates.segment<TDim>(TDim * iNode) =
+                    Interpolate(element.CoordinateElement(), dofElement.Interpolation().GetLocalCoords(iNode));
+
+        mDofElements.push_back(&dofElement);
+        mCells.emplace_back(kernel, coordinates);
+    }
+}
+
+template <int TDim>
+int SumFactorizedBatch<TDim>::NumCells() const
+{
+    return mCells.size();
+}
+
+template <int TDim>
+DofType SumFactorizedBatch<TDim>::GetDofType() const
+{
+    return mDofType;
+}
+
+template <int TDim>
+bool SumFactorizedBatch<TDim>::IsHessian0Symmetric() const
+{
+    return mLaw.HasSymmetricTangent();
+}
+
+template <int TDim>
+void SumFactorizedBatch<TDim>::AddGradient(DofVector<double>* rGradient, double deltaT) const
+{
+    Eigen::VectorXd& gradient = (*rGradient)[mDofType];
+    for (int iCell = 0; iCell < NumCells(); ++iCell)
+    {
+        const ElementFem& dofElement = *mDofElements[iCell];
+        const Eigen::VectorXi numbering = dofElement.GetDofNumbering();
+        const Eigen::VectorXd local = mCells[iCell].MomentumBalanceGradient(dofElement.ExtractNodeValues(), mLaw,
+                                                                            deltaT, mCellStartId + iCell);
+        for (int i = 0; i < numbering.rows(); ++i)
+            gradient[numbering[i]] += local[i];
+    }
+}
+
+template <int TDim>
+void SumFactorizedBatch<TDim>::AddHessian0(DofMatrixSparse<double>* rHessian, double deltaT,
+                                           eMatrixStorage storage) const
+{
+    Eigen::SparseMatrix<double>& hessian = (*rHessian)(mDofType, mDofType);
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int iCell = 0; iCell < NumCells(); ++iCell)
+    {
+        const ElementFem& dofElement = *mDofElements[iCell];
+        const Eigen::VectorXi numbering = dofElement.GetDofNumbering();
+        const Eigen::MatrixXd local = mCells[iCell].MomentumBalanceHessian0(dofElement.ExtractNodeValues(), mLaw,
+                                                                            deltaT, mCellStartId + iCell);
+        for (int j = 0; j < numbering.rows(); ++j)
+            for (int i = 0; i < numbering.rows(); ++i)
+                if (storage == eMatrixStorage::FULL or numbering[i] <= numbering[j])
+                    triplets.push_back({numbering[i], numbering[j], local(i, j)});
+    }
+    Eigen::SparseMatrix<double> cellHessians(hessian.rows(), hessian.cols());
+    cellHessians.setFromTriplets(triplets.begin(), triplets.end());
+    hessian += cellHessians;
+}
+
+template <int TDim>
+void SumFactorizedBatch<TDim>::AddHessian0Product(const Eigen::Ref<const Eigen::VectorXd>& x,
+                                                  Eigen::Ref<Eigen::VectorXd> rProduct, double deltaT) const
+{
+    for (int iCell = 0; iCell < NumCells(); ++iCell)
+    {
+        const ElementFem& dofElement = *mDofElements[iCell];
+        const Eigen::VectorXi numbering = dofElement.GetDofNumbering();
+        Eigen::VectorXd localX(numbering.rows());
+        for (int i = 0; i < numbering.rows(); ++i)
+            localX[i] = x[numbering[i]];
+        const Eigen::VectorXd local = mCells[iCell].MomentumBalanceHessian0Apply(
+                dofElement.ExtractNodeValues(), localX, mLaw, deltaT, mCellStartId + iCell);
+        for (int i = 0; i < numbering.rows(); ++i)
+            rProduct[numbering[i]] += local[i];
+    }
+}
+
+template <int TDim>
+void SumFactorizedBatch<TDim>::AddHessian0Diagonal(Eigen::Ref<Eigen::VectorXd> rDiagonal, double deltaT) const
+{
+    for (int iCell = 0; iCell < NumCells(); ++iCell)
+    {
+        const ElementFem& dofElement = *mDofElements[iCell];
+        const Eigen::VectorXi numbering = dofElement.GetDofNumbering();
+        const Eigen::VectorXd local = mCells[iCell]
+                                              .MomentumBalanceHessian0(dofElement.ExtractNodeValues(), mLaw, deltaT,
+                                                                       mCellStartId + iCell)
+                                              .diagonal();
+        for (int i = 0; i < numbering.rows(); ++i)
+            rDiagonal[numbering[i]] += local[i];
+    }
+}
+
+template class NuTo::SumFactorization<1>;
+template class NuTo::SumFactorization<2>;
+template class NuTo::SumFactorization<3>;
+template class NuTo::SumFactorizedCell<1>;
+template class NuTo::SumFactorizedCell<2>;
+template class NuTo::SumFactorizedCell<3>;
+template class NuTo::SumFactorizedBatch<1>;
+template class NuTo::SumFactorizedBatch<2>;
+template class NuTo::SumFactorizedBatch<3>;
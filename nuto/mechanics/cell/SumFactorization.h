@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/StdVector>
+#include "nuto/base/Group.h"
+#include "nuto/mechanics/cell/CellBatchInterface.h"
+#include "nuto/mechanics/constitutive/MechanicsInterface.h"
+#include "nuto/mechanics/elements/ElementCollection.h"
+#include "nuto/mechanics/elements/ElementInterface.h"
+#include "nuto/mechanics/integrationtypes/IntegrationTypeTensorProduct.h"
+
+namespace NuTo
+{
+//! @brief Sum factorized evaluation of tensor product shape functions at tensor product integration points
+//!
+//! The shape functions of InterpolationQuadLobatto/InterpolationBrickLobatto are products of 1D Lobatto shape
+//! functions N(x, y, z) = N_i(x) N_j(y) N_k(z) and the integration points of IntegrationTypeTensorProduct are tensor
+//! products of 1D points. Interpolating node values to all integration points is thus done by applying the small 1D
+//! matrices N_i(xi_q) direction by direction instead of multiplying with the dense (numIps x numNodes) matrix. With
+//! n = order + 1 nodes per direction, this reduces the cost from O(n^(2 TDim)) to O(n^(TDim + 1)).
+//! @tparam TDim dimension of the tensor product
+template <int TDim>
+class SumFactorization
+{
+public:
+    //! ctor
+    //! @param order order of the Lobatto interpolation, see InterpolationTrussLobatto(order)
+    //! @param integrationType tensor product integration type
+    SumFactorization(int order, const IntegrationTypeTensorProduct<TDim>& integrationType);
+
+    int GetNumNodes() const;
+
+    int GetNumIntegrationPoints() const;
+
+    double GetIntegrationPointWeight(int iIP) const;
+
+    //! @return values sum_i N_i(xi_q) u_i at all integration points q
+    //! @param nodeValues values of a scalar field at the nodes
+    Eigen::VectorXd Interpolate(const Eigen::VectorXd& nodeValues) const;
+
+    //! @return derivatives with respect to the natural coordinates at all integration points, [numIps x TDim]
+    //! @param nodeValues values of a scalar field at the nodes
+    Eigen::MatrixXd InterpolateDerivatives(const Eigen::VectorXd& nodeValues) const;
+
+    //! @brief transpose of Interpolate(...)
+    //! @return sum_q N_i(xi_q) ipValues_q for all nodes i
+    Eigen::VectorXd IntegrateShape(const Eigen::VectorXd& ipValues) const;
+
+    //! @brief transpose of InterpolateDerivatives(...)
+    //! @return sum_q sum_d dN_i/dxi_d(xi_q) ipValues(q, d) for all nodes i
+    Eigen::VectorXd IntegrateDerivatives(const Eigen::MatrixXd& ipValues) const;
+
+private:
+    //! @brief applies the 1D matrices `matrices[d]` in each direction d to `values`
+    Eigen::VectorXd Contract(const std::array<const Eigen::MatrixXd*, TDim>& matrices,
+                             const Eigen::VectorXd& values) const;
+
+    //! 1D shape functions (rows: integration points, cols: nodes)
+    Eigen::MatrixXd mN;
+    //! 1D shape function derivatives (rows: integration points, cols: nodes)
+    Eigen::MatrixXd mDN;
+    Eigen::MatrixXd mNTransposed;
+    Eigen::MatrixXd mDNTransposed;
+
+    int mNumNodes;
+    int mNumIps;
+    std::vector<double> mWeights;
+};
+
+//! @brief Matrix free operators of a single isoparametric Lobatto cell, evaluated via SumFactorization
+//! @remark The jacobians are calculated once in the ctor. Stores TDim^2 + 1 doubles per integration point.
+template <int TDim>
+class SumFactorizedCell
+{
+public:
+    //! ctor
+    //! @param kernel sum factorization of the interpolation and integration type of the cell
+    //! @param coordinateElement Lobatto coordinate element with kernel.GetNumNodes() nodes
+    SumFactorizedCell(const SumFactorization<TDim>& kernel, const ElementInterface& coordinateElement);
+
+    //! ctor
+    //! @param kernel sum factorization of the interpolation and integration type of the cell
+    //! @param nodeCoordinates coordinates of the kernel.GetNumNodes() Lobatto nodes, ordered in blocks per node
+    SumFactorizedCell(const SumFactorization<TDim>& kernel, const Eigen::VectorXd& nodeCoordinates);
+
+    //! @return M u, with the consistent mass matrix M of a field with any number of components
+    //! @param nodeValues node values ordered in blocks belonging to a node, like ElementInterface::ExtractNodeValues()
+    Eigen::VectorXd MassApply(const Eigen::VectorXd& nodeValues, double density = 1.) const;
+
+    //! @return K u, with the matrix K = int grad(N)^T grad(N) of a scalar field, e.g. for the wave equation
+    Eigen::VectorXd LaplaceApply(const Eigen::VectorXd& nodeValues, double conductivity = 1.) const;
+
+    //! @return int B^T sigma(B u), like Integrands::MomentumBalance::Gradient
+    //! @param cellId cell id that is passed to the law
+    Eigen::VectorXd MomentumBalanceGradient(const Eigen::VectorXd& displacements,
+                                            const Laws::MechanicsInterface<TDim>& law, double deltaT,
+                                            int cellId = 0) const;
+
+    //! @return int B^T C(B u) B x, the product of Integrands::MomentumBalance::Hessian0 with `x`
+    Eigen::VectorXd MomentumBalanceHessian0Apply(const Eigen::VectorXd& displacements, const Eigen::VectorXd& x,
+                                                 const Laws::MechanicsInterface<TDim>& law, double deltaT,
+                                                 int cellId = 0) const;
+
+    //! @return int B^T C(B u) B, the local matrix of Integrands::MomentumBalance::Hessian0
+    //! @remark The matrix is built column by column from the sum factorized products, for the assembled paths.
+    Eigen::MatrixXd MomentumBalanceHessian0(const Eigen::VectorXd& displacements,
+                                            const Laws::MechanicsInterface<TDim>& law, double deltaT,
+                                            int cellId = 0) const;
+
+private:
+    using Matrix = Eigen::Matrix<double, TDim, TDim>;
+    using Tangents = std::vector<EngineeringTangent<TDim>, Eigen::aligned_allocator<EngineeringTangent<TDim>>>;
+
+    //! @return tangents C(B u) of `law` at all integration points
+    Tangents MomentumBalanceTangents(const Eigen::VectorXd& displacements, const Laws::MechanicsInterface<TDim>& law,
+                                     double deltaT, int cellId) const;
+
+    //! @return int B^T C B x with the tangents C at all integration points
+    Eigen::VectorXd ApplyTangents(const Tangents& tangents, const Eigen::VectorXd& x) const;
+
+    //! @return displacement gradients du_c/dx_d at all integration points
+    std::vector<Matrix, Eigen::aligned_allocator<Matrix>> DisplacementGradients(const Eigen::VectorXd& u) const;
+
+    //! @return sum_q sum_d dN_i/dx_d S_q(c, d) detJ w for all nodes i and components c
+    Eigen::VectorXd IntegrateStresses(const std::vector<Matrix, Eigen::aligned_allocator<Matrix>>& stresses) const;
+
+    const SumFactorization<TDim>& mKernel;
+    std::vector<Matrix, Eigen::aligned_allocator<Matrix>> mInverseJacobians;
+    Eigen::VectorXd mDetJw;
+};
+
+//! @brief Momentum balance of a group of Lobatto cells, evaluated via SumFactorizedCell and assembled like a
+//! CellBatch, e.g. via TimeDependentProblem::AddBatch(...)
+//! @remark The displacement elements must use the Lobatto interpolation of the kernel. The coordinate elements may use
+//! any interpolation, their geometry is interpolated to the displacement nodes.
+template <int TDim>
+class SumFactorizedBatch : public CellBatchInterface
+{
+public:
+    //! ctor
+    //! @param elements group of elements with a `dofType` element each
+    //! @param kernel sum factorization of the displacement interpolation and the integration type
+    //! @param dofType displacement dof type with TDim components
+    //! @param law constitutive law, called with the same CellIds as the cells created by
+    //! CellStorage::AddCells(elements, integrationType, cellStartId)
+    //! @param cellStartId start id of the continuous cell numbering
+    SumFactorizedBatch(Group<ElementCollectionFem> elements, const SumFactorization<TDim>& kernel, DofType dofType,
+                       const Laws::MechanicsInterface<TDim>& law, int cellStartId = 0);
+
+    //! @return number of cells in the batch
+    int NumCells() const;
+
+    DofType GetDofType() const override;
+
+    bool IsHessian0Symmetric() const override;
+
+    void AddGradient(DofVector<double>* rGradient, double deltaT) const override;
+
+    void AddHessian0(DofMatrixSparse<double>* rHessian, double deltaT,
+                     eMatrixStorage storage = eMatrixStorage::FULL) const override;
+
+    void AddHessian0Product(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::Ref<Eigen::VectorXd> rProduct,
+                            double deltaT) const override;
+
+    void AddHessian0Diagonal(Eigen::Ref<Eigen::VectorXd> rDiagonal, double deltaT) const override;
+
+private:
+    DofType mDofType;
+    const Laws::MechanicsInterface<TDim>& mLaw;
+    int mCellStartId;
+
+    std::vector<const ElementFem*> mDofElements;
+    std::vector<SumFactorizedCell<TDim>> mCells;
+};
+} /* NuTo */
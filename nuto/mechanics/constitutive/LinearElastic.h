@@ -30,6 +30,11 @@ public:
         return mC;
     }
 
+    bool HasSymmetricTangent() const override
+    {
+        return true;
+    }
+
     void SetPlaneState(ePlaneState planeState)
     {
         mC = CalculateC(mE, mNu, planeState);
@@ -67,6 +67,19 @@ public:
                        mEvolution.DkappaDstrain(strain, deltaT, ids);
     }
 
+    std::pair<EngineeringStress<TDim>, EngineeringTangent<TDim>>
+    StressAndTangent(EngineeringStrain<TDim> strain, double deltaT, CellIds ids) const override
+    {
+        double kappa = mEvolution.Kappa(strain, deltaT, ids);
+        double omega = mDamageLaw.Damage(kappa);
+        double dOmegadKappa = mDamageLaw.Derivative(kappa);
+
+        EngineeringTangent<TDim> tangent = mElasticDamage.DstressDstrain(strain, omega) +
+                                           mElasticDamage.DstressDomega(strain, omega) * dOmegadKappa *
+                                                   mEvolution.DkappaDstrain(strain, deltaT, ids);
+        return {mElasticDamage.Stress(strain, omega), tangent};
+    }
+
     void Update(EngineeringStrain<TDim> strain, double deltaT, CellIds ids)
     {
         mEvolution.Update(strain, deltaT, ids);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <utility>
 #include "nuto/mechanics/constitutive/EngineeringStrain.h"
 #include "nuto/mechanics/constitutive/EngineeringStress.h"
 #include "nuto/mechanics/constitutive/EngineeringTangent.h"
@@ -14,6 +15,20 @@ struct MechanicsInterface
 {
     virtual EngineeringStress<TDim> Stress(EngineeringStrain<TDim> strain, double deltaT, CellIds ids) const = 0;
     virtual EngineeringTangent<TDim> Tangent(EngineeringStrain<TDim>, double deltaT, CellIds ids) const = 0;
+
+    //! @return true if Tangent(...) is symmetric for all possible states
+    virtual bool HasSymmetricTangent() const
+    {
+        return false;
+    }
+
+    //! @brief evaluates Stress(...) and Tangent(...) at once
+    //! @remark Override this if both share expensive intermediate results, e.g. history dependent variables.
+    virtual std::pair<EngineeringStress<TDim>, EngineeringTangent<TDim>>
+    StressAndTangent(EngineeringStrain<TDim> strain, double deltaT, CellIds ids) const
+    {
+        return {Stress(strain, deltaT, ids), Tangent(strain, deltaT, ids)};
+    }
 };
 } /* Laws */
 } /* NuTo */
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <vector>
+#include <eigen3/Eigen/Core>
+#include "nuto/mechanics/dofs/DofVector.h"
+
+namespace NuTo
+{
+
+//! @brief dof vector that stores the values of all its dof types in one contiguous buffer
+//! @remark The dof types and their sizes (the layout) are fixed in the ctor. The values of one dof type are a segment
+//! of the buffer, in the order of the dof types passed to the ctor. Thus, the whole vector is available as a single
+//! Eigen vector without copies, see Values() and ToEigen(const ContiguousDofVector<T>&, ...), and the arithmetic
+//! operations run on the whole buffer at once. The arithmetic operations require the same layout for both operands.
+//! @remark It is used by the matrix vector products of the matrix-free operators. NewtonRaphson::Solve, its line search
+//! and ConstrainedSystemSolver still work on DofVector, since the gradients and hessians of TimeDependentProblem are
+//! assembled into DofVectors. A flat vector there would only move the ToEigen/FromEigen copies to the assembly.
+template <typename T>
+class ContiguousDofVector
+{
+public:
+    using Vector = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+
+    ContiguousDofVector() = default;
+
+    //! @brief zero initialized vector
+    //! @param dofs dof types in the order of their segments
+    //! @param sizes number of values of each of the `dofs`
+    ContiguousDofVector(std::vector<DofType> dofs, const std::vector<int>& sizes)
+        : mDofs(dofs)
+    {
+        mValues.setZero(BuildSegments(sizes));
+    }
+
+    //! @brief vector with the layout of the ctor above that takes over the memory of `values`
+    //! @param values values of all `dofs`, one segment after the other
+    ContiguousDofVector(std::vector<DofType> dofs, const std::vector<int>& sizes, Vector&& values)
+        : mDofs(dofs)
+    {
+        const int totalRows = BuildSegments(sizes);
+        if (values.rows() != totalRows)
+            throw Exception(__PRETTY_FUNCTION__, "The dof types have " + std::to_string(totalRows) +
+                                                         " values in total, got " + std::to_string(values.rows()) +
+                                                         ".");
+        mValues = std::move(values);
+    }
+
+    //! @brief copies the `dofs` of `v` into a contiguous vector
+    ContiguousDofVector(const DofVector<T>& v, std::vector<DofType> dofs)
+        : ContiguousDofVector(dofs, Sizes(v, dofs))
+    {
+        for (const DofType& dof : dofs)
+            (*this)[dof] = v[dof];
+    }
+
+    //! @return view on the values of `dof`, throws if `dof` is not part of the layout
+    Eigen::VectorBlock<Vector> operator[](const DofType& dof)
+    {
+        const Segment& segment = mSegments[dof];
+        return mValues.segment(segment.start, segment.rows);
+    }
+
+    //! @return view on the values of `dof`, throws if `dof` is not part of the layout
+    Eigen::VectorBlock<const Vector> operator[](const DofType& dof) const
+    {
+        const Segment& segment = mSegments[dof];
+        return mValues.segment(segment.start, segment.rows);
+    }
+
+    T operator()(const DofType& dof, int globalDofNumber) const
+    {
+        return mValues[mSegments[dof].start + globalDofNumber];
+    }
+
+    bool Has(const DofType& dof) const
+    {
+        return mSegments.Has(dof);
+    }
+
+    //! @return position of the first value of `dof` in Values()
+    int Start(const DofType& dof) const
+    {
+        return mSegments[dof].start;
+    }
+
+    //! @return number of values of `dof`
+    int Rows(const DofType& dof) const
+    {
+        return mSegments[dof].rows;
+    }
+
+    //! @return dof types in the order of their segments
+    const std::vector<DofType>& DofTypes() const
+    {
+        return mDofs;
+    }
+
+    //! @return values of all dof types, one segment after the other
+    const Vector& Values() const
+    {
+        return mValues;
+    }
+
+    //! @return values of all dof types, one segment after the other
+    Vector& Values()
+    {
+        return mValues;
+    }
+
+    //! @return copy of the values as DofVector
+    DofVector<T> ToDofVector() const
+    {
+        DofVector<T> v;
+        for (const DofType& dof : mDofs)
+            v[dof] = (*this)[dof];
+        return v;
+    }
+
+    //! @return true if `other` has the same dof types with the same sizes in the same order
+    bool SameLayout(const ContiguousDofVector& other) const
+    {
+        if (mDofs.size() != other.mDofs.size() or mValues.rows() != other.mValues.rows())
+            return false;
+        for (size_t i = 0; i < mDofs.size(); ++i)
+            if (mDofs[i].Id() != other.mDofs[i].Id() or Rows(mDofs[i]) != other.Rows(mDofs[i]))
+                return false;
+        return true;
+    }
+
+    ContiguousDofVector& operator+=(const ContiguousDofVector& rhs)
+    {
+        ThrowOnDifferentLayout(rhs);
+        mValues += rhs.mValues;
+        return *this;
+    }
+
+    ContiguousDofVector& operator-=(const ContiguousDofVector& rhs)
+    {
+        ThrowOnDifferentLayout(rhs);
+        mValues -= rhs.mValues;
+        return *this;
+    }
+
+    ContiguousDofVector& operator*=(double scalar)
+    {
+        mValues *= scalar;
+        return *this;
+    }
+
+    friend ContiguousDofVector operator+(ContiguousDofVector lhs, const ContiguousDofVector& rhs)
+    {
+        lhs += rhs;
+        return lhs;
+    }
+
+    friend ContiguousDofVector operator-(ContiguousDofVector lhs, const ContiguousDofVector& rhs)
+    {
+        lhs -= rhs;
+        return lhs;
+    }
+
+    friend ContiguousDofVector operator*(ContiguousDofVector lhs, double scalar)
+    {
+        lhs *= scalar;
+        return lhs;
+    }
+
+    friend ContiguousDofVector operator*(double scalar, ContiguousDofVector rhs)
+    {
+        rhs *= scalar;
+        return rhs;
+    }
+
+    //! @brief calculates (*this) += `rhs` * `scalar`
+    void AddScaled(const ContiguousDofVector& rhs, double scalar)
+    {
+        ThrowOnDifferentLayout(rhs);
+        mValues += rhs.mValues * scalar;
+    }
+
+    void SetZero()
+    {
+        mValues.setZero();
+    }
+
+private:
+    struct Segment
+    {
+        int start;
+        int rows;
+    };
+
+    //! @return total number of values
+    int BuildSegments(const std::vector<int>& sizes)
+    {
+        if (mDofs.size() != sizes.size())
+            throw Exception(__PRETTY_FUNCTION__, "Provide one size per dof type.");
+        int start = 0;
+        for (size_t i = 0; i < mDofs.size(); ++i)
+        {
+            mSegments[mDofs[i]] = {start, sizes[i]};
+            start += sizes[i];
+        }
+        return start;
+    }
+
+    static std::vector<int> Sizes(const DofVector<T>& v, const std::vector<DofType>& dofs)
+    {
+        std::vector<int> sizes;
+        for (const DofType& dof : dofs)
+            sizes.push_back(v[dof].rows());
+        return sizes;
+    }
+
+    void ThrowOnDifferentLayout(const ContiguousDofVector& other) const
+    {
+        if (not SameLayout(other))
+            throw Exception(__PRETTY_FUNCTION__, "The dof vectors have different layouts.");
+    }
+
+    std::vector<DofType> mDofs;
+    DofContainer<Segment> mSegments;
+    Vector mValues;
+};
+} /* NuTo */
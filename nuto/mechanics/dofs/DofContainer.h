@@ -1,15 +1,34 @@
 #pragma once
 
-#include <map>
+#include <algorithm>
+#include <utility>
 #include <vector>
 #include "nuto/mechanics/dofs/DofType.h"
 
 namespace NuTo
 {
+//! @brief container that stores one T per dof type, similar to std::map<DofType, T>
+//! @remark The entries are stored in a compact array, sorted by DofType::Id(). A second array holds only the ids and
+//! is searched linearly. For the few dof types of a problem, this is faster than the tree traversal of the std::map
+//! and the memory does not depend on the ids. The iteration visits the entries in the order of their dof type ids,
+//! just like the std::map. Unlike the std::map, adding a new dof type may invalidate references to existing values.
+//! The entries are moved, not copied, in that case.
 template <typename T>
 class DofContainer
 {
+    using Entry = std::pair<DofType, T>;
+    using Entries = std::vector<Entry>;
+
 public:
+    //! @remark The iterators yield std::pair<DofType, T>. Modifying the dof type of an entry is not allowed.
+    using iterator = typename Entries::iterator;
+    using const_iterator = typename Entries::const_iterator;
+
+    DofContainer() = default;
+    DofContainer(const DofContainer&) = default;
+    DofContainer(DofContainer&&) = default;
+    DofContainer& operator=(const DofContainer&) = default;
+    DofContainer& operator=(DofContainer&&) = default;
     virtual ~DofContainer() = default;
 
     //! @brief nonconst access, similar to map::operator[]()
@@ -18,9 +37,12 @@ public:
     //          an existing value
     //          an newly default constructed value
     //! @remark This requires T to be default constructable.
-    T& operator[](DofType dofType)
+    T& operator[](const DofType& dofType)
     {
-        return mData[dofType];
+        const size_t index = LowerBound(dofType.Id());
+        if (index == mIds.size() or mIds[index] != dofType.Id())
+            Emplace(index, dofType, T());
+        return mEntries[index].second;
     }
 
     //! @brief nonconst access, similar to map::at()
@@ -28,46 +50,78 @@ public:
     //! @return reference to an existing value, throws if there is no value
     //! @remark This does not default construct a new T and thus does not
     //          require T to be default constructable.
-    T& At(DofType dofType)
+    T& At(const DofType& dofType)
     {
-        return mData.at(dofType);
+        return const_cast<T&>(static_cast<const DofContainer&>(*this)[dofType]);
     }
 
     //! @brief const access
     //! @param dofType dof type
     //! @return const reference to existing value, throws if there is no value
-    const T& operator[](DofType dofType) const
+    const T& operator[](const DofType& dofType) const
     {
-        return mData.at(dofType);
+        const size_t index = LowerBound(dofType.Id());
+        if (index == mIds.size() or mIds[index] != dofType.Id())
+            throw Exception(__PRETTY_FUNCTION__, "Container contains no entry for " + dofType.GetName() + ".");
+        return mEntries[index].second;
     }
 
     //! @brief copies a `t` into the container, throws, if there already is an entry at `dofType`
     //! @param dofType dof type
     //! @param t value to insert
-    void Insert(DofType dofType, T t)
+    void Insert(const DofType& dofType, T t)
     {
-        auto it = mData.emplace(dofType, t); // it = pair<iterator, bool>
-        if (not it.second)
+        const size_t index = LowerBound(dofType.Id());
+        if (index != mIds.size() and mIds[index] == dofType.Id())
             throw Exception(__PRETTY_FUNCTION__,
                             "Insert failed. Container already contains an entry for " + dofType.GetName() + ".");
+        Emplace(index, dofType, std::move(t));
+    }
+
+    bool Has(const DofType& dofType) const
+    {
+        return std::find(mIds.begin(), mIds.end(), dofType.Id()) != mIds.end();
+    }
+
+    iterator begin()
+    {
+        return mEntries.begin();
+    }
+
+    iterator end()
+    {
+        return mEntries.end();
+    }
+
+    const_iterator begin() const
+    {
+        return mEntries.begin();
     }
 
-    bool Has(DofType dofType) const
+    const_iterator end() const
     {
-        return mData.find(dofType) != mData.end();
+        return mEntries.end();
     }
 
-    auto begin() const
+private:
+    //! @return index of the first entry whose id is not less than `id`
+    size_t LowerBound(int id) const
     {
-        return mData.begin();
+        size_t index = 0;
+        while (index < mIds.size() and mIds[index] < id)
+            ++index;
+        return index;
     }
 
-    auto end() const
+    void Emplace(size_t index, const DofType& dofType, T t)
     {
-        return mData.end();
+        mIds.reserve(mIds.size() + 1); // the insertion of the id below can then no longer throw
+        mEntries.emplace(mEntries.begin() + index, dofType, std::move(t));
+        mIds.insert(mIds.begin() + index, dofType.Id());
     }
 
-protected:
-    std::map<DofType, T, CompareDofType> mData;
+    //! @brief ids of the dof types of the entries, mIds[i] == mEntries[i].first.Id()
+    std::vector<int> mIds;
+    Entries mEntries;
 };
 } /* NuTo */
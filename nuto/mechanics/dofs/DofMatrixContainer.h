@@ -1,45 +1,51 @@
 #pragma once
 
-#include <map>
 #include <vector>
 #include <eigen3/Eigen/Core>
-#include "nuto/mechanics/dofs/DofType.h"
+#include "nuto/mechanics/dofs/DofContainer.h"
 
 namespace NuTo
 {
 
 //! @brief dof container that is also capable of performing calculations.
+//! @remark The blocks are stored in a DofContainer of rows that are DofContainers themselves, so the access to a block
+//! consists of two array lookups.
 template <typename T>
 class DofMatrixContainer
 {
 public:
-    T& operator()(DofType d0, DofType d1)
+    T& operator()(const DofType& d0, const DofType& d1)
     {
-        return this->mData[std::make_pair(d0, d1)];
+        return mData[d0][d1];
     }
 
-    const T& operator()(DofType d0, DofType d1) const
+    const T& operator()(const DofType& d0, const DofType& d1) const
     {
-        return this->mData.at(std::make_pair(d0, d1));
+        return mData[d0][d1];
     }
 
     //! @brief performs _uninitialized addition_ that resizes the data to the length of `rhs`
     DofMatrixContainer& operator+=(const DofMatrixContainer& rhs)
     {
-        for (auto& entry : rhs.mData)
+        for (auto& row : rhs.mData)
         {
-            if (mData.find(entry.first) != mData.end())
-                mData[entry.first] += entry.second;
-            else
-                mData[entry.first] = entry.second;
+            DofContainer<T>& thisRow = mData[row.first];
+            for (auto& entry : row.second)
+            {
+                if (thisRow.Has(entry.first))
+                    thisRow[entry.first] += entry.second;
+                else
+                    thisRow[entry.first] = entry.second;
+            }
         }
         return *this;
     }
 
     DofMatrixContainer& operator*=(double scalar)
     {
-        for (auto& entry : mData)
-            entry.second *= scalar;
+        for (auto& row : mData)
+            for (auto& entry : row.second)
+                entry.second *= scalar;
         return *this;
     }
 
@@ -60,23 +66,27 @@ public:
     //! scaled with DetJ and the integration point weight.
     void AddScaled(const DofMatrixContainer& rhs, double scalar)
     {
-        for (auto& entry : rhs.mData)
+        for (auto& row : rhs.mData)
         {
-            if (mData.find(entry.first) != mData.end())
-                mData[entry.first] += entry.second * scalar;
-            else
-                mData[entry.first] = entry.second * scalar;
+            DofContainer<T>& thisRow = mData[row.first];
+            for (auto& entry : row.second)
+            {
+                if (thisRow.Has(entry.first))
+                    thisRow[entry.first] += entry.second * scalar;
+                else
+                    thisRow[entry.first] = entry.second * scalar;
+            }
         }
     }
 
     friend std::ostream& operator<<(std::ostream& out, const DofMatrixContainer<T>& dofMatrix)
     {
-        for (auto& entry : dofMatrix.mData)
-        {
-            auto& dofs = entry.first;
-            out << "=== " << dofs.first.GetName() << " " << dofs.second.GetName() << " ===" << std::endl;
-            out << entry.second << std::endl;
-        }
+        for (auto& row : dofMatrix.mData)
+            for (auto& entry : row.second)
+            {
+                out << "=== " << row.first.GetName() << " " << entry.first.GetName() << " ===" << std::endl;
+                out << entry.second << std::endl;
+            }
         out << "====" << std::endl;
         return out;
     }
@@ -84,11 +94,12 @@ public:
     std::vector<DofType> DofTypes() const
     {
         std::vector<DofType> dofTypes;
-        for (const auto& data : mData)
-        {
-            AddUnique(&dofTypes, data.first.first);
-            AddUnique(&dofTypes, data.first.second);
-        }
+        for (const auto& row : mData)
+            for (const auto& entry : row.second)
+            {
+                AddUnique(&dofTypes, row.first);
+                AddUnique(&dofTypes, entry.first);
+            }
         return dofTypes;
     }
 
@@ -106,18 +117,6 @@ private:
             dofTypes->push_back(dofType);
     }
 
-    using DofPair = std::pair<DofType, DofType>;
-    struct CompareDofPairs
-    {
-        bool operator()(const DofPair& a, const DofPair& b) const
-        {
-            // check for equiv(a.first, b.first)
-            if (a.first.Id() == b.first.Id())
-                return a.second.Id() < b.second.Id();
-            else
-                return a.first.Id() < b.first.Id();
-        }
-    };
-    std::map<DofPair, T, CompareDofPairs> mData;
+    DofContainer<DofContainer<T>> mData;
 };
 } /* NuTo */
@@ -8,5 +8,15 @@ namespace NuTo
 //! @brief dof container that is also capable of performing calculations.
 template <typename T>
 using DofMatrixSparse = DofMatrixContainer<Eigen::SparseMatrix<T>>;
+
+//! @brief storage scheme of a DofMatrixSparse with respect to an ordered list of dof types
+enum class eMatrixStorage
+{
+    //! all entries of all blocks
+    FULL,
+    //! only the upper triangle of a symmetric matrix: the upper triangle of the diagonal blocks (dofI, dofI) and the
+    //! blocks (dofI, dofJ) where dofI is listed before dofJ. The remaining blocks are empty.
+    UPPER
+};
 }
 
@@ -1,35 +1,80 @@
 #include "nuto/mechanics/dofs/DofNumbering.h"
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include "nuto/math/GraphOrdering.h"
 
 using namespace NuTo;
 
+namespace
+{
+
 //! @brief build dof numbering, starting at 0, for all `nodes` regardless of constraints
+//! @param nodeOrder the i-th numbered node is nodes[nodeOrder[i]]
 //! @return total number of dofs in `nodes`
-int InitialUnconstrainedNumbering(const Group<NodeSimple>& nodes)
+int InitialUnconstrainedNumbering(const Group<NodeSimple>& nodes, const std::vector<int>& nodeOrder)
 {
     int dofNumber = 0;
-    for (auto& node : nodes)
+    for (int iNode : nodeOrder)
+    {
+        NodeSimple& node = *(nodes.begin() + iNode); // Group iterators give nonconst access
         for (int iComponent = 0; iComponent < node.GetNumValues(); ++iComponent)
             node.SetDofNumber(iComponent, dofNumber++);
+    }
     return dofNumber;
 }
 
-constexpr int INDEPENDENT = -1;
-
-//! @brief Find the status (INDEPENDENT or dependent) for all dof numbers.
-//! @return The status vector contains two information. Value INDEPENDENT means, well..., independent. Any value other
-//! than that is the index of the equation where this dof is the dependent one.
-std::vector<int> GetStatusOfDofNumber(const Constraint::Constraints& constraints, DofType dof, int numDofs)
+//! @brief graph of the `nodes`, connects the nodes of each dof element and each constraint equation
+AdjacencyList NodeGraph(const Group<NodeSimple>& nodes, DofType dof, const Constraint::Constraints& constraints,
+                        const Group<ElementCollectionFem>& elements)
 {
-    std::vector<int> dofStatus(numDofs, INDEPENDENT); // initialize as INDEPENDENT
+    std::unordered_map<const NodeSimple*, int> index;
+    for (size_t iNode = 0; iNode < nodes.Size(); ++iNode)
+        index.emplace(&nodes[iNode], iNode);
+
+    AdjacencyList adjacency(nodes.Size());
+    auto connect = [&](const std::vector<int>& clique) {
+        for (int i : clique)
+            for (int j : clique)
+                if (i != j)
+                    adjacency[i].push_back(j);
+    };
+
+    std::vector<int> clique;
+    for (const auto& element : elements)
+    {
+        if (not element.Has(dof))
+            continue;
+        const ElementFem& dofElement = element.DofElement(dof);
+        clique.clear();
+        for (int iNode = 0; iNode < dofElement.GetNumNodes(); ++iNode)
+        {
+            auto it = index.find(&dofElement.GetNode(iNode));
+            if (it != index.end())
+                clique.push_back(it->second);
+        }
+        connect(clique);
+    }
+
     for (int iEquation = 0; iEquation < constraints.GetNumEquations(dof); ++iEquation)
     {
-        int dependentDofNumber = constraints.GetEquation(dof, iEquation).GetDependentDofNumber();
-        dofStatus.at(dependentDofNumber) = iEquation;
+        const auto& equation = constraints.GetEquation(dof, iEquation);
+        clique = {index.at(&equation.GetDependentTerm().GetNode())};
+        for (const auto& term : equation.GetIndependentTerms())
+            clique.push_back(index.at(&term.GetNode()));
+        connect(clique);
+    }
+
+    for (auto& neighbors : adjacency)
+    {
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
     }
-    return dofStatus;
+    return adjacency;
 }
 
-DofInfo DofNumbering::Build(const Group<NodeSimple>& dofNodes, DofType dof, const Constraint::Constraints& constraints)
+//! @brief throws if the constraints contain nodes that are not part of `dofNodes`
+void CheckConstraintNodes(const Group<NodeSimple>& dofNodes, DofType dof, const Constraint::Constraints& constraints)
 {
     for (int iEquation = 0; iEquation < constraints.GetNumEquations(dof); ++iEquation)
     {
@@ -47,15 +92,42 @@ DofInfo DofNumbering::Build(const Group<NodeSimple>& dofNodes, DofType dof, cons
                                         "may have selected the wrong nodes (coordinate nodes?) "
                                         "from the mesh.");
     }
+}
 
+//! @brief numbers the nodes in the order `nodeOrder`, see InitialUnconstrainedNumbering
+DofInfo BuildInOrder(const Group<NodeSimple>& dofNodes, DofType dof, const Constraint::Constraints& constraints,
+                     const std::vector<int>& nodeOrder)
+{
     int numDependentDofs = constraints.GetNumEquations(dof);
-    const int numDofs = InitialUnconstrainedNumbering(dofNodes);
+    const int numDofs = InitialUnconstrainedNumbering(dofNodes, nodeOrder);
 
     DofInfo dofInfo;
     dofInfo.numDependentDofs[dof] = numDependentDofs;
     dofInfo.numIndependentDofs[dof] = numDofs - numDependentDofs;
     return dofInfo;
 }
+} // namespace
+
+DofInfo DofNumbering::Build(const Group<NodeSimple>& dofNodes, DofType dof, const Constraint::Constraints& constraints)
+{
+    CheckConstraintNodes(dofNodes, dof, constraints);
+    std::vector<int> nodeOrder(dofNodes.Size());
+    std::iota(nodeOrder.begin(), nodeOrder.end(), 0);
+    return BuildInOrder(dofNodes, dof, constraints, nodeOrder);
+}
+
+DofInfo DofNumbering::Build(const Group<NodeSimple>& dofNodes, DofType dof, const Constraint::Constraints& constraints,
+                            const Group<ElementCollectionFem>& elements, eDofOrdering ordering)
+{
+    if (ordering == eDofOrdering::NATURAL)
+        return Build(dofNodes, dof, constraints);
+
+    CheckConstraintNodes(dofNodes, dof, constraints);
+    const AdjacencyList graph = NodeGraph(dofNodes, dof, constraints, elements);
+    const std::vector<int> nodeOrder =
+            ordering == eDofOrdering::RCM ? ReverseCuthillMcKee(graph) : NestedDissection(graph);
+    return BuildInOrder(dofNodes, dof, constraints, nodeOrder);
+}
 
 std::vector<int> DofNumbering::Get(const Group<NodeSimple>& dofNodes, int component)
 {
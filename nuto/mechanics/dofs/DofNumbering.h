@@ -4,11 +4,23 @@
 
 #include "nuto/mechanics/dofs/DofInfo.h"
 #include "nuto/mechanics/constraints/Constraints.h"
+#include "nuto/mechanics/elements/ElementCollection.h"
 #include "nuto/mechanics/nodes/NodeSimple.h"
 
 namespace NuTo
 {
 
+//! @brief order in which DofNumbering::Build numbers the dof nodes, the components of a node stay consecutive
+enum class eDofOrdering
+{
+    //! order of the dof nodes
+    NATURAL,
+    //! reverse Cuthill-McKee, small bandwidth and profile, see NuTo::ReverseCuthillMcKee
+    RCM,
+    //! nested dissection, small fill-in of direct sparse factorizations, see NuTo::NestedDissection
+    NESTED_DISSECTION
+};
+
 namespace DofNumbering
 {
 
@@ -16,6 +28,14 @@ namespace DofNumbering
 //! @remark Numbering starts at 0 with all the dofs that are not constrained. Constrained dofs have the highest numbers
 DofInfo Build(const Group<NodeSimple>& dofNodes, DofType dof, const Constraint::Constraints& constraints);
 
+//! Builds the dof numbering like Build(dofNodes, dof, constraints), but numbers the nodes in the order `ordering` of
+//! the node graph. Two nodes are connected if they are part of the same dof element of `elements` or of the same
+//! constraint equation.
+//! @remark The solvers in NuTo::EigenSparseSolve(...) compute their own fill-reducing ordering. RCM and
+//! NESTED_DISSECTION pay off for solvers without one, the iterative solvers and the cache reuse in the assembly.
+DofInfo Build(const Group<NodeSimple>& dofNodes, DofType dof, const Constraint::Constraints& constraints,
+              const Group<ElementCollectionFem>& elements, eDofOrdering ordering);
+
 //! Extracts the dof numbers from `dofNodes` for a given component (0 for scalar, x=0, y=1, z=2 for vector dofs)
 std::vector<int> Get(const Group<NodeSimple>& dofNodes, int component = 0);
 
@@ -1,9 +1,8 @@
 #pragma once
 
-#include <map>
 #include <vector>
 #include <eigen3/Eigen/Core>
-#include "nuto/mechanics/dofs/DofType.h"
+#include "nuto/mechanics/dofs/DofContainer.h"
 
 namespace NuTo
 {
@@ -17,7 +16,7 @@ public:
     //! @return const reference to existing value, throws if there is no value
     const Eigen::Matrix<T, Eigen::Dynamic, 1>& operator[](const DofType& dofType) const
     {
-        return mData.at(dofType);
+        return mData[dofType];
     }
 
     //! @brief nonconst access
@@ -36,7 +35,7 @@ public:
     {
         for (auto& entry : rhs.mData)
         {
-            if (mData.find(entry.first) != mData.end())
+            if (mData.Has(entry.first))
                 mData[entry.first] += entry.second;
             else
                 mData[entry.first] = entry.second;
@@ -49,7 +48,7 @@ public:
     {
         for (auto& entry : rhs.mData)
         {
-            if (mData.find(entry.first) != mData.end())
+            if (mData.Has(entry.first))
                 mData[entry.first] -= entry.second;
             else
                 mData[entry.first] = -entry.second;
@@ -120,6 +119,15 @@ public:
         return out;
     }
 
+    //! @brief scalar product over the dof types of `a`, `b` has to contain them as well
+    friend T Dot(const DofVector& a, const DofVector& b)
+    {
+        T dot = 0;
+        for (auto& entry : a.mData)
+            dot += entry.second.dot(b[entry.first]);
+        return dot;
+    }
+
     //! @brief calculates (*this) += `rhs` * `scalar`
     //! @remark This is the common case in the numerical integration - summing up all integration point contributions
     //! scaled with DetJ and the integration point weight.
@@ -127,7 +135,7 @@ public:
     {
         for (auto& entry : rhs.mData)
         {
-            if (mData.find(entry.first) != mData.end())
+            if (mData.Has(entry.first))
                 mData[entry.first] += entry.second * scalar;
             else
                 mData[entry.first] = entry.second * scalar;
@@ -145,7 +153,7 @@ public:
 
 protected:
     //! @brief data container
-    std::map<DofType, Eigen::Matrix<T, Eigen::Dynamic, 1>, CompareDofType> mData;
+    DofContainer<Eigen::Matrix<T, Eigen::Dynamic, 1>> mData;
 };
 
 } /* NuTo */
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "nuto/mechanics/dofs/DofVector.h"
+#include "nuto/mechanics/dofs/ContiguousDofVector.h"
 
 namespace NuTo
 {
@@ -51,4 +51,49 @@ inline void FromEigen(const Eigen::Matrix<T, Eigen::Dynamic, 1>& source, std::ve
         currentStartRow += rows;
     }
 }
+
+template <typename T>
+inline int TotalRows(const ContiguousDofVector<T>& v, const std::vector<DofType>& dofs)
+{
+    int totalRows = 0;
+    for (auto dof : dofs)
+        totalRows += v.Rows(dof);
+    return totalRows;
+}
+
+//! @brief zero-copy view on the dofs entries of a ContiguousDofVector
+//! @param v dof vector to export
+//! @param dofs dof types to export, they have to be consecutive segments of `v` in the same order, e.g.
+//! v.DofTypes()
+//! @return map of the combined subvectors of v
+template <typename T>
+inline Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>> ToEigen(const ContiguousDofVector<T>& v,
+                                                                     const std::vector<DofType>& dofs)
+{
+    if (dofs.empty())
+        return {v.Values().data(), 0};
+    int rows = 0;
+    for (const DofType& dof : dofs)
+    {
+        if (v.Start(dof) != v.Start(dofs.front()) + rows)
+            throw Exception(__PRETTY_FUNCTION__, "The dof types are not consecutive in the dof vector.");
+        rows += v.Rows(dof);
+    }
+    return {v.Values().data() + v.Start(dofs.front()), rows};
+}
+
+//! @brief imports values into a ContiguousDofVector
+//! @param source eigen vector whose values are imported
+//! @param dofs dof types to import, consecutive segments of `rDestination`, see ToEigen(const ContiguousDofVector&,
+//! ...)
+//! @param rDestination properly sized dof vector
+template <typename T>
+inline void FromEigen(const Eigen::Matrix<T, Eigen::Dynamic, 1>& source, const std::vector<DofType>& dofs,
+                      ContiguousDofVector<T>* rDestination)
+{
+    assert(rDestination != nullptr);
+    const auto destination = ToEigen(*rDestination, dofs);
+    assert(destination.rows() == source.rows());
+    rDestination->Values().segment(destination.data() - rDestination->Values().data(), source.rows()) = source;
+}
 } /* NuTo */
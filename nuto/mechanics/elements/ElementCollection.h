@@ -1,6 +1,8 @@
 #pragma once
+#include <utility>
+#include <vector>
 #include "nuto/mechanics/elements/ElementInterface.h"
-#include "nuto/mechanics/dofs/DofContainer.h"
+#include "nuto/mechanics/dofs/DofType.h"
 #include "nuto/mechanics/elements/ElementFem.h"
 #include "nuto/mechanics/elements/ElementIga.h"
 
@@ -17,6 +19,7 @@ public:
     virtual ~ElementCollection() = default;
     virtual const ElementInterface& CoordinateElement() const = 0;
     virtual const ElementInterface& DofElement(DofType) const = 0;
+    virtual bool Has(DofType) const = 0;
     virtual const Shape& GetShape() const = 0;
 };
 
@@ -27,6 +30,9 @@ public:
 //! semantics. Additionally, the compiler is free to eliminate all the copies (whenever that is the right thing to do).
 //! The access to the underlying elements is provided via const-reference. This reference is implicitly casted to the
 //! base class ElementInterface.
+//! @remark The dof elements are stored in one contiguous array along with the ids of their dof types. A collection has
+//! few dof types, so the linear search is cheap, and neither the dof types nor a lookup structure are copied into
+//! each collection.
 template <typename TElement>
 class ElementCollectionImpl : public ElementCollection
 {
@@ -45,13 +51,10 @@ public:
     //! @param dofElement element to add
     void AddDofElement(DofType dofType, TElement dofElement)
     {
-        mDofElements.Insert(dofType, dofElement);
-        // The alternative implementation with
-        //        mDofElements[dofType] = dofElement
-        // will fail. The operator[] must be able default construct a new TElement, if it does not exist. It would then
-        // return a reference to it and dofElement can be copied/moved into it. Our elements are not default
-        // constructable (may require nodes, interpolations, ...). Thus, use Insert here, that copies/moves the entity
-        // into the DofContainer without a temporary, default constructed TElement.
+        if (Find(dofType) != nullptr)
+            throw Exception(__PRETTY_FUNCTION__,
+                            "Insert failed. Container already contains an entry for " + dofType.GetName() + ".");
+        mDofElements.emplace_back(dofType.Id(), std::move(dofElement));
     }
 
     //! @brief Getter for CoordinateElement
@@ -76,7 +79,10 @@ public:
     //! ElementCollection
     const TElement& DofElement(DofType dofType) const override
     {
-        return mDofElements[dofType];
+        const TElement* element = Find(dofType);
+        if (element == nullptr)
+            throw Exception(__PRETTY_FUNCTION__, "Container contains no entry for " + dofType.GetName() + ".");
+        return *element;
     }
 
     //! @brief nonconst Getter for DofElements
@@ -85,12 +91,12 @@ public:
     //! ElementCollection
     TElement& DofElement(DofType dofType)
     {
-        return mDofElements.At(dofType);
+        return const_cast<TElement&>(static_cast<const ElementCollectionImpl&>(*this).DofElement(dofType));
     }
 
-    bool Has(DofType dof) const
+    bool Has(DofType dof) const override
     {
-        return mDofElements.Has(dof);
+        return Find(dof) != nullptr;
     }
 
     const Shape& GetShape() const override
@@ -99,8 +105,18 @@ public:
     }
 
 private:
+    //! @return dof element of `dofType`, nullptr if there is none
+    const TElement* Find(const DofType& dofType) const
+    {
+        for (const auto& entry : mDofElements)
+            if (entry.first == dofType.Id())
+                return &entry.second;
+        return nullptr;
+    }
+
     TElement mCoordinateElement;
-    DofContainer<TElement> mDofElements;
+    //! @brief dof elements along with the ids of their dof types
+    std::vector<std::pair<int, TElement>> mDofElements;
     const Shape& mShape;
 };
 
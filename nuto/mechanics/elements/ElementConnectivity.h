@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+#include "nuto/mechanics/nodes/NodeSimple.h"
+#include "nuto/mechanics/interpolation/InterpolationSimple.h"
+
+namespace NuTo
+{
+//! @brief compressed (CSR) node connectivity of all elements with the same interpolation
+//! @remark The nodes of all elements are stored in a single array, nodes[element * numNodes + i]. All elements share
+//! the interpolation and thus the number of nodes, the row offsets of the CSR format are implicit. ElementFem is a
+//! view on one element of a connectivity.
+class ElementConnectivity
+{
+public:
+    //! @param interpolation interpolation of all elements, has to outlive this connectivity
+    explicit ElementConnectivity(const InterpolationSimple& interpolation)
+        : mInterpolation(&interpolation)
+        , mNumNodes(interpolation.GetNumNodes())
+    {
+    }
+
+    //! @brief adds an element with the `nodes`
+    //! @return index of the new element
+    int Add(const std::vector<NodeSimple*>& nodes)
+    {
+        assert(static_cast<int>(nodes.size()) == mNumNodes);
+        mNodes.insert(mNodes.end(), nodes.begin(), nodes.end());
+        return Size() - 1;
+    }
+
+    //! @brief adds an element with the `nodes`
+    //! @return index of the new element
+    int Add(std::initializer_list<std::reference_wrapper<NodeSimple>> nodes)
+    {
+        assert(static_cast<int>(nodes.size()) == mNumNodes);
+        for (NodeSimple& node : nodes)
+            mNodes.push_back(&node);
+        return Size() - 1;
+    }
+
+    //! @brief reserves memory for `numElements` elements in total
+    void Reserve(int numElements)
+    {
+        mNodes.reserve(numElements * mNumNodes);
+    }
+
+    //! @return number of elements
+    int Size() const
+    {
+        return mNodes.size() / mNumNodes;
+    }
+
+    //! @return number of nodes per element
+    int NumNodes() const
+    {
+        return mNumNodes;
+    }
+
+    //! @return `i`-th node of the element `element`
+    NodeSimple& Node(int element, int i) const
+    {
+        assert(i < mNumNodes);
+        assert(element < Size());
+        return *mNodes[element * mNumNodes + i];
+    }
+
+    const InterpolationSimple& Interpolation() const
+    {
+        return *mInterpolation;
+    }
+
+private:
+    const InterpolationSimple* mInterpolation;
+    int mNumNodes;
+    std::vector<NodeSimple*> mNodes;
+};
+} /* NuTo */
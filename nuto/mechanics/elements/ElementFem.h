@@ -1,33 +1,46 @@
 #pragma once
 
+#include <cassert>
 #include <vector>
 #include "nuto/mechanics/nodes/NodeSimple.h"
 #include "nuto/mechanics/elements/ElementInterface.h"
+#include "nuto/mechanics/elements/ElementConnectivity.h"
 #include "nuto/mechanics/interpolation/InterpolationSimple.h"
 #include "nuto/mechanics/cell/Matrix.h"
 
 namespace NuTo
 {
 
+//! @brief finite element with nodal interpolation
+//! @remark ElementFem is either a view on one element of an ElementConnectivity shared with other elements, e.g. the
+//! one of a mesh, see MeshFem::CreateElement, or a standalone element with its own list of nodes.
 class ElementFem : public ElementInterface
 {
 public:
     ElementFem(std::vector<NodeSimple*> nodes, const InterpolationSimple& interpolation)
-        : mInterpolation(interpolation)
-        , mShape(interpolation.GetShape())
+        : mInterpolation(&interpolation)
+        , mOwnNodes(std::move(nodes))
     {
-        for (NodeSimple* node : nodes)
-            mNodes.push_back(*node);
-        assert(static_cast<int>(mNodes.size()) == interpolation.GetNumNodes());
+        assert(static_cast<int>(mOwnNodes.size()) == interpolation.GetNumNodes());
     }
 
     ElementFem(std::initializer_list<std::reference_wrapper<NuTo::NodeSimple>> nodes,
                const InterpolationSimple& interpolation)
-        : mNodes(nodes)
-        , mInterpolation(interpolation)
-        , mShape(interpolation.GetShape())
+        : mInterpolation(&interpolation)
+    {
+        assert(static_cast<int>(nodes.size()) == interpolation.GetNumNodes());
+        mOwnNodes.reserve(nodes.size());
+        for (NodeSimple& node : nodes)
+            mOwnNodes.push_back(&node);
+    }
+
+    //! @brief view on the element `index` of a shared connectivity
+    //! @param rConnectivity connectivity that outlives this element
+    ElementFem(const ElementConnectivity* rConnectivity, int index)
+        : mInterpolation(&rConnectivity->Interpolation())
+        , mConnectivity(rConnectivity)
+        , mIndex(index)
     {
-        assert(static_cast<int>(mNodes.size()) == interpolation.GetNumNodes());
     }
 
     virtual Eigen::VectorXd ExtractNodeValues(int instance = 0) const override
@@ -76,35 +89,36 @@ public:
 
     int GetNumNodes() const override
     {
-        return mNodes.size();
+        return mConnectivity ? mConnectivity->NumNodes() : static_cast<int>(mOwnNodes.size());
     }
 
     const InterpolationSimple& Interpolation() const
     {
-        return mInterpolation;
+        return *mInterpolation;
     }
 
     NodeSimple& GetNode(int i)
     {
-        assert(i < static_cast<int>(mNodes.size()));
-        return mNodes[i];
+        return mConnectivity ? mConnectivity->Node(mIndex, i) : *mOwnNodes[i];
     }
 
 
     const NodeSimple& GetNode(int i) const
     {
-        assert(i < static_cast<int>(mNodes.size()));
-        return mNodes[i];
+        return mConnectivity ? mConnectivity->Node(mIndex, i) : *mOwnNodes[i];
     }
 
     const Shape& GetShape() const
     {
-        return mShape;
+        return Interpolation().GetShape();
     }
 
 private:
-    std::vector<std::reference_wrapper<NodeSimple>> mNodes;
-    std::reference_wrapper<const InterpolationSimple> mInterpolation;
-    const Shape& mShape;
+    const InterpolationSimple* mInterpolation;
+    //! @brief shared connectivity of the element, nullptr for a standalone element
+    const ElementConnectivity* mConnectivity = nullptr;
+    int mIndex = 0;
+    //! @brief nodes of a standalone element, empty for a view on a shared connectivity
+    std::vector<NodeSimple*> mOwnNodes;
 };
 } /* NuTo */
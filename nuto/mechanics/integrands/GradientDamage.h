@@ -124,6 +124,77 @@ public:
         mKappas(data.Ids().cellId, data.Ids().ipId) = Kappa(data);
     }
 
+    //! @brief fixed size version of Gradient(...) for NuTo::CellT
+    //! @return local gradient, the TDim * TNumNodes entries of mDisp followed by the TNumNodes entries of mEeq
+    //! @remark The fixed size versions use mKappas directly, overrides of Kappa(...) are not considered.
+    template <int TNumNodes>
+    Eigen::Matrix<double, (TDim + 1) * TNumNodes, 1> GradientT(const CellIpDataT<TDim, TNumNodes>& data)
+    {
+        constexpr int numDisp = TDim * TNumNodes;
+
+        const double eeq = data.Value(mEeq);
+        const double omega = mDamageLaw.Damage(std::max(mKappas(data.Ids().cellId, data.Ids().ipId), eeq));
+
+        const Eigen::Matrix<double, TDim, 1> eeqGradient = data.Gradient(mEeq);
+        const Eigen::Matrix<double, Voigt::Dim(TDim), numDisp> Bdisp = data.BStrain();
+        const NuTo::EngineeringStrain<TDim> strain = Bdisp * data.template NodeValueVector<TDim>(mDisp);
+
+        const double g = mInteraction.Factor(omega);
+
+        Eigen::Matrix<double, (TDim + 1) * TNumNodes, 1> gradient;
+        gradient.template head<numDisp>() = Bdisp.transpose() * mLinearElasticDamage.Stress(strain, omega);
+        gradient.template tail<TNumNodes>() = data.Shape().transpose() * (eeq - mNorm.Value(strain)) +
+                                              data.BGradient().transpose() * (mC * g * eeqGradient);
+        return gradient;
+    }
+
+    //! @brief fixed size version of Hessian0(...) for NuTo::CellT
+    //! @return local hessian with the blocks ordered like in GradientT(...)
+    template <int TNumNodes>
+    Eigen::Matrix<double, (TDim + 1) * TNumNodes, (TDim + 1) * TNumNodes>
+    Hessian0T(const CellIpDataT<TDim, TNumNodes>& data)
+    {
+        constexpr int numDisp = TDim * TNumNodes;
+
+        const double eeq = data.Value(mEeq);
+        const double kappaHistory = mKappas(data.Ids().cellId, data.Ids().ipId);
+        const double kappa = std::max(kappaHistory, eeq);
+        const double omega = mDamageLaw.Damage(kappa);
+        const double dKappa_dEeq = eeq >= kappaHistory ? 1 : 0;
+        const double dOmega_dKappa = mDamageLaw.Derivative(kappa);
+
+        const Eigen::Matrix<double, TDim, 1> eeqGradient = data.Gradient(mEeq);
+        const Eigen::Matrix<double, Voigt::Dim(TDim), numDisp> Bdisp = data.BStrain();
+        const NuTo::EngineeringStrain<TDim> strain = Bdisp * data.template NodeValueVector<TDim>(mDisp);
+
+        const Eigen::Matrix<double, 1, TNumNodes>& Neeq = data.Shape();
+        const Eigen::Matrix<double, TDim, TNumNodes> Beeq = data.BGradient();
+
+        const double g = mInteraction.Factor(omega);
+        const double dgdw = mInteraction.Derivative(omega);
+
+        Eigen::Matrix<double, (TDim + 1) * TNumNodes, (TDim + 1) * TNumNodes> hessian0;
+        hessian0.template topLeftCorner<numDisp, numDisp>() =
+                Bdisp.transpose() * mLinearElasticDamage.DstressDstrain(strain, omega) * Bdisp;
+        hessian0.template bottomLeftCorner<TNumNodes, numDisp>() =
+                -Neeq.transpose() * mNorm.Derivative(strain).transpose() * Bdisp;
+        hessian0.template bottomRightCorner<TNumNodes, TNumNodes>() =
+                Neeq.transpose() * Neeq + mC * g * Beeq.transpose() * Beeq +
+                Beeq.transpose() * mC * eeqGradient * dgdw * dOmega_dKappa * dKappa_dEeq * Neeq;
+        hessian0.template topRightCorner<numDisp, TNumNodes>() =
+                Bdisp.transpose() *
+                (mLinearElasticDamage.DstressDomega(strain, omega) * dOmega_dKappa * dKappa_dEeq) * Neeq;
+        return hessian0;
+    }
+
+    //! @brief fixed size version of Update(...) for NuTo::CellT
+    template <int TNumNodes>
+    void UpdateT(const CellIpDataT<TDim, TNumNodes>& data)
+    {
+        double& kappa = mKappas(data.Ids().cellId, data.Ids().ipId);
+        kappa = std::max(kappa, data.Value(mEeq));
+    }
+
     virtual double Kappa(const CellIpData& data) const
     {
         return std::max(mKappas(data.Ids().cellId, data.Ids().ipId), data.Value(mEeq));
@@ -7,6 +7,7 @@
 #include "nuto/mechanics/interpolation/TypeDefs.h"
 #include "nuto/mechanics/cell/CellIpData.h"
 #include "nuto/mechanics/cell/CellData.h"
+#include "nuto/mechanics/cell/CellIpDataT.h"
 
 namespace NuTo
 {
@@ -45,6 +46,59 @@ public:
         return hessian0;
     }
 
+    //! @brief material tangent D of Hessian0 = B^T D B, see TimeDependentProblem::AddHessian0TangentFunction
+    Eigen::MatrixXd Hessian0Tangent(const CellIpData& cellIpData, double deltaT)
+    {
+        return mLaw.Tangent(cellIpData.Apply(mDofType, Nabla::Strain()), deltaT, cellIpData.Ids());
+    }
+
+    //! @brief differential operator B of Hessian0 = B^T D B, see TimeDependentProblem::AddHessian0TangentFunction
+    const Eigen::MatrixXd& Hessian0Operator(const CellIpData& cellIpData) const
+    {
+        return cellIpData.B(mDofType, Nabla::Strain());
+    }
+
+    //! @return true if all the local Hessian0 matrices are symmetric, see TimeDependentProblem::AddHessian0Function
+    bool IsHessian0Symmetric() const
+    {
+        return mLaw.HasSymmetricTangent();
+    }
+
+    //! @brief Gradient(...) and Hessian0(...) with a single evaluation of the strain, the B matrix and the law
+    std::pair<DofVector<double>, DofMatrix<double>> GradientAndHessian0(const CellIpData& cellIpData, double deltaT)
+    {
+        std::pair<DofVector<double>, DofMatrix<double>> result;
+
+        Eigen::MatrixXd B = cellIpData.B(mDofType, Nabla::Strain());
+        auto stressAndTangent =
+                mLaw.StressAndTangent(cellIpData.Apply(mDofType, Nabla::Strain()), deltaT, cellIpData.Ids());
+        result.first[mDofType] = B.transpose() * stressAndTangent.first;
+        result.second(mDofType, mDofType) = B.transpose() * stressAndTangent.second * B;
+
+        return result;
+    }
+
+    //! @brief fixed size version of Gradient(...) for NuTo::CellT
+    //! @return local gradient of the displacement dof type
+    template <int TNumNodes>
+    Eigen::Matrix<double, TDim * TNumNodes, 1> GradientT(const CellIpDataT<TDim, TNumNodes>& data, double deltaT)
+    {
+        const Eigen::Matrix<double, Voigt::Dim(TDim), TDim * TNumNodes> B = data.BStrain();
+        const EngineeringStrain<TDim> strain = B * data.template NodeValueVector<TDim>(mDofType);
+        return B.transpose() * mLaw.Stress(strain, deltaT, data.Ids());
+    }
+
+    //! @brief fixed size version of Hessian0(...) for NuTo::CellT
+    //! @return local hessian of the displacement dof type
+    template <int TNumNodes>
+    Eigen::Matrix<double, TDim * TNumNodes, TDim * TNumNodes> Hessian0T(const CellIpDataT<TDim, TNumNodes>& data,
+                                                                       double deltaT)
+    {
+        const Eigen::Matrix<double, Voigt::Dim(TDim), TDim * TNumNodes> B = data.BStrain();
+        const EngineeringStrain<TDim> strain = B * data.template NodeValueVector<TDim>(mDofType);
+        return B.transpose() * mLaw.Tangent(strain, deltaT, data.Ids()) * B;
+    }
+
 protected:
     DofType mDofType;
 
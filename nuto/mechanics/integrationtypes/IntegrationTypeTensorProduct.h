@@ -47,6 +47,13 @@ public:
         return mShape;
     }
 
+    //! @brief returns the 1D integration point coordinates, the integration point rIpNum has the coordinates
+    //! (ip1D[rIpNum % n], ip1D[rIpNum / n % n], ...) with n = ip1D.size()
+    const std::vector<double>& GetIntegrationPointCoordinates1D() const
+    {
+        return mIPts1D;
+    }
+
 private:
     //! @brief 1D integration points coordinates
     std::vector<double> mIPts1D;
@@ -11,6 +11,35 @@ InterpolationSimple& MeshFem::CreateInterpolation(const InterpolationSimple& int
     return *mInterpolations.rbegin()->get();
 }
 
+ElementFem MeshFem::CreateElement(const std::vector<NodeSimple*>& nodes, const InterpolationSimple& interpolation)
+{
+    ElementConnectivity& connectivity = Connectivity(boost::none, interpolation);
+    return ElementFem(&connectivity, connectivity.Add(nodes));
+}
+
+ElementFem MeshFem::CreateElement(std::initializer_list<std::reference_wrapper<NodeSimple>> nodes,
+                                  const InterpolationSimple& interpolation)
+{
+    ElementConnectivity& connectivity = Connectivity(boost::none, interpolation);
+    return ElementFem(&connectivity, connectivity.Add(nodes));
+}
+
+ElementFem MeshFem::CreateDofElement(DofType dofType, const std::vector<NodeSimple*>& nodes,
+                                     const InterpolationSimple& interpolation)
+{
+    ElementConnectivity& connectivity = Connectivity(dofType, interpolation);
+    return ElementFem(&connectivity, connectivity.Add(nodes));
+}
+
+ElementConnectivity& MeshFem::Connectivity(boost::optional<DofType> dofType, const InterpolationSimple& interpolation)
+{
+    const int dofId = dofType ? dofType->Id() : -1;
+    auto& connectivity = mConnectivities[{dofId, &interpolation}];
+    if (connectivity == nullptr)
+        connectivity = std::make_unique<ElementConnectivity>(interpolation);
+    return *connectivity;
+}
+
 NodeSimple& MeshFem::NodeAtCoordinate(Eigen::VectorXd coords, DofType dofType, double tol /* = 1.e-10 */)
 {
     for (auto& element : this->Elements)
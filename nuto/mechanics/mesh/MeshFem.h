@@ -2,9 +2,11 @@
 #include "nuto/base/Group.h"
 #include "nuto/base/ValueVector.h"
 #include "nuto/mechanics/DirectionEnum.h"
-#include "nuto/mechanics/nodes/NodeSimple.h"
+#include "nuto/mechanics/nodes/NodeContainer.h"
 #include "nuto/mechanics/elements/ElementCollection.h"
 
+#include <boost/optional.hpp>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -13,6 +15,8 @@ namespace NuTo
 //! @brief contains the nodes, elements and interpolations for a classic finite element mesh
 //! @remark Elements contain references to nodes. Thus, a copy of MeshFem is not trivially possible and only move is
 //! allowed
+//! @remark The node lists of the elements are stored compactly in one ElementConnectivity per dof type and
+//! interpolation. Create the elements via CreateElement and CreateDofElement to use them.
 class MeshFem
 {
 public:
@@ -29,6 +33,29 @@ public:
     //! @return reference to the cloned object
     InterpolationSimple& CreateInterpolation(const InterpolationSimple& interpolation);
 
+    //! @brief adds the `nodes` to the connectivity of the coordinate elements with `interpolation`
+    //! @param nodes coordinate nodes of the element
+    //! @param interpolation interpolation of the element, has to outlive the mesh
+    //! @return element view on the new entry of the connectivity, e.g. to add it to `Elements`
+    ElementFem CreateElement(const std::vector<NodeSimple*>& nodes, const InterpolationSimple& interpolation);
+
+    //! @brief adds the `nodes` to the connectivity of the coordinate elements with `interpolation`
+    ElementFem CreateElement(std::initializer_list<std::reference_wrapper<NodeSimple>> nodes,
+                             const InterpolationSimple& interpolation);
+
+    //! @brief adds the `nodes` to the connectivity of the `dofType` elements with `interpolation`
+    //! @param dofType dof type
+    //! @param nodes dof nodes of the element
+    //! @param interpolation interpolation of the element, has to outlive the mesh
+    //! @return element view on the new entry of the connectivity, e.g. to add it to an element collection
+    ElementFem CreateDofElement(DofType dofType, const std::vector<NodeSimple*>& nodes,
+                                const InterpolationSimple& interpolation);
+
+    //! @brief connectivity of the elements of `dofType` with `interpolation`, created if it does not exist
+    //! @param dofType dof type, boost::none for the coordinate elements
+    //! @remark All elements created by this mesh are views on one of these connectivities.
+    ElementConnectivity& Connectivity(boost::optional<DofType> dofType, const InterpolationSimple& interpolation);
+
     //! @brief selects a coordinate at given `coords`
     //! @param coords global coordinates
     //! @param tol selection tolerance
@@ -74,10 +101,13 @@ public:
     void AllocateDofInstances(DofType dofType, int numInstances);
 
 public:
-    ValueVector<NodeSimple> Nodes;
+    NodeContainer Nodes;
     ValueVector<ElementCollectionFem> Elements;
 
 private:
     std::vector<std::unique_ptr<InterpolationSimple>> mInterpolations;
+
+    //! @brief connectivities per (dof type id or -1 for the coordinates, interpolation)
+    std::map<std::pair<int, const InterpolationSimple*>, std::unique_ptr<ElementConnectivity>> mConnectivities;
 };
 } /* NuTo */
@@ -200,12 +200,13 @@ void NuTo::AddDofInterpolation(NuTo::MeshFem* rMesh, DofType dofType, Group<Elem
             }
             else
             {
-                auto& node = rMesh->Nodes.Add(Eigen::VectorXd::Zero(dofType.GetNum()));
+                auto& node = rMesh->Nodes.AddDofNode(dofType, Eigen::VectorXd::Zero(dofType.GetNum()));
                 subBoxes.Add(NodePoint(coord, node));
                 nodesForTheNewlyCreatedElement.push_back(&node);
             }
         }
-        elementCollection.AddDofElement(dofType, ElementFem(nodesForTheNewlyCreatedElement, interpolation));
+        ElementFem dofElement = rMesh->CreateDofElement(dofType, nodesForTheNewlyCreatedElement, interpolation);
+        elementCollection.AddDofElement(dofType, dofElement);
     }
 }
 
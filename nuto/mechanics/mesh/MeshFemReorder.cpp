@@ -0,0 +1,57 @@
+#include "nuto/mechanics/mesh/MeshFemReorder.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+using namespace NuTo;
+
+namespace
+{
+
+//! @brief mean of the node coordinates of `element`
+Eigen::VectorXd Centroid(const ElementFem& element)
+{
+    Eigen::VectorXd centroid = Eigen::VectorXd::Zero(element.GetNode(0).GetNumValues());
+    for (int iNode = 0; iNode < element.GetNumNodes(); ++iNode)
+        centroid += element.GetNode(iNode).GetValues();
+    return centroid / element.GetNumNodes();
+}
+} // namespace
+
+void NuTo::ReorderAlongCurve(MeshFem* rMesh, eSpaceFillingCurve curve, std::vector<DofType> dofTypes)
+{
+    std::vector<Eigen::VectorXd> centroids;
+    centroids.reserve(rMesh->Elements.Size());
+    for (const auto& element : rMesh->Elements)
+        centroids.push_back(Centroid(element.CoordinateElement()));
+    rMesh->Elements.Reorder(SpaceFillingCurveOrder(centroids, curve));
+
+    // position of each node in the first touch order, untouched nodes keep their relative order at the end
+    std::unordered_map<const NodeSimple*, int> position;
+    auto touch = [&](const ElementFem& element) {
+        for (int iNode = 0; iNode < element.GetNumNodes(); ++iNode)
+            position.emplace(&element.GetNode(iNode), position.size());
+    };
+    for (const auto& element : rMesh->Elements)
+    {
+        touch(element.CoordinateElement());
+        for (DofType dof : dofTypes)
+            if (element.Has(dof))
+                touch(element.DofElement(dof));
+    }
+
+    const int numNodes = rMesh->Nodes.Size();
+    std::vector<int> firstTouch(numNodes, std::numeric_limits<int>::max());
+    for (int iNode = 0; iNode < numNodes; ++iNode)
+    {
+        auto it = position.find(&rMesh->Nodes[iNode]);
+        if (it != position.end())
+            firstTouch[iNode] = it->second;
+    }
+
+    std::vector<int> order(numNodes);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return firstTouch[a] < firstTouch[b]; });
+    rMesh->Nodes.Reorder(order);
+}
@@ -493,7 +493,8 @@ void NuTo::MeshGmsh::CreateElements(const GmshFileContent& fileContent,
                             .first;
         auto elementNodes = GetElementNodes(nodePtrs, gmshElement);
 
-        NuTo::ElementCollectionFem& element = mMesh.Elements.Add({{elementNodes, *(interpolationIter->second)}});
+        NuTo::ElementCollectionFem& element =
+                mMesh.Elements.Add(mMesh.CreateElement(elementNodes, *(interpolationIter->second)));
         CheckJacobian(element.CoordinateElement());
         AddElementToPhysicalGroup(fileContent, element, gmshElement.tags[0]);
     }
@@ -0,0 +1,213 @@
+#include "nuto/mechanics/mesh/StructuredMeshHierarchy.h"
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <string>
+#include "nuto/base/Exception.h"
+#include "nuto/mechanics/mesh/MeshFemDofConvert.h"
+#include "nuto/mechanics/mesh/UnitMeshFem.h"
+
+using namespace NuTo;
+
+namespace
+{
+
+int NumCells(const std::vector<int>& divisions)
+{
+    return std::accumulate(divisions.begin(), divisions.end(), 1, std::multiplies<int>());
+}
+
+//! @return structured index of the `i`th element of UnitMeshFem with `divisions`, x fastest
+std::vector<int> StructuredIndex(int i, const std::vector<int>& divisions)
+{
+    std::vector<int> index;
+    for (int numDivisions : divisions)
+    {
+        index.push_back(i % numDivisions);
+        i /= numDivisions;
+    }
+    return index;
+}
+
+//! @return position of the element or node with the structured `index` in the order of UnitMeshFem
+int LinearIndex(const std::vector<int>& index, const std::vector<int>& sizes)
+{
+    int i = 0;
+    for (int d = sizes.size() - 1; d >= 0; --d)
+        i = i * sizes[d] + index[d];
+    return i;
+}
+
+//! @return number of dofs of `dof` in the `elements`, i.e. the largest dof number + 1
+int NumDofs(const std::vector<const ElementCollectionFem*>& elements, DofType dof)
+{
+    int numDofs = 0;
+    for (const ElementCollectionFem* element : elements)
+    {
+        const ElementFem& dofElement = element->DofElement(dof);
+        for (int iNode = 0; iNode < dofElement.GetNumNodes(); ++iNode)
+            for (int component = 0; component < dof.GetNum(); ++component)
+                numDofs = std::max(numDofs, dofElement.GetNode(iNode).GetDofNumber(component) + 1);
+    }
+    return numDofs;
+}
+} // namespace
+
+StructuredMeshHierarchy::StructuredMeshHierarchy(const MeshFem& fine, std::vector<int> divisions,
+                                                 std::vector<DofType> dofs, int maxNumLevels)
+    : mFine(fine)
+    , mDofs(dofs)
+{
+    if (divisions.empty() or divisions.size() > 3)
+        throw Exception(__PRETTY_FUNCTION__, "The mesh has to be one, two or three dimensional.");
+    if (static_cast<int>(fine.Elements.Size()) != NumCells(divisions))
+        throw Exception(__PRETTY_FUNCTION__, "The mesh has " + std::to_string(fine.Elements.Size()) +
+                                                     " elements, the divisions require " +
+                                                     std::to_string(NumCells(divisions)) + ".");
+    for (DofType dof : mDofs)
+        if (not fine.Elements[0].Has(dof))
+            throw Exception(__PRETTY_FUNCTION__, "The mesh has no interpolation of " + dof.GetName() + ".");
+
+    mDivisions.push_back(divisions);
+    mElements.emplace_back();
+    for (const ElementCollectionFem& element : fine.Elements)
+        mElements.back().push_back(&element);
+
+    mCoarseMeshes.reserve(maxNumLevels);
+    while (NumLevels() < maxNumLevels and
+           std::all_of(mDivisions.back().begin(), mDivisions.back().end(), [](int n) { return n % 2 == 0; }))
+        Coarsen();
+}
+
+void StructuredMeshHierarchy::Coarsen()
+{
+    const int finer = NumLevels() - 1;
+    const std::vector<int>& fineDivisions = mDivisions[finer];
+    std::vector<int> divisions;
+    for (int n : fineDivisions)
+        divisions.push_back(n / 2);
+
+    const int dim = divisions.size();
+    MeshFem mesh = dim == 1 ? UnitMeshFem::CreateLines(divisions[0])
+                            : dim == 2 ? UnitMeshFem::CreateQuads(divisions[0], divisions[1])
+                                       : UnitMeshFem::CreateBricks(divisions[0], divisions[1], divisions[2]);
+
+    // the vertex (i, j, k) of the coarse mesh is the vertex (2i, 2j, 2k) of the finer mesh
+    std::vector<int> numVertices;
+    for (int n : divisions)
+        numVertices.push_back(n + 1);
+    for (int iVertex = 0; iVertex < NumCells(numVertices); ++iVertex)
+    {
+        const std::vector<int> vertex = StructuredIndex(iVertex, numVertices);
+        std::vector<int> fineElement(dim);
+        Eigen::VectorXd naturalCoords(dim);
+        for (int d = 0; d < dim; ++d)
+        {
+            fineElement[d] = std::min(2 * vertex[d], fineDivisions[d] - 1);
+            naturalCoords[d] = 2 * vertex[d] == fineDivisions[d] ? 1. : -1.;
+        }
+        mesh.Nodes[LinearIndex(vertex, numVertices)].SetValues(
+                Interpolate(Element(finer, fineElement).CoordinateElement(), naturalCoords));
+    }
+
+    for (DofType dof : mDofs)
+    {
+        const InterpolationSimple& fineInterpolation = mElements[finer].front()->DofElement(dof).Interpolation();
+        AddDofInterpolation(&mesh, dof, mesh.CreateInterpolation(fineInterpolation));
+        int dofNumber = 0;
+        for (NodeSimple& node : mesh.NodesTotal(dof))
+            for (int component = 0; component < dof.GetNum(); ++component)
+                node.SetDofNumber(component, dofNumber++);
+    }
+
+    mCoarseMeshes.push_back(std::move(mesh));
+    mDivisions.push_back(divisions);
+    mElements.emplace_back();
+    for (const ElementCollectionFem& element : mCoarseMeshes.back().Elements)
+        mElements.back().push_back(&element);
+}
+
+int StructuredMeshHierarchy::NumLevels() const
+{
+    return mDivisions.size();
+}
+
+const MeshFem& StructuredMeshHierarchy::Mesh(int level) const
+{
+    return level == 0 ? mFine : mCoarseMeshes.at(level - 1);
+}
+
+const std::vector<int>& StructuredMeshHierarchy::Divisions(int level) const
+{
+    return mDivisions.at(level);
+}
+
+const ElementCollectionFem& StructuredMeshHierarchy::Element(int level, const std::vector<int>& index) const
+{
+    return *mElements[level][LinearIndex(index, mDivisions[level])];
+}
+
+Eigen::SparseMatrix<double> StructuredMeshHierarchy::Prolongator(int level) const
+{
+    if (level < 0 or level + 1 >= NumLevels())
+        throw Exception(__PRETTY_FUNCTION__, "There is no prolongator from level " + std::to_string(level + 1) + ".");
+
+    const std::vector<int>& divisions = mDivisions[level];
+    std::vector<Eigen::Triplet<double>> triplets;
+    int rowOffset = 0;
+    int columnOffset = 0;
+    for (DofType dof : mDofs)
+    {
+        const int numFineDofs = NumDofs(mElements[level], dof);
+        std::vector<bool> isDone(numFineDofs, false);
+        for (size_t iElement = 0; iElement < mElements[level].size(); ++iElement)
+        {
+            // the fine element is the part `offset` of the coarse element
+            const std::vector<int> index = StructuredIndex(iElement, divisions);
+            std::vector<int> coarseIndex;
+            for (int i : index)
+                coarseIndex.push_back(i / 2);
+            const ElementFem& fineElement = mElements[level][iElement]->DofElement(dof);
+            const ElementFem& coarseElement = Element(level + 1, coarseIndex).DofElement(dof);
+
+            for (int iNode = 0; iNode < fineElement.GetNumNodes(); ++iNode)
+            {
+                const NodeSimple& node = fineElement.GetNode(iNode);
+                if (node.GetDofNumber(0) < 0)
+                    throw Exception(__PRETTY_FUNCTION__, "The dofs of " + dof.GetName() + " are not numbered.");
+                if (isDone[node.GetDofNumber(0)])
+                    continue;
+                isDone[node.GetDofNumber(0)] = true;
+
+                Eigen::VectorXd naturalCoords = fineElement.Interpolation().GetLocalCoords(iNode);
+                for (size_t d = 0; d < index.size(); ++d)
+                    naturalCoords[d] = 0.5 * (naturalCoords[d] + 2 * (index[d] % 2) - 1);
+
+                const Eigen::VectorXd N = coarseElement.Interpolation().GetShapeFunctions(naturalCoords);
+                for (int iCoarse = 0; iCoarse < coarseElement.GetNumNodes(); ++iCoarse)
+                {
+                    if (std::abs(N[iCoarse]) < 1.e-12)
+                        continue;
+                    const NodeSimple& coarseNode = coarseElement.GetNode(iCoarse);
+                    for (int component = 0; component < dof.GetNum(); ++component)
+                        triplets.emplace_back(rowOffset + node.GetDofNumber(component),
+                                              columnOffset + coarseNode.GetDofNumber(component), N[iCoarse]);
+                }
+            }
+        }
+        rowOffset += numFineDofs;
+        columnOffset += NumDofs(mElements[level + 1], dof);
+    }
+
+    Eigen::SparseMatrix<double> P(rowOffset, columnOffset);
+    P.setFromTriplets(triplets.begin(), triplets.end());
+    return P;
+}
+
+std::vector<Eigen::SparseMatrix<double>> StructuredMeshHierarchy::Prolongators() const
+{
+    std::vector<Eigen::SparseMatrix<double>> prolongators;
+    for (int level = 0; level + 1 < NumLevels(); ++level)
+        prolongators.push_back(Prolongator(level));
+    return prolongators;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <vector>
+#include <Eigen/Sparse>
+#include "nuto/mechanics/mesh/MeshFem.h"
+
+namespace NuTo
+{
+
+//! @brief hierarchy of structured meshes for the GeometricMultigrid, built by coarsening a mesh of
+//! UnitMeshFem::CreateLines, UnitMeshFem::CreateQuads or UnitMeshFem::CreateBricks
+//!
+//! Each coarser mesh has half the divisions of the finer one, as long as they are even. Its vertices are vertices of
+//! the finer mesh, thus the coarse meshes follow a mapping of UnitMeshFem::Transform. The dof elements of the coarse
+//! meshes use the dof interpolations of the fine mesh, the coarse dofs are numbered consecutively.
+//!
+//! The prolongators evaluate the coarse shape functions at the natural coordinates of the fine dof nodes. The fine
+//! elements are located in the coarse ones by their structured indices, no search is required and the mapping does
+//! not matter.
+class StructuredMeshHierarchy
+{
+public:
+    //! @param fine mesh of UnitMeshFem with the dof interpolations of all `dofs`, with its elements in the order of
+    //! their creation, i.e. before ReorderAlongCurve(...). Has to outlive the hierarchy.
+    //! @param divisions number of divisions of the `fine` mesh in each direction, e.g. {numX, numY}
+    //! @param dofs dof types of the prolongators, in the order of the system
+    //! @param maxNumLevels maximum number of meshes, including the fine one
+    StructuredMeshHierarchy(const MeshFem& fine, std::vector<int> divisions, std::vector<DofType> dofs,
+                            int maxNumLevels = 10);
+
+    //! @return number of meshes, including the fine one
+    int NumLevels() const;
+
+    //! @param level 0 is the fine mesh
+    const MeshFem& Mesh(int level) const;
+
+    const std::vector<int>& Divisions(int level) const;
+
+    //! @return prolongator from `level + 1` to `level` of all dofs, block diagonal in the order of the dofs
+    //! @remark The rows of level 0 are the current dof numbers of the fine mesh. Thus, call it after the dof numbering,
+    //! e.g. after QuasistaticSolver::SetConstraints(...).
+    Eigen::SparseMatrix<double> Prolongator(int level) const;
+
+    //! @return prolongators of all levels, see GeometricMultigrid::SetProlongators(...)
+    std::vector<Eigen::SparseMatrix<double>> Prolongators() const;
+
+private:
+    //! @return element of `level` with the structured `index`
+    const ElementCollectionFem& Element(int level, const std::vector<int>& index) const;
+
+    //! @brief adds the next coarser mesh to the hierarchy
+    void Coarsen();
+
+    const MeshFem& mFine;
+    std::vector<DofType> mDofs;
+    std::vector<std::vector<int>> mDivisions;
+
+    //! @brief elements of each level in their structured order
+    std::vector<std::vector<const ElementCollectionFem*>> mElements;
+
+    std::vector<MeshFem> mCoarseMeshes;
+};
+
+} /* NuTo */
@@ -37,11 +37,12 @@ MeshFem UnitMeshFem::CreateLines(int numX)
 {
     MeshFem mesh = CreateNodes1D(numX);
     const auto& interpolation = mesh.CreateInterpolation(NuTo::InterpolationTrussLinear());
+    mesh.Connectivity(boost::none, interpolation).Reserve(numX);
     for (int i = 0; i < numX; ++i)
     {
         auto& nl = mesh.Nodes[i];
         auto& nr = mesh.Nodes[i + 1];
-        mesh.Elements.Add({{{nl, nr}, interpolation}});
+        mesh.Elements.Add(mesh.CreateElement({nl, nr}, interpolation));
     }
     return mesh;
 }
@@ -51,6 +52,7 @@ MeshFem UnitMeshFem::CreateTriangles(int numX, int numY)
 {
     MeshFem mesh = CreateNodes2D(numX, numY);
     const auto& interpolation = mesh.CreateInterpolation(NuTo::InterpolationTriangleLinear());
+    mesh.Connectivity(boost::none, interpolation).Reserve(2 * numX * numY);
     for (int iY = 0; iY < numY; ++iY)
         for (int iX = 0; iX < numX; ++iX)
         {
@@ -58,8 +60,8 @@ MeshFem UnitMeshFem::CreateTriangles(int numX, int numY)
             auto& node1 = mesh.Nodes[iX + 1 + iY * (numX + 1)];
             auto& node2 = mesh.Nodes[iX + 1 + (iY + 1) * (numX + 1)];
             auto& node3 = mesh.Nodes[iX + (iY + 1) * (numX + 1)];
-            mesh.Elements.Add({{{node0, node1, node2}, interpolation}});
-            mesh.Elements.Add({{{node0, node2, node3}, interpolation}});
+            mesh.Elements.Add(mesh.CreateElement({node0, node1, node2}, interpolation));
+            mesh.Elements.Add(mesh.CreateElement({node0, node2, node3}, interpolation));
         }
     return mesh;
 }
@@ -68,6 +70,7 @@ MeshFem UnitMeshFem::CreateQuads(int numX, int numY)
 {
     MeshFem mesh = CreateNodes2D(numX, numY);
     const auto& interpolation = mesh.CreateInterpolation(NuTo::InterpolationQuadLinear());
+    mesh.Connectivity(boost::none, interpolation).Reserve(numX * numY);
     for (int iY = 0; iY < numY; ++iY)
         for (int iX = 0; iX < numX; ++iX)
         {
@@ -75,7 +78,7 @@ MeshFem UnitMeshFem::CreateQuads(int numX, int numY)
             auto& node1 = mesh.Nodes[iX + 1 + iY * (numX + 1)];
             auto& node2 = mesh.Nodes[iX + 1 + (iY + 1) * (numX + 1)];
             auto& node3 = mesh.Nodes[iX + (iY + 1) * (numX + 1)];
-            mesh.Elements.Add({{{node0, node1, node2, node3}, interpolation}});
+            mesh.Elements.Add(mesh.CreateElement({node0, node1, node2, node3}, interpolation));
         }
     return mesh;
 }
@@ -96,6 +99,7 @@ MeshFem UnitMeshFem::CreateBricks(int numX, int numY, int numZ)
                 mesh.Nodes.Add(Eigen::Vector3d(x, y, z));
             }
     const auto& interpolation = mesh.CreateInterpolation(NuTo::InterpolationBrickLinear());
+    mesh.Connectivity(boost::none, interpolation).Reserve(numX * numY * numZ);
     for (int iZ = 0; iZ < numZ; ++iZ)
         for (int iY = 0; iY < numY; ++iY)
             for (int iX = 0; iX < numX; ++iX)
@@ -108,7 +112,8 @@ MeshFem UnitMeshFem::CreateBricks(int numX, int numY, int numZ)
                 auto& node5 = mesh.Nodes[iX + 1 + iY * numXe + (iZ + 1) * numXe * numYe];
                 auto& node6 = mesh.Nodes[iX + 1 + (iY + 1) * numXe + (iZ + 1) * numXe * numYe];
                 auto& node7 = mesh.Nodes[iX + (iY + 1) * numXe + (iZ + 1) * numXe * numYe];
-                mesh.Elements.Add({{{node0, node1, node2, node3, node4, node5, node6, node7}, interpolation}});
+                mesh.Elements.Add(
+                        mesh.CreateElement({node0, node1, node2, node3, node4, node5, node6, node7}, interpolation));
             }
     return mesh;
 }
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cassert>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+#include <boost/iterator/indirect_iterator.hpp>
+#include "nuto/mechanics/dofs/DofType.h"
+#include "nuto/mechanics/nodes/NodeSimple.h"
+
+namespace NuTo
+{
+
+//! @brief container that stores nodes in structure of arrays storages and keeps references to the nodes valid
+//! @remark The values and dof numbers of the nodes are stored in one NodeStorage per dof type (and one per dimension
+//! for the coordinate nodes), the container holds lightweight NodeSimple handles to them. Apart from that, it behaves
+//! like a ValueVector<NodeSimple>.
+class NodeContainer
+{
+    using Data = std::vector<NodeSimple*>;
+    //! @brief indirect (dereferencing) iterator to provide value semantics for the iterators
+    typedef boost::indirect_iterator<typename Data::iterator> IndirectIterator;
+    typedef boost::indirect_iterator<typename Data::const_iterator> ConstIndirectIterator;
+
+public:
+    //! @brief constructs a node from `args` and adds it to the storage of the coordinate nodes
+    template <typename... TArgs>
+    NodeSimple& Add(TArgs&&... args)
+    {
+        return Add(NodeSimple(std::forward<TArgs>(args)...));
+    }
+
+    //! @brief adds a copy of `node` to the storage of the coordinate nodes
+    NodeSimple& Add(NodeSimple&& node)
+    {
+        return AddTo(Storage(-1, node.GetNumValues()), node);
+    }
+
+    //! @brief adds a node with the values `values` to the storage of the nodes of `dof`
+    NodeSimple& AddDofNode(DofType dof, const Eigen::VectorXd& values)
+    {
+        return AddTo(Storage(dof.Id(), values.rows()), NodeSimple(values));
+    }
+
+    IndirectIterator begin()
+    {
+        return mNodes.begin();
+    }
+
+    IndirectIterator end()
+    {
+        return mNodes.end();
+    }
+
+    ConstIndirectIterator begin() const
+    {
+        return mNodes.begin();
+    }
+
+    ConstIndirectIterator end() const
+    {
+        return mNodes.end();
+    }
+
+    typename Data::size_type Size() const
+    {
+        return mNodes.size();
+    }
+
+    const NodeSimple& operator[](int i) const
+    {
+        return *mNodes[i];
+    }
+
+    NodeSimple& operator[](int i)
+    {
+        return *mNodes[i];
+    }
+
+    //! @remark The values of erased nodes stay in their storage until the next Reorder(...).
+    IndirectIterator Erase(IndirectIterator it)
+    {
+        return mNodes.erase(it.base());
+    }
+
+    IndirectIterator Erase(IndirectIterator from, IndirectIterator to)
+    {
+        return mNodes.erase(from.base(), to.base());
+    }
+
+    //! @brief rearranges the nodes such that the i-th node is the previous `order[i]`-th node
+    //! @param order permutation of [0, Size()), references to the nodes stay valid
+    //! @remark The values in each storage are rearranged in the same order. The values of erased nodes are removed
+    //! from the storages, the erased nodes must not be used anymore.
+    void Reorder(const std::vector<int>& order)
+    {
+        assert(order.size() == mNodes.size());
+        Data reordered;
+        reordered.reserve(mNodes.size());
+        for (int i : order)
+            reordered.push_back(mNodes[i]);
+        mNodes = std::move(reordered);
+
+        std::map<NodeStorage*, std::vector<NodeSimple*>> nodesOfStorage;
+        for (NodeSimple* node : mNodes)
+            if (node->mOwnStorage == nullptr)
+                nodesOfStorage[node->mStorage].push_back(node);
+
+        for (auto& entry : nodesOfStorage)
+        {
+            NodeStorage& storage = *entry.first;
+            const std::vector<NodeSimple*>& nodes = entry.second;
+            std::vector<int> storageOrder;
+            for (const NodeSimple* node : nodes)
+                storageOrder.push_back(node->mIndex);
+            storage.Reorder(storageOrder);
+            for (size_t i = 0; i < nodes.size(); ++i)
+                nodes[i]->mIndex = i;
+        }
+    }
+
+private:
+    //! @return storage for the nodes of the dof type with the id `dofId`, -1 for the coordinate nodes
+    NodeStorage& Storage(int dofId, int dim)
+    {
+        auto& storage = mStorages[{dofId, dim}];
+        if (storage == nullptr)
+            storage = std::make_unique<NodeStorage>(dim);
+        return *storage;
+    }
+
+    NodeSimple& AddTo(NodeStorage& storage, const NodeSimple& node)
+    {
+        mHandles.emplace_back(&storage, storage.Add(node.GetNumInstances()));
+        NodeSimple& handle = mHandles.back();
+        handle.CopyFrom(node);
+        mNodes.push_back(&handle);
+        return handle;
+    }
+
+    std::map<std::pair<int, int>, std::unique_ptr<NodeStorage>> mStorages;
+    //! @brief handles to the nodes in the storages, a std::deque keeps references to them valid
+    std::deque<NodeSimple> mHandles;
+    //! @brief nodes in the order of the container
+    Data mNodes;
+};
+} /* NuTo */
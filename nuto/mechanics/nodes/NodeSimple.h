@@ -1,12 +1,18 @@
 #pragma once
 
 #include <Eigen/Core>
+#include <memory>
 #include <vector>
 #include <cassert>
+#include "nuto/base/Exception.h"
+#include "nuto/mechanics/nodes/NodeStorage.h"
 
 namespace NuTo
 {
 //! @brief Store node values and its dof
+//! @remark A node is a handle to its values and dof numbers in a NodeStorage, either in a storage shared with other
+//! nodes, e.g. the one of a mesh, see NodeContainer, or in its own storage. Copies of a node own a copy of its values,
+//! they are not handles to the same node.
 //! @todo fix sized nodes?
 class NodeSimple
 {
@@ -16,76 +22,148 @@ public:
     //! @remark this magic number `-1` indicates an uninitialized state. I was not able to declare a static variable
     //! NOT_SET=-1. Maybe someone else can help.
     NodeSimple(Eigen::VectorXd values)
-        : mValues({values})
-        , mDofNumbers(Eigen::VectorXi::Constant(values.rows(), -1))
+        : NodeSimple(std::make_unique<NodeStorage>(values.rows()))
     {
+        mIndex = mStorage->Add(values);
     }
 
     //! @brief initializes a 1D node with `value` and a dof number 0
     //! @param value initial node value
     NodeSimple(double value)
-        : mValues({Eigen::VectorXd::Constant(1, value)})
-        , mDofNumbers(Eigen::VectorXi::Zero(1))
+        : NodeSimple(1, 1)
     {
+        SetValue(0, value);
+        SetDofNumber(0, 0);
     }
 
     NodeSimple(int dimension, int numInstances)
-        : mValues(numInstances, Eigen::VectorXd::Zero(dimension))
-        , mDofNumbers(Eigen::VectorXi::Constant(dimension, -1))
+        : NodeSimple(std::make_unique<NodeStorage>(dimension))
     {
+        mIndex = mStorage->Add(numInstances);
+    }
+
+    //! @brief handle to the node `index` of a shared storage
+    //! @param rStorage storage that outlives this node
+    NodeSimple(NodeStorage* rStorage, int index)
+        : mStorage(rStorage)
+        , mIndex(index)
+    {
+    }
+
+    //! @brief copies the values, instances and dof numbers of `other` into an own storage
+    NodeSimple(const NodeSimple& other)
+        : NodeSimple(other.GetNumValues(), other.GetNumInstances())
+    {
+        CopyFrom(other);
+    }
+
+    NodeSimple(NodeSimple&&) = default;
+
+    //! @brief copies the values, instances and dof numbers of `other` into the storage of this node
+    //! @remark A node in a shared storage stays in it, e.g. in the storage of its NodeContainer, and thus requires the
+    //! same number of values as `other`.
+    NodeSimple& operator=(const NodeSimple& other)
+    {
+        if (this == &other)
+            return *this;
+        if (other.GetNumValues() != GetNumValues())
+        {
+            if (mOwnStorage == nullptr)
+                throw Exception(__PRETTY_FUNCTION__, "A node in a shared storage cannot change its number of values.");
+            *this = NodeSimple(other.GetNumValues(), other.GetNumInstances());
+        }
+        AllocateInstances(other.GetNumInstances());
+        CopyFrom(other);
+        return *this;
+    }
+
+    //! @brief takes over the storage of `other` if both own their storage, copies the values otherwise, see
+    //! operator=(const NodeSimple&)
+    NodeSimple& operator=(NodeSimple&& other)
+    {
+        if (mOwnStorage == nullptr or other.mOwnStorage == nullptr)
+            return *this = static_cast<const NodeSimple&>(other);
+        mOwnStorage = std::move(other.mOwnStorage);
+        mStorage = mOwnStorage.get();
+        mIndex = other.mIndex;
+        return *this;
     }
 
     //! Allocates `numInstances` full of zeros
     void AllocateInstances(int numInstances)
     {
         assert(numInstances > 0);
-        mValues.resize(numInstances, Eigen::VectorXd::Zero(mValues[0].size()));
+        mStorage->AllocateInstances(mIndex, numInstances);
     }
 
     int GetNumInstances() const
     {
-        return mValues.size();
+        return mStorage->NumInstances(mIndex);
     }
 
-    const Eigen::VectorXd& GetValues(int instance = 0) const
+    Eigen::Map<const Eigen::VectorXd> GetValues(int instance = 0) const
     {
-        assert(instance < static_cast<int>(mValues.size()));
-        return mValues[instance];
+        assert(instance < GetNumInstances());
+        return static_cast<const NodeStorage&>(*mStorage).Values(mIndex, instance);
     }
 
     int GetDofNumber(int component) const
     {
-        assert(component < mDofNumbers.rows());
-        return mDofNumbers[component];
+        return static_cast<const NodeStorage&>(*mStorage).DofNumber(mIndex, component);
     }
 
-    void SetValues(Eigen::VectorXd values, int instance = 0)
+    void SetValues(const Eigen::VectorXd& values, int instance = 0)
     {
-        assert(instance < static_cast<int>(mValues.size()));
-        assert(values.size() == mValues[instance].size());
-        mValues[instance] = values;
+        assert(instance < GetNumInstances());
+        assert(values.size() == GetNumValues());
+        mStorage->Values(mIndex, instance) = values;
     }
 
     void SetValue(int component, double value, int instance = 0)
     {
-        assert(instance < static_cast<int>(mValues.size()));
-        assert(component < mDofNumbers.rows());
-        mValues[instance][component] = value;
+        assert(instance < GetNumInstances());
+        assert(component < GetNumValues());
+        mStorage->Values(mIndex, instance)[component] = value;
     }
 
     void SetDofNumber(int component, int dofNumber)
     {
-        assert(component < mDofNumbers.rows());
-        mDofNumbers[component] = dofNumber;
+        mStorage->DofNumber(mIndex, component) = dofNumber;
     }
 
     int GetNumValues() const
     {
-        return mValues[0].rows();
+        return mStorage->Dim();
+    }
+
+    //! @return position of the node in its storage
+    int Index() const
+    {
+        return mIndex;
     }
 
 private:
-    std::vector<Eigen::VectorXd> mValues;
-    Eigen::VectorXi mDofNumbers;
+    friend class NodeContainer;
+
+    explicit NodeSimple(std::unique_ptr<NodeStorage> storage)
+        : mStorage(storage.get())
+        , mIndex(0)
+        , mOwnStorage(std::move(storage))
+    {
+    }
+
+    //! @brief copies the values of all instances and the dof numbers of `other`, the sizes have to match
+    void CopyFrom(const NodeSimple& other)
+    {
+        for (int instance = 0; instance < GetNumInstances(); ++instance)
+            SetValues(other.GetValues(instance), instance);
+        for (int component = 0; component < GetNumValues(); ++component)
+            SetDofNumber(component, other.GetDofNumber(component));
+    }
+
+    NodeStorage* mStorage;
+    int mIndex;
+    //! @brief storage of a node that is not part of a shared storage, nullptr otherwise
+    std::unique_ptr<NodeStorage> mOwnStorage;
 };
 } /* NuTo */
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <Eigen/Core>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace NuTo
+{
+//! @brief structure of arrays storage of the values and dof numbers of nodes with the same number of components
+//! @remark The values of all nodes are stored in one array per instance, values[instance][node * dim + component], and
+//! the dof numbers in a single array, dofNumbers[node * dim + component]. Compared to individual node objects, this
+//! avoids the heap allocations per node and keeps the values of neighboring nodes next to each other. The nodes are
+//! accessed via their index, NodeSimple is a handle to one node of a storage.
+class NodeStorage
+{
+public:
+    //! @param dim number of components of each node
+    explicit NodeStorage(int dim)
+        : mDim(dim)
+    {
+    }
+
+    //! @brief adds a node with all instances and dof numbers set to zero and -1, respectively
+    //! @return index of the new node
+    int Add(int numInstances = 1)
+    {
+        assert(numInstances > 0);
+        const int index = Size();
+        for (auto& values : mValues)
+            values.resize(values.size() + mDim, 0.);
+        mDofNumbers.resize(mDofNumbers.size() + mDim, -1);
+        mNumInstances.push_back(0);
+        AllocateInstances(index, numInstances);
+        return index;
+    }
+
+    //! @brief adds a node with the `values` as instance 0
+    //! @return index of the new node
+    int Add(const Eigen::VectorXd& values)
+    {
+        assert(values.rows() == mDim);
+        const int index = Add();
+        // plain copy, the vectorized Eigen assignment of a dynamic size triggers false -Wstringop-overread warnings
+        std::copy_n(values.data(), mDim, mValues[0].data() + index * mDim);
+        return index;
+    }
+
+    int Dim() const
+    {
+        return mDim;
+    }
+
+    //! @return number of nodes
+    int Size() const
+    {
+        return mNumInstances.size();
+    }
+
+    int NumInstances(int node) const
+    {
+        return mNumInstances[node];
+    }
+
+    //! @brief resizes the instances of `node` to `numInstances`, new instances are zero
+    void AllocateInstances(int node, int numInstances)
+    {
+        assert(numInstances > 0);
+        while (static_cast<int>(mValues.size()) < numInstances)
+            mValues.emplace_back(mDofNumbers.size(), 0.);
+        const int oldNumInstances = mNumInstances[node];
+        mNumInstances[node] = numInstances;
+        for (int instance = oldNumInstances; instance < numInstances; ++instance)
+            Values(node, instance).setZero();
+    }
+
+    Eigen::Map<Eigen::VectorXd> Values(int node, int instance)
+    {
+        assert(instance < mNumInstances[node]);
+        return {mValues[instance].data() + node * mDim, mDim};
+    }
+
+    Eigen::Map<const Eigen::VectorXd> Values(int node, int instance) const
+    {
+        assert(instance < mNumInstances[node]);
+        return {mValues[instance].data() + node * mDim, mDim};
+    }
+
+    int& DofNumber(int node, int component)
+    {
+        assert(component < mDim);
+        return mDofNumbers[node * mDim + component];
+    }
+
+    int DofNumber(int node, int component) const
+    {
+        assert(component < mDim);
+        return mDofNumbers[node * mDim + component];
+    }
+
+    //! @brief rearranges the nodes such that the i-th node is the previous `order[i]`-th node
+    //! @param order permutation of [0, Size()) or of a subset of it, the nodes that are not in `order` are removed
+    void Reorder(const std::vector<int>& order)
+    {
+        assert(static_cast<int>(order.size()) <= Size());
+        for (auto& values : mValues)
+            values = Permuted(values, order);
+        mDofNumbers = Permuted(mDofNumbers, order);
+
+        std::vector<int> numInstances(order.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            numInstances[i] = mNumInstances[order[i]];
+        mNumInstances = std::move(numInstances);
+    }
+
+private:
+    template <typename T>
+    std::vector<T> Permuted(const std::vector<T>& v, const std::vector<int>& order) const
+    {
+        std::vector<T> permuted(order.size() * mDim);
+        for (size_t i = 0; i < order.size(); ++i)
+            std::copy_n(v.begin() + order[i] * mDim, mDim, permuted.begin() + i * mDim);
+        return permuted;
+    }
+
+    int mDim;
+    std::vector<std::vector<double>> mValues;
+    std::vector<int> mDofNumbers;
+    std::vector<int> mNumInstances;
+};
+} /* NuTo */
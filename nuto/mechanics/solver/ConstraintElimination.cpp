@@ -0,0 +1,181 @@
+#include "nuto/mechanics/solver/ConstraintElimination.h"
+#include "nuto/base/Exception.h"
+#include "nuto/mechanics/dofs/DofMatrixSparse.h"
+#include "nuto/mechanics/dofs/DofMatrixSparseConvertEigen.h"
+
+using namespace NuTo;
+
+namespace
+{
+
+//! @brief appends the number of equations of `dof` and, per equation, the dof number of the dependent term, the number
+//! of independent terms and their dof numbers to `rDofNumbers` and the coefficients of the independent terms to
+//! `rCoefficients`
+void TermsOf(const Constraint::Constraints& bcs, DofType dof, std::vector<int>* rDofNumbers,
+             std::vector<double>* rCoefficients)
+{
+    const int numEquations = bcs.GetNumEquations(dof);
+    rDofNumbers->push_back(numEquations);
+    for (int i = 0; i < numEquations; ++i)
+    {
+        const Constraint::Equation& equation = bcs.GetEquation(dof, i);
+        rDofNumbers->push_back(equation.GetDependentDofNumber());
+        rDofNumbers->push_back(equation.GetIndependentTerms().size());
+        for (const Constraint::Term& term : equation.GetIndependentTerms())
+        {
+            rDofNumbers->push_back(term.GetConstrainedDofNumber());
+            rCoefficients->push_back(term.GetCoefficient());
+        }
+    }
+}
+} // namespace
+
+ConstraintElimination::ConstraintElimination(const Constraint::Constraints& bcs, std::vector<DofType> dofs,
+                                             const DofVector<double>& sizes)
+    : mDofs(dofs)
+{
+    int offset = 0;
+    for (DofType dof : mDofs)
+    {
+        const int numDofs = sizes[dof].rows();
+        mNumDofs.push_back(numDofs);
+        TermsOf(bcs, dof, &mTermDofNumbers, &mTermCoefficients);
+
+        const Constraint::JKNumbering jk = bcs.GetJKNumbering(dof, numDofs);
+        for (int i = 0; i < jk.mNumJ; ++i)
+            mIndependent.push_back(offset + jk.mIndices[i]);
+        offset += numDofs;
+    }
+
+    mIsDirichlet = mTermCoefficients.empty();
+    mReducedIndex.assign(offset, -1);
+    for (size_t i = 0; i < mIndependent.size(); ++i)
+        mReducedIndex[mIndependent[i]] = i;
+
+    if (mIsDirichlet)
+        return;
+
+    DofMatrixSparse<double> C;
+    for (DofType rdof : mDofs)
+        C(rdof, rdof) = bcs.BuildUnitConstraintMatrix(rdof, sizes[rdof].rows());
+
+    for (DofType rdof : mDofs)
+        for (DofType cdof : mDofs)
+            if (rdof.Id() != cdof.Id())
+                C(rdof, cdof) = Eigen::SparseMatrix<double>(C(rdof, rdof).rows(), C(cdof, cdof).cols());
+    mC = ToEigen(C, mDofs);
+}
+
+bool ConstraintElimination::Matches(const Constraint::Constraints& bcs, const DofVector<double>& sizes) const
+{
+    std::vector<int> termDofNumbers;
+    std::vector<double> termCoefficients;
+    for (size_t i = 0; i < mDofs.size(); ++i)
+    {
+        if (sizes[mDofs[i]].rows() != mNumDofs[i])
+            return false;
+        TermsOf(bcs, mDofs[i], &termDofNumbers, &termCoefficients);
+    }
+    return termDofNumbers == mTermDofNumbers and termCoefficients == mTermCoefficients;
+}
+
+bool ConstraintElimination::IsDirichlet() const
+{
+    return mIsDirichlet;
+}
+
+const Eigen::SparseMatrix<double>& ConstraintElimination::Reduce(const Eigen::SparseMatrix<double>& K)
+{
+    if (not mIsDirichlet)
+    {
+        mKmod = mC.transpose() * K * mC;
+        return mKmod;
+    }
+
+    if (not K.isCompressed())
+        throw Exception(__PRETTY_FUNCTION__, "K has to be in compressed storage.");
+    if (K.rows() != static_cast<int>(mReducedIndex.size()) or K.cols() != K.rows())
+        throw Exception(__PRETTY_FUNCTION__, "The dimensions of K do not match the dofs.");
+
+    if (mSource.empty() or not mPattern.Matches(K))
+    {
+        GatherPattern(K);
+        mPattern = SparsePattern(K);
+    }
+
+    const double* values = K.valuePtr();
+    double* reducedValues = mKmod.valuePtr();
+    for (size_t i = 0; i < mSource.size(); ++i)
+        reducedValues[i] = values[mSource[i]];
+    return mKmod;
+}
+
+void ConstraintElimination::GatherPattern(const Eigen::SparseMatrix<double>& K)
+{
+    // K_JJ keeps the (column major) order of the entries of K, since mReducedIndex is monotonic
+    const int numJ = mIndependent.size();
+    std::vector<int> outer(numJ + 1, 0);
+    std::vector<int> inner;
+    mSource.clear();
+    for (int j = 0; j < numJ; ++j)
+    {
+        const int column = mIndependent[j];
+        for (int k = K.outerIndexPtr()[column]; k < K.outerIndexPtr()[column + 1]; ++k)
+        {
+            const int row = mReducedIndex[K.innerIndexPtr()[k]];
+            if (row < 0)
+                continue;
+            inner.push_back(row);
+            mSource.push_back(k);
+        }
+        outer[j + 1] = inner.size();
+    }
+
+    mKmod.resize(numJ, numJ);
+    mKmod.resizeNonZeros(inner.size());
+    std::copy(outer.begin(), outer.end(), mKmod.outerIndexPtr());
+    std::copy(inner.begin(), inner.end(), mKmod.innerIndexPtr());
+}
+
+Eigen::VectorXd ConstraintElimination::Restrict(const Eigen::VectorXd& f) const
+{
+    if (not mIsDirichlet)
+        return mC.transpose() * f;
+    return SelectIndependent(f);
+}
+
+Eigen::VectorXd ConstraintElimination::Prolongate(const Eigen::VectorXd& uJ) const
+{
+    if (not mIsDirichlet)
+        return mC * uJ;
+
+    Eigen::VectorXd u = Eigen::VectorXd::Zero(mReducedIndex.size());
+    for (size_t i = 0; i < mIndependent.size(); ++i)
+        u[mIndependent[i]] = uJ[i];
+    return u;
+}
+
+Eigen::VectorXd ConstraintElimination::SelectIndependent(const Eigen::VectorXd& u) const
+{
+    Eigen::VectorXd uJ(mIndependent.size());
+    for (size_t i = 0; i < mIndependent.size(); ++i)
+        uJ[i] = u[mIndependent[i]];
+    return uJ;
+}
+
+Eigen::SparseMatrix<double> ConstraintElimination::SelectIndependentRows(const Eigen::SparseMatrix<double>& P) const
+{
+    if (P.rows() != static_cast<int>(mReducedIndex.size()))
+        throw Exception(__PRETTY_FUNCTION__, "The matrix has " + std::to_string(P.rows()) + " rows, expected " +
+                                                     std::to_string(mReducedIndex.size()) + ".");
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int j = 0; j < P.outerSize(); ++j)
+        for (Eigen::SparseMatrix<double>::InnerIterator it(P, j); it; ++it)
+            if (mReducedIndex[it.row()] >= 0)
+                triplets.emplace_back(mReducedIndex[it.row()], it.col(), it.value());
+
+    Eigen::SparseMatrix<double> PJ(mIndependent.size(), P.cols());
+    PJ.setFromTriplets(triplets.begin(), triplets.end());
+    return PJ;
+}
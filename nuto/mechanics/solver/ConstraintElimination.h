@@ -0,0 +1,84 @@
+#pragma once
+#include <vector>
+#include <Eigen/Sparse>
+#include "nuto/mechanics/dofs/DofVector.h"
+#include "nuto/mechanics/constraints/Constraints.h"
+#include "nuto/math/EigenSparseSolve.h"
+
+namespace NuTo
+{
+
+//! @brief eliminates the dependent dofs from a linear system K u = f with u = C uJ + rhs, see
+//! Constraint::Constraints::BuildUnitConstraintMatrix(...)
+//!
+//! The system of the independent dofs is Kmod uJ = fmod with Kmod = C^T K C and fmod = C^T f. If all constraints are of
+//! Dirichlet type (no independent terms), C only selects the independent dofs and Kmod = K_JJ is gathered from K by
+//! the JKNumbering instead of two sparse matrix products. The positions of the entries of K_JJ in K are kept as long as
+//! the nonzero pattern of K does not change, then only the values are copied. Otherwise, C is built once and reused.
+//! The elimination depends on the dof numbers of the constrained nodes and thus has to be rebuilt after a renumbering,
+//! see Matches(...).
+//!
+//! All vectors and matrices are joined over the `dofs` in their order, see ToEigen(...).
+class ConstraintElimination
+{
+public:
+    //! @param bcs constraints, only the dof numbers and the coefficients of their terms are used
+    //! @param dofs dof types
+    //! @param sizes vector with the number of dofs of each dof type, e.g. the rhs of the system
+    ConstraintElimination(const Constraint::Constraints& bcs, std::vector<DofType> dofs,
+                          const DofVector<double>& sizes);
+
+    //! @return true if this elimination was built for the same number of dofs of each dof type and for equations with
+    //! the same dof numbers and coefficients, e.g. false after a renumbering of the constrained dofs
+    bool Matches(const Constraint::Constraints& bcs, const DofVector<double>& sizes) const;
+
+    //! @return true if no equation has independent terms
+    bool IsDirichlet() const;
+
+    //! @return Kmod = C^T K C
+    //! @remark the returned reference stays valid until the next call
+    const Eigen::SparseMatrix<double>& Reduce(const Eigen::SparseMatrix<double>& K);
+
+    //! @return fmod = C^T f
+    Eigen::VectorXd Restrict(const Eigen::VectorXd& f) const;
+
+    //! @return u = C uJ, without the rhs of the constraints
+    Eigen::VectorXd Prolongate(const Eigen::VectorXd& uJ) const;
+
+    //! @return uJ, the independent dofs of `u`, the inverse of Prolongate(uJ)
+    Eigen::VectorXd SelectIndependent(const Eigen::VectorXd& u) const;
+
+    //! @return the rows of `P` of the independent dofs, e.g. to restrict a multigrid prolongator to the system of the
+    //! independent dofs. The dependent dofs of linear constraints are not interpolated from the independent ones.
+    Eigen::SparseMatrix<double> SelectIndependentRows(const Eigen::SparseMatrix<double>& P) const;
+
+private:
+    void GatherPattern(const Eigen::SparseMatrix<double>& K);
+
+    std::vector<DofType> mDofs;
+    std::vector<int> mNumDofs;
+
+    //! @brief dof numbers of the terms of all equations, see TermsOf(...) in the implementation
+    std::vector<int> mTermDofNumbers;
+    //! @brief coefficients of the independent terms of all equations
+    std::vector<double> mTermCoefficients;
+    bool mIsDirichlet = true;
+
+    //! @brief joined dof numbers of the independent dofs in ascending order
+    std::vector<int> mIndependent;
+
+    //! @brief index of each joined dof number in mIndependent, -1 for the dependent dofs
+    std::vector<int> mReducedIndex;
+
+    //! @brief unit constraint matrix, only built for constraints with independent terms
+    Eigen::SparseMatrix<double> mC;
+
+    Eigen::SparseMatrix<double> mKmod;
+
+    //! @brief position of each entry of mKmod in the value array of K
+    std::vector<int> mSource;
+    //! @brief pattern of the K of mSource
+    SparsePattern mPattern;
+};
+
+} /* NuTo */
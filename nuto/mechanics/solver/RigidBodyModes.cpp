@@ -0,0 +1,89 @@
+#include "nuto/mechanics/solver/RigidBodyModes.h"
+#include <unordered_map>
+#include "nuto/base/Exception.h"
+
+using namespace NuTo;
+
+namespace
+{
+
+//! @return coordinates of all nodes of `dof`, interpolated from the coordinate elements
+std::unordered_map<const NodeSimple*, Eigen::VectorXd> DofNodeCoordinates(const MeshFem& mesh, DofType dof)
+{
+    std::unordered_map<const NodeSimple*, Eigen::VectorXd> coordinates;
+    for (const ElementCollectionFem& elementCollection : mesh.Elements)
+    {
+        if (not elementCollection.Has(dof))
+            continue;
+        const ElementFem& dofElement = elementCollection.DofElement(dof);
+        for (int iNode = 0; iNode < dofElement.GetNumNodes(); ++iNode)
+        {
+            const NodeSimple& node = dofElement.GetNode(iNode);
+            if (coordinates.find(&node) == coordinates.end())
+                coordinates[&node] = Interpolate(elementCollection.CoordinateElement(),
+                                                 dofElement.Interpolation().GetLocalCoords(iNode));
+        }
+    }
+    return coordinates;
+}
+} // namespace
+
+std::vector<DofVector<double>> NuTo::RigidBodyModes(const MeshFem& mesh, std::vector<DofType> dofs)
+{
+    std::vector<std::unordered_map<const NodeSimple*, Eigen::VectorXd>> coordinates;
+    DofVector<double> zero;
+    for (DofType dof : dofs)
+    {
+        coordinates.push_back(DofNodeCoordinates(mesh, dof));
+        int numDofs = 0;
+        for (const auto& nodeCoordinates : coordinates.back())
+            for (int component = 0; component < dof.GetNum(); ++component)
+                numDofs = std::max(numDofs, nodeCoordinates.first->GetDofNumber(component) + 1);
+        zero[dof] = Eigen::VectorXd::Zero(numDofs);
+    }
+
+    std::vector<DofVector<double>> modes;
+    for (size_t iDof = 0; iDof < dofs.size(); ++iDof)
+    {
+        const DofType dof = dofs[iDof];
+        if (coordinates[iDof].empty())
+            throw Exception(__PRETTY_FUNCTION__, "There are no nodes of dof type " + dof.GetName() + ".");
+
+        const int dim = coordinates[iDof].begin()->second.rows();
+        const int numComponents = dof.GetNum();
+        const bool isVector = numComponents == dim;
+
+        Eigen::VectorXd centroid = Eigen::VectorXd::Zero(dim);
+        for (const auto& nodeCoordinates : coordinates[iDof])
+            centroid += nodeCoordinates.second;
+        centroid /= coordinates[iDof].size();
+
+        // translations or constant modes, one per component
+        for (int component = 0; component < numComponents; ++component)
+        {
+            DofVector<double> mode = zero;
+            for (const auto& nodeCoordinates : coordinates[iDof])
+                mode[dof][nodeCoordinates.first->GetDofNumber(component)] = 1.;
+            modes.push_back(mode);
+        }
+
+        if (not isVector)
+            continue;
+
+        // rotations in the plane of the components a and b
+        for (int a = 0; a < dim; ++a)
+            for (int b = a + 1; b < dim; ++b)
+            {
+                DofVector<double> mode = zero;
+                for (const auto& nodeCoordinates : coordinates[iDof])
+                {
+                    const NodeSimple& node = *nodeCoordinates.first;
+                    const Eigen::VectorXd x = nodeCoordinates.second - centroid;
+                    mode[dof][node.GetDofNumber(a)] = -x[b];
+                    mode[dof][node.GetDofNumber(b)] = x[a];
+                }
+                modes.push_back(mode);
+            }
+    }
+    return modes;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <vector>
+#include "nuto/mechanics/dofs/DofVector.h"
+#include "nuto/mechanics/mesh/MeshFem.h"
+
+namespace NuTo
+{
+
+//! @brief near nullspace of the `dofs` of `mesh` for the multigrid preconditioner of `AmgCG`, see
+//! ConstrainedSystemSolver::SetNearNullspace(...)
+//!
+//! A dof type with one component per coordinate, e.g. the displacements, contributes its rigid body modes, i.e. the
+//! translations and the rotations (1 in 2D, 3 in 3D) about the centroid of its nodes. Any other dof type contributes
+//! one constant mode per component. The coordinates of the dof nodes are interpolated from the coordinate elements.
+//! Each mode contains all `dofs`, the ones of the other dof types are zero.
+//! @remark uses the current dof numbers, thus call it after the dof numbering, e.g. after
+//! QuasistaticSolver::SetConstraints(...)
+std::vector<DofVector<double>> RigidBodyModes(const MeshFem& mesh, std::vector<DofType> dofs);
+
+} /* NuTo */
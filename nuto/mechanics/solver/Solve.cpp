@@ -5,27 +5,41 @@
 
 using namespace NuTo;
 
-DofVector<double> NuTo::Solve(const DofMatrixSparse<double>& K, const DofVector<double>& f,
-                              Constraint::Constraints& bcs, std::vector<DofType> dofs, std::string solver)
+namespace
 {
-    auto K_full = ToEigen(K, dofs);
-    auto f_full = ToEigen(f, dofs);
 
-    DofMatrixSparse<double> C_dof;
-    for (auto rdof : dofs)
-        C_dof(rdof, rdof) = bcs.BuildUnitConstraintMatrix(rdof, f[rdof].rows());
+//! @brief exports K to a single matrix with both triangles
+Eigen::SparseMatrix<double> FullEigenMatrix(const DofMatrixSparse<double>& K, std::vector<DofType> dofs,
+                                            eMatrixStorage storage)
+{
+    if (storage == eMatrixStorage::FULL)
+        return ToEigen(K, dofs);
+    return ToEigen(K, dofs).selfadjointView<Eigen::Upper>();
+}
 
-    for (auto rdof : dofs)
-        for (auto cdof : dofs)
-            if (rdof.Id() != cdof.Id())
-                C_dof(rdof, cdof) = Eigen::SparseMatrix<double>(C_dof(rdof, rdof).rows(), C_dof(cdof, cdof).cols());
+//! @brief solver for the constrained system Kmod, that is symmetric if K is stored symmetrically
+std::string SolverForStorage(std::string solver, eMatrixStorage storage)
+{
+    return storage == eMatrixStorage::UPPER ? SymmetricSolver(solver) : solver;
+}
 
-    auto C = ToEigen(C_dof, dofs);
-    Eigen::SparseMatrix<double> Kmod = C.transpose() * K_full * C;
-    Eigen::VectorXd fmod = C.transpose() * f_full;
+//! @brief factorizes Kmod = C^T K C, unless `solver` reuses its existing factorization
+void FactorizeConstrained(const EigenSparseSolver& solver, ConstraintElimination& elimination,
+                          const Eigen::SparseMatrix<double>& K_full)
+{
+    if (solver.ReusesFactorization() and solver.HasFactorization())
+        return;
+    solver.Factorize(elimination.Reduce(K_full));
+}
 
-    Eigen::VectorXd u = EigenSparseSolve(Kmod, fmod, solver);
-    u = C * u;
+DofVector<double> SolveConstrained(const DofMatrixSparse<double>& K, const DofVector<double>& f,
+                                   std::vector<DofType> dofs, eMatrixStorage storage,
+                                   ConstraintElimination& elimination, const EigenSparseSolver& solver)
+{
+    if (not(solver.ReusesFactorization() and solver.HasFactorization()))
+        solver.Factorize(elimination.Reduce(FullEigenMatrix(K, dofs, storage)));
+
+    Eigen::VectorXd u = elimination.Prolongate(solver.SolveFactorized(elimination.Restrict(ToEigen(f, dofs))));
 
     // TODO: for correct size
     DofVector<double> result = f;
@@ -33,24 +47,14 @@ DofVector<double> NuTo::Solve(const DofMatrixSparse<double>& K, const DofVector<
     return result;
 }
 
-DofVector<double> NuTo::SolveTrialState(const DofMatrixSparse<double>& K, const DofVector<double>& f, double oldTime,
-                                        double newTime, Constraint::Constraints& bcs, std::vector<DofType> dofs,
-                                        std::string solver)
+DofVector<double> SolveTrialStateConstrained(const DofMatrixSparse<double>& K, const DofVector<double>& f,
+                                             double oldTime, double newTime, Constraint::Constraints& bcs,
+                                             std::vector<DofType> dofs, eMatrixStorage storage,
+                                             ConstraintElimination& elimination, const EigenSparseSolver& solver)
 {
-    auto K_full = ToEigen(K, dofs);
+    auto K_full = FullEigenMatrix(K, dofs, storage);
     auto f_full = ToEigen(f, dofs);
 
-    DofMatrixSparse<double> C_dof;
-    for (auto rdof : dofs)
-        C_dof(rdof, rdof) = bcs.BuildUnitConstraintMatrix(rdof, f[rdof].rows());
-
-    for (auto rdof : dofs)
-        for (auto cdof : dofs)
-            if (rdof.Id() != cdof.Id())
-                C_dof(rdof, cdof) = Eigen::SparseMatrix<double>(C_dof(rdof, rdof).rows(), C_dof(cdof, cdof).cols());
-
-    auto C = ToEigen(C_dof, dofs);
-
     // this is just for the correct size, can be replaced when the constraints know the dimensions
     DofVector<double> deltaBrhs(f);
     deltaBrhs.SetZero();
@@ -60,41 +64,128 @@ DofVector<double> NuTo::SolveTrialState(const DofMatrixSparse<double>& K, const
                            bcs.GetSparseGlobalRhs(dof, f[dof].rows(), oldTime));
     }
 
-    Eigen::SparseMatrix<double> Kmod = C.transpose() * K_full * C;
+    FactorizeConstrained(solver, elimination, K_full);
 
     Eigen::VectorXd deltaBrhsEigen(ToEigen(deltaBrhs, dofs));
 
     // this last operation should in theory be done with a sparse deltaBrhsVector
-    Eigen::VectorXd fmod = C.transpose() * (f_full + K_full * deltaBrhsEigen);
+    Eigen::VectorXd fmod = elimination.Restrict(f_full + K_full * deltaBrhsEigen);
 
-    Eigen::VectorXd u = EigenSparseSolve(Kmod, fmod, solver);
+    Eigen::VectorXd u = solver.SolveFactorized(fmod);
     // this is the negative increment
     // residual = gradient
     // hessian = dresidual / ddof
     // taylorseries expansion 0 = residual + hessian * deltadof
-    u = C * u - deltaBrhsEigen;
+    u = elimination.Prolongate(u) - deltaBrhsEigen;
 
     // TODO: for correct size
     DofVector<double> result = f;
     FromEigen(u, f.DofTypes(), &result);
     return result;
 }
+} // namespace
+
+DofVector<double> NuTo::Solve(const DofMatrixSparse<double>& K, const DofVector<double>& f,
+                              Constraint::Constraints& bcs, std::vector<DofType> dofs, std::string solver,
+                              eMatrixStorage storage)
+{
+    ConstraintElimination elimination(bcs, dofs, f);
+    return SolveConstrained(K, f, dofs, storage, elimination, EigenSparseSolver(SolverForStorage(solver, storage)));
+}
+
+DofVector<double> NuTo::SolveTrialState(const DofMatrixSparse<double>& K, const DofVector<double>& f, double oldTime,
+                                        double newTime, Constraint::Constraints& bcs, std::vector<DofType> dofs,
+                                        std::string solver, eMatrixStorage storage)
+{
+    ConstraintElimination elimination(bcs, dofs, f);
+    return SolveTrialStateConstrained(K, f, oldTime, newTime, bcs, dofs, storage, elimination,
+                                      EigenSparseSolver(SolverForStorage(solver, storage)));
+}
 
 ConstrainedSystemSolver::ConstrainedSystemSolver(Constraint::Constraints& bcs, std::vector<DofType> dofs,
-                                                 std::string solver)
+                                                 std::string solver, eMatrixStorage storage)
     : mBcs(bcs)
     , mDofs(dofs)
-    , mSolver(solver)
+    , mSolver(SolverForStorage(solver, storage))
+    , mStorage(storage)
 {
 }
 
 DofVector<double> ConstrainedSystemSolver::Solve(const DofMatrixSparse<double>& K, const DofVector<double>& f) const
 {
-    return NuTo::Solve(K, f, mBcs, mDofs, mSolver);
+    return SolveConstrained(K, f, mDofs, mStorage, Elimination(f), mSolver);
 }
 
 DofVector<double> ConstrainedSystemSolver::SolveTrialState(const DofMatrixSparse<double>& K, const DofVector<double>& f,
                                                            double oldTime, double newTime) const
 {
-    return NuTo::SolveTrialState(K, f, oldTime, newTime, mBcs, mDofs, mSolver);
+    return SolveTrialStateConstrained(K, f, oldTime, newTime, mBcs, mDofs, mStorage, Elimination(f), mSolver);
+}
+
+DofVector<double> ConstrainedSystemSolver::SolveFactorized(const DofVector<double>& f) const
+{
+    ConstraintElimination& elimination = Elimination(f);
+    Eigen::VectorXd u = elimination.Prolongate(mSolver.SolveFactorized(elimination.Restrict(ToEigen(f, mDofs))));
+
+    DofVector<double> result = f;
+    FromEigen(u, f.DofTypes(), &result);
+    return result;
+}
+
+bool ConstrainedSystemSolver::HasFactorization() const
+{
+    return mSolver.HasFactorization();
+}
+
+void ConstrainedSystemSolver::Refactorize(const DofMatrixSparse<double>& K)
+{
+    DofVector<double> sizes;
+    for (DofType dof : mDofs)
+        sizes[dof] = Eigen::VectorXd::Zero(K(dof, dof).rows());
+    mSolver.Refactorize(Elimination(sizes).Reduce(FullEigenMatrix(K, mDofs, mStorage)));
+}
+
+void ConstrainedSystemSolver::ReuseFactorization(bool reuse)
+{
+    mSolver.ReuseFactorization(reuse);
+}
+
+void ConstrainedSystemSolver::SetNearNullspace(const std::vector<DofVector<double>>& modes)
+{
+    if (modes.empty())
+    {
+        mSolver.SetNearNullspace(Eigen::MatrixXd());
+        return;
+    }
+
+    ConstraintElimination& elimination = Elimination(modes.front());
+    Eigen::MatrixXd nearNullspace;
+    for (size_t i = 0; i < modes.size(); ++i)
+    {
+        const Eigen::VectorXd modeJ = elimination.SelectIndependent(ToEigen(modes[i], mDofs));
+        if (i == 0)
+            nearNullspace.resize(modeJ.rows(), modes.size());
+        nearNullspace.col(i) = modeJ;
+    }
+    mSolver.SetNearNullspace(nearNullspace);
+}
+
+void ConstrainedSystemSolver::SetProlongators(std::vector<Eigen::SparseMatrix<double>> prolongators,
+                                              const DofVector<double>& sizes)
+{
+    if (not prolongators.empty())
+        prolongators.front() = Elimination(sizes).SelectIndependentRows(prolongators.front());
+    mSolver.SetProlongators(prolongators);
+}
+
+const EigenSparseSolver& ConstrainedSystemSolver::LinearSolver() const
+{
+    return mSolver;
+}
+
+ConstraintElimination& ConstrainedSystemSolver::Elimination(const DofVector<double>& sizes) const
+{
+    if (mElimination == nullptr or not mElimination->Matches(mBcs, sizes))
+        mElimination = std::make_unique<ConstraintElimination>(mBcs, mDofs, sizes);
+    return *mElimination;
 }
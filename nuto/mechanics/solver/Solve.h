@@ -3,29 +3,73 @@
 #include "nuto/mechanics/dofs/DofVector.h"
 #include "nuto/mechanics/dofs/DofMatrixSparse.h"
 #include "nuto/mechanics/constraints/Constraints.h"
+#include "nuto/math/EigenSparseSolve.h"
+#include "nuto/mechanics/solver/ConstraintElimination.h"
 
 namespace NuTo
 {
 
+//! @param storage eMatrixStorage::UPPER if `K` only contains the upper triangle of a symmetric matrix, see
+//! SimpleAssembler::BuildMatrix(...). The direct LU/QR solvers are then replaced by SymmetricSolver(solver).
 DofVector<double> Solve(const DofMatrixSparse<double>& K, const DofVector<double>& f, Constraint::Constraints& bcs,
-                        std::vector<DofType> dofs, std::string solver = "EigenSparseLU");
+                        std::vector<DofType> dofs, std::string solver = "EigenSparseLU",
+                        eMatrixStorage storage = eMatrixStorage::FULL);
 
 DofVector<double> SolveTrialState(const DofMatrixSparse<double>& K, const DofVector<double>& f, double oldTime,
                                   double newTime, Constraint::Constraints& bcs, std::vector<DofType> dofs,
-                                  std::string solver = "EigenSparseLU");
+                                  std::string solver = "EigenSparseLU", eMatrixStorage storage = eMatrixStorage::FULL);
 
+//! @brief solves linear systems with constraints, see Solve(...)
+//! @remark The solver keeps the factorization of the constrained matrix between the calls, see EigenSparseSolver.
+//! The symbolic analysis is reused as long as the nonzero pattern does not change. The elimination of the constrained
+//! dofs is kept as well, as long as the number of dofs and the dof numbers and coefficients of the constraint
+//! equations do not change, see ConstraintElimination::Matches(...).
 class ConstrainedSystemSolver
 {
 public:
-    ConstrainedSystemSolver(Constraint::Constraints& bcs, std::vector<DofType> dofs, std::string solver);
+    //! @param storage storage scheme of the matrices passed to Solve(...) and SolveTrialState(...)
+    ConstrainedSystemSolver(Constraint::Constraints& bcs, std::vector<DofType> dofs, std::string solver,
+                            eMatrixStorage storage = eMatrixStorage::FULL);
     DofVector<double> Solve(const DofMatrixSparse<double>& A, const DofVector<double>& b) const;
     DofVector<double> SolveTrialState(const DofMatrixSparse<double>& A, const DofVector<double>& b, double oldTime,
                                       double newTime) const;
 
+    //! @brief solves with the factorization of the last Solve(...), SolveTrialState(...) or Refactorize(...)
+    //! @remark The result contains the dependent dofs as well, like the one of Solve(...).
+    DofVector<double> SolveFactorized(const DofVector<double>& b) const;
+
+    bool HasFactorization() const;
+
+    //! @brief numerical factorization of the constrained matrix of `A` only, see EigenSparseSolver::Refactorize
+    void Refactorize(const DofMatrixSparse<double>& A);
+
+    //! @param reuse true: Solve(...) and SolveTrialState(...) solve with the existing factorization and do not
+    //! factorize their matrix, see EigenSparseSolver::ReuseFactorization
+    void ReuseFactorization(bool reuse);
+
+    //! @brief near nullspace for the multigrid preconditioner of the `AmgCG` solver, see EigenSparseSolver
+    //! @param modes e.g. RigidBodyModes(...), each with the values of all dof types, restricted to the independent dofs
+    //! of the current constraints. Empty to use the default of the preconditioner.
+    void SetNearNullspace(const std::vector<DofVector<double>>& modes);
+
+    //! @brief prolongators for the multigrid preconditioner of the `GmgCG` solver, see EigenSparseSolver
+    //! @param prolongators e.g. StructuredMeshHierarchy::Prolongators(), the rows of the first one are restricted to
+    //! the independent dofs of the current constraints
+    //! @param sizes vector with the number of dofs of each dof type, e.g. the rhs of the system
+    void SetProlongators(std::vector<Eigen::SparseMatrix<double>> prolongators, const DofVector<double>& sizes);
+
+    const EigenSparseSolver& LinearSolver() const;
+
 private:
+    //! @return elimination for the dof sizes of `sizes`, built upon the first call or if the sizes changed
+    ConstraintElimination& Elimination(const DofVector<double>& sizes) const;
+
     Constraint::Constraints& mBcs;
     std::vector<DofType> mDofs;
-    std::string mSolver;
+    EigenSparseSolver mSolver;
+    eMatrixStorage mStorage;
+
+    mutable std::unique_ptr<ConstraintElimination> mElimination;
 };
 
 
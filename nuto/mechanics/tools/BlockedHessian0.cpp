@@ -0,0 +1,48 @@
+#include "nuto/mechanics/tools/BlockedHessian0.h"
+#include "nuto/base/Exception.h"
+
+using namespace NuTo;
+
+BlockedHessian0::BlockedHessian0(TimeDependentProblem& problem, const DofVector<double>& dofValues, DofType dof,
+                                 double t, double dt)
+    : mK(problem.Hessian0Blocked(dofValues, dof, t, dt))
+{
+}
+
+void BlockedHessian0::SetConstraintMatrix(Eigen::SparseMatrix<double> C)
+{
+    if (C.rows() != mK.rows())
+        throw Exception(__PRETTY_FUNCTION__, "The constraint matrix has " + std::to_string(C.rows()) +
+                                                     " rows, expected " + std::to_string(mK.rows()) + ".");
+    mC = C;
+    mHasConstraintMatrix = true;
+}
+
+const BlockSparseMatrix& BlockedHessian0::Matrix() const
+{
+    return mK;
+}
+
+int BlockedHessian0::rows() const
+{
+    return mHasConstraintMatrix ? mC.cols() : mK.rows();
+}
+
+int BlockedHessian0::cols() const
+{
+    return rows();
+}
+
+Eigen::VectorXd BlockedHessian0::operator*(const Eigen::VectorXd& x) const
+{
+    if (mHasConstraintMatrix)
+        return mC.transpose() * (mK * Eigen::VectorXd(mC * x));
+    return mK * x;
+}
+
+Eigen::VectorXd BlockedHessian0::diagonal() const
+{
+    if (mHasConstraintMatrix)
+        return mC.cwiseAbs2().transpose() * mK.diagonal();
+    return mK.diagonal();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Eigen/Sparse>
+#include "nuto/math/BlockSparseMatrix.h"
+#include "nuto/mechanics/tools/TimeDependentProblem.h"
+
+namespace NuTo
+{
+//! @brief Linear operator y = Hessian0(u) x of a TimeDependentProblem, assembled once in the node blocked format
+//!
+//! This is the assembled counterpart of NuTo::MatrixFreeHessian0 with the same Eigen interface for NuTo::Gmres and
+//! NuTo::ConjugateGradient. The products run on the BlockSparseMatrix of TimeDependentProblem::Hessian0Blocked(...),
+//! with one column index per node block instead of one per scalar entry.
+//!
+//! The Eigen interface acts on the independent dofs only, if a constraint matrix C is set. It then represents
+//! C^T Hessian0 C, the same system that is solved by NuTo::Solve(...).
+class BlockedHessian0
+{
+public:
+    //! ctor
+    //! @param problem time dependent problem with Hessian0 functions and without batches
+    //! @param dofValues independent and dependent dof values that define the state of the linearization
+    //! @param dof vector valued dof type
+    //! @param t global time
+    //! @param dt time step
+    BlockedHessian0(TimeDependentProblem& problem, const DofVector<double>& dofValues, DofType dof, double t,
+                    double dt);
+
+    //! @brief restricts the Eigen interface to the independent dofs
+    //! @param C unit constraint matrix of `dof` that maps the independent dofs to all dofs
+    void SetConstraintMatrix(Eigen::SparseMatrix<double> C);
+
+    //! @return assembled Hessian0 of the independent and dependent dofs
+    const BlockSparseMatrix& Matrix() const;
+
+    int rows() const;
+
+    int cols() const;
+
+    //! @return C^T Hessian0 C x, or Hessian0 x if no constraint matrix is set
+    Eigen::VectorXd operator*(const Eigen::VectorXd& x) const;
+
+    //! @return diagonal of C^T Hessian0 C, couplings of independent dofs via the dependent dofs are neglected, see
+    //! MatrixFreeHessian0::diagonal()
+    Eigen::VectorXd diagonal() const;
+
+private:
+    BlockSparseMatrix mK;
+
+    Eigen::SparseMatrix<double> mC;
+    bool mHasConstraintMatrix = false;
+};
+} /* NuTo */
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <vector>
+#include <Eigen/Core>
+#include "nuto/mechanics/cell/CellRange.h"
+
+namespace NuTo
+{
+//! @brief interface of the typed cell pools of the CellStorage
+class CellPoolInterface
+{
+public:
+    virtual ~CellPoolInterface() = default;
+
+    //! @return number of cells
+    virtual int Size() const = 0;
+
+    //! @brief splits the pool into contiguous ranges of at most `chunkSize` cells
+    virtual std::vector<CellRange> Ranges(int chunkSize) = 0;
+
+    //! @brief Ranges(...) with read only access to the cells
+    virtual std::vector<ConstCellRange> Ranges(int chunkSize) const = 0;
+};
+
+//! @brief stores cells of type TCell contiguously in blocks of fixed capacity
+//! @remark The cells are constructed in place and never moved, references to them stay valid. Cells are neither
+//! copyable nor movable, so the blocks are raw (aligned) memory.
+template <typename TCell>
+class CellPool : public CellPoolInterface
+{
+public:
+    //! @param blockSize number of cells per block
+    explicit CellPool(int blockSize = 1024)
+        : mBlockSize(blockSize)
+    {
+    }
+
+    CellPool(const CellPool&) = delete;
+    CellPool& operator=(const CellPool&) = delete;
+
+    ~CellPool()
+    {
+        for (int i = 0; i < mSize; ++i)
+            (*this)[i].~TCell();
+        for (TCell* block : mBlocks)
+            mAllocator.deallocate(block, mBlockSize);
+    }
+
+    //! @brief constructs a cell from `args` in the pool
+    template <typename... TArgs>
+    TCell& Add(TArgs&&... args)
+    {
+        if (mSize == static_cast<int>(mBlocks.size()) * mBlockSize)
+            mBlocks.push_back(mAllocator.allocate(mBlockSize));
+        TCell* cell = new (mBlocks.back() + mSize % mBlockSize) TCell(std::forward<TArgs>(args)...);
+        ++mSize;
+        return *cell;
+    }
+
+    int Size() const override
+    {
+        return mSize;
+    }
+
+    TCell& operator[](int i)
+    {
+        assert(i < mSize);
+        return mBlocks[i / mBlockSize][i % mBlockSize];
+    }
+
+    std::vector<CellRange> Ranges(int chunkSize) override
+    {
+        return RangesT<CellRange, TCell>(chunkSize);
+    }
+
+    std::vector<ConstCellRange> Ranges(int chunkSize) const override
+    {
+        return RangesT<ConstCellRange, const TCell>(chunkSize);
+    }
+
+private:
+    template <typename TRange, typename TBlockCell>
+    std::vector<TRange> RangesT(int chunkSize) const
+    {
+        assert(chunkSize > 0);
+        std::vector<TRange> ranges;
+        for (int start = 0; start < mSize;)
+        {
+            const int end = std::min({start + chunkSize, mSize, (start / mBlockSize + 1) * mBlockSize});
+            ranges.emplace_back(static_cast<TBlockCell*>(mBlocks[start / mBlockSize]) + start % mBlockSize,
+                                end - start);
+            start = end;
+        }
+        return ranges;
+    }
+
+    int mBlockSize;
+    int mSize = 0;
+    std::vector<TCell*> mBlocks;
+    //! @brief respects the alignment of fixed size Eigen members of TCell, e.g. in CellT
+    Eigen::aligned_allocator<TCell> mAllocator;
+};
+} /* NuTo */
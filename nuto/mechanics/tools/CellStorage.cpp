@@ -1,16 +1,116 @@
 #include "nuto/mechanics/tools/CellStorage.h"
-#include "nuto/mechanics/cell/Cell.h"
+#include "nuto/base/Exception.h"
+#include "nuto/math/shapes/Shape.h"
 
 using namespace NuTo;
 
 Group<CellInterface> CellStorage::AddCells(Group<ElementCollectionFem> elements,
                                            const IntegrationTypeBase& integrationType, int cellStartId)
 {
+    CellPool<Cell>& pool = Pool<Cell>(integrationType);
     Group<CellInterface> cellGroup;
     for (auto& element : elements)
     {
-        mCells.push_back(new Cell(element, integrationType, cellStartId++));
-        cellGroup.Add(mCells.back());
+        Cell& cell = pool.Add(element, integrationType, cellStartId++);
+        cell.EnableShapeFunctionTables(mShapeFunctionTables.get());
+        if (mGeometryBudget)
+            cell.EnableGeometryCache(mGeometryBudget.get(), mGeometryDofs);
+        cellGroup.Add(cell);
     }
     return cellGroup;
 }
+
+void CellStorage::EnableGeometryCache(std::vector<DofType> dofTypes, size_t maxBytes)
+{
+    DisableGeometryCache();
+    mGeometryBudget = std::make_unique<GeometryCacheBudget>(maxBytes);
+    mGeometryDofs = dofTypes;
+    ForEachCell([&](Cell& cell) { cell.EnableGeometryCache(mGeometryBudget.get(), mGeometryDofs); });
+}
+
+void CellStorage::DisableGeometryCache()
+{
+    ForEachCell([](Cell& cell) { cell.DisableGeometryCache(); });
+    mGeometryBudget.reset();
+    mGeometryDofs.clear();
+}
+
+size_t CellStorage::GeometryCacheBytes() const
+{
+    return mGeometryBudget ? mGeometryBudget->UsedBytes() : 0;
+}
+
+size_t CellStorage::NumShapeFunctionTables() const
+{
+    return mShapeFunctionTables->Size();
+}
+
+int CellStorage::Size() const
+{
+    int size = 0;
+    for (const auto& pool : mPools)
+        size += pool->Size();
+    return size;
+}
+
+std::vector<CellRange> CellStorage::Ranges(int chunkSize)
+{
+    std::vector<CellRange> ranges;
+    for (const auto& pool : mPools)
+    {
+        std::vector<CellRange> poolRanges = pool->Ranges(chunkSize);
+        ranges.insert(ranges.end(), poolRanges.begin(), poolRanges.end());
+    }
+    return ranges;
+}
+
+std::vector<ConstCellRange> CellStorage::Ranges(int chunkSize) const
+{
+    std::vector<ConstCellRange> ranges;
+    for (const auto& pool : mPools)
+    {
+        std::vector<ConstCellRange> poolRanges = static_cast<const CellPoolInterface&>(*pool).Ranges(chunkSize);
+        ranges.insert(ranges.end(), poolRanges.begin(), poolRanges.end());
+    }
+    return ranges;
+}
+
+namespace
+{
+
+//! @return natural coordinates of the centroid of `shape`
+Eigen::VectorXd NaturalCentroid(const Shape& shape)
+{
+    switch (shape.Enum())
+    {
+    case eShape::Line:
+        return Eigen::VectorXd::Zero(1);
+    case eShape::Triangle:
+        return Eigen::Vector2d::Constant(1. / 3.);
+    case eShape::Quadrilateral:
+        return Eigen::Vector2d::Zero();
+    case eShape::Tetrahedron:
+        return Eigen::Vector3d::Constant(1. / 4.);
+    case eShape::Hexahedron:
+        return Eigen::Vector3d::Zero();
+    case eShape::Prism:
+        return Eigen::Vector3d(1. / 3., 1. / 3., 0.);
+    case eShape::Pyramid:
+        return Eigen::Vector3d(0., 0., 1. / 4.);
+    }
+    throw Exception(__PRETTY_FUNCTION__, "Unknown shape.");
+}
+} // namespace
+
+Group<CellInterface> NuTo::CellsAlongCurve(Group<CellInterface> cells, eSpaceFillingCurve curve)
+{
+    std::vector<Eigen::VectorXd> centroids;
+    centroids.reserve(cells.Size());
+    for (const auto& cell : cells)
+        centroids.push_back(cell.Interpolate(NaturalCentroid(cell.GetShape())));
+
+    Group<CellInterface> sorted;
+    for (int i : SpaceFillingCurveOrder(centroids, curve))
+        sorted.Add(cells[i]);
+    return sorted;
+}
@@ -1,8 +1,12 @@
 #pragma once
-#include <boost/ptr_container/ptr_vector.hpp>
-#include "nuto/mechanics/cell/CellInterface.h"
+#include <map>
+#include <memory>
+#include <typeindex>
+#include "nuto/mechanics/cell/CellT.h"
+#include "nuto/mechanics/tools/CellPool.h"
 #include "nuto/mechanics/elements/ElementCollection.h"
 #include "nuto/base/Group.h"
+#include "nuto/math/SpaceFillingCurve.h"
 
 namespace NuTo
 {
@@ -10,10 +14,14 @@ namespace NuTo
 class IntegrationTypeBase;
 
 //! stores and creates integration cells
+//! @remark The cells are stored contiguously in one CellPool per (cell type, integration type). Ranges() splits them
+//! into chunks, e.g. for the SimpleAssembler overloads that take cell ranges.
 class CellStorage
 {
 public:
     //! creates and stores cells from elements, an integration type and a continuous id
+    //! @remark The cells share precomputed shape function tables, one per (interpolation, integration type) pair. The
+    //! interpolations and the integration type have to outlive this storage.
     //! @param elements group of elements
     //! @param integrationType suitable integration type that matches the elements
     //! @param cellStartId start id of the continous cell numbering
@@ -21,7 +29,90 @@ public:
     Group<CellInterface> AddCells(Group<ElementCollectionFem> elements, const IntegrationTypeBase& integrationType,
                                   int cellStartId = 0);
 
+    //! creates and stores compile time specialized cells, see CellT
+    //! @param elements group of isoparametric elements with TNumNodes nodes
+    //! @param integrationType suitable integration type with TNumIps integration points
+    //! @param cellStartId start id of the continous cell numbering
+    //! @return group of newly created cells
+    template <int TDim, int TNumNodes, int TNumIps>
+    Group<CellT<TDim, TNumNodes, TNumIps>> AddCellsT(Group<ElementCollectionFem> elements,
+                                                     const IntegrationTypeBase& integrationType, int cellStartId = 0)
+    {
+        using CellType = CellT<TDim, TNumNodes, TNumIps>;
+        CellPool<CellType>& pool = Pool<CellType>(integrationType);
+        Group<CellType> cellGroup;
+        for (auto& element : elements)
+        {
+            CellType& cell = pool.Add(element, integrationType, cellStartId++);
+            if (mGeometryBudget)
+                cell.EnableGeometryCache(mGeometryBudget.get(), mGeometryDofs);
+            cellGroup.Add(cell);
+        }
+        return cellGroup;
+    }
+
+    //! caches the reference geometry (inverse jacobians, detJ * w, dN/dx) of all integration points of all cells,
+    //! including the cells that are added later
+    //! @param dofTypes dof types whose global shape function derivatives dN/dx are cached
+    //! @param maxBytes memory budget for the caches of all cells. Cells whose cache does not fit into the remaining
+    //! budget are evaluated without cache.
+    //! @remark The cache of each cell is filled on its first evaluation. It assumes that the nodal coordinates do not
+    //! change afterwards, e.g. small strain analyses. Call DisableGeometryCache() after changing them.
+    void EnableGeometryCache(std::vector<DofType> dofTypes, size_t maxBytes = std::numeric_limits<size_t>::max());
+
+    //! disables the geometry cache and frees its memory
+    void DisableGeometryCache();
+
+    //! @return memory currently used by the geometry caches of all cells in bytes
+    size_t GeometryCacheBytes() const;
+
+    //! @return number of distinct shape function tables shared by the cells
+    size_t NumShapeFunctionTables() const;
+
+    //! @return number of cells
+    int Size() const;
+
+    //! @brief splits all cells into contiguous ranges of at most `chunkSize` cells of the same type, in the order of
+    //! the creation of their pools
+    std::vector<CellRange> Ranges(int chunkSize = 256);
+
+    //! @brief Ranges(...) with read only access to the cells
+    std::vector<ConstCellRange> Ranges(int chunkSize = 256) const;
+
 private:
-    boost::ptr_vector<CellInterface> mCells;
+    //! @return pool of the cells of type TCell with `integrationType`, created if it does not exist
+    template <typename TCell>
+    CellPool<TCell>& Pool(const IntegrationTypeBase& integrationType)
+    {
+        auto& pool = mPoolIndex[{std::type_index(typeid(TCell)), &integrationType}];
+        if (pool == nullptr)
+        {
+            mPools.push_back(std::make_unique<CellPool<TCell>>());
+            pool = mPools.back().get();
+        }
+        return static_cast<CellPool<TCell>&>(*pool);
+    }
+
+    //! @brief calls `f` for all cells of all pools
+    template <typename TFunction>
+    void ForEachCell(TFunction f)
+    {
+        for (const CellRange& range : Ranges())
+            for (Cell& cell : range)
+                f(cell);
+    }
+
+    std::unique_ptr<ShapeFunctionTables> mShapeFunctionTables = std::make_unique<ShapeFunctionTables>();
+    std::unique_ptr<GeometryCacheBudget> mGeometryBudget;
+    std::vector<DofType> mGeometryDofs;
+    //! @brief cell pools in the order of their creation
+    std::vector<std::unique_ptr<CellPoolInterface>> mPools;
+    std::map<std::pair<std::type_index, const IntegrationTypeBase*>, CellPoolInterface*> mPoolIndex;
 };
+
+//! @brief sorts `cells` along a space filling curve through their centroids, e.g. for cells of a mesh that was not
+//! reordered via ReorderAlongCurve(MeshFem*, ...)
+//! @return group with the same cells, the assembly visits them in this order
+Group<CellInterface> CellsAlongCurve(Group<CellInterface> cells,
+                                     eSpaceFillingCurve curve = eSpaceFillingCurve::HILBERT);
 } /* NuTo */
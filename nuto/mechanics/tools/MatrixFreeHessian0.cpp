@@ -0,0 +1,77 @@
+#include "nuto/mechanics/tools/MatrixFreeHessian0.h"
+#include "nuto/base/Exception.h"
+#include "nuto/mechanics/dofs/DofVectorConvertEigen.h"
+
+using namespace NuTo;
+
+MatrixFreeHessian0::MatrixFreeHessian0(TimeDependentProblem& problem, DofVector<double> dofValues,
+                                       std::vector<DofType> dofs, double t, double dt, bool cacheTangents)
+    : mProblem(problem)
+    , mDofValues(dofValues)
+    , mDofs(dofs)
+    , mT(t)
+    , mDt(dt)
+    , mCacheTangents(cacheTangents)
+{
+    for (DofType dof : mDofs)
+        mSizes.push_back(mDofValues[dof].rows());
+    if (mCacheTangents)
+        mTangents = mProblem.BuildHessian0Tangents(mDofValues, mDofs, mT, mDt);
+}
+
+void MatrixFreeHessian0::SetConstraintMatrix(Eigen::SparseMatrix<double> C)
+{
+    if (C.rows() != TotalRows(mDofValues, mDofs))
+        throw Exception(__PRETTY_FUNCTION__, "The constraint matrix has " + std::to_string(C.rows()) +
+                                                     " rows, expected " +
+                                                     std::to_string(TotalRows(mDofValues, mDofs)) + ".");
+    mC = C;
+    mHasConstraintMatrix = true;
+}
+
+DofVector<double> MatrixFreeHessian0::Apply(const DofVector<double>& x) const
+{
+    if (mCacheTangents)
+        return mProblem.Hessian0Product(mTangents, mDofValues, x, mDofs, mT, mDt);
+    return mProblem.Hessian0Product(mDofValues, x, mDofs, mT, mDt);
+}
+
+DofVector<double> MatrixFreeHessian0::Diagonal() const
+{
+    if (mCacheTangents)
+        return mProblem.Hessian0Diagonal(mTangents, mDofValues, mDofs, mT, mDt);
+    return mProblem.Hessian0Diagonal(mDofValues, mDofs, mT, mDt);
+}
+
+int MatrixFreeHessian0::rows() const
+{
+    return mHasConstraintMatrix ? mC.cols() : TotalRows(mDofValues, mDofs);
+}
+
+int MatrixFreeHessian0::cols() const
+{
+    return rows();
+}
+
+Eigen::VectorXd MatrixFreeHessian0::operator*(const Eigen::VectorXd& x) const
+{
+    // The contiguous vectors adopt the Eigen vectors without copies and the dependent dof values of mDofValues are not
+    // needed, since C x contains all dofs.
+    Eigen::VectorXd allX = mHasConstraintMatrix ? Eigen::VectorXd(mC * x) : x;
+    const ContiguousDofVector<double> xDof(mDofs, mSizes, std::move(allX));
+
+    ContiguousDofVector<double> y = mCacheTangents
+                                            ? mProblem.Hessian0Product(mTangents, mDofValues, xDof, mDofs, mT, mDt)
+                                            : mProblem.Hessian0Product(mDofValues, xDof, mDofs, mT, mDt);
+    if (mHasConstraintMatrix)
+        return mC.transpose() * y.Values();
+    return std::move(y.Values());
+}
+
+Eigen::VectorXd MatrixFreeHessian0::diagonal() const
+{
+    const Eigen::VectorXd d = ToEigen(Diagonal(), mDofs);
+    if (mHasConstraintMatrix)
+        return mC.cwiseAbs2().transpose() * d;
+    return d;
+}
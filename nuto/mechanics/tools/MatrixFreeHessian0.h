@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Eigen/Sparse>
+#include "nuto/mechanics/tools/TimeDependentProblem.h"
+
+namespace NuTo
+{
+//! @brief Linear operator y = Hessian0(u) x of a TimeDependentProblem that never assembles Hessian0
+//!
+//! The products and the diagonal are calculated cell by cell from the registered Hessian0 functions. The lowercase
+//! methods rows(), cols(), operator* and diagonal() make this operator usable in NuTo::Gmres and
+//! NuTo::ConjugateGradient, e.g. with the NuTo::JacobiPreconditioner.
+//!
+//! The Eigen interface acts on the independent dofs only, if a constraint matrix C is set. It then represents
+//! C^T Hessian0 C, the same system that is solved by NuTo::Solve(...).
+class MatrixFreeHessian0
+{
+public:
+    //! ctor
+    //! @param problem time dependent problem with Hessian0 functions
+    //! @param dofValues independent and dependent dof values that define the state of the linearization
+    //! @param dofs dof types
+    //! @param t global time
+    //! @param dt time step
+    //! @param cacheTangents keeps the tangents of all integration points of the functions added via
+    //! TimeDependentProblem::AddHessian0TangentFunction(...). This costs one small tangent per integration point but
+    //! evaluates the constitutive laws only once instead of in every product. The products B^T (D (B x)) are applied
+    //! per integration point without local matrices.
+    MatrixFreeHessian0(TimeDependentProblem& problem, DofVector<double> dofValues, std::vector<DofType> dofs,
+                       double t, double dt, bool cacheTangents = false);
+
+    //! @brief restricts the Eigen interface to the independent dofs
+    //! @param C unit constraint matrix of all `dofs` that maps the independent dofs to all dofs
+    void SetConstraintMatrix(Eigen::SparseMatrix<double> C);
+
+    //! @return Hessian0 * x for independent and dependent dofs
+    DofVector<double> Apply(const DofVector<double>& x) const;
+
+    //! @return diagonal of Hessian0 for independent and dependent dofs
+    DofVector<double> Diagonal() const;
+
+    int rows() const;
+
+    int cols() const;
+
+    //! @return C^T Hessian0 C x, or Hessian0 x if no constraint matrix is set
+    Eigen::VectorXd operator*(const Eigen::VectorXd& x) const;
+
+    //! @return diagonal of C^T Hessian0 C, couplings of independent dofs via the dependent dofs are neglected. This is
+    //! exact for the common case of Dirichlet constraints.
+    Eigen::VectorXd diagonal() const;
+
+private:
+    TimeDependentProblem& mProblem;
+    DofVector<double> mDofValues;
+    std::vector<DofType> mDofs;
+    //! @brief number of values of each of the mDofs, the layout of the contiguous vectors in operator*
+    std::vector<int> mSizes;
+    double mT;
+    double mDt;
+
+    TimeDependentProblem::Hessian0Tangents mTangents;
+    bool mCacheTangents;
+
+    Eigen::SparseMatrix<double> mC;
+    bool mHasConstraintMatrix = false;
+};
+} /* NuTo */
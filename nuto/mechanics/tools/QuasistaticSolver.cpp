@@ -2,6 +2,7 @@
 
 #include <ostream>
 #include <iomanip>
+#include <cmath>
 #include <boost/range/numeric.hpp>
 
 #include "nuto/base/Logger.h"
@@ -29,10 +30,11 @@ QuasistaticSolver::QuasistaticSolver(TimeDependentProblem& s, std::vector<DofTyp
 void QuasistaticSolver::SetConstraints(Constraint::Constraints constraints)
 {
     mConstraints = constraints;
+    mSolver.reset();
     if (mX[mDofs.front()].rows() == 0)
-        mX = mProblem.RenumberDofs(constraints, mDofs, DofVector<double>());
+        mX = mProblem.RenumberDofs(constraints, mDofs, DofVector<double>(), mDofOrdering);
     else
-        mX = mProblem.RenumberDofs(constraints, mDofs, mX);
+        mX = mProblem.RenumberDofs(constraints, mDofs, mX, mDofOrdering);
 
     for (auto dofI : mDofs)
         for (auto dofJ : mDofs)
@@ -42,6 +44,31 @@ void QuasistaticSolver::SetConstraints(Constraint::Constraints constraints)
                 mCmatUnit(dofI, dofJ).setZero();
 }
 
+void QuasistaticSolver::SetDofOrdering(eDofOrdering ordering)
+{
+    mDofOrdering = ordering;
+}
+
+void QuasistaticSolver::SetTangentUpdate(NewtonRaphson::TangentUpdate update, int maxIterations)
+{
+    mTangentUpdate = update;
+    mMaxIterations = maxIterations;
+}
+
+void QuasistaticSolver::SetNearNullspace(std::vector<DofVector<double>> modes)
+{
+    mNearNullspace = modes;
+    if (mSolver)
+        mSolver->SetNearNullspace(mNearNullspace);
+}
+
+void QuasistaticSolver::SetProlongators(std::vector<Eigen::SparseMatrix<double>> prolongators)
+{
+    mProlongators = prolongators;
+    if (mSolver)
+        mSolver->SetProlongators(mProlongators, mX);
+}
+
 void QuasistaticSolver::SetGlobalTime(double globalTime)
 {
     mTimeStep = globalTime - mGlobalTime;
@@ -51,7 +78,7 @@ void QuasistaticSolver::SetGlobalTime(double globalTime)
 DofVector<double> QuasistaticSolver::TrialState(double newGlobalTime, const ConstrainedSystemSolver& solver)
 {
     // compute hessian for last converged time step
-    auto hessian0 = mProblem.Hessian0(mX, mDofs, mGlobalTime, mTimeStep);
+    const auto& hessian0 = mProblem.Hessian0(mX, mDofs, mGlobalTime, mTimeStep);
     Eigen::SparseMatrix<double> hessian0Eigen(ToEigen(hessian0, mDofs));
 
     // update time step
@@ -71,11 +98,17 @@ DofVector<double> QuasistaticSolver::Residual(const DofVector<double>& u)
 }
 
 
-DofMatrixSparse<double> QuasistaticSolver::Derivative(const DofVector<double>& u)
+const DofMatrixSparse<double>& QuasistaticSolver::Derivative(const DofVector<double>& u)
 {
     return mProblem.Hessian0(u, mDofs, mGlobalTime + mTimeStep, mTimeStep);
 }
 
+std::pair<DofVector<double>, const DofMatrixSparse<double>&>
+QuasistaticSolver::ResidualAndDerivative(const DofVector<double>& u)
+{
+    return mProblem.GradientAndHessian0(u, mDofs, mGlobalTime + mTimeStep, mTimeStep);
+}
+
 void QuasistaticSolver::UpdateHistory(const DofVector<double>& x)
 {
     mProblem.UpdateHistory(x, mDofs, mGlobalTime + mTimeStep, mTimeStep);
@@ -83,10 +116,12 @@ void QuasistaticSolver::UpdateHistory(const DofVector<double>& x)
 
 double QuasistaticSolver::Norm(const DofVector<double>& residual) const
 {
-    // all these conversions should be removed at some point, workaround to remove JK
-    Eigen::VectorXd tmp = ToEigen(residual, mDofs);
-    auto C = ToEigen(mCmatUnit, mDofs);
-    return (C.transpose() * tmp).norm();
+    // |C^T r| block by block, without assembling C and r into single Eigen objects in each iteration. mCmatUnit is
+    // block diagonal, see SetConstraints(...).
+    double squaredNorm = 0;
+    for (DofType dof : mDofs)
+        squaredNorm += (mCmatUnit(dof, dof).transpose() * residual[dof]).squaredNorm();
+    return std::sqrt(squaredNorm);
 }
 
 void QuasistaticSolver::Info(int i, const DofVector<double>& x, const DofVector<double>& r) const
@@ -115,8 +150,16 @@ void QuasistaticSolver::WriteTimeDofResidual(std::ostream& out, DofType dofType,
 
 int QuasistaticSolver::DoStep(double newGlobalTime, std::string solverType)
 {
-    // allocate constraint system solver
-    ConstrainedSystemSolver solver(mConstraints, mDofs, solverType);
+    // allocate constraint system solver, or reuse the one of the last step
+    if (not mSolver or mSolverType != solverType)
+    {
+        mSolver = std::make_unique<ConstrainedSystemSolver>(mConstraints, mDofs, solverType,
+                                                            mProblem.Hessian0Storage());
+        mSolver->SetNearNullspace(mNearNullspace);
+        mSolver->SetProlongators(mProlongators, mX);
+        mSolverType = solverType;
+    }
+    const ConstrainedSystemSolver& solver = *mSolver;
 
     // compute trial solution (includes update of the constraint dofs, no line search)
     DofVector<double> trialU = TrialState(newGlobalTime, solver);
@@ -129,7 +172,21 @@ int QuasistaticSolver::DoStep(double newGlobalTime, std::string solverType)
     DofVector<double> tmpX;
     try
     {
-        tmpX = NewtonRaphson::Solve(*this, trialU, solver, 6, NewtonRaphson::LineSearch(), &numIterations);
+        // the fused functions assemble the derivative with each residual, in vain for the other tangent updates
+        if (mProblem.HasGradientAndHessian0Functions() and mTangentUpdate.IsFullNewton())
+            tmpX = NewtonRaphson::Solve(*this, trialU, solver, mMaxIterations, NewtonRaphson::LineSearch(),
+                                        &numIterations);
+        else
+        {
+            // without fused functions, ResidualAndDerivative(u) only adds Hessian0 assemblies to the line search
+            auto problem = NewtonRaphson::DefineProblem(
+                    [&](const DofVector<double>& u) { return Residual(u); },
+                    [&](const DofVector<double>& u) -> const DofMatrixSparse<double>& { return Derivative(u); },
+                    [&](const DofVector<double>& r) { return Norm(r); }, mTolerance,
+                    [&](int i, const DofVector<double>& x, const DofVector<double>& r) { Info(i, x, r); });
+            tmpX = NewtonRaphson::Solve(problem, trialU, solver, mMaxIterations, NewtonRaphson::LineSearch(),
+                                        &numIterations, mTangentUpdate);
+        }
     }
     catch (std::exception& e)
     {
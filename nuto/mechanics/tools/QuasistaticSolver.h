@@ -1,9 +1,11 @@
 #pragma once
 
+#include "nuto/math/TangentUpdate.h"
 #include "nuto/mechanics/solver/Solve.h"
 #include "nuto/mechanics/tools/TimeDependentProblem.h"
 #include "nuto/mechanics/constraints/Constraints.h"
 #include <iosfwd>
+#include <memory>
 
 namespace NuTo
 {
@@ -23,6 +25,25 @@ public:
     //! @param constraints linear constraints
     void SetConstraints(Constraint::Constraints constraints);
 
+    //! @brief node ordering of the dof numbering, see TimeDependentProblem::RenumberDofs(...)
+    //! @remark takes effect with the next SetConstraints(...)
+    void SetDofOrdering(eDofOrdering ordering);
+
+    //! @brief when the newton iterations of DoStep(...) evaluate and factorize a new derivative
+    //! @param update e.g. NewtonRaphson::ModifiedNewton(0, 0.5, true) keeps the factorization of the trial state until
+    //! the convergence stagnates
+    //! @param maxIterations maximum number of newton iterations per step, the modified and quasi-newton methods need
+    //! more iterations than the full newton method
+    void SetTangentUpdate(NewtonRaphson::TangentUpdate update, int maxIterations = 20);
+
+    //! @brief near nullspace for the `AmgCG` solver of DoStep(...), see ConstrainedSystemSolver::SetNearNullspace(...)
+    //! @param modes e.g. RigidBodyModes(mesh, dofs) with the dof numbering of SetConstraints(...)
+    void SetNearNullspace(std::vector<DofVector<double>> modes);
+
+    //! @brief prolongators for the `GmgCG` solver of DoStep(...), see ConstrainedSystemSolver::SetProlongators(...)
+    //! @param prolongators e.g. StructuredMeshHierarchy::Prolongators() with the dof numbering of SetConstraints(...)
+    void SetProlongators(std::vector<Eigen::SparseMatrix<double>> prolongators);
+
     //! sets the global time required for evaluating the constraint right hand side
     //! @param globalTime global time
     void SetGlobalTime(double globalTime);
@@ -42,7 +63,12 @@ public:
 
     //! evaluates the derivative dR/dx, part of NuTo::NewtonRaphson::Problem
     //! @param u independent dof values
-    DofMatrixSparse<double> Derivative(const DofVector<double>& u);
+    //! @return reference to the Hessian0 of the problem, see TimeDependentProblem::Hessian0(...)
+    const DofMatrixSparse<double>& Derivative(const DofVector<double>& u);
+
+    //! evaluates R(u) and dR/dx at once, used by NuTo::NewtonRaphson::Solve instead of Residual(u) and Derivative(u)
+    //! @param u independent dof values
+    std::pair<DofVector<double>, const DofMatrixSparse<double>&> ResidualAndDerivative(const DofVector<double>& u);
 
 
     //! evaluates the norm of R, part of NuTo::NewtonRaphson::Problem
@@ -62,6 +88,10 @@ public:
     //! Updates mProblem to time `newGlobalTime` and saves the new state mX upon convergence
     //! @param newGlobalTime new global time
     //! @param solverType solver type from NuTo::EigenSparseSolve(...)
+    //! @remark Uses the fused ResidualAndDerivative(u) if the problem has functions added via
+    //! TimeDependentProblem::AddGradientAndHessian0Function(...) and the tangent update is the full newton method
+    //! @remark The constraint system solver and thus the symbolic analysis of its factorization are kept between the
+    //! steps, until the constraints or the `solverType` change.
     //! @return number of iterations required by the newton algorithm, throws upon failure to converge
     int DoStep(double newGlobalTime, std::string solverType = "EigenSparseLU");
 
@@ -81,6 +111,17 @@ private:
 
     std::vector<DofType> mDofs;
     DofMatrixSparse<double> mCmatUnit;
+    eDofOrdering mDofOrdering = eDofOrdering::NATURAL;
+
+    //! @brief solver of the last DoStep(...), references mConstraints
+    std::unique_ptr<ConstrainedSystemSolver> mSolver;
+    std::string mSolverType;
+
+    std::vector<DofVector<double>> mNearNullspace;
+    std::vector<Eigen::SparseMatrix<double>> mProlongators;
+
+    NewtonRaphson::TangentUpdate mTangentUpdate = NewtonRaphson::FullNewton();
+    int mMaxIterations = 6;
 
     double mGlobalTime = 0;
     double mTimeStep = 0;
@@ -1,15 +1,49 @@
 #include "nuto/mechanics/tools/TimeDependentProblem.h"
-#include "nuto/mechanics/dofs/DofNumbering.h"
+#include "nuto/mechanics/cell/Cell.h"
 
 using namespace NuTo;
 
+namespace
+{
+
+bool SameDofTypes(const std::vector<DofType>& one, const std::vector<DofType>& two)
+{
+    if (one.size() != two.size())
+        return false;
+    for (size_t i = 0; i < one.size(); ++i)
+        if (one[i].Id() != two[i].Id())
+            return false;
+    return true;
+}
+
+//! @brief adds `summand` to `rSum`, an empty `rSum` takes over `summand` and its layout
+void AddTo(ContiguousDofVector<double>* rSum, ContiguousDofVector<double> summand)
+{
+    if (rSum->DofTypes().empty())
+        *rSum = std::move(summand);
+    else
+        *rSum += summand;
+}
+
+//! @return group of all cells of `ranges`
+Group<CellInterface> ToGroup(const std::vector<CellRange>& ranges)
+{
+    Group<CellInterface> group;
+    for (const CellRange& range : ranges)
+        for (Cell& cell : range)
+            group.Add(cell);
+    return group;
+}
+} // namespace
+
 TimeDependentProblem::TimeDependentProblem(MeshFem* rMesh)
-    : mMerger(rMesh)
+    : mMesh(*rMesh)
+    , mMerger(rMesh)
 {
 }
 
 DofVector<double> TimeDependentProblem::RenumberDofs(Constraint::Constraints constraints, std::vector<DofType> dofTypes,
-                                                   DofVector<double> oldDofValues)
+                                                   DofVector<double> oldDofValues, eDofOrdering ordering)
 {
     DofInfo dofInfos;
 
@@ -20,25 +54,82 @@ DofVector<double> TimeDependentProblem::RenumberDofs(Constraint::Constraints con
         if (oldDofValues[dofType].rows() != 0) // initial case: No merge of an uninitialized vector
             mMerger.Merge(oldDofValues, {dofType});
 
-        auto dofInfo = DofNumbering::Build(mMerger.Nodes(dofType), dofType, constraints);
+        const Group<NodeSimple>& nodes = mMerger.Nodes(dofType);
+        auto dofInfo = ordering == eDofOrdering::NATURAL
+                               ? DofNumbering::Build(nodes, dofType, constraints)
+                               : DofNumbering::Build(nodes, dofType, constraints, mMesh.ElementsTotal(), ordering);
         dofInfos.Merge(dofType, dofInfo);
 
+        std::vector<int>& permutation = mDofPermutations[dofType];
+        permutation.clear();
+        for (const auto& node : nodes)
+            for (int iComponent = 0; iComponent < node.GetNumValues(); ++iComponent)
+                permutation.push_back(node.GetDofNumber(iComponent));
+
         renumberedValues[dofType].resize(dofInfo.numIndependentDofs[dofType] + dofInfo.numDependentDofs[dofType]);
 
         mMerger.Extract(&renumberedValues, {dofType});
     }
     mAssembler.SetDofInfo(dofInfos);
+    mDofValueSource->InvalidateNumbering();
+    ClearHessian0Pattern();
+    mColoringDofs.clear();
     return renumberedValues;
 }
 
+const std::vector<int>& TimeDependentProblem::DofPermutation(DofType dof) const
+{
+    if (not mDofPermutations.Has(dof))
+        throw Exception(__PRETTY_FUNCTION__, "There is no numbering for dof type " + dof.GetName() + ".");
+    return mDofPermutations[dof];
+}
+
+void TimeDependentProblem::EnableDirectNodeValues()
+{
+    mDirectNodeValues = true;
+    for (auto& gradientFunction : mGradientFunctions)
+        ConnectDofValueSource(gradientFunction.first);
+    for (auto& hessian0Function : mHessian0Functions)
+        ConnectDofValueSource(hessian0Function.first);
+}
+
+void TimeDependentProblem::ConnectDofValueSource(const Group<CellInterface>& group)
+{
+    if (not mDirectNodeValues)
+        return;
+    for (CellInterface& cellInterface : group)
+    {
+        Cell* cell = dynamic_cast<Cell*>(&cellInterface);
+        if (cell == nullptr)
+            throw Exception(__PRETTY_FUNCTION__, "Direct node values require cells of type NuTo::Cell.");
+        cell->SetDofValueSource(mDofValueSource);
+    }
+}
+
+DofValueSource* TimeDependentProblem::MergeNodeValues(const DofVector<double>& dofValues,
+                                                      const std::vector<DofType>& dofs)
+{
+    if (not mDirectNodeValues or not mBatches.empty())
+        mMerger.Merge(dofValues, dofs);
+    return mDirectNodeValues ? mDofValueSource.get() : nullptr;
+}
+
 void TimeDependentProblem::AddGradientFunction(Group<CellInterface> group, GradientFunction f)
 {
+    ConnectDofValueSource(group);
     mGradientFunctions.push_back({group, f});
+    mGradientRanges.emplace_back();
+    mColoringDofs.clear();
 }
 
-void TimeDependentProblem::AddHessian0Function(Group<CellInterface> group, HessianFunction f)
+void TimeDependentProblem::AddHessian0Function(Group<CellInterface> group, HessianFunction f, bool symmetric)
 {
+    ConnectDofValueSource(group);
     mHessian0Functions.push_back({group, f});
+    mHessian0Ranges.emplace_back();
+    mHessian0Symmetric.push_back(symmetric);
+    ClearHessian0Pattern();
+    mColoringDofs.clear();
 }
 
 void TimeDependentProblem::AddUpdateFunction(Group<CellInterface> group, UpdateFunction f)
@@ -46,6 +137,75 @@ void TimeDependentProblem::AddUpdateFunction(Group<CellInterface> group, UpdateF
     mUpdateFunctions.push_back({group, f});
 }
 
+void TimeDependentProblem::AddGradientFunction(std::vector<CellRange> ranges, GradientFunction f)
+{
+    AddGradientFunction(ToGroup(ranges), f);
+    mGradientRanges.back() = std::move(ranges);
+}
+
+void TimeDependentProblem::AddHessian0Function(std::vector<CellRange> ranges, HessianFunction f, bool symmetric)
+{
+    AddHessian0Function(ToGroup(ranges), f, symmetric);
+    mHessian0Ranges.back() = std::move(ranges);
+}
+
+void TimeDependentProblem::AddGradientAndHessian0Function(Group<CellInterface> group, GradientAndHessian0Function f,
+                                                          bool symmetric)
+{
+    mGradientAndHessian0Functions.push_back({f, mGradientFunctions.size(), mHessian0Functions.size()});
+    AddGradientFunction(group, [f](const CellIpData& cellIpData, double t, double dt) {
+        return f(cellIpData, t, dt).first;
+    });
+    AddHessian0Function(group,
+                        [f](const CellIpData& cellIpData, double t, double dt) { return f(cellIpData, t, dt).second; },
+                        symmetric);
+}
+
+void TimeDependentProblem::AddBatch(const CellBatchInterface& batch)
+{
+    mBatches.push_back(&batch);
+    ClearHessian0Pattern();
+}
+
+void TimeDependentProblem::ThrowOnBatches(std::string function) const
+{
+    if (not mBatches.empty())
+        throw Exception(function, "This method does not support cell batches, see AddBatch(...).");
+}
+
+void TimeDependentProblem::AddHessian0TangentFunction(Group<CellInterface> group, DofType dof,
+                                                      SimpleAssembler::OperatorFunction b, TangentFunction tangent,
+                                                      bool symmetric)
+{
+    mHessian0TangentFunctions.push_back({dof, b, tangent, mHessian0Functions.size()});
+    AddHessian0Function(group,
+                        [dof, b, tangent](const CellIpData& cellIpData, double t, double dt) {
+                            const Eigen::MatrixXd& B = b(cellIpData);
+                            DofMatrix<double> hessian0;
+                            hessian0(dof, dof) = B.transpose() * tangent(cellIpData, t, dt) * B;
+                            return hessian0;
+                        },
+                        symmetric);
+}
+
+bool TimeDependentProblem::HasGradientAndHessian0Functions() const
+{
+    return not mGradientAndHessian0Functions.empty();
+}
+
+eMatrixStorage TimeDependentProblem::Hessian0Storage() const
+{
+    if (mHessian0Symmetric.empty() and mBatches.empty())
+        return eMatrixStorage::FULL;
+    for (bool symmetric : mHessian0Symmetric)
+        if (not symmetric)
+            return eMatrixStorage::FULL;
+    for (const CellBatchInterface* batch : mBatches)
+        if (not batch->IsHessian0Symmetric())
+            return eMatrixStorage::FULL;
+    return eMatrixStorage::UPPER;
+}
+
 template <typename TCellInterfaceFunction, typename TTimeDepFunction>
 TCellInterfaceFunction Apply(TTimeDepFunction& f, double t, double dt)
 {
@@ -56,23 +216,336 @@ TCellInterfaceFunction Apply(TTimeDepFunction& f, double t, double dt)
 DofVector<double> TimeDependentProblem::Gradient(const DofVector<double>& dofValues, std::vector<DofType> dofs, double t,
                                                double dt)
 {
-    mMerger.Merge(dofValues, dofs);
+    ScopedDofValueBinding binding(MergeNodeValues(dofValues, dofs), dofValues, dofs);
+    UpdateColorings(dofs);
     DofVector<double> gradient;
-    for (auto& gradientFunction : mGradientFunctions)
-        gradient += mAssembler.BuildVector(gradientFunction.first, dofs,
-                                           Apply<CellInterface::VectorFunction>(gradientFunction.second, t, dt));
+    for (size_t i = 0; i < mGradientFunctions.size(); ++i)
+    {
+        auto f = Apply<CellInterface::VectorFunction>(mGradientFunctions[i].second, t, dt);
+        if (mGradientRanges[i].empty())
+            gradient += mAssembler.BuildVector(mGradientFunctions[i].first, dofs, f, mGradientColorings[i]);
+        else
+            gradient += mAssembler.BuildVector(mGradientRanges[i], dofs, f, mGradientColorings[i]);
+    }
+    for (const CellBatchInterface* batch : mBatches)
+        gradient += mAssembler.BuildVector(*batch, dofs, dt);
     return gradient;
 }
 
-DofMatrixSparse<double> TimeDependentProblem::Hessian0(const DofVector<double>& dofValues, std::vector<DofType> dofs,
-                                                     double t, double dt)
+const DofMatrixSparse<double>& TimeDependentProblem::Hessian0(const DofVector<double>& dofValues,
+                                                             std::vector<DofType> dofs, double t, double dt)
 {
-    mMerger.Merge(dofValues, dofs);
-    DofMatrixSparse<double> hessian0;
+    ScopedDofValueBinding binding(MergeNodeValues(dofValues, dofs), dofValues, dofs);
+
+    if (mHessian0Dofs.empty() or not SameDofTypes(mHessian0Dofs, dofs))
+    {
+        // first assembly via triplets, this defines the nonzero pattern for all following assemblies
+        DofMatrixSparse<double> hessian0;
+        for (size_t i = 0; i < mHessian0Functions.size(); ++i)
+        {
+            auto f = Apply<CellInterface::MatrixFunction>(mHessian0Functions[i].second, t, dt);
+            if (mHessian0Ranges[i].empty())
+                hessian0 += mAssembler.BuildMatrix(mHessian0Functions[i].first, dofs, f, Hessian0Storage());
+            else
+                hessian0 += mAssembler.BuildMatrix(mHessian0Ranges[i], dofs, f, Hessian0Storage());
+        }
+        for (const CellBatchInterface* batch : mBatches)
+            hessian0 += mAssembler.BuildMatrix(*batch, dofs, dt, Hessian0Storage());
+        for (auto dofI : dofs)
+            for (auto dofJ : dofs)
+                hessian0(dofI, dofJ).makeCompressed();
+
+        mHessian0 = std::move(hessian0);
+        mHessian0Dofs = dofs;
+        mHessian0ScatterMaps = std::vector<SimpleAssembler::ScatterMap>(mHessian0Functions.size());
+        return mHessian0;
+    }
+
+    for (auto dofI : dofs)
+        for (auto dofJ : dofs)
+            mHessian0(dofI, dofJ).coeffs().setZero();
+
+    UpdateColorings(dofs);
+    for (size_t i = 0; i < mHessian0Functions.size(); ++i)
+        mAssembler.AddToMatrix(&mHessian0, mHessian0Functions[i].first, dofs,
+                               Apply<CellInterface::MatrixFunction>(mHessian0Functions[i].second, t, dt),
+                               &mHessian0ScatterMaps[i], mHessian0Colorings[i], Hessian0Storage());
+    for (const CellBatchInterface* batch : mBatches)
+        mAssembler.AddToMatrix(&mHessian0, *batch, dofs, dt, Hessian0Storage());
+    return mHessian0;
+}
+
+std::pair<DofVector<double>, const DofMatrixSparse<double>&>
+TimeDependentProblem::GradientAndHessian0(const DofVector<double>& dofValues, std::vector<DofType> dofs, double t,
+                                          double dt)
+{
+    if (mHessian0Dofs.empty() or not SameDofTypes(mHessian0Dofs, dofs))
+    {
+        Hessian0(dofValues, dofs, t, dt);
+        return {Gradient(dofValues, dofs, t, dt), mHessian0};
+    }
+
+    ScopedDofValueBinding binding(MergeNodeValues(dofValues, dofs), dofValues, dofs);
+    UpdateColorings(dofs);
+
+    std::vector<bool> isFusedGradient(mGradientFunctions.size(), false);
+    std::vector<bool> isFusedHessian0(mHessian0Functions.size(), false);
+    for (const auto& entry : mGradientAndHessian0Functions)
+    {
+        isFusedGradient[entry.gradientIndex] = true;
+        isFusedHessian0[entry.hessian0Index] = true;
+    }
+
+    DofVector<double> gradient;
+    for (size_t i = 0; i < mGradientFunctions.size(); ++i)
+    {
+        if (isFusedGradient[i])
+            continue;
+        auto f = Apply<CellInterface::VectorFunction>(mGradientFunctions[i].second, t, dt);
+        if (mGradientRanges[i].empty())
+            gradient += mAssembler.BuildVector(mGradientFunctions[i].first, dofs, f, mGradientColorings[i]);
+        else
+            gradient += mAssembler.BuildVector(mGradientRanges[i], dofs, f, mGradientColorings[i]);
+    }
+
+    for (auto dofI : dofs)
+        for (auto dofJ : dofs)
+            mHessian0(dofI, dofJ).coeffs().setZero();
+
+    for (size_t i = 0; i < mHessian0Functions.size(); ++i)
+        if (not isFusedHessian0[i])
+            mAssembler.AddToMatrix(&mHessian0, mHessian0Functions[i].first, dofs,
+                                   Apply<CellInterface::MatrixFunction>(mHessian0Functions[i].second, t, dt),
+                                   &mHessian0ScatterMaps[i], mHessian0Colorings[i], Hessian0Storage());
+
+    for (auto& entry : mGradientAndHessian0Functions)
+    {
+        const size_t iHessian0 = entry.hessian0Index;
+        gradient += mAssembler.BuildVectorAndAddToMatrix(
+                &mHessian0, mHessian0Functions[iHessian0].first, dofs,
+                Apply<CellInterface::VectorMatrixFunction>(entry.f, t, dt), &mHessian0ScatterMaps[iHessian0],
+                mHessian0Colorings[iHessian0], Hessian0Storage());
+    }
+
+    for (const CellBatchInterface* batch : mBatches)
+    {
+        gradient += mAssembler.BuildVector(*batch, dofs, dt);
+        mAssembler.AddToMatrix(&mHessian0, *batch, dofs, dt, Hessian0Storage());
+    }
+    return {std::move(gradient), mHessian0};
+}
+
+BlockSparseMatrix TimeDependentProblem::Hessian0Blocked(const DofVector<double>& dofValues, DofType dof, double t,
+                                                        double dt)
+{
+    ThrowOnBatches(__PRETTY_FUNCTION__);
+    ScopedDofValueBinding binding(MergeNodeValues(dofValues, {dof}), dofValues, {dof});
+    UpdateColorings({dof});
+
+    if (mHessian0BlockedDof.empty() or not SameDofTypes(mHessian0BlockedDof, {dof}))
+    {
+        std::vector<Group<CellInterface>> cellGroups;
+        for (auto& hessian0Function : mHessian0Functions)
+            cellGroups.push_back(hessian0Function.first);
+        mHessian0Blocked = mAssembler.BuildBlockMatrixPattern(cellGroups, dof);
+        mHessian0BlockedDof = {dof};
+        mHessian0BlockedScatterMaps = std::vector<SimpleAssembler::BlockScatterMap>(mHessian0Functions.size());
+    }
+    else
+        mHessian0Blocked.SetZero();
+
+    for (size_t i = 0; i < mHessian0Functions.size(); ++i)
+        mAssembler.AddToBlockMatrix(&mHessian0Blocked, mHessian0Functions[i].first, dof,
+                                    Apply<CellInterface::MatrixFunction>(mHessian0Functions[i].second, t, dt),
+                                    &mHessian0BlockedScatterMaps[i], mHessian0Colorings[i]);
+    return mHessian0Blocked;
+}
+
+DofVector<double> TimeDependentProblem::Hessian0Product(const DofVector<double>& dofValues, const DofVector<double>& x,
+                                                        std::vector<DofType> dofs, double t, double dt)
+{
+    ScopedDofValueBinding binding(MergeNodeValues(dofValues, dofs), dofValues, dofs);
+    UpdateColorings(dofs);
+    DofVector<double> product;
+    for (size_t i = 0; i < mHessian0Functions.size(); ++i)
+        product += mAssembler.BuildMatrixVectorProduct(
+                mHessian0Functions[i].first, dofs,
+                Apply<CellInterface::MatrixFunction>(mHessian0Functions[i].second, t, dt), x, mHessian0Colorings[i]);
+    for (const CellBatchInterface* batch : mBatches)
+        product += mAssembler.BuildMatrixVectorProduct(*batch, dofs, x, dt);
+    return product;
+}
+
+DofVector<double> TimeDependentProblem::Hessian0Diagonal(const DofVector<double>& dofValues,
+                                                         std::vector<DofType> dofs, double t, double dt)
+{
+    ScopedDofValueBinding binding(MergeNodeValues(dofValues, dofs), dofValues, dofs);
+    UpdateColorings(dofs);
+    DofVector<double> diagonal;
+    for (size_t i = 0; i < mHessian0Functions.size(); ++i)
+        diagonal += mAssembler.BuildDiagonal(mHessian0Functions[i].first, dofs,
+                                             Apply<CellInterface::MatrixFunction>(mHessian0Functions[i].second, t, dt),
+                                             mHessian0Colorings[i]);
+    for (const CellBatchInterface* batch : mBatches)
+        diagonal += mAssembler.BuildDiagonal(*batch, dofs, dt);
+    return diagonal;
+}
+
+ContiguousDofVector<double> TimeDependentProblem::Hessian0Product(const DofVector<double>& dofValues,
+                                                                  const ContiguousDofVector<double>& x,
+                                                                  std::vector<DofType> dofs, double t, double dt)
+{
+    ScopedDofValueBinding binding(MergeNodeValues(dofValues, dofs), dofValues, dofs);
+    UpdateColorings(dofs);
+    ContiguousDofVector<double> product;
+    for (size_t i = 0; i < mHessian0Functions.size(); ++i)
+        AddTo(&product, mAssembler.BuildMatrixVectorProduct(
+                                mHessian0Functions[i].first, dofs,
+                                Apply<CellInterface::MatrixFunction>(mHessian0Functions[i].second, t, dt), x,
+                                mHessian0Colorings[i]));
+    for (const CellBatchInterface* batch : mBatches)
+        AddTo(&product, mAssembler.BuildMatrixVectorProduct(*batch, dofs, x, dt));
+    return product;
+}
+
+std::vector<int> TimeDependentProblem::Hessian0TangentIndices() const
+{
+    std::vector<int> indices(mHessian0Functions.size(), -1);
+    for (size_t i = 0; i < mHessian0TangentFunctions.size(); ++i)
+        indices[mHessian0TangentFunctions[i].hessian0Index] = i;
+    return indices;
+}
+
+TimeDependentProblem::Hessian0Tangents TimeDependentProblem::BuildHessian0Tangents(const DofVector<double>& dofValues,
+                                                                                  std::vector<DofType> dofs, double t,
+                                                                                  double dt)
+{
+    ScopedDofValueBinding binding(MergeNodeValues(dofValues, dofs), dofValues, dofs);
+    Hessian0Tangents tangents;
+    for (auto& entry : mHessian0TangentFunctions)
+    {
+        const TangentFunction& tangent = entry.tangent;
+        tangents.push_back(mAssembler.BuildIpTangents(
+                mHessian0Functions[entry.hessian0Index].first,
+                [&](const CellIpData& cellIpData) { return tangent(cellIpData, t, dt); }));
+    }
+    return tangents;
+}
+
+DofVector<double> TimeDependentProblem::Hessian0Product(const Hessian0Tangents& tangents,
+                                                        const DofVector<double>& dofValues,
+                                                        const DofVector<double>& x, std::vector<DofType> dofs,
+                                                        double t, double dt)
+{
+    ScopedDofValueBinding binding(MergeNodeValues(dofValues, dofs), dofValues, dofs);
+    UpdateColorings(dofs);
+    const std::vector<int> tangentIndices = Hessian0TangentIndices();
+    DofVector<double> product;
+    for (size_t i = 0; i < mHessian0Functions.size(); ++i)
+    {
+        const int iTangent = tangentIndices[i];
+        if (iTangent == -1)
+            product += mAssembler.BuildMatrixVectorProduct(
+                    mHessian0Functions[i].first, dofs,
+                    Apply<CellInterface::MatrixFunction>(mHessian0Functions[i].second, t, dt), x,
+                    mHessian0Colorings[i]);
+        else
+        {
+            const Hessian0TangentEntry& entry = mHessian0TangentFunctions[iTangent];
+            product += mAssembler.BuildMatrixVectorProduct(mHessian0Functions[i].first, dofs, entry.dof, entry.b,
+                                                           tangents.at(iTangent), x, mHessian0Colorings[i]);
+        }
+    }
+    for (const CellBatchInterface* batch : mBatches)
+        product += mAssembler.BuildMatrixVectorProduct(*batch, dofs, x, dt);
+    return product;
+}
+
+ContiguousDofVector<double> TimeDependentProblem::Hessian0Product(const Hessian0Tangents& tangents,
+                                                                  const DofVector<double>& dofValues,
+                                                                  const ContiguousDofVector<double>& x,
+                                                                  std::vector<DofType> dofs, double t, double dt)
+{
+    ScopedDofValueBinding binding(MergeNodeValues(dofValues, dofs), dofValues, dofs);
+    UpdateColorings(dofs);
+    const std::vector<int> tangentIndices = Hessian0TangentIndices();
+    ContiguousDofVector<double> product;
+    for (size_t i = 0; i < mHessian0Functions.size(); ++i)
+    {
+        const int iTangent = tangentIndices[i];
+        ContiguousDofVector<double> productI;
+        if (iTangent == -1)
+            productI = mAssembler.BuildMatrixVectorProduct(
+                    mHessian0Functions[i].first, dofs,
+                    Apply<CellInterface::MatrixFunction>(mHessian0Functions[i].second, t, dt), x,
+                    mHessian0Colorings[i]);
+        else
+        {
+            const Hessian0TangentEntry& entry = mHessian0TangentFunctions[iTangent];
+            productI = mAssembler.BuildMatrixVectorProduct(mHessian0Functions[i].first, dofs, entry.dof, entry.b,
+                                                           tangents.at(iTangent), x, mHessian0Colorings[i]);
+        }
+        AddTo(&product, std::move(productI));
+    }
+    for (const CellBatchInterface* batch : mBatches)
+        AddTo(&product, mAssembler.BuildMatrixVectorProduct(*batch, dofs, x, dt));
+    return product;
+}
+
+DofVector<double> TimeDependentProblem::Hessian0Diagonal(const Hessian0Tangents& tangents,
+                                                         const DofVector<double>& dofValues,
+                                                         std::vector<DofType> dofs, double t, double dt)
+{
+    ScopedDofValueBinding binding(MergeNodeValues(dofValues, dofs), dofValues, dofs);
+    UpdateColorings(dofs);
+    const std::vector<int> tangentIndices = Hessian0TangentIndices();
+    DofVector<double> diagonal;
+    for (size_t i = 0; i < mHessian0Functions.size(); ++i)
+    {
+        const int iTangent = tangentIndices[i];
+        if (iTangent == -1)
+            diagonal += mAssembler.BuildDiagonal(
+                    mHessian0Functions[i].first, dofs,
+                    Apply<CellInterface::MatrixFunction>(mHessian0Functions[i].second, t, dt),
+                    mHessian0Colorings[i]);
+        else
+        {
+            const Hessian0TangentEntry& entry = mHessian0TangentFunctions[iTangent];
+            diagonal += mAssembler.BuildDiagonal(mHessian0Functions[i].first, dofs, entry.dof, entry.b,
+                                                 tangents.at(iTangent), mHessian0Colorings[i]);
+        }
+    }
+    for (const CellBatchInterface* batch : mBatches)
+        diagonal += mAssembler.BuildDiagonal(*batch, dofs, dt);
+    return diagonal;
+}
+
+void TimeDependentProblem::UpdateColorings(const std::vector<DofType>& dofs)
+{
+    if (not mColoringDofs.empty() and SameDofTypes(mColoringDofs, dofs))
+        return;
+
+    mGradientColorings.clear();
+    for (size_t i = 0; i < mGradientFunctions.size(); ++i)
+        mGradientColorings.push_back(mGradientRanges[i].empty()
+                                             ? mAssembler.BuildColoring(mGradientFunctions[i].first, dofs)
+                                             : mAssembler.BuildColoring(mGradientRanges[i], dofs));
+
+    mHessian0Colorings.clear();
     for (auto& hessian0Function : mHessian0Functions)
-        hessian0 += mAssembler.BuildMatrix(hessian0Function.first, dofs,
-                                           Apply<CellInterface::MatrixFunction>(hessian0Function.second, t, dt));
-    return hessian0;
+        mHessian0Colorings.push_back(mAssembler.BuildColoring(hessian0Function.first, dofs));
+
+    mColoringDofs = dofs;
+}
+
+void TimeDependentProblem::ClearHessian0Pattern()
+{
+    mHessian0 = DofMatrixSparse<double>();
+    mHessian0Dofs.clear();
+    mHessian0ScatterMaps.clear();
+    mHessian0Blocked = BlockSparseMatrix();
+    mHessian0BlockedDof.clear();
+    mHessian0BlockedScatterMaps.clear();
 }
 
 void TimeDependentProblem::UpdateHistory(const DofVector<double>& dofValues, std::vector<DofType> dofs, double t,
@@ -82,4 +555,6 @@ void TimeDependentProblem::UpdateHistory(const DofVector<double>& dofValues, std
     for (auto& updateFunction : mUpdateFunctions)
         for (auto& cell : updateFunction.first)
             cell.Apply(Apply<CellInterface::VoidFunction>(updateFunction.second, t, dt));
+    for (const CellBatchInterface* batch : mBatches)
+        batch->UpdateHistory(dt);
 }
@@ -1,9 +1,11 @@
 #pragma once
 #include "nuto/mechanics/cell/CellInterface.h"
 #include "nuto/mechanics/cell/SimpleAssembler.h"
+#include "nuto/mechanics/cell/DofValueSource.h"
 #include "nuto/base/Group.h"
 #include "nuto/mechanics/dofs/DofVector.h"
 #include "nuto/mechanics/dofs/DofMatrixSparse.h"
+#include "nuto/mechanics/dofs/DofNumbering.h"
 
 #include "nuto/mechanics/tools/NodalValueMerger.h"
 
@@ -22,32 +24,230 @@ public:
     using GradientFunction = std::function<DofVector<double>(const CellIpData&, double t, double dt)>;
     using HessianFunction = std::function<DofMatrix<double>(const CellIpData&, double t, double dt)>;
     using UpdateFunction = std::function<void(const CellIpData&, double t, double dt)>;
+    using GradientAndHessian0Function =
+            std::function<std::pair<DofVector<double>, DofMatrix<double>>(const CellIpData&, double t, double dt)>;
+    using TangentFunction = std::function<Eigen::MatrixXd(const CellIpData&, double t, double dt)>;
 
     TimeDependentProblem(MeshFem* rMesh);
 
+    //! @brief builds the dof numbering of `dofTypes` and transfers `oldDofValues` to the new numbering
+    //! @param ordering node ordering, RCM and NESTED_DISSECTION are computed from the element connectivity of the
+    //! mesh, see DofNumbering::Build(...)
+    //! @return `oldDofValues` in the new numbering, the values stored at the nodes if `oldDofValues` is empty
     DofVector<double> RenumberDofs(Constraint::Constraints constraints, std::vector<DofType> dofTypes,
-                                 DofVector<double> oldDofValues);
+                                   DofVector<double> oldDofValues, eDofOrdering ordering = eDofOrdering::NATURAL);
+
+    //! @brief permutation of the last RenumberDofs(...), e.g. to map results to the natural numbering
+    //! @return dof numbers `p` with p[i] = new number of the i-th dof in the natural order of the dof nodes
+    const std::vector<int>& DofPermutation(DofType dof) const;
 
     void AddGradientFunction(Group<CellInterface> group, GradientFunction f);
-    void AddHessian0Function(Group<CellInterface> group, HessianFunction f);
+    //! @param symmetric true if all the local matrices of f are symmetric, e.g. Integrands::MomentumBalance with
+    //! IsHessian0Symmetric(). Hessian0 is stored as eMatrixStorage::UPPER if all its functions are symmetric.
+    void AddHessian0Function(Group<CellInterface> group, HessianFunction f, bool symmetric = false);
     void AddUpdateFunction(Group<CellInterface> group, UpdateFunction f);
 
+    //! @brief AddGradientFunction(...) for contiguous ranges of cells, e.g. CellStorage::Ranges()
+    //! @remark The cells of the ranges are assembled color by color, like the cells of a group.
+    void AddGradientFunction(std::vector<CellRange> ranges, GradientFunction f);
+
+    //! @brief AddHessian0Function(...) for contiguous ranges of cells, e.g. CellStorage::Ranges()
+    //! @remark The first assembly of Hessian0, that defines its nonzero pattern, runs over the ranges. The following
+    //! assemblies and the matrix-free methods visit the cells as a group.
+    void AddHessian0Function(std::vector<CellRange> ranges, HessianFunction f, bool symmetric = false);
+
+    //! @brief adds the Hessian0 function B^T D B of the single dof type `dof`, e.g. the momentum balance with
+    //! B = cellIpData.B(dof, Nabla::Strain()) and the tangent D of the constitutive law
+    //! @param b differential operator B of `dof`
+    //! @param tangent material tangent D
+    //! @param symmetric true if all tangents are symmetric, see AddHessian0Function(...)
+    //! @remark The contribution is part of all the Hessian0 methods. The matrix-free products with the tangents of
+    //! BuildHessian0Tangents(...) apply B^T (D (B x)) per integration point instead of local matrices.
+    void AddHessian0TangentFunction(Group<CellInterface> group, DofType dof, SimpleAssembler::OperatorFunction b,
+                                    TangentFunction tangent, bool symmetric = false);
+
+    //! @brief adds a function that calculates the Gradient and the Hessian0 contribution of an integration point at
+    //! once, e.g. Integrands::MomentumBalance::GradientAndHessian0
+    //! @remark The contributions are part of all the Gradient and Hessian0 methods. Only GradientAndHessian0(...)
+    //! evaluates f once for both, the others discard the unused part of f.
+    //! @param symmetric true if all the local hessians of f are symmetric, see AddHessian0Function(...)
+    void AddGradientAndHessian0Function(Group<CellInterface> group, GradientAndHessian0Function f,
+                                        bool symmetric = false);
+
+    //! @brief adds a batch of cells that contributes to Gradient(...), all Hessian0 methods and
+    //! GradientAndHessian0(...), e.g. a CellBatch or a SumFactorizedBatch of the momentum balance or a CellTBatch of
+    //! fixed size kernels. UpdateHistory(...) calls CellBatchInterface::UpdateHistory(...) of the batch.
+    //! @remark The batch is kept by reference and has to outlive this problem. It reads the node values, these are
+    //! thus merged into the nodes even if direct node values are enabled. Only Hessian0Blocked(...) does not support
+    //! batches and throws.
+    void AddBatch(const CellBatchInterface& batch);
+
+    //! @brief the cells read the node values directly from the dof values passed to Gradient(...), Hessian0(...) and
+    //! the other evaluation methods, instead of merging the dof values into the nodes before each evaluation
+    //! @remark Only UpdateHistory(...) and RenumberDofs(...) still merge the dof values into the nodes, e.g. for the
+    //! output. This applies to all cells of the gradient and hessian functions, also to the ones added later. They
+    //! have to be of type NuTo::Cell. Integrands must access the node values via CellIpData, not via the nodes.
+    void EnableDirectNodeValues();
+
+    //! @return true if there are functions added via AddGradientAndHessian0Function(...)
+    bool HasGradientAndHessian0Functions() const;
+
+    //! @return storage scheme of the matrices returned by Hessian0(...) and GradientAndHessian0(...)
+    eMatrixStorage Hessian0Storage() const;
+
     DofVector<double> Gradient(const DofVector<double>& dofValues, std::vector<DofType> dofs, double t, double dt);
-    DofMatrixSparse<double> Hessian0(const DofVector<double>& dofValues, std::vector<DofType> dofs, double t, double dt);
+
+    //! @return Hessian0 assembled into the values of the memoized matrix, without copying it
+    //! @remark The reference is valid until the next call to Hessian0(...) or GradientAndHessian0(...), a renumbering
+    //! or a new Hessian0 function. Copy the matrix to keep it.
+    const DofMatrixSparse<double>& Hessian0(const DofVector<double>& dofValues, std::vector<DofType> dofs, double t,
+                                            double dt);
+
+    //! @brief Gradient(...) and Hessian0(...) with a single merge of the dof values and a single pass over the cells
+    //! of each function added via AddGradientAndHessian0Function(...)
+    //! @remark The first call with new `dofs` (or after a renumbering) defines the nonzero pattern of Hessian0 and
+    //! evaluates Gradient(...) and Hessian0(...) separately.
+    //! @return gradient and a reference to the memoized Hessian0, see Hessian0(...)
+    std::pair<DofVector<double>, const DofMatrixSparse<double>&>
+    GradientAndHessian0(const DofVector<double>& dofValues, std::vector<DofType> dofs, double t, double dt);
+
+    //! @brief Hessian0 of the vector valued `dof` in the node blocked format, e.g. for fast products in iterative
+    //! solvers, see SimpleAssembler::BuildBlockMatrixPattern(...)
+    //! @remark The nonzero pattern is reused until the dof numbering changes.
+    BlockSparseMatrix Hessian0Blocked(const DofVector<double>& dofValues, DofType dof, double t, double dt);
 
     void UpdateHistory(const DofVector<double>& dofValues, std::vector<DofType> dofs, double t, double dt);
 
+    //! @brief Calculates Hessian0 * x without assembling Hessian0
+    //! @param dofValues dof values that define the state of the linearization
+    //! @param x vector with independent and dependent dof values of all `dofs`
+    DofVector<double> Hessian0Product(const DofVector<double>& dofValues, const DofVector<double>& x,
+                                      std::vector<DofType> dofs, double t, double dt);
+
+    //! @brief Calculates the diagonal of Hessian0 without assembling Hessian0
+    DofVector<double> Hessian0Diagonal(const DofVector<double>& dofValues, std::vector<DofType> dofs, double t,
+                                       double dt);
+
+    //! @brief Hessian0Product(...) for contiguous vectors, the product has one segment per dof type in the order of
+    //! `dofs`
+    ContiguousDofVector<double> Hessian0Product(const DofVector<double>& dofValues,
+                                                const ContiguousDofVector<double>& x, std::vector<DofType> dofs,
+                                                double t, double dt);
+
+    //! @brief tangents of all integration points, one SimpleAssembler::IpTangents per function added via
+    //! AddHessian0TangentFunction(...)
+    using Hessian0Tangents = std::vector<SimpleAssembler::IpTangents>;
+
+    //! @brief Calculates the tangents of all functions added via AddHessian0TangentFunction(...). These are valid as
+    //! long as the state `dofValues` and the dof numbering do not change and avoid the reevaluation of the
+    //! constitutive laws in each product.
+    Hessian0Tangents BuildHessian0Tangents(const DofVector<double>& dofValues, std::vector<DofType> dofs, double t,
+                                           double dt);
+
+    //! @brief Hessian0Product(...) with the tangents of BuildHessian0Tangents(...), the remaining Hessian0 functions
+    //! are integrated on the fly
+    DofVector<double> Hessian0Product(const Hessian0Tangents& tangents, const DofVector<double>& dofValues,
+                                      const DofVector<double>& x, std::vector<DofType> dofs, double t, double dt);
+
+    //! @brief Hessian0Product(...) for contiguous vectors with the tangents of BuildHessian0Tangents(...)
+    ContiguousDofVector<double> Hessian0Product(const Hessian0Tangents& tangents, const DofVector<double>& dofValues,
+                                                const ContiguousDofVector<double>& x, std::vector<DofType> dofs,
+                                                double t, double dt);
+
+    //! @brief Hessian0Diagonal(...) with the tangents of BuildHessian0Tangents(...)
+    DofVector<double> Hessian0Diagonal(const Hessian0Tangents& tangents, const DofVector<double>& dofValues,
+                                       std::vector<DofType> dofs, double t, double dt);
+
 private:
+    MeshFem& mMesh;
     SimpleAssembler mAssembler;
     NodalValueMerger mMerger;
 
+    //! @brief dof values bound during the evaluations, see EnableDirectNodeValues()
+    //! @remark shared with the cells, which may outlive this problem
+    std::shared_ptr<DofValueSource> mDofValueSource = std::make_shared<DofValueSource>();
+    bool mDirectNodeValues = false;
+
+    //! @brief sets the dof value source of all cells in `group` if direct node values are enabled
+    void ConnectDofValueSource(const Group<CellInterface>& group);
+
+    //! @brief merges `dofValues` into the nodes, unless direct node values are enabled and there are no batches
+    //! @return dof value source to bind `dofValues` to, nullptr if direct node values are disabled
+    DofValueSource* MergeNodeValues(const DofVector<double>& dofValues, const std::vector<DofType>& dofs);
+
+    //! @brief dof permutations of the last RenumberDofs(...), see DofPermutation(...)
+    DofContainer<std::vector<int>> mDofPermutations;
+
     using GradientPair = std::pair<Group<CellInterface>, GradientFunction>;
     using Hessian0Pair = std::pair<Group<CellInterface>, HessianFunction>;
     using UpdatePair = std::pair<Group<CellInterface>, UpdateFunction>;
 
     std::vector<GradientPair> mGradientFunctions;
     std::vector<Hessian0Pair> mHessian0Functions;
+    //! @brief cell ranges of each gradient function, empty for the functions added with a group
+    std::vector<std::vector<CellRange>> mGradientRanges;
+    //! @brief cell ranges of each Hessian0 function, empty for the functions added with a group
+    std::vector<std::vector<CellRange>> mHessian0Ranges;
+    //! @brief symmetry of each Hessian0 function, see AddHessian0Function(...)
+    std::vector<bool> mHessian0Symmetric;
     std::vector<UpdatePair> mUpdateFunctions;
+    //! @brief batches added via AddBatch(...)
+    std::vector<const CellBatchInterface*> mBatches;
+
+    //! @brief throws if there are batches, for the methods that do not support them
+    void ThrowOnBatches(std::string function) const;
+
+    //! @brief function added via AddGradientAndHessian0Function(...) and the positions of its separate parts in
+    //! mGradientFunctions and mHessian0Functions
+    struct GradientAndHessian0Entry
+    {
+        GradientAndHessian0Function f;
+        size_t gradientIndex;
+        size_t hessian0Index;
+    };
+    std::vector<GradientAndHessian0Entry> mGradientAndHessian0Functions;
+
+    //! @brief function added via AddHessian0TangentFunction(...) and the position of its local matrices in
+    //! mHessian0Functions
+    struct Hessian0TangentEntry
+    {
+        DofType dof;
+        SimpleAssembler::OperatorFunction b;
+        TangentFunction tangent;
+        size_t hessian0Index;
+    };
+    std::vector<Hessian0TangentEntry> mHessian0TangentFunctions;
+
+    //! @return index in mHessian0TangentFunctions for each Hessian0 function, -1 for the others
+    std::vector<int> Hessian0TangentIndices() const;
+
+    //! @brief Hessian0 of the last call, its nonzero pattern is reused until the dof numbering changes
+    DofMatrixSparse<double> mHessian0;
+    //! @brief dof types of mHessian0, empty if there is no valid pattern
+    std::vector<DofType> mHessian0Dofs;
+    //! @brief scatter maps of the cells of each Hessian0 function into the values of mHessian0
+    std::vector<SimpleAssembler::ScatterMap> mHessian0ScatterMaps;
+
+    //! @brief node blocked Hessian0 of the last call to Hessian0Blocked(...), its pattern is reused
+    BlockSparseMatrix mHessian0Blocked;
+    //! @brief dof type of mHessian0Blocked, empty if there is no valid pattern
+    std::vector<DofType> mHessian0BlockedDof;
+    //! @brief scatter maps of the cells of each Hessian0 function into the values of mHessian0Blocked
+    std::vector<SimpleAssembler::BlockScatterMap> mHessian0BlockedScatterMaps;
+
+    //! @brief drops the memoized nonzero pattern of Hessian0, e.g. after a renumbering
+    void ClearHessian0Pattern();
+
+    //! @brief dof types of the cell colorings, empty if there are no valid colorings
+    std::vector<DofType> mColoringDofs;
+    //! @brief cell colorings of each gradient function for the lock-free assembly, of the cells of the ranges for the
+    //! functions added with ranges
+    std::vector<SimpleAssembler::Coloring> mGradientColorings;
+    //! @brief cell colorings of each Hessian0 function for the lock-free assembly
+    std::vector<SimpleAssembler::Coloring> mHessian0Colorings;
+
+    //! @brief (re)builds the cell colorings of all functions if they are not valid for `dofs`
+    void UpdateColorings(const std::vector<DofType>& dofs);
 
 
     /*
@@ -0,0 +1,115 @@
+#include "BoostUnitTest.h"
+#include "Poisson.h"
+#include <cstdlib>
+#include "nuto/math/AmgPreconditioner.h"
+#include "nuto/math/ConjugateGradient.h"
+
+using namespace NuTo;
+
+using Test::Poisson;
+
+BOOST_AUTO_TEST_CASE(AmgHierarchy)
+{
+    AmgPreconditioner amg(Poisson(60));
+    BOOST_CHECK_GT(amg.NumLevels(), 1);
+    BOOST_CHECK_EQUAL(amg.Size(0), 3600);
+    BOOST_CHECK_LE(amg.Size(amg.NumLevels() - 1), 500);
+    for (int level = 1; level < amg.NumLevels(); ++level)
+        BOOST_CHECK_LT(amg.Size(level), amg.Size(level - 1) / 3);
+}
+
+BOOST_AUTO_TEST_CASE(AmgSmallMatrixIsExact)
+{
+    // below the coarse size, the V-cycle is the direct solve
+    Eigen::SparseMatrix<double> A = Poisson(10);
+    AmgPreconditioner amg(A);
+    BOOST_CHECK_EQUAL(amg.NumLevels(), 1);
+    Eigen::VectorXd b = Eigen::VectorXd::Ones(A.rows());
+    BoostUnitTest::CheckEigenMatrix(A * amg.solve(b), b);
+}
+
+BOOST_AUTO_TEST_CASE(AmgReproducible)
+{
+    // the smoother damping does not depend on the state of std::rand
+    Eigen::SparseMatrix<double> A = Poisson(60);
+    Eigen::VectorXd b = Eigen::VectorXd::Ones(A.rows());
+    std::srand(1);
+    const Eigen::VectorXd x1 = AmgPreconditioner(A).solve(b);
+    std::srand(2);
+    const Eigen::VectorXd x2 = AmgPreconditioner(A).solve(b);
+    BOOST_CHECK(x1 == x2);
+}
+
+BOOST_AUTO_TEST_CASE(AmgConjugateGradientIterations)
+{
+    Eigen::SparseMatrix<double> A = Poisson(60);
+    Eigen::VectorXd b = Eigen::VectorXd::Ones(A.rows());
+
+    Eigen::ConjugateGradient<Eigen::SparseMatrix<double>> diagonal;
+    diagonal.setTolerance(1.e-10);
+    diagonal.compute(A);
+    Eigen::VectorXd xDiagonal = diagonal.solve(b);
+
+    AmgConjugateGradient amg;
+    amg.setTolerance(1.e-10);
+    amg.compute(A);
+    Eigen::VectorXd xAmg = amg.solve(b);
+
+    BOOST_CHECK_EQUAL(amg.info(), Eigen::Success);
+    BoostUnitTest::CheckEigenMatrix(xAmg, xDiagonal, 1.e-6);
+    BOOST_CHECK_LT(amg.iterations(), diagonal.iterations() / 4);
+    BOOST_TEST_MESSAGE("CG iterations, diagonal: " << diagonal.iterations() << ", AMG: " << amg.iterations());
+}
+
+BOOST_AUTO_TEST_CASE(AmgReuseProlongators)
+{
+    Eigen::SparseMatrix<double> A = Poisson(60);
+    Eigen::VectorXd b = Eigen::VectorXd::Ones(A.rows());
+
+    AmgConjugateGradient cg;
+    cg.setTolerance(1.e-10);
+    cg.analyzePattern(A);
+    cg.factorize(A);
+    Eigen::VectorXd x = cg.solve(b);
+    const int numIterations = cg.iterations();
+
+    // same pattern, different values: only the coarse matrices are recomputed
+    Eigen::SparseMatrix<double> A2 = A;
+    for (int i = 0; i < A2.rows(); ++i)
+        A2.coeffRef(i, i) += 0.1;
+    cg.factorize(A2);
+    x = cg.solve(b);
+    BoostUnitTest::CheckEigenMatrix(A2 * x, b, 1.e-7);
+    BOOST_CHECK_LE(cg.iterations(), numIterations);
+}
+
+BOOST_AUTO_TEST_CASE(AmgNearNullspace)
+{
+    // two components per grid point with the constant translations as near nullspace, like elasticity
+    const int numComponents = 2;
+    Eigen::SparseMatrix<double> A = Poisson(40, numComponents);
+    Eigen::MatrixXd translations = Eigen::MatrixXd::Zero(A.rows(), numComponents);
+    for (int i = 0; i < A.rows(); ++i)
+        translations(i, i % numComponents) = 1.;
+
+    AmgConjugateGradient cg;
+    cg.setTolerance(1.e-10);
+    cg.preconditioner().SetNearNullspace(translations);
+    cg.compute(A);
+
+    Eigen::VectorXd b = Eigen::VectorXd::Random(A.rows());
+    Eigen::VectorXd x = cg.solve(b);
+    BoostUnitTest::CheckEigenMatrix(A * x, b, 1.e-7);
+    BOOST_CHECK_LT(cg.iterations(), 30);
+}
+
+BOOST_AUTO_TEST_CASE(AmgNuToConjugateGradient)
+{
+    Eigen::SparseMatrix<double> A = Poisson(60);
+    Eigen::VectorXd b = Eigen::VectorXd::Ones(A.rows());
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(A.rows());
+    const int numIterations =
+            NuTo::ConjugateGradient<Eigen::SparseMatrix<double>, AmgPreconditioner>(A, b, x, 1000, 1.e-10);
+    BOOST_CHECK_LT(numIterations, 30);
+    BoostUnitTest::CheckEigenMatrix(A * x, b, 1.e-7);
+}
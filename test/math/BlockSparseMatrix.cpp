@@ -0,0 +1,78 @@
+#include "BoostUnitTest.h"
+#include <boost/test/data/test_case.hpp>
+#include "nuto/base/Exception.h"
+#include "nuto/math/BlockSparseMatrix.h"
+
+namespace bdata = boost::unit_test::data;
+
+using namespace NuTo;
+
+//! @brief random matrix with `numBlocks` x `numBlocks` blocks of size `blockSize`, tridiagonal on the block level
+Eigen::SparseMatrix<double> BlockTridiagonal(int numBlocks, int blockSize)
+{
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int iBlock = 0; iBlock < numBlocks; ++iBlock)
+        for (int jBlock = std::max(iBlock - 1, 0); jBlock < std::min(iBlock + 2, numBlocks); ++jBlock)
+            for (int i = 0; i < blockSize; ++i)
+                for (int j = 0; j < blockSize; ++j)
+                    triplets.emplace_back(iBlock * blockSize + i, jBlock * blockSize + j,
+                                          Eigen::internal::random<double>(-1, 1));
+    Eigen::SparseMatrix<double> m(numBlocks * blockSize, numBlocks * blockSize);
+    m.setFromTriplets(triplets.begin(), triplets.end());
+    return m;
+}
+
+BOOST_DATA_TEST_CASE(ConvertAndMultiply, bdata::make({1, 2, 3, 4}), blockSize)
+{
+    const int numBlocks = 7;
+    const Eigen::SparseMatrix<double> m = BlockTridiagonal(numBlocks, blockSize);
+    BlockSparseMatrix b(m, blockSize);
+
+    BOOST_CHECK_EQUAL(b.BlockSize(), blockSize);
+    BOOST_CHECK_EQUAL(b.rows(), m.rows());
+    BOOST_CHECK_EQUAL(b.cols(), m.cols());
+    BOOST_CHECK_EQUAL(b.NonZeroBlocks(), 3 * numBlocks - 2);
+
+    BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(b.ToEigen()), Eigen::MatrixXd(m));
+
+    const Eigen::VectorXd x = Eigen::VectorXd::Random(m.cols());
+    BoostUnitTest::CheckEigenMatrix(b * x, m * x);
+    BoostUnitTest::CheckEigenMatrix(b.diagonal(), Eigen::VectorXd(m.diagonal()));
+
+    b.SetZero();
+    BOOST_CHECK_EQUAL(b.NonZeroBlocks(), 3 * numBlocks - 2);
+    BOOST_CHECK_SMALL((b * x).norm(), 1.e-14);
+}
+
+BOOST_AUTO_TEST_CASE(Pattern)
+{
+    // blocks (0, 0), (0, 2) and (1, 1), the duplicate is removed
+    BlockSparseMatrix b(2, 2, 3, {{2, 0, 2}, {1}});
+    BOOST_CHECK_EQUAL(b.rows(), 4);
+    BOOST_CHECK_EQUAL(b.cols(), 6);
+    BOOST_CHECK_EQUAL(b.NonZeroBlocks(), 3);
+    BOOST_CHECK_EQUAL(b.BlockOffset(0, 0), 0);
+    BOOST_CHECK_EQUAL(b.BlockOffset(0, 2), 1);
+    BOOST_CHECK_EQUAL(b.BlockOffset(1, 1), 2);
+    BOOST_CHECK_THROW(b.BlockOffset(1, 0), Exception);
+
+    // column major blocks
+    double* block = b.BlockData(b.BlockOffset(0, 2));
+    block[0] = 1;
+    block[1] = 2;
+    block[2] = 3;
+    block[3] = 4;
+    Eigen::MatrixXd expected = Eigen::MatrixXd::Zero(4, 6);
+    expected.block<2, 2>(0, 4) << 1, 3, 2, 4;
+    BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(b.ToEigen()), expected);
+
+    BOOST_CHECK_THROW(BlockSparseMatrix(2, 2, 3, {{3}, {}}), Exception);
+    BOOST_CHECK_THROW(BlockSparseMatrix(2, 2, 3, {{0}}), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(WrongDimensions)
+{
+    const Eigen::SparseMatrix<double> m = BlockTridiagonal(3, 2);
+    BOOST_CHECK_THROW(BlockSparseMatrix(m, 4), Exception);
+    BOOST_CHECK_THROW(BlockSparseMatrix(2, 1, 1, {{0}}) * Eigen::VectorXd::Ones(3), Exception);
+}
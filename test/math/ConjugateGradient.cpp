@@ -0,0 +1,48 @@
+#include "BoostUnitTest.h"
+#include "nuto/math/ConjugateGradient.h"
+#include "nuto/math/JacobiPreconditioner.h"
+
+using MatrixType = Eigen::MatrixXd;
+using VectorType = Eigen::VectorXd;
+using SparseMatrixType = Eigen::SparseMatrix<double>;
+
+BOOST_AUTO_TEST_CASE(SolveSystemSpd)
+{
+    const int dim = 4;
+
+    MatrixType A(dim, dim);
+    A << 1, -1, 0, 0, -1, 2, -1, 0, 0, -1, 2, -1, 0, 0, -1, 2;
+
+    VectorType x = VectorType::Zero(dim);
+    VectorType b = VectorType::Ones(dim);
+
+    int numIterations = NuTo::ConjugateGradient<MatrixType, NuTo::JacobiPreconditioner>(A, b, x, 100, 1.e-12);
+
+    // in exact arithmetic, CG converges in at most dim iterations
+    BOOST_CHECK_LE(numIterations, dim + 1);
+    BoostUnitTest::CheckEigenMatrix(A * x, b);
+}
+
+BOOST_AUTO_TEST_CASE(SolveSparseSystem)
+{
+    const int dim = 100;
+
+    SparseMatrixType A(dim, dim);
+    for (int i = 0; i < dim; ++i)
+    {
+        A.insert(i, i) = 2 + i;
+        if (i > 0)
+            A.insert(i, i - 1) = -1;
+        if (i < dim - 1)
+            A.insert(i, i + 1) = -1;
+    }
+
+    VectorType x = VectorType::Zero(dim);
+    VectorType b = VectorType::Ones(dim);
+
+    NuTo::ConjugateGradient<SparseMatrixType>(A, b, x, 1000, 1.e-12);
+    BoostUnitTest::CheckEigenMatrix(A * x, b);
+
+    // exact initial guess
+    BOOST_CHECK_EQUAL(NuTo::ConjugateGradient<SparseMatrixType>(A, b, x, 1000, 1.e-8), 0);
+}
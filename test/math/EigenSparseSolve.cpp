@@ -34,7 +34,7 @@ struct LinearSystem
 
 auto builtInSolverNames = {"EigenSparseLU",       "EigenSparseQR",          "EigenSimplicialLLT",
                            "EigenSimplicialLDLT", "EigenConjugateGradient", "EigenLeastSquaresConjugateGradient",
-                           "EigenBiCGSTAB"};
+                           "EigenBiCGSTAB",       "AmgCG",                  "GmgCG"};
 
 BOOST_DATA_TEST_CASE(builtInSolvers, bdata::make(builtInSolverNames), solver)
 {
@@ -74,3 +74,100 @@ BOOST_AUTO_TEST_CASE(WrongSolverName)
     LinearSystem sys;
     BOOST_CHECK_THROW(EigenSparseSolve(sys.A, sys.b, "Möööp"), NuTo::Exception);
 }
+
+BOOST_DATA_TEST_CASE(ReuseAnalysis, bdata::make(builtInSolverNames), solverName)
+{
+    LinearSystem sys;
+    EigenSparseSolver solver(solverName);
+    BoostUnitTest::CheckVector(solver.Solve(sys.A, sys.b), sys.expected_x, 3);
+
+    // same pattern, different values: only the numerical factorization is repeated
+    Eigen::SparseMatrix<double> A2 = 2. * sys.A;
+    BoostUnitTest::CheckVector(solver.Solve(A2, sys.b), 0.5 * sys.expected_x, 3);
+    BOOST_CHECK_EQUAL(solver.NumAnalyses(), 1);
+    BOOST_CHECK_EQUAL(solver.NumFactorizations(), 2);
+
+    solver.Refactorize(sys.A);
+    BoostUnitTest::CheckVector(solver.SolveFactorized(sys.b), sys.expected_x, 3);
+    BOOST_CHECK_EQUAL(solver.NumAnalyses(), 1);
+
+    // different pattern
+    Eigen::SparseMatrix<double> A3 = sys.A;
+    A3.coeffRef(0, 2) = 0.;
+    A3.coeffRef(2, 0) = 0.;
+    A3.makeCompressed();
+    BoostUnitTest::CheckVector(solver.Solve(A3, sys.b), sys.expected_x, 3);
+    BOOST_CHECK_EQUAL(solver.NumAnalyses(), 2);
+
+    // the factorization of an uncompressed matrix factorizes a compressed temporary, the iterative solvers have to
+    // keep it alive until SolveFactorized(...)
+    Eigen::SparseMatrix<double> uncompressed = sys.A;
+    uncompressed.uncompress();
+    solver.Factorize(uncompressed);
+    BoostUnitTest::CheckVector(solver.SolveFactorized(sys.b), sys.expected_x, 3);
+}
+
+BOOST_AUTO_TEST_CASE(SparsePatternMatches)
+{
+    LinearSystem sys;
+    SparsePattern pattern(sys.A);
+    BOOST_CHECK(pattern.Matches(sys.A));
+    BOOST_CHECK(pattern.Matches(Eigen::SparseMatrix<double>(2. * sys.A)));
+    BOOST_CHECK(not SparsePattern().Matches(sys.A));
+
+    // same dimensions and number of nonzeros, one entry moved
+    Eigen::SparseMatrix<double> moved(3, 3);
+    moved.insert(0, 0) = 1.0;
+    moved.insert(0, 2) = -1.0;
+    moved.insert(1, 0) = -1.0;
+    moved.insert(1, 1) = 2.0;
+    moved.insert(1, 2) = -1.0;
+    moved.insert(2, 1) = -1.0;
+    moved.insert(2, 2) = 2.0;
+    moved.makeCompressed();
+    BOOST_CHECK_EQUAL(moved.nonZeros(), sys.A.nonZeros());
+    BOOST_CHECK(not pattern.Matches(moved));
+
+    Eigen::SparseMatrix<double> larger = sys.A;
+    larger.conservativeResize(4, 4);
+    larger.makeCompressed();
+    BOOST_CHECK(not pattern.Matches(larger));
+}
+
+BOOST_AUTO_TEST_CASE(ReuseFactorization)
+{
+    LinearSystem sys;
+    EigenSparseSolver solver("EigenSparseLU");
+    solver.ReuseFactorization(true);
+    solver.Solve(sys.A, sys.b);
+
+    // A2 is ignored, the factorization of A is reused
+    Eigen::SparseMatrix<double> A2 = 2. * sys.A;
+    BoostUnitTest::CheckVector(solver.Solve(A2, sys.b), sys.expected_x, 3);
+    BOOST_CHECK_EQUAL(solver.NumFactorizations(), 1);
+
+    solver.ReuseFactorization(false);
+    BoostUnitTest::CheckVector(solver.Solve(A2, sys.b), 0.5 * sys.expected_x, 3);
+    BOOST_CHECK_EQUAL(solver.NumFactorizations(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(NoFactorization)
+{
+    LinearSystem sys;
+    EigenSparseSolver solver("EigenSparseLU");
+    BOOST_CHECK(not solver.HasFactorization());
+    BOOST_CHECK_THROW(solver.SolveFactorized(sys.b), Exception);
+    BOOST_CHECK_THROW(solver.Refactorize(sys.A), Exception);
+
+    solver.Factorize(sys.A);
+    BOOST_CHECK(solver.HasFactorization());
+
+    // copies share the settings, not the factorization
+    EigenSparseSolver copy(solver);
+    BOOST_CHECK(not copy.HasFactorization());
+    BOOST_CHECK_EQUAL(copy.SolverName(), "EigenSparseLU");
+
+    solver.Reset();
+    BOOST_CHECK(not solver.HasFactorization());
+    BOOST_CHECK_THROW(solver.SolveFactorized(sys.b), Exception);
+}
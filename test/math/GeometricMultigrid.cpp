@@ -0,0 +1,181 @@
+#include "BoostUnitTest.h"
+#include "Poisson.h"
+#include <cstdlib>
+#include "nuto/base/Exception.h"
+#include "nuto/math/ConjugateGradient.h"
+#include "nuto/math/GeometricMultigrid.h"
+#include "nuto/math/JacobiPreconditioner.h"
+#include "nuto/math/Smoothers.h"
+
+using namespace NuTo;
+
+using Test::Poisson;
+
+//! @brief bilinear interpolation from (n - 1) / 2 x (n - 1) / 2 to n x n inner grid points
+Eigen::SparseMatrix<double> Prolongator(int n)
+{
+    const int numCoarse = (n - 1) / 2;
+    std::vector<Eigen::Triplet<double>> triplets1D;
+    for (int i = 0; i < numCoarse; ++i)
+    {
+        triplets1D.emplace_back(2 * i, i, 0.5);
+        triplets1D.emplace_back(2 * i + 1, i, 1.);
+        triplets1D.emplace_back(2 * i + 2, i, 0.5);
+    }
+
+    // tensor product of the 1D interpolations
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (const auto& a : triplets1D)
+        for (const auto& b : triplets1D)
+            triplets.emplace_back(a.row() * n + b.row(), a.col() * numCoarse + b.col(), a.value() * b.value());
+    Eigen::SparseMatrix<double> P(n * n, numCoarse * numCoarse);
+    P.setFromTriplets(triplets.begin(), triplets.end());
+    return P;
+}
+
+//! @brief prolongators down to a single coarse grid point
+std::vector<Eigen::SparseMatrix<double>> Prolongators(int n)
+{
+    std::vector<Eigen::SparseMatrix<double>> prolongators;
+    for (; n > 1; n = (n - 1) / 2)
+        prolongators.push_back(Prolongator(n));
+    return prolongators;
+}
+
+BOOST_AUTO_TEST_CASE(GmgLevels)
+{
+    Eigen::SparseMatrix<double> A = Poisson(31);
+    GeometricMultigrid gmg;
+    gmg.SetProlongators(Prolongators(31));
+    gmg.compute(A);
+    BOOST_CHECK_EQUAL(gmg.NumLevels(), 5);
+    BOOST_CHECK_EQUAL(gmg.Size(0), 31 * 31);
+    BOOST_CHECK_EQUAL(gmg.Size(1), 15 * 15);
+    BOOST_CHECK_EQUAL(gmg.Size(4), 1);
+}
+
+BOOST_AUTO_TEST_CASE(GmgWithoutProlongatorsIsExact)
+{
+    Eigen::SparseMatrix<double> A = Poisson(7);
+    GeometricMultigrid gmg(A);
+    BOOST_CHECK_EQUAL(gmg.NumLevels(), 1);
+    Eigen::VectorXd b = Eigen::VectorXd::Ones(A.rows());
+    BoostUnitTest::CheckEigenMatrix(A * gmg.solve(b), b);
+}
+
+BOOST_AUTO_TEST_CASE(GmgIterationsIndependentOfMeshSize)
+{
+    for (eSmoother smoother : {eSmoother::CHEBYSHEV, eSmoother::JACOBI})
+    {
+        GeometricMultigrid::Options options;
+        options.smoother = smoother;
+        std::vector<int> numIterations;
+        for (int n : {31, 127})
+        {
+            Eigen::SparseMatrix<double> A = Poisson(n);
+            Eigen::VectorXd b = Eigen::VectorXd::Ones(A.rows());
+
+            GmgConjugateGradient cg;
+            cg.setTolerance(1.e-10);
+            cg.preconditioner().SetOptions(options);
+            cg.preconditioner().SetProlongators(Prolongators(n));
+            cg.compute(A);
+            Eigen::VectorXd x = cg.solve(b);
+            BOOST_CHECK_EQUAL(cg.info(), Eigen::Success);
+            BOOST_CHECK_SMALL((A * x - b).norm(), 1.e-8);
+            numIterations.push_back(cg.iterations());
+        }
+        BOOST_TEST_MESSAGE("CG iterations with GMG, n = 31: " << numIterations[0] << ", n = 127: "
+                                                               << numIterations[1]);
+        BOOST_CHECK_LT(numIterations[1], 15);
+        BOOST_CHECK_LE(numIterations[1], numIterations[0] + 2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GmgStationaryIteration)
+{
+    // V-cycles x += M (b - A x) as a solver
+    Eigen::SparseMatrix<double> A = Poisson(63);
+    GeometricMultigrid gmg;
+    gmg.SetProlongators(Prolongators(63));
+    gmg.compute(A);
+
+    Eigen::VectorXd b = Eigen::VectorXd::Ones(A.rows());
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(A.rows());
+    double residual = b.norm();
+    for (int i = 0; i < 5; ++i)
+    {
+        x += gmg.solve(b - A * x);
+        const double newResidual = (b - A * x).norm();
+        BOOST_CHECK_LT(newResidual, 0.15 * residual);
+        residual = newResidual;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GmgDropsEmptyCoarseDofs)
+{
+    Eigen::SparseMatrix<double> A = Poisson(15);
+    std::vector<Eigen::SparseMatrix<double>> prolongators = Prolongators(15);
+
+    // an additional coarse dof without fine dofs
+    Eigen::SparseMatrix<double> P0 = prolongators[0];
+    P0.conservativeResize(P0.rows(), P0.cols() + 1);
+    Eigen::SparseMatrix<double> P1 = prolongators[1];
+    P1.conservativeResize(P1.rows() + 1, P1.cols());
+    prolongators[0] = P0;
+    prolongators[1] = P1;
+
+    GeometricMultigrid gmg;
+    gmg.SetProlongators(prolongators);
+    gmg.compute(A);
+    BOOST_CHECK_EQUAL(gmg.Size(1), 7 * 7);
+    BOOST_CHECK_EQUAL(gmg.info(), Eigen::Success);
+
+    gmg.SetProlongators({Prolongator(31)});
+    BOOST_CHECK_THROW(gmg.compute(A), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(ChebyshevPreconditionerIterations)
+{
+    Eigen::SparseMatrix<double> A = Poisson(63);
+    Eigen::VectorXd b = Eigen::VectorXd::Ones(A.rows());
+
+    Eigen::VectorXd xJacobi = Eigen::VectorXd::Zero(A.rows());
+    const int numJacobi = NuTo::ConjugateGradient<Eigen::SparseMatrix<double>, JacobiPreconditioner>(
+            A, b, xJacobi, 1000, 1.e-10);
+
+    Eigen::VectorXd xChebyshev = Eigen::VectorXd::Zero(A.rows());
+    const int numChebyshev =
+            NuTo::ConjugateGradient<Eigen::SparseMatrix<double>, ChebyshevPreconditioner<Eigen::SparseMatrix<double>>>(
+                    A, b, xChebyshev, 1000, 1.e-10);
+
+    BoostUnitTest::CheckEigenMatrix(xChebyshev, xJacobi, 1.e-6);
+    BOOST_CHECK_LT(numChebyshev, numJacobi / 2);
+}
+
+BOOST_AUTO_TEST_CASE(SmoothersReduceOscillations)
+{
+    Eigen::SparseMatrix<double> A = Poisson(31);
+    const Eigen::VectorXd inverseDiagonal = InverseDiagonal(A);
+    const double lambdaMax = EstimateMaxEigenvalue(A, inverseDiagonal);
+    BOOST_CHECK_GT(lambdaMax, 1.8);
+    BOOST_CHECK_LE(lambdaMax, 2.);
+
+    // reproducible, independent of the state of std::rand
+    std::srand(7);
+    BOOST_CHECK_EQUAL(EstimateMaxEigenvalue(A, inverseDiagonal), lambdaMax);
+
+    // highly oscillating error, exact solution zero
+    Eigen::VectorXd error(A.rows());
+    for (int i = 0; i < A.rows(); ++i)
+        error[i] = (i % 2 == 0) ? 1. : -1.;
+    const Eigen::VectorXd b = Eigen::VectorXd::Zero(A.rows());
+
+    Eigen::VectorXd xChebyshev = error;
+    ChebyshevSmooth(A, inverseDiagonal, lambdaMax, 4., 2, b, &xChebyshev);
+    BOOST_CHECK_LT(xChebyshev.norm(), 0.3 * error.norm());
+
+    Eigen::VectorXd xJacobi = error;
+    JacobiSmooth(A, 4. / 3. / lambdaMax * inverseDiagonal, 2, b, &xJacobi);
+    BOOST_CHECK_LT(xJacobi.norm(), 0.3 * error.norm());
+}
@@ -0,0 +1,104 @@
+#include "BoostUnitTest.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <Eigen/SparseCholesky>
+#include "nuto/base/Exception.h"
+#include "nuto/math/GraphOrdering.h"
+
+using namespace NuTo;
+
+//! @brief 5-point stencil graph of a n x n grid with randomly numbered vertices
+AdjacencyList ShuffledGrid(int n)
+{
+    std::vector<int> id(n * n);
+    std::iota(id.begin(), id.end(), 0);
+    std::shuffle(id.begin(), id.end(), std::mt19937(6174));
+
+    AdjacencyList adjacency(n * n);
+    for (int y = 0; y < n; ++y)
+        for (int x = 0; x < n; ++x)
+        {
+            if (x + 1 < n)
+            {
+                adjacency[id[x + n * y]].push_back(id[x + 1 + n * y]);
+                adjacency[id[x + 1 + n * y]].push_back(id[x + n * y]);
+            }
+            if (y + 1 < n)
+            {
+                adjacency[id[x + n * y]].push_back(id[x + n * (y + 1)]);
+                adjacency[id[x + n * (y + 1)]].push_back(id[x + n * y]);
+            }
+        }
+    return adjacency;
+}
+
+void CheckPermutation(std::vector<int> order, int size)
+{
+    BOOST_REQUIRE_EQUAL(order.size(), size);
+    std::sort(order.begin(), order.end());
+    for (int i = 0; i < size; ++i)
+        BOOST_CHECK_EQUAL(order[i], i);
+}
+
+//! @return number of nonzeros in the Cholesky factor of the graph laplacian with the numbering `order`
+int CholeskyNonZeros(const AdjacencyList& adjacency, const std::vector<int>& order)
+{
+    std::vector<int> position(order.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        position[order[i]] = i;
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (size_t vertex = 0; vertex < adjacency.size(); ++vertex)
+    {
+        triplets.emplace_back(position[vertex], position[vertex], 5.);
+        for (int neighbor : adjacency[vertex])
+            triplets.emplace_back(position[vertex], position[neighbor], -1.);
+    }
+    Eigen::SparseMatrix<double> A(adjacency.size(), adjacency.size());
+    A.setFromTriplets(triplets.begin(), triplets.end());
+
+    Eigen::SimplicialLLT<Eigen::SparseMatrix<double>, Eigen::Lower, Eigen::NaturalOrdering<int>> llt(A);
+    BOOST_REQUIRE(llt.info() == Eigen::Success);
+    return llt.matrixL().nestedExpression().nonZeros();
+}
+
+BOOST_AUTO_TEST_CASE(Path)
+{
+    // 0 - 3 - 1 - 4 - 2
+    AdjacencyList adjacency = {{3}, {3, 4}, {4}, {0, 1}, {1, 2}};
+    BOOST_CHECK_EQUAL(Bandwidth(adjacency, {0, 1, 2, 3, 4}), 3);
+    BOOST_CHECK_EQUAL(Bandwidth(adjacency, ReverseCuthillMcKee(adjacency)), 1);
+}
+
+BOOST_AUTO_TEST_CASE(Disconnected)
+{
+    AdjacencyList adjacency = {{2}, {}, {0}, {4}, {3, 5}, {4}, {}};
+    CheckPermutation(ReverseCuthillMcKee(adjacency), 7);
+    CheckPermutation(NestedDissection(adjacency, 1), 7);
+    BOOST_CHECK(ReverseCuthillMcKee({}).empty());
+    BOOST_CHECK_THROW(ReverseCuthillMcKee({{1}}), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(Grid)
+{
+    const int n = 64;
+    const AdjacencyList adjacency = ShuffledGrid(n);
+    std::vector<int> shuffled(n * n);
+    std::iota(shuffled.begin(), shuffled.end(), 0);
+
+    const std::vector<int> rcm = ReverseCuthillMcKee(adjacency);
+    const std::vector<int> nd = NestedDissection(adjacency);
+    CheckPermutation(rcm, n * n);
+    CheckPermutation(nd, n * n);
+
+    BOOST_CHECK_GT(Bandwidth(adjacency, shuffled), n * n / 2);
+    BOOST_CHECK_LE(Bandwidth(adjacency, rcm), 2 * n);
+
+    const int fillShuffled = CholeskyNonZeros(adjacency, shuffled);
+    const int fillRcm = CholeskyNonZeros(adjacency, rcm);
+    const int fillNd = CholeskyNonZeros(adjacency, nd);
+    BOOST_TEST_MESSAGE("Cholesky nonzeros shuffled/RCM/ND: " << fillShuffled << "/" << fillRcm << "/" << fillNd);
+    BOOST_CHECK_LT(fillRcm, fillShuffled / 4);
+    BOOST_CHECK_LT(fillNd, fillRcm);
+}
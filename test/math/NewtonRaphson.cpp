@@ -4,6 +4,7 @@
 #include <cmath>
 #include <iostream>
 #include <complex>
+#include <tuple>
 #include <Eigen/Sparse>
 #include <Eigen/SparseLU>
 
@@ -116,3 +117,163 @@ BOOST_AUTO_TEST_CASE(NewtonSparseLineSearch)
     auto result = Solve(ValidMatrixProblem(), x0, NuTo::EigenSparseSolver("EigenSparseLU"), 20, LineSearch());
     BoostUnitTest::CheckVector(result, std::vector<double>{-2., 1.}, 2);
 }
+
+/* ##################################################
+ * ##        FUSED RESIDUAL AND DERIVATIVE         ##
+ * ################################################## */
+
+//! @brief scalar problem that only provides the fused evaluation and counts its calls
+struct FusedScalarProblem
+{
+    std::pair<double, double> ResidualAndDerivative(double x)
+    {
+        ++numEvaluations;
+        return {x * x * x - x + 6, 3. * x * x - 1};
+    }
+
+    double Norm(double r) const
+    {
+        return std::abs(r);
+    }
+
+    void Info(int, double, double) const
+    {
+    }
+
+    double mTolerance = tolerance;
+    int numEvaluations = 0;
+};
+
+BOOST_AUTO_TEST_CASE(NewtonScalarFused)
+{
+    static_assert(HasResidualAndDerivative<FusedScalarProblem, double>::value, "");
+    static_assert(not HasResidualAndDerivative<decltype(ValidProblem()), double>::value, "");
+
+    FusedScalarProblem problem;
+    int numIterations = 0;
+    double result = Solve(problem, 0., DoubleSolver(), 100, NoLineSearch(), &numIterations);
+    BOOST_CHECK_CLOSE_FRACTION(result, -2, tolerance);
+    // one fused evaluation per iteration plus the initial one
+    BOOST_CHECK_EQUAL(problem.numEvaluations, numIterations + 1);
+
+    FusedScalarProblem problemLineSearch;
+    result = Solve(problemLineSearch, 0., DoubleSolver(), 100, LineSearch());
+    BOOST_CHECK_CLOSE_FRACTION(result, -2, tolerance);
+}
+
+/* ##################################################
+ * ##               TANGENT UPDATES                ##
+ * ################################################## */
+
+//! @brief R(x) = A x + x^3 - b with a symmetric derivative
+auto MildlyNonlinearProblem()
+{
+    auto A = []() {
+        Eigen::SparseMatrix<double> m(3, 3);
+        m.insert(0, 0) = 4;
+        m.insert(0, 1) = -1;
+        m.insert(1, 0) = -1;
+        m.insert(1, 1) = 4;
+        m.insert(1, 2) = -1;
+        m.insert(2, 1) = -1;
+        m.insert(2, 2) = 4;
+        m.makeCompressed();
+        return m;
+    };
+    auto R = [A](const Eigen::VectorXd& x) -> Eigen::VectorXd {
+        return A() * x + x.array().cube().matrix() - Eigen::Vector3d(1, 2, 3);
+    };
+    auto DR = [A](const Eigen::VectorXd& x) -> Eigen::SparseMatrix<double> {
+        Eigen::SparseMatrix<double> m = A();
+        for (int i = 0; i < 3; ++i)
+            m.coeffRef(i, i) += 3 * x[i] * x[i];
+        return m;
+    };
+    auto Norm = [](const Eigen::VectorXd& r) { return r.norm(); };
+    return DefineProblem(R, DR, Norm, tolerance);
+}
+
+//! @brief solves MildlyNonlinearProblem() from x0 = 0 with `update`
+//! @return number of iterations and number of factorizations
+std::pair<int, int> SolveMildlyNonlinear(const TangentUpdate& update)
+{
+    auto problem = MildlyNonlinearProblem();
+    NuTo::EigenSparseSolver solver("EigenSparseLU");
+    Eigen::VectorXd x0 = Eigen::VectorXd::Zero(3);
+    int numIterations = 0;
+    Eigen::VectorXd x = Solve(problem, x0, solver, 50, NoLineSearch(), &numIterations, update);
+    BOOST_CHECK_LT(problem.Residual(x).norm(), tolerance);
+    BOOST_CHECK_EQUAL(solver.NumAnalyses(), 1);
+    return {numIterations, solver.NumFactorizations()};
+}
+
+BOOST_AUTO_TEST_CASE(NewtonFull)
+{
+    // quadratic convergence, one factorization per iteration
+    int numIterations, numFactorizations;
+    std::tie(numIterations, numFactorizations) = SolveMildlyNonlinear(FullNewton());
+    BOOST_CHECK_LE(numIterations, 6);
+    BOOST_CHECK_EQUAL(numFactorizations, numIterations);
+}
+
+BOOST_AUTO_TEST_CASE(NewtonModified)
+{
+    const int numIterationsFull = SolveMildlyNonlinear(FullNewton()).first;
+    int numIterations, numFactorizations;
+
+    // only the derivative at x0, linear convergence
+    std::tie(numIterations, numFactorizations) = SolveMildlyNonlinear(ModifiedNewton(0, 1.));
+    BOOST_CHECK_EQUAL(numFactorizations, 1);
+    BOOST_CHECK_GT(numIterations, numIterationsFull);
+
+    // a new derivative every third iteration
+    std::tie(numIterations, numFactorizations) = SolveMildlyNonlinear(ModifiedNewton(3, 1.));
+    BOOST_CHECK_GT(numIterations, numIterationsFull);
+    BOOST_CHECK_LE(numIterations, 2 * numIterationsFull);
+    BOOST_CHECK_EQUAL(numFactorizations, (numIterations + 2) / 3);
+}
+
+BOOST_AUTO_TEST_CASE(NewtonQuasi)
+{
+    // superlinear convergence with the single factorization at x0
+    const int numIterationsFull = SolveMildlyNonlinear(FullNewton()).first;
+    for (auto method : {eQuasiNewton::BROYDEN, eQuasiNewton::BFGS})
+    {
+        int numIterations, numFactorizations;
+        std::tie(numIterations, numFactorizations) = SolveMildlyNonlinear(QuasiNewton(method, 0, 1.));
+        BOOST_CHECK_EQUAL(numFactorizations, 1);
+        BOOST_CHECK_GT(numIterations, numIterationsFull);
+        BOOST_CHECK_LE(numIterations, 3 * numIterationsFull);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(NewtonReuseInitial)
+{
+    auto problem = MildlyNonlinearProblem();
+    NuTo::EigenSparseSolver solver("EigenSparseLU");
+    Eigen::VectorXd x0 = Eigen::VectorXd::Zero(3);
+    solver.Factorize(problem.Derivative(x0));
+
+    Eigen::VectorXd x = Solve(problem, x0, solver, 50, NoLineSearch(), nullptr, ModifiedNewton(0, 1., true));
+    BOOST_CHECK_LT(problem.Residual(x).norm(), tolerance);
+    BOOST_CHECK_EQUAL(solver.NumFactorizations(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(NewtonScalarSecant)
+{
+    // the scalar Broyden update is the secant method, starting close enough to the root
+    int numIterationsNewton = 0;
+    int numIterationsSecant = 0;
+    Solve(ValidProblem(), -1.5, DoubleSolver(), 100, NoLineSearch(), &numIterationsNewton);
+    auto result = Solve(ValidProblem(), -1.5, DoubleSolver(), 100, NoLineSearch(), &numIterationsSecant,
+                        QuasiNewton(eQuasiNewton::BROYDEN, 0, 1.));
+    BOOST_CHECK_CLOSE_FRACTION(result, -2, tolerance);
+    BOOST_CHECK_GE(numIterationsSecant, numIterationsNewton);
+}
+
+BOOST_AUTO_TEST_CASE(NewtonStagnation)
+{
+    // the derivative at x0 = 0 points away from the root, a new one is evaluated once the residual grows
+    auto result = Solve(ValidProblem(), 0., DoubleSolver(), 100, LineSearch(), nullptr, ModifiedNewton(0, 0.9));
+    BOOST_CHECK_CLOSE_FRACTION(result, -2, tolerance);
+}
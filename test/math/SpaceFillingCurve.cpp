@@ -0,0 +1,61 @@
+#include "BoostUnitTest.h"
+#include <algorithm>
+#include <boost/test/data/test_case.hpp>
+#include "nuto/base/Exception.h"
+#include "nuto/math/SpaceFillingCurve.h"
+
+namespace bdata = boost::unit_test::data;
+
+using namespace NuTo;
+
+//! @brief all points of the grid [0, 2^bits)^dim sorted along `curve`
+std::vector<Eigen::VectorXi> SortedGrid(int dim, int bits, eSpaceFillingCurve curve)
+{
+    const int n = 1 << bits;
+    std::vector<Eigen::VectorXi> points;
+    for (int i = 0; i < std::pow(n, dim); ++i)
+    {
+        Eigen::VectorXi point(dim);
+        for (int d = 0, rest = i; d < dim; ++d, rest /= n)
+            point[d] = rest % n;
+        points.push_back(point);
+    }
+    std::sort(points.begin(), points.end(), [&](const Eigen::VectorXi& a, const Eigen::VectorXi& b) {
+        return SpaceFillingCurveKey(a, bits, curve) < SpaceFillingCurveKey(b, bits, curve);
+    });
+    return points;
+}
+
+BOOST_AUTO_TEST_CASE(Morton2D)
+{
+    const auto points = SortedGrid(2, 1, eSpaceFillingCurve::MORTON);
+    BoostUnitTest::CheckEigenMatrix(points[0], Eigen::Vector2i(0, 0));
+    BoostUnitTest::CheckEigenMatrix(points[1], Eigen::Vector2i(1, 0));
+    BoostUnitTest::CheckEigenMatrix(points[2], Eigen::Vector2i(0, 1));
+    BoostUnitTest::CheckEigenMatrix(points[3], Eigen::Vector2i(1, 1));
+}
+
+BOOST_DATA_TEST_CASE(HilbertNeighbors, bdata::make({1, 2, 3}), dim)
+{
+    // each point of the Hilbert curve is a direct neighbor of its predecessor
+    const auto points = SortedGrid(dim, 3, eSpaceFillingCurve::HILBERT);
+    for (size_t i = 1; i < points.size(); ++i)
+        BOOST_CHECK_EQUAL((points[i] - points[i - 1]).cwiseAbs().sum(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(Order)
+{
+    std::vector<Eigen::VectorXd> points = {Eigen::Vector2d(1, 1), Eigen::Vector2d(0, 0), Eigen::Vector2d(1, 0),
+                                           Eigen::Vector2d(0, 0), Eigen::Vector2d(0, 1)};
+
+    // ties keep their relative order
+    const std::vector<int> morton = SpaceFillingCurveOrder(points, eSpaceFillingCurve::MORTON);
+    BOOST_CHECK((morton == std::vector<int>{1, 3, 2, 4, 0}));
+
+    const std::vector<int> hilbert = SpaceFillingCurveOrder(points, eSpaceFillingCurve::HILBERT);
+    BOOST_CHECK((hilbert == std::vector<int>{1, 3, 2, 0, 4}));
+
+    BOOST_CHECK(SpaceFillingCurveOrder({}).empty());
+    BOOST_CHECK_THROW(SpaceFillingCurveOrder({Eigen::Vector2d(0, 0), Eigen::Vector3d(0, 0, 0)}), Exception);
+    BOOST_CHECK_THROW(SpaceFillingCurveKey(Eigen::Vector3i(0, 0, 0), 22, eSpaceFillingCurve::MORTON), Exception);
+}
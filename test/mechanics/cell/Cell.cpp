@@ -1,5 +1,6 @@
 #include "BoostUnitTest.h"
 #include <fakeit.hpp>
+#include <set>
 
 #include "nuto/math/shapes/Triangle.h"
 
@@ -100,6 +101,193 @@ BOOST_AUTO_TEST_CASE(CellLetsSee)
     BOOST_CHECK_CLOSE(cell.Integrate(VolumeF), lx * ly, 1.e-10);
 }
 
+//! @brief distorted linear quad with nonzero displacements and a mocked 2x2 Gauss integration type
+struct DistortedQuad
+{
+    DistortedQuad()
+        : nCoord0(Eigen::Vector2d({0, 0}))
+        , nCoord1(Eigen::Vector2d({4, 0}))
+        , nCoord2(Eigen::Vector2d({5, 3}))
+        , nCoord3(Eigen::Vector2d({1, 2}))
+        , nDispl0(Eigen::Vector2d({0, 0}))
+        , nDispl1(Eigen::Vector2d({0.1, 0}))
+        , nDispl2(Eigen::Vector2d({0.2, 0.1}))
+        , nDispl3(Eigen::Vector2d({0, 0.3}))
+        , coordinateElement({nCoord0, nCoord1, nCoord2, nCoord3}, interpolation)
+        , displacementElement({nDispl0, nDispl1, nDispl2, nDispl3}, interpolation)
+        , elements(coordinateElement)
+        , dofDispl("Displacements", 2)
+        , law(20000, 0.2, NuTo::ePlaneState::PLANE_STRESS)
+        , integrand({dofDispl}, law)
+    {
+        elements.AddDofElement(dofDispl, displacementElement);
+
+        Method(intType, GetNumIntegrationPoints) = 4;
+        Method(intType, GetIntegrationPointWeight) = 1;
+        Eigen::Matrix<double, 2, 4> ipCoords;
+        ipCoords << -a, a, a, -a, -a, -a, a, a;
+        for (int iIP = 0; iIP < 4; ++iIP)
+            fakeit::When(Method(intType, GetLocalIntegrationPointCoordinates).Using(iIP))
+                    .AlwaysReturn(Eigen::VectorXd(ipCoords.col(iIP)));
+        fakeit::When(Method(intType, GetShape)).AlwaysReturn(quad);
+    }
+
+    const double a = 0.577350269189626;
+
+    NuTo::InterpolationQuadLinear interpolation;
+    NuTo::NodeSimple nCoord0;
+    NuTo::NodeSimple nCoord1;
+    NuTo::NodeSimple nCoord2;
+    NuTo::NodeSimple nCoord3;
+    NuTo::NodeSimple nDispl0;
+    NuTo::NodeSimple nDispl1;
+    NuTo::NodeSimple nDispl2;
+    NuTo::NodeSimple nDispl3;
+    NuTo::ElementFem coordinateElement;
+    NuTo::ElementFem displacementElement;
+    NuTo::ElementCollectionFem elements;
+    NuTo::DofType dofDispl;
+
+    fakeit::Mock<NuTo::IntegrationTypeBase> intType;
+    NuTo::Quadrilateral quad;
+
+    NuTo::Laws::LinearElastic<2> law;
+    NuTo::Integrands::MomentumBalance<2> integrand;
+};
+
+BOOST_FIXTURE_TEST_CASE(CellGeometryCache, DistortedQuad)
+{
+    auto GradientF = [&](const NuTo::CellIpData& cellIpData) { return integrand.Gradient(cellIpData, 0); };
+    auto Hessian0F = [&](const NuTo::CellIpData& cellIpData) { return integrand.Hessian0(cellIpData, 0); };
+
+    NuTo::Cell cell(elements, intType.get(), 0);
+    const Eigen::VectorXd gradient = cell.Integrate(GradientF)[dofDispl];
+    const Eigen::MatrixXd hessian = cell.Integrate(Hessian0F)(dofDispl, dofDispl);
+    const double volume = cell.Integrate(VolumeF);
+    auto DetF = [](const NuTo::CellIpData& cellIpData) {
+        return Eigen::VectorXd::Constant(1, cellIpData.GetJacobian().Det());
+    };
+    const std::vector<Eigen::VectorXd> determinants = cell.Eval(DetF);
+
+    NuTo::GeometryCacheBudget budget;
+    cell.EnableGeometryCache(&budget, {dofDispl});
+    BOOST_CHECK(not cell.HasGeometryCache());
+
+    BoostUnitTest::CheckEigenMatrix(cell.Integrate(GradientF)[dofDispl], gradient);
+    BOOST_CHECK(cell.HasGeometryCache());
+    BOOST_CHECK_EQUAL(budget.UsedBytes(), NuTo::CellGeometry::Bytes(4, 2, 2, {4}));
+    BoostUnitTest::CheckEigenMatrix(cell.Integrate(Hessian0F)(dofDispl, dofDispl), hessian);
+    BOOST_CHECK_CLOSE(cell.Integrate(VolumeF), volume, 1.e-10);
+
+    // the cache does not store the jacobians, they are calculated on demand
+    const std::vector<Eigen::VectorXd> cachedDeterminants = cell.Eval(DetF);
+    for (int iIP = 0; iIP < 4; ++iIP)
+        BoostUnitTest::CheckEigenMatrix(cachedDeterminants[iIP], determinants[iIP]);
+
+    // the cache only contains the reference geometry, changing the displacements is fine
+    nDispl2.SetValue(1, 0.5);
+    const Eigen::VectorXd gradientCached = cell.Integrate(GradientF)[dofDispl];
+    cell.DisableGeometryCache();
+    BOOST_CHECK_EQUAL(budget.UsedBytes(), 0);
+    BoostUnitTest::CheckEigenMatrix(cell.Integrate(GradientF)[dofDispl], gradientCached);
+
+    // budget too small: evaluation without cache
+    NuTo::GeometryCacheBudget tinyBudget(10);
+    cell.EnableGeometryCache(&tinyBudget, {dofDispl});
+    BoostUnitTest::CheckEigenMatrix(cell.Integrate(GradientF)[dofDispl], gradientCached);
+    BOOST_CHECK(not cell.HasGeometryCache());
+    BOOST_CHECK_EQUAL(tinyBudget.UsedBytes(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(CellShapeFunctionTables, DistortedQuad)
+{
+    NuTo::ShapeFunctionTable table(interpolation, intType.get());
+    BOOST_CHECK_EQUAL(table.GetNumIntegrationPoints(), 4);
+    for (int iIP = 0; iIP < 4; ++iIP)
+    {
+        const Eigen::VectorXd ipCoords = intType.get().GetLocalIntegrationPointCoordinates(iIP);
+        BoostUnitTest::CheckEigenMatrix(table.ShapeFunctions(iIP), interpolation.GetShapeFunctions(ipCoords));
+        BoostUnitTest::CheckEigenMatrix(table.DerivativeShapeFunctions(iIP),
+                                        interpolation.GetDerivativeShapeFunctions(ipCoords));
+    }
+
+    auto GradientF = [&](const NuTo::CellIpData& cellIpData) { return integrand.Gradient(cellIpData, 0); };
+    auto Hessian0F = [&](const NuTo::CellIpData& cellIpData) { return integrand.Hessian0(cellIpData, 0); };
+    auto ValueF = [&](const NuTo::CellIpData& cellIpData) { return cellIpData.Value(dofDispl); };
+
+    NuTo::Cell cell(elements, intType.get(), 0);
+    const Eigen::VectorXd gradient = cell.Integrate(GradientF)[dofDispl];
+    const Eigen::MatrixXd hessian = cell.Integrate(Hessian0F)(dofDispl, dofDispl);
+    const std::vector<Eigen::VectorXd> values = cell.Eval(ValueF);
+
+    NuTo::ShapeFunctionTables registry;
+    cell.EnableShapeFunctionTables(&registry);
+    NuTo::Cell otherCell(elements, intType.get(), 1);
+    otherCell.EnableShapeFunctionTables(&registry);
+
+    for (NuTo::Cell* c : {&cell, &otherCell})
+    {
+        BoostUnitTest::CheckEigenMatrix(c->Integrate(GradientF)[dofDispl], gradient);
+        BoostUnitTest::CheckEigenMatrix(c->Integrate(Hessian0F)(dofDispl, dofDispl), hessian);
+        const std::vector<Eigen::VectorXd> tableValues = c->Eval(ValueF);
+        for (int iIP = 0; iIP < 4; ++iIP)
+            BoostUnitTest::CheckEigenMatrix(tableValues[iIP], values[iIP]);
+    }
+    // coordinates and displacements of both cells share the same interpolation and integration type
+    BOOST_CHECK_EQUAL(registry.Size(), 1);
+
+    NuTo::GeometryCacheBudget budget;
+    cell.EnableGeometryCache(&budget, {dofDispl});
+    BoostUnitTest::CheckEigenMatrix(cell.Integrate(GradientF)[dofDispl], gradient);
+    BOOST_CHECK(cell.HasGeometryCache());
+
+    cell.EnableShapeFunctionTables(nullptr);
+    BoostUnitTest::CheckEigenMatrix(cell.Integrate(Hessian0F)(dofDispl, dofDispl), hessian);
+}
+
+BOOST_FIXTURE_TEST_CASE(CellWorkspaceReuse, DistortedQuad)
+{
+    NuTo::ShapeFunctionTables registry;
+    NuTo::Cell cell(elements, intType.get(), 0);
+    NuTo::Cell otherCell(elements, intType.get(), 1);
+    cell.EnableShapeFunctionTables(&registry);
+    otherCell.EnableShapeFunctionTables(&registry);
+
+    // all integration points of all cells share the memory of the memoized N and B
+    std::set<const double*> nMemory;
+    std::set<const double*> bMemory;
+    for (NuTo::Cell* c : {&cell, &otherCell})
+    {
+        int iIP = 0;
+        c->Apply([&](const NuTo::CellIpData& cellIpData) {
+            const Eigen::VectorXd ipCoords = intType.get().GetLocalIntegrationPointCoordinates(iIP++);
+            BoostUnitTest::CheckEigenMatrix(cellIpData.N(dofDispl), displacementElement.GetNMatrix(ipCoords));
+            nMemory.insert(cellIpData.N(dofDispl).data());
+            bMemory.insert(cellIpData.B(dofDispl, NuTo::Nabla::Strain()).data());
+        });
+    }
+    BOOST_CHECK_EQUAL(nMemory.size(), 1);
+    BOOST_CHECK_EQUAL(bMemory.size(), 1);
+
+    // nested evaluations use their own workspace and leave the outer memoized values untouched
+    const Eigen::MatrixXd N0 = displacementElement.GetNMatrix(Eigen::Vector2d({-a, -a}));
+    const Eigen::MatrixXd N3 = displacementElement.GetNMatrix(Eigen::Vector2d({-a, a}));
+    cell.Apply([&](const NuTo::CellIpData& cellIpData) {
+        const Eigen::MatrixXd& N = cellIpData.N(dofDispl);
+        const Eigen::MatrixXd expected = N;
+        otherCell.Apply([&](const NuTo::CellIpData& inner) { inner.N(dofDispl); });
+        BoostUnitTest::CheckEigenMatrix(N, expected);
+        BoostUnitTest::CheckEigenMatrix(cellIpData.N(dofDispl), expected);
+    });
+    otherCell.Eval([&](const NuTo::CellIpData& cellIpData) {
+        if (cellIpData.Ids().ipId == 0)
+            BoostUnitTest::CheckEigenMatrix(cellIpData.N(dofDispl), N0);
+        if (cellIpData.Ids().ipId == 3)
+            BoostUnitTest::CheckEigenMatrix(cellIpData.N(dofDispl), N3);
+        return Eigen::VectorXd();
+    });
+}
+
 BOOST_AUTO_TEST_CASE(CellShapeMismatch)
 {
     fakeit::Mock<NuTo::ElementCollection> elemCollection;
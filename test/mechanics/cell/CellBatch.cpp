@@ -0,0 +1,138 @@
+#include "BoostUnitTest.h"
+
+#include <deque>
+#include "nuto/mechanics/cell/CellBatch.h"
+#include "nuto/mechanics/cell/CellT.h"
+#include "nuto/mechanics/constitutive/LinearElastic.h"
+#include "nuto/mechanics/integrands/MomentumBalance.h"
+#include "nuto/mechanics/integrationtypes/IntegrationTypeTensorProduct.h"
+#include "nuto/mechanics/integrationtypes/IntegrationTypeTetrahedron.h"
+#include "nuto/mechanics/integrationtypes/IntegrationTypeTriangle.h"
+#include "nuto/mechanics/interpolation/InterpolationBrickLinear.h"
+#include "nuto/mechanics/interpolation/InterpolationQuadLinear.h"
+#include "nuto/mechanics/interpolation/InterpolationTetrahedronLinear.h"
+#include "nuto/mechanics/interpolation/InterpolationTriangleLinear.h"
+
+using namespace NuTo;
+
+//! @brief compares the batched integration of `numCells` distorted cells with the cell by cell integration of CellT
+template <int TDim, int TNumNodes, int TNumIps, int TPack>
+void CheckBatch(const InterpolationSimple& interpolation, const IntegrationTypeBase& integrationType, int numCells)
+{
+    DofType disp("Displacements", TDim);
+    Laws::LinearElastic<TDim> law(20000, 0.2);
+    Integrands::MomentumBalance<TDim> integrand(disp, law);
+
+    std::deque<NodeSimple> nodes;
+    std::deque<ElementCollectionFem> elements;
+    Group<ElementCollectionFem> elementGroup;
+    int dofNumber = 0;
+    for (int iCell = 0; iCell < numCells; ++iCell)
+    {
+        std::vector<NodeSimple*> coordinateNodes;
+        std::vector<NodeSimple*> displacementNodes;
+        for (int iNode = 0; iNode < TNumNodes; ++iNode)
+        {
+            Eigen::VectorXd coordinates = interpolation.GetLocalCoords(iNode) * (1 + iCell);
+            coordinates += 0.1 * Eigen::VectorXd::Random(TDim);
+            nodes.emplace_back(coordinates);
+            coordinateNodes.push_back(&nodes.back());
+
+            nodes.emplace_back(1.e-3 * Eigen::VectorXd::Random(TDim));
+            for (int iDim = 0; iDim < TDim; ++iDim)
+                nodes.back().SetDofNumber(iDim, dofNumber++);
+            displacementNodes.push_back(&nodes.back());
+        }
+        elements.emplace_back(ElementFem(coordinateNodes, interpolation));
+        elements.back().AddDofElement(disp, ElementFem(displacementNodes, interpolation));
+        elementGroup.Add(elements.back());
+    }
+
+    CellBatch<TDim, TNumNodes, TNumIps, TPack> batch(elementGroup, integrationType, disp, law);
+    BOOST_CHECK_EQUAL(batch.NumCells(), numCells);
+
+    DofVector<double> gradient;
+    gradient[disp] = Eigen::VectorXd::Zero(dofNumber);
+    batch.AddGradient(&gradient, 0);
+
+    DofMatrixSparse<double> hessian;
+    hessian(disp, disp).resize(dofNumber, dofNumber);
+    batch.AddHessian0(&hessian, 0);
+
+    // each cell has its own dofs, the global vector and matrix thus consist of the local ones
+    int iCell = 0;
+    for (auto& element : elementGroup)
+    {
+        CellT<TDim, TNumNodes, TNumIps> cell(element, integrationType, iCell);
+        const auto localGradient =
+                cell.IntegrateT([&](const typename CellT<TDim, TNumNodes, TNumIps>::IpData& data) {
+                    return integrand.GradientT(data, 0);
+                });
+        const auto localHessian =
+                cell.IntegrateT([&](const typename CellT<TDim, TNumNodes, TNumIps>::IpData& data) {
+                    return integrand.Hessian0T(data, 0);
+                });
+
+        constexpr int numDofs = TDim * TNumNodes;
+        BoostUnitTest::CheckEigenMatrix(gradient[disp].segment(iCell * numDofs, numDofs), localGradient, 1.e-10);
+        Eigen::MatrixXd globalHessian = hessian(disp, disp);
+        BoostUnitTest::CheckEigenMatrix(globalHessian.block(iCell * numDofs, iCell * numDofs, numDofs, numDofs),
+                                        localHessian, 1.e-10);
+        ++iCell;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CellBatchTriangle)
+{
+    InterpolationTriangleLinear interpolation;
+    IntegrationTypeTriangle integrationType(2);
+    CheckBatch<2, 3, 3, 4>(interpolation, integrationType, 7);
+}
+
+BOOST_AUTO_TEST_CASE(CellBatchQuad)
+{
+    InterpolationQuadLinear interpolation;
+    IntegrationTypeTensorProduct<2> integrationType(2, eIntegrationMethod::GAUSS);
+    CheckBatch<2, 4, 4, 4>(interpolation, integrationType, 5);
+    CheckBatch<2, 4, 4, 8>(interpolation, integrationType, 8);
+}
+
+BOOST_AUTO_TEST_CASE(CellBatchTetrahedron)
+{
+    InterpolationTetrahedronLinear interpolation;
+    IntegrationTypeTetrahedron integrationType(2);
+    CheckBatch<3, 4, 4, 4>(interpolation, integrationType, 6);
+}
+
+BOOST_AUTO_TEST_CASE(CellBatchBrick)
+{
+    InterpolationBrickLinear interpolation;
+    IntegrationTypeTensorProduct<3> integrationType(2, eIntegrationMethod::GAUSS);
+    CheckBatch<3, 8, 8, 4>(interpolation, integrationType, 3);
+}
+
+BOOST_AUTO_TEST_CASE(CellBatchMixedInterpolations)
+{
+    InterpolationQuadLinear interpolation0;
+    InterpolationQuadLinear interpolation1;
+    IntegrationTypeTensorProduct<2> integrationType(2, eIntegrationMethod::GAUSS);
+
+    NodeSimple n0(Eigen::Vector2d(0, 0));
+    NodeSimple n1(Eigen::Vector2d(1, 0));
+    NodeSimple n2(Eigen::Vector2d(1, 1));
+    NodeSimple n3(Eigen::Vector2d(0, 1));
+    DofType disp("Displacements", 2);
+
+    ElementCollectionFem element0(ElementFem({n0, n1, n2, n3}, interpolation0));
+    element0.AddDofElement(disp, ElementFem({n0, n1, n2, n3}, interpolation0));
+    ElementCollectionFem element1(ElementFem({n0, n1, n2, n3}, interpolation1));
+    element1.AddDofElement(disp, ElementFem({n0, n1, n2, n3}, interpolation1));
+
+    Laws::LinearElastic<2> law(20000, 0.2);
+    BOOST_CHECK_NO_THROW((CellBatch<2, 4, 4>(Group<ElementCollectionFem>(element0), integrationType, disp, law)));
+    BOOST_CHECK_THROW((CellBatch<2, 4, 4>(Group<ElementCollectionFem>({element0, element1}), integrationType, disp,
+                                          law)),
+                      Exception);
+    BOOST_CHECK_THROW((CellBatch<2, 4, 9>(Group<ElementCollectionFem>(element0), integrationType, disp, law)),
+                      Exception);
+}
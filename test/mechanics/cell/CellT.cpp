@@ -0,0 +1,228 @@
+#include "BoostUnitTest.h"
+#include <fakeit.hpp>
+
+#include "nuto/mechanics/cell/CellT.h"
+#include "nuto/mechanics/cell/CellTBatch.h"
+#include "nuto/mechanics/elements/ElementCollection.h"
+#include "nuto/mechanics/interpolation/InterpolationQuadLinear.h"
+#include "nuto/mechanics/integrands/MomentumBalance.h"
+#include "nuto/mechanics/integrands/GradientDamage.h"
+#include "nuto/mechanics/constitutive/LinearElastic.h"
+
+using namespace NuTo;
+
+//! @brief distorted 4 node quad with displacements and nonlocal equivalent strains
+struct QuadFixture
+{
+    QuadFixture()
+        : coordinateElement({nCoord0, nCoord1, nCoord2, nCoord3}, interpolation)
+        , elements(coordinateElement)
+    {
+        elements.AddDofElement(disp, ElementFem({nDispl0, nDispl1, nDispl2, nDispl3}, interpolation));
+        elements.AddDofElement(eeq, ElementFem({nEeq0, nEeq1, nEeq2, nEeq3}, interpolation));
+
+        constexpr double a = 0.577350269189626;
+        Method(intType, GetNumIntegrationPoints) = 4;
+        Method(intType, GetIntegrationPointWeight) = 1;
+        fakeit::When(Method(intType, GetLocalIntegrationPointCoordinates).Using(0))
+                .AlwaysReturn(Eigen::Vector2d({-a, -a}));
+        fakeit::When(Method(intType, GetLocalIntegrationPointCoordinates).Using(1))
+                .AlwaysReturn(Eigen::Vector2d({a, -a}));
+        fakeit::When(Method(intType, GetLocalIntegrationPointCoordinates).Using(2))
+                .AlwaysReturn(Eigen::Vector2d({a, a}));
+        fakeit::When(Method(intType, GetLocalIntegrationPointCoordinates).Using(3))
+                .AlwaysReturn(Eigen::Vector2d({-a, a}));
+        fakeit::When(Method(intType, GetShape)).AlwaysReturn(quad);
+    }
+
+    InterpolationQuadLinear interpolation;
+    NodeSimple nCoord0 = NodeSimple(Eigen::Vector2d({0, 0}));
+    NodeSimple nCoord1 = NodeSimple(Eigen::Vector2d({4, 0}));
+    NodeSimple nCoord2 = NodeSimple(Eigen::Vector2d({5, 3}));
+    NodeSimple nCoord3 = NodeSimple(Eigen::Vector2d({1, 2}));
+    ElementFem coordinateElement;
+
+    NodeSimple nDispl0 = NodeSimple(Eigen::Vector2d({0, 0}));
+    NodeSimple nDispl1 = NodeSimple(Eigen::Vector2d({1.e-4, 0}));
+    NodeSimple nDispl2 = NodeSimple(Eigen::Vector2d({2.e-4, 1.e-4}));
+    NodeSimple nDispl3 = NodeSimple(Eigen::Vector2d({0, 3.e-4}));
+
+    NodeSimple nEeq0 = NodeSimple(1.e-4);
+    NodeSimple nEeq1 = NodeSimple(2.e-4);
+    NodeSimple nEeq2 = NodeSimple(0.5e-4);
+    NodeSimple nEeq3 = NodeSimple(3.e-4);
+
+    ElementCollectionFem elements;
+    DofType disp = DofType("Displacements", 2);
+    ScalarDofType eeq = ScalarDofType("Eeq");
+
+    fakeit::Mock<IntegrationTypeBase> intType;
+    Quadrilateral quad;
+};
+
+BOOST_FIXTURE_TEST_CASE(CellTMomentumBalance, QuadFixture)
+{
+    Laws::LinearElastic<2> law(20000, 0.2, ePlaneState::PLANE_STRESS);
+    Integrands::MomentumBalance<2> integrand(disp, law);
+
+    CellT<2, 4, 4> cell(elements, intType.get(), 0);
+
+    auto Gradient = [&](const CellIpData& data) { return integrand.Gradient(data, 0); };
+    auto Hessian0 = [&](const CellIpData& data) { return integrand.Hessian0(data, 0); };
+
+    auto GradientT = [&](const CellT<2, 4, 4>::IpData& data) { return integrand.GradientT(data, 0); };
+    auto Hessian0T = [&](const CellT<2, 4, 4>::IpData& data) { return integrand.Hessian0T(data, 0); };
+
+    BoostUnitTest::CheckEigenMatrix(cell.IntegrateT(GradientT), cell.Integrate(Gradient)[disp]);
+    BoostUnitTest::CheckEigenMatrix(cell.IntegrateT(Hessian0T), cell.Integrate(Hessian0)(disp, disp));
+
+    auto Volume = [](const CellT<2, 4, 4>::IpData&) { return 1.; };
+    BOOST_CHECK_CLOSE(cell.IntegrateT(Volume), 9.5, 1.e-10);
+}
+
+BOOST_FIXTURE_TEST_CASE(CellTGradientDamage, QuadFixture)
+{
+    Integrands::GradientDamage<2> integrand(disp, eeq, Material::DefaultConcrete());
+    integrand.mKappas.setZero(1, 4);
+    integrand.mKappas(0, 1) = 2.e-4; // one integration point with kappa > eeq
+
+    CellT<2, 4, 4> cell(elements, intType.get(), 0);
+
+    auto Gradient = [&](const CellIpData& data) { return integrand.Gradient(data); };
+    auto Hessian0 = [&](const CellIpData& data) { return integrand.Hessian0(data); };
+
+    auto GradientT = [&](const CellT<2, 4, 4>::IpData& data) { return integrand.GradientT(data); };
+    auto Hessian0T = [&](const CellT<2, 4, 4>::IpData& data) { return integrand.Hessian0T(data); };
+
+    const DofVector<double> gradient = cell.Integrate(Gradient);
+    const Eigen::Matrix<double, 12, 1> gradientT = cell.IntegrateT(GradientT);
+    BoostUnitTest::CheckEigenMatrix(gradientT.head<8>(), gradient[disp]);
+    BoostUnitTest::CheckEigenMatrix(gradientT.tail<4>(), gradient[eeq]);
+
+    const DofMatrix<double> hessian0 = cell.Integrate(Hessian0);
+    const Eigen::Matrix<double, 12, 12> hessian0T = cell.IntegrateT(Hessian0T);
+    BoostUnitTest::CheckEigenMatrix(hessian0T.topLeftCorner<8, 8>(), hessian0(disp, disp));
+    BoostUnitTest::CheckEigenMatrix(hessian0T.topRightCorner<8, 4>(), hessian0(disp, eeq));
+    BoostUnitTest::CheckEigenMatrix(hessian0T.bottomLeftCorner<4, 8>(), hessian0(eeq, disp));
+    BoostUnitTest::CheckEigenMatrix(hessian0T.bottomRightCorner<4, 4>(), hessian0(eeq, eeq));
+
+    cell.ApplyT([&](const CellT<2, 4, 4>::IpData& data) { integrand.UpdateT(data); });
+    for (int iIP = 0; iIP < 4; ++iIP)
+        BOOST_CHECK_GT(integrand.mKappas(0, iIP), 0.);
+}
+
+BOOST_FIXTURE_TEST_CASE(CellTMismatch, QuadFixture)
+{
+    BOOST_CHECK_THROW((CellT<2, 4, 3>(elements, intType.get(), 0)), Exception);
+    BOOST_CHECK_THROW((CellT<2, 8, 4>(elements, intType.get(), 0)), Exception);
+
+    // eeq has only one component
+    CellT<2, 4, 4> cell(elements, intType.get(), 0);
+    auto WrongComponents = [&](const CellT<2, 4, 4>::IpData& data) { return data.NodeValueVector<2>(eeq).eval(); };
+    BOOST_CHECK_THROW(cell.IntegrateT(WrongComponents), Exception);
+}
+
+BOOST_FIXTURE_TEST_CASE(CellTGeometryCache, QuadFixture)
+{
+    Laws::LinearElastic<2> law(20000, 0.2, ePlaneState::PLANE_STRESS);
+    Integrands::MomentumBalance<2> integrand(disp, law);
+    auto Hessian0T = [&](const CellT<2, 4, 4>::IpData& data) { return integrand.Hessian0T(data, 0); };
+
+    CellT<2, 4, 4> cell(elements, intType.get(), 0);
+    const Eigen::Matrix<double, 8, 8> hessian0 = cell.IntegrateT(Hessian0T);
+
+    GeometryCacheBudget budget;
+    cell.EnableGeometryCache(&budget, {});
+    BoostUnitTest::CheckEigenMatrix(cell.IntegrateT(Hessian0T), hessian0);
+    BOOST_CHECK(cell.HasGeometryCache());
+}
+
+//! @brief dof numbers in the node order, the same for the dynamic Cell::DofNumbering and the local CellT ordering
+void NumberDofs(QuadFixture& f)
+{
+    int dofNumber = 0;
+    for (NodeSimple* node : {&f.nDispl0, &f.nDispl1, &f.nDispl2, &f.nDispl3})
+        for (int component = 0; component < 2; ++component)
+            node->SetDofNumber(component, dofNumber++);
+    dofNumber = 0;
+    for (NodeSimple* node : {&f.nEeq0, &f.nEeq1, &f.nEeq2, &f.nEeq3})
+        node->SetDofNumber(0, dofNumber++);
+}
+
+BOOST_FIXTURE_TEST_CASE(CellTBatchMomentumBalance, QuadFixture)
+{
+    NumberDofs(*this);
+    Laws::LinearElastic<2> law(20000, 0.2, ePlaneState::PLANE_STRESS);
+    Integrands::MomentumBalance<2> integrand(disp, law);
+
+    CellT<2, 4, 4> cell(elements, intType.get(), 0);
+    auto batch = MakeCellTBatch(
+            Group<CellT<2, 4, 4>>(cell), {disp},
+            [&](const CellT<2, 4, 4>::IpData& data, double dt) { return integrand.GradientT(data, dt); },
+            [&](const CellT<2, 4, 4>::IpData& data, double dt) { return integrand.Hessian0T(data, dt); }, true);
+    BOOST_CHECK_EQUAL(batch.NumCells(), 1);
+    BOOST_CHECK(batch.IsHessian0Symmetric());
+
+    const Eigen::MatrixXd hessian0 = cell.Integrate([&](const CellIpData& data) {
+        return integrand.Hessian0(data, 0);
+    })(disp, disp);
+
+    DofMatrixSparse<double> hessian0Batch;
+    hessian0Batch(disp, disp).resize(8, 8);
+    batch.AddHessian0(&hessian0Batch, 0, eMatrixStorage::UPPER);
+    BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(hessian0Batch(disp, disp)),
+                                    Eigen::MatrixXd(hessian0.triangularView<Eigen::Upper>()));
+
+    const Eigen::VectorXd x = Eigen::VectorXd::Random(8);
+    Eigen::VectorXd product = Eigen::VectorXd::Zero(8);
+    batch.AddHessian0Product(x, product, 0);
+    BoostUnitTest::CheckEigenMatrix(product, hessian0 * x);
+
+    Eigen::VectorXd diagonal = Eigen::VectorXd::Zero(8);
+    batch.AddHessian0Diagonal(diagonal, 0);
+    BoostUnitTest::CheckEigenMatrix(diagonal, hessian0.diagonal());
+}
+
+BOOST_FIXTURE_TEST_CASE(CellTBatchGradientDamage, QuadFixture)
+{
+    NumberDofs(*this);
+    Integrands::GradientDamage<2> integrand(disp, eeq, Material::DefaultConcrete());
+    integrand.mKappas.setZero(1, 4);
+    integrand.mKappas(0, 1) = 2.e-4;
+
+    CellT<2, 4, 4> cell(elements, intType.get(), 0);
+    auto batch = MakeCellTBatch(Group<CellT<2, 4, 4>>(cell), {disp, eeq},
+                                [&](const CellT<2, 4, 4>::IpData& data, double) { return integrand.GradientT(data); },
+                                [&](const CellT<2, 4, 4>::IpData& data, double) { return integrand.Hessian0T(data); });
+    batch.SetUpdateFunction([&](const CellT<2, 4, 4>::IpData& data, double) { integrand.UpdateT(data); });
+    BOOST_CHECK_EQUAL(batch.GetDofTypes().size(), 2);
+
+    const DofVector<double> gradient = cell.Integrate([&](const CellIpData& data) { return integrand.Gradient(data); });
+    DofVector<double> gradientBatch;
+    gradientBatch[disp] = Eigen::VectorXd::Zero(8);
+    gradientBatch[eeq] = Eigen::VectorXd::Zero(4);
+    batch.AddGradient(&gradientBatch, 0);
+    BoostUnitTest::CheckEigenMatrix(gradientBatch[disp], gradient[disp]);
+    BoostUnitTest::CheckEigenMatrix(gradientBatch[eeq], gradient[eeq]);
+
+    const DofMatrix<double> hessian0 =
+            cell.Integrate([&](const CellIpData& data) { return integrand.Hessian0(data); });
+    const std::vector<DofType> dofs = {disp, eeq};
+    DofMatrixSparse<double> hessian0Batch;
+    for (DofType dofI : dofs)
+        for (DofType dofJ : dofs)
+            hessian0Batch(dofI, dofJ).resize(dofI.GetNum() * 4, dofJ.GetNum() * 4);
+    batch.AddHessian0(&hessian0Batch, 0);
+    for (DofType dofI : dofs)
+        for (DofType dofJ : dofs)
+            BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(hessian0Batch(dofI, dofJ)), hessian0(dofI, dofJ));
+
+    // the coupled local hessians support neither the upper storage nor the matrix-free products
+    BOOST_CHECK_THROW(batch.AddHessian0(&hessian0Batch, 0, eMatrixStorage::UPPER), Exception);
+    Eigen::VectorXd diagonal = Eigen::VectorXd::Zero(8);
+    BOOST_CHECK_THROW(batch.AddHessian0Diagonal(diagonal, 0), Exception);
+
+    batch.UpdateHistory(0);
+    for (int iIP = 0; iIP < 4; ++iIP)
+        BOOST_CHECK_GT(integrand.mKappas(0, iIP), 0.);
+}
@@ -17,6 +17,7 @@ fakeit::Mock<NuTo::CellInterface> MockCell(const NuTo::DofType& dof, Eigen::Vect
     mockHessian(dof, dof) << 11, 12, 13, 21, 22, 23, 31, 32, 33;
 
     Method(cell, DofNumbering) = mockNumbering;
+    fakeit::When(Method(cell, Has)).AlwaysReturn(true);
     fakeit::When(OverloadedMethod(cell, Integrate, NuTo::DofVector<double>(NuTo::CellInterface::VectorFunction)))
             .AlwaysReturn(mockGradient);
     fakeit::When(OverloadedMethod(cell, Integrate, NuTo::DofMatrix<double>(NuTo::CellInterface::MatrixFunction)))
@@ -113,6 +114,125 @@ BOOST_AUTO_TEST_CASE(AssemblerHessian)
     BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(hessian(d, d)), hessianE);
 }
 
+BOOST_AUTO_TEST_CASE(AssemblerHessianReusePattern)
+{
+    NuTo::DofType d("0", 1);
+    NuTo::SimpleAssembler assembler = SetupAssembler(d);
+
+    auto mockCell0 = MockCell(d, Eigen::Vector3i(0, 1, 2));
+    auto mockCell1 = MockCell(d, Eigen::Vector3i(2, 3, 4));
+    NuTo::Group<NuTo::CellInterface> cells({mockCell0.get(), mockCell1.get()});
+
+    NuTo::DofMatrixSparse<double> hessian = assembler.BuildMatrix(cells, {d}, NuTo::CellInterface::MatrixFunction());
+    const Eigen::MatrixXd hessianE = Eigen::MatrixXd(hessian(d, d));
+    const int nonZeros = hessian(d, d).nonZeros();
+
+    NuTo::SimpleAssembler::ScatterMap scatterMap;
+    hessian(d, d).coeffs().setZero();
+    assembler.AddToMatrix(&hessian, cells, {d}, NuTo::CellInterface::MatrixFunction(), &scatterMap);
+    BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(hessian(d, d)), hessianE);
+    BOOST_CHECK_EQUAL(scatterMap.size(), 2);
+
+    // second assembly uses the memoized scatter map and adds to the existing values
+    assembler.AddToMatrix(&hessian, cells, {d}, NuTo::CellInterface::MatrixFunction(), &scatterMap);
+    BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(hessian(d, d)), 2. * hessianE);
+    BOOST_CHECK_EQUAL(hessian(d, d).nonZeros(), nonZeros);
+
+    // entries (0, 4) and (4, 0) are not part of the pattern
+    auto mockCell2 = MockCell(d, Eigen::Vector3i(0, 1, 4));
+    NuTo::SimpleAssembler::ScatterMap otherScatterMap;
+    BOOST_CHECK_THROW(assembler.AddToMatrix(&hessian, {mockCell2.get()}, {d}, NuTo::CellInterface::MatrixFunction(),
+                                            &otherScatterMap),
+                      NuTo::Exception);
+}
+
+BOOST_AUTO_TEST_CASE(AssemblerHessianUpper)
+{
+    NuTo::DofType d("0", 1);
+    NuTo::SimpleAssembler assembler = SetupAssembler(d);
+
+    auto mockCell0 = MockCell(d, Eigen::Vector3i(0, 1, 2));
+    auto mockCell1 = MockCell(d, Eigen::Vector3i(2, 3, 4));
+    NuTo::Group<NuTo::CellInterface> cells({mockCell0.get(), mockCell1.get()});
+
+    const Eigen::MatrixXd full =
+            Eigen::MatrixXd(assembler.BuildMatrix(cells, {d}, NuTo::CellInterface::MatrixFunction())(d, d));
+    const Eigen::MatrixXd upperE = full.triangularView<Eigen::Upper>();
+
+    NuTo::DofMatrixSparse<double> upper =
+            assembler.BuildMatrix(cells, {d}, NuTo::CellInterface::MatrixFunction(), NuTo::eMatrixStorage::UPPER);
+    BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(upper(d, d)), upperE);
+    BOOST_CHECK_EQUAL(upper(d, d).nonZeros(), 11);
+
+    // the scatter map skips the lower triangle of the local matrices
+    NuTo::SimpleAssembler::ScatterMap scatterMap;
+    upper(d, d).coeffs().setZero();
+    assembler.AddToMatrix(&upper, cells, {d}, NuTo::CellInterface::MatrixFunction(), &scatterMap,
+                          assembler.BuildColoring(cells, {d}), NuTo::eMatrixStorage::UPPER);
+    BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(upper(d, d)), upperE);
+    BOOST_CHECK_EQUAL(upper(d, d).nonZeros(), 11);
+}
+
+BOOST_AUTO_TEST_CASE(AssemblerColoring)
+{
+    NuTo::DofType d("0", 1);
+    NuTo::SimpleAssembler assembler = SetupAssembler(d);
+
+    auto mockCell0 = MockCell(d, Eigen::Vector3i(0, 1, 2));
+    auto mockCell1 = MockCell(d, Eigen::Vector3i(2, 3, 4));
+    auto mockCell2 = MockCell(d, Eigen::Vector3i(3, 4, 1));
+    NuTo::Group<NuTo::CellInterface> cells({mockCell0.get(), mockCell1.get(), mockCell2.get()});
+
+    // every cell shares a dof with each other cell
+    NuTo::SimpleAssembler::Coloring coloring = assembler.BuildColoring(cells, {d});
+    BOOST_CHECK_EQUAL(coloring.size(), 3);
+
+    // cells without an interpolation for d do not block any color
+    auto mockCell3 = MockCell(d, Eigen::Vector3i(0, 1, 2));
+    fakeit::When(Method(mockCell3, Has)).AlwaysReturn(false);
+    BOOST_CHECK_EQUAL(assembler.BuildColoring({mockCell0.get(), mockCell3.get()}, {d}).size(), 1);
+
+    // colored and uncolored assembly give the same results
+    NuTo::CellInterface::VectorFunction vectorFunction;
+    NuTo::CellInterface::MatrixFunction matrixFunction;
+
+    BoostUnitTest::CheckEigenMatrix(assembler.BuildVector(cells, {d}, vectorFunction, coloring)[d],
+                                    assembler.BuildVector(cells, {d}, vectorFunction)[d]);
+
+    BoostUnitTest::CheckEigenMatrix(assembler.BuildDiagonallyLumpedMatrix(cells, {d}, matrixFunction, coloring)[d],
+                                    assembler.BuildDiagonallyLumpedMatrix(cells, {d}, matrixFunction)[d]);
+
+    NuTo::DofMatrixSparse<double> hessian = assembler.BuildMatrix(cells, {d}, matrixFunction);
+    const Eigen::MatrixXd hessianE = Eigen::MatrixXd(hessian(d, d));
+
+    NuTo::SimpleAssembler::ScatterMap scatterMap;
+    hessian(d, d).coeffs().setZero();
+    assembler.AddToMatrix(&hessian, cells, {d}, matrixFunction, &scatterMap, coloring);
+    BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(hessian(d, d)), hessianE);
+}
+
+BOOST_AUTO_TEST_CASE(AssemblerMatrixFree)
+{
+    NuTo::DofType d("0", 1);
+    NuTo::SimpleAssembler assembler = SetupAssembler(d);
+
+    auto mockCell0 = MockCell(d, Eigen::Vector3i(0, 1, 2));
+    auto mockCell1 = MockCell(d, Eigen::Vector3i(2, 3, 4));
+    NuTo::Group<NuTo::CellInterface> cells({mockCell0.get(), mockCell1.get()});
+    NuTo::SimpleAssembler::Coloring coloring = assembler.BuildColoring(cells, {d});
+    NuTo::CellInterface::MatrixFunction matrixFunction;
+
+    const Eigen::MatrixXd hessianE = Eigen::MatrixXd(assembler.BuildMatrix(cells, {d}, matrixFunction)(d, d));
+
+    NuTo::DofVector<double> x;
+    x[d] = (Eigen::VectorXd(5) << 1, 2, 3, 4, 5).finished();
+
+    BoostUnitTest::CheckEigenMatrix(assembler.BuildMatrixVectorProduct(cells, {d}, matrixFunction, x, coloring)[d],
+                                    hessianE * x[d]);
+    BoostUnitTest::CheckEigenMatrix(assembler.BuildDiagonal(cells, {d}, matrixFunction, coloring)[d],
+                                    Eigen::VectorXd(hessianE.diagonal()));
+}
+
 BOOST_AUTO_TEST_CASE(AssemblerLumpedMass)
 {
     NuTo::DofType d("0", 1);
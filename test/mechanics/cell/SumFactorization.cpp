@@ -0,0 +1,141 @@
+#include "BoostUnitTest.h"
+
+#include "LobattoElement.h"
+#include "nuto/mechanics/cell/CellT.h"
+#include "nuto/mechanics/integrands/MomentumBalance.h"
+#include "nuto/mechanics/interpolation/InterpolationBrickLobatto.h"
+#include "nuto/mechanics/interpolation/InterpolationQuadLobatto.h"
+
+using namespace NuTo;
+
+//! @brief Lobatto element that is evaluated via CellT, SumFactorizedCell and SumFactorizedBatch
+template <int TDim, int TOrder, typename TInterpolation>
+struct LobattoCell : Test::LobattoElement<TDim, TInterpolation>
+{
+    static constexpr int NumNodes = (TOrder + 1) * (TOrder + 1) * (TDim == 3 ? TOrder + 1 : 1);
+    using Cell = CellT<TDim, NumNodes, NumNodes>;
+    using IpData = typename Cell::IpData;
+
+    LobattoCell(std::function<Eigen::VectorXd(Eigen::VectorXd)> transform)
+        : Test::LobattoElement<TDim, TInterpolation>(TOrder, transform)
+        , cell(*this->elements, this->integrationType, 0)
+        , momentumBalance(this->disp, this->law)
+    {
+    }
+
+    void Check()
+    {
+        SumFactorizedCell<TDim> sumFactorized(this->kernel, this->elements->CoordinateElement());
+        const auto& law = this->law;
+
+        const Eigen::VectorXd u = this->elements->DofElement(this->disp).ExtractNodeValues();
+        const Eigen::VectorXd x = Eigen::VectorXd::Random(u.rows());
+        const Eigen::VectorXd scalar = Eigen::VectorXd::Random(NumNodes);
+
+        auto Mass = [](const IpData& data) { return (data.Shape().transpose() * data.Shape()).eval(); };
+        BoostUnitTest::CheckEigenMatrix(sumFactorized.MassApply(scalar, 2.), 2. * cell.IntegrateT(Mass) * scalar);
+
+        auto VectorMass = [](const IpData& data) {
+            return (data.template N<TDim>().transpose() * data.template N<TDim>()).eval();
+        };
+        BoostUnitTest::CheckEigenMatrix(sumFactorized.MassApply(x), cell.IntegrateT(VectorMass) * x);
+
+        auto Laplace = [](const IpData& data) { return (data.BGradient().transpose() * data.BGradient()).eval(); };
+        BoostUnitTest::CheckEigenMatrix(sumFactorized.LaplaceApply(scalar, 3.), 3. * cell.IntegrateT(Laplace) * scalar);
+
+        BoostUnitTest::CheckEigenMatrix(sumFactorized.MomentumBalanceGradient(u, law, 0), CellGradient(), 1.e-8);
+        BoostUnitTest::CheckEigenMatrix(sumFactorized.MomentumBalanceHessian0Apply(u, x, law, 0), CellHessian0() * x,
+                                        1.e-8);
+        BoostUnitTest::CheckEigenMatrix(sumFactorized.MomentumBalanceHessian0(u, law, 0), CellHessian0(), 1.e-8);
+    }
+
+    void CheckBatch()
+    {
+        const DofType disp = this->disp;
+        SumFactorizedBatch<TDim> batch(*this->elements, this->kernel, disp, this->law);
+        BOOST_CHECK_EQUAL(batch.NumCells(), 1);
+        BOOST_CHECK(batch.IsHessian0Symmetric());
+
+        DofVector<double> gradient;
+        gradient[disp] = Eigen::VectorXd::Zero(this->NumDofs());
+        batch.AddGradient(&gradient, 0);
+        BoostUnitTest::CheckEigenMatrix(gradient[disp], CellGradient(), 1.e-8);
+
+        DofMatrixSparse<double> hessian;
+        hessian(disp, disp).resize(this->NumDofs(), this->NumDofs());
+        batch.AddHessian0(&hessian, 0);
+        BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(hessian(disp, disp)), CellHessian0(), 1.e-8);
+
+        const Eigen::VectorXd x = Eigen::VectorXd::Random(this->NumDofs());
+        Eigen::VectorXd product = Eigen::VectorXd::Zero(this->NumDofs());
+        batch.AddHessian0Product(x, product, 0);
+        BoostUnitTest::CheckEigenMatrix(product, CellHessian0() * x, 1.e-8);
+
+        Eigen::VectorXd diagonal = Eigen::VectorXd::Zero(this->NumDofs());
+        batch.AddHessian0Diagonal(diagonal, 0);
+        BoostUnitTest::CheckEigenMatrix(diagonal, CellHessian0().diagonal(), 1.e-8);
+    }
+
+    Eigen::VectorXd CellGradient()
+    {
+        return cell.IntegrateT([&](const IpData& data) { return momentumBalance.GradientT(data, 0); });
+    }
+
+    Eigen::MatrixXd CellHessian0()
+    {
+        return cell.IntegrateT([&](const IpData& data) { return momentumBalance.Hessian0T(data, 0); });
+    }
+
+    Cell cell;
+    Integrands::MomentumBalance<TDim> momentumBalance;
+};
+
+BOOST_AUTO_TEST_CASE(Interpolation1D)
+{
+    // the 1D sum factorization is just the dense product
+    IntegrationTypeTensorProduct<1> integrationType(3, eIntegrationMethod::GAUSS);
+    SumFactorization<1> kernel(2, integrationType);
+    BOOST_CHECK_EQUAL(kernel.GetNumNodes(), 3);
+    BOOST_CHECK_EQUAL(kernel.GetNumIntegrationPoints(), 3);
+
+    // nodes at -1, 0, 1, the linear function 2 + x is interpolated exactly
+    const Eigen::VectorXd values = Eigen::Vector3d(1, 2, 3);
+    for (int iIP = 0; iIP < 3; ++iIP)
+    {
+        const double ipCoord = integrationType.GetLocalIntegrationPointCoordinates(iIP)[0];
+        BOOST_CHECK_CLOSE(kernel.Interpolate(values)[iIP], 2 + ipCoord, 1.e-10);
+        BOOST_CHECK_CLOSE(kernel.InterpolateDerivatives(values)(iIP, 0), 1, 1.e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(QuadLobatto)
+{
+    LobattoCell<2, 3, InterpolationQuadLobatto> quad([](Eigen::VectorXd x) {
+        return Eigen::Vector2d(2 * x[0] + 0.1 * x[1] * x[1], x[1] + 0.2 * x[0] * x[1]);
+    });
+    quad.Check();
+    quad.CheckBatch();
+}
+
+BOOST_AUTO_TEST_CASE(BrickLobatto)
+{
+    LobattoCell<3, 2, InterpolationBrickLobatto> brick([](Eigen::VectorXd x) {
+        return Eigen::Vector3d(x[0] + 0.1 * x[1] * x[2], 2 * x[1] + 0.1 * x[0], 0.5 * x[2] + 0.1 * x[0] * x[1]);
+    });
+    brick.Check();
+    brick.CheckBatch();
+}
+
+BOOST_AUTO_TEST_CASE(WrongCoordinateElement)
+{
+    IntegrationTypeTensorProduct<2> integrationType(3, eIntegrationMethod::GAUSS);
+    SumFactorization<2> kernel(2, integrationType);
+
+    InterpolationQuadLobatto interpolation(1);
+    NodeSimple n0(Eigen::Vector2d(0, 0));
+    NodeSimple n1(Eigen::Vector2d(1, 0));
+    NodeSimple n2(Eigen::Vector2d(0, 1));
+    NodeSimple n3(Eigen::Vector2d(1, 1));
+    ElementFem element({n0, n1, n2, n3}, interpolation);
+    BOOST_CHECK_THROW(SumFactorizedCell<2>(kernel, element), Exception);
+}
@@ -0,0 +1,91 @@
+#include "BoostUnitTest.h"
+#include "nuto/mechanics/dofs/DofVectorConvertEigen.h"
+
+using namespace NuTo;
+
+struct TestVectors
+{
+    DofType dof0 = DofType("foo", 1);
+    DofType dof1 = DofType("bar", 1);
+
+    ContiguousDofVector<double> v0;
+    ContiguousDofVector<double> v1;
+
+    TestVectors()
+        : v0({dof1, dof0}, {2, 3})
+        , v1({dof1, dof0}, {2, 3})
+    {
+        v0[dof0] = Eigen::Vector3d({1, 2, 3});
+        v0[dof1] = Eigen::Vector2d({8, 9});
+
+        v1[dof0] = Eigen::Vector3d({10, 20, 30});
+        v1[dof1] = Eigen::Vector2d({80, 90});
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE(ContiguousDofVectorLayout, TestVectors)
+{
+    BOOST_CHECK_EQUAL(v0.Start(dof1), 0);
+    BOOST_CHECK_EQUAL(v0.Start(dof0), 2);
+    BOOST_CHECK_EQUAL(v0.Rows(dof0), 3);
+    BOOST_CHECK(v0.Has(dof0));
+    BOOST_CHECK(not v0.Has(DofType("baz", 1)));
+    BoostUnitTest::CheckEigenMatrix(v0.Values(), Eigen::Matrix<double, 5, 1>(8, 9, 1, 2, 3));
+    BOOST_CHECK_EQUAL(v0(dof0, 1), 2);
+
+    BOOST_CHECK(v0.SameLayout(v1));
+    BOOST_CHECK(not v0.SameLayout(ContiguousDofVector<double>({dof0, dof1}, {3, 2})));
+    BOOST_CHECK_THROW(v0 += ContiguousDofVector<double>({dof0, dof1}, {3, 2}), Exception);
+}
+
+BOOST_FIXTURE_TEST_CASE(ContiguousDofVectorArithmetic, TestVectors)
+{
+    v0 += v1;
+    BoostUnitTest::CheckEigenMatrix(v0[dof0], Eigen::Vector3d(11, 22, 33));
+    BoostUnitTest::CheckEigenMatrix(v0[dof1], Eigen::Vector2d(88, 99));
+
+    v0 -= v1;
+    BoostUnitTest::CheckEigenMatrix(v0[dof0], Eigen::Vector3d(1, 2, 3));
+
+    v0.AddScaled(v1, 0.5);
+    BoostUnitTest::CheckEigenMatrix(v0[dof1], Eigen::Vector2d(48, 54));
+
+    const ContiguousDofVector<double> v2 = 2 * (v1 - v0);
+    BoostUnitTest::CheckEigenMatrix(v2[dof0], Eigen::Vector3d(8, 16, 24));
+}
+
+BOOST_FIXTURE_TEST_CASE(ContiguousDofVectorAdoptsMemory, TestVectors)
+{
+    Eigen::VectorXd values = Eigen::VectorXd::LinSpaced(5, 0, 4);
+    const double* data = values.data();
+    ContiguousDofVector<double> v({dof1, dof0}, {2, 3}, std::move(values));
+    BOOST_CHECK(v.Values().data() == data);
+    BoostUnitTest::CheckEigenMatrix(v[dof0], Eigen::Vector3d(2, 3, 4));
+
+    BOOST_CHECK_THROW(ContiguousDofVector<double>({dof1, dof0}, {2, 3}, Eigen::VectorXd(4)), Exception);
+    BOOST_CHECK_THROW(ContiguousDofVector<double>({dof1, dof0}, {2}), Exception);
+}
+
+BOOST_FIXTURE_TEST_CASE(ContiguousDofVectorConversion, TestVectors)
+{
+    const DofVector<double> dofVector = v0.ToDofVector();
+    BoostUnitTest::CheckEigenMatrix(dofVector[dof0], Eigen::Vector3d(1, 2, 3));
+
+    const ContiguousDofVector<double> v(dofVector, {dof1, dof0});
+    BoostUnitTest::CheckEigenMatrix(v.Values(), v0.Values());
+}
+
+BOOST_FIXTURE_TEST_CASE(ContiguousDofVectorToEigen, TestVectors)
+{
+    // views without copies
+    BOOST_CHECK(ToEigen(v0, {dof1, dof0}).data() == v0.Values().data());
+    BOOST_CHECK(ToEigen(v0, {dof0}).data() == v0[dof0].data());
+    BoostUnitTest::CheckEigenMatrix(ToEigen(v0, {dof0}), Eigen::Vector3d(1, 2, 3));
+    BOOST_CHECK_EQUAL(TotalRows(v0, {dof1, dof0}), 5);
+
+    // dofs in a different order are not a consecutive segment
+    BOOST_CHECK_THROW(ToEigen(v0, {dof0, dof1}), Exception);
+
+    FromEigen(Eigen::VectorXd(Eigen::Vector3d(7, 6, 5)), {dof0}, &v0);
+    BoostUnitTest::CheckEigenMatrix(v0.Values(), Eigen::Matrix<double, 5, 1>(8, 9, 7, 6, 5));
+}
@@ -42,3 +42,42 @@ BOOST_AUTO_TEST_CASE(DofContainerAccessMany)
         BOOST_CHECK_NO_THROW(container[dof]);
     }
 }
+
+BOOST_AUTO_TEST_CASE(DofContainerIteration)
+{
+    NuTo::DofType dof0("0", 1);
+    NuTo::DofType dof1("1", 1);
+    NuTo::DofType dof2("2", 1);
+
+    NuTo::DofContainer<int> container;
+    BOOST_CHECK(container.begin() == container.end());
+
+    container[dof2] = 2;
+    container[dof0] = 0;
+    BOOST_CHECK(container.Has(dof0));
+    BOOST_CHECK(not container.Has(dof1));
+    BOOST_CHECK(container.Has(dof2));
+    BOOST_CHECK_THROW(static_cast<const NuTo::DofContainer<int>&>(container)[dof1], NuTo::Exception);
+    BOOST_CHECK_THROW(container.At(dof1), NuTo::Exception);
+
+    // entries are visited in the order of the dof type ids, not in the order of insertion
+    std::vector<int> values;
+    for (const auto& entry : container)
+    {
+        BOOST_CHECK_EQUAL(entry.first.Id(), entry.second == 0 ? dof0.Id() : dof2.Id());
+        values.push_back(entry.second);
+    }
+    const std::vector<int> expected = {0, 2};
+    BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.end(), expected.begin(), expected.end());
+
+    for (auto& entry : container)
+        entry.second *= 10;
+    BOOST_CHECK_EQUAL(container[dof2], 20);
+
+    NuTo::DofContainer<int> copy;
+    copy[dof1] = 1;
+    copy = container;
+    BOOST_CHECK(not copy.Has(dof1));
+    BOOST_CHECK_EQUAL(copy[dof0], 0);
+    BOOST_CHECK_EQUAL(copy[dof2], 20);
+}
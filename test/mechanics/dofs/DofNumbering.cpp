@@ -1,6 +1,8 @@
 #include "BoostUnitTest.h"
 
+#include <boost/ptr_container/ptr_vector.hpp>
 #include "nuto/mechanics/dofs/DofNumbering.h"
+#include "nuto/mechanics/interpolation/InterpolationTrussLinear.h"
 
 // wrap algorithm to provide range-like interface
 bool IsPermutation(std::vector<int> v0, std::vector<int> v1)
@@ -59,3 +61,48 @@ BOOST_AUTO_TEST_CASE(Extract)
     BOOST_CHECK_NO_THROW(DofNumbering::Get({}));
     BOOST_CHECK(DofNumbering::Get({}).empty());
 }
+
+BOOST_AUTO_TEST_CASE(Ordering)
+{
+    // chain of truss elements 0 - 1 - 2 - ... - 9, the nodes are added to the group in a shuffled order
+    const int numNodes = 10;
+    std::vector<NodeSimple> nodes(numNodes, NodeSimple(Eigen::Vector2d::Zero()));
+    InterpolationTrussLinear interpolation;
+    boost::ptr_vector<ElementCollectionFem> elements;
+    Group<ElementCollectionFem> elementGroup;
+    for (int i = 0; i + 1 < numNodes; ++i)
+    {
+        elements.push_back(new ElementCollectionFem({{nodes[i], nodes[i + 1]}, interpolation}));
+        elements.back().AddDofElement(d, {{nodes[i], nodes[i + 1]}, interpolation});
+        elementGroup.Add(elements.back());
+    }
+
+    Group<NodeSimple> group;
+    for (int i : {3, 7, 0, 9, 5, 1, 8, 2, 6, 4})
+        group.Add(nodes[i]);
+
+    Constraint::Constraints constraints;
+    constraints.Add(d, {nodes[0], 0, rhs});
+
+    for (auto ordering : {eDofOrdering::RCM, eDofOrdering::NESTED_DISSECTION})
+    {
+        auto dofInfo = DofNumbering::Build(group, d, constraints, elementGroup, ordering);
+        BOOST_CHECK_EQUAL(dofInfo.numDependentDofs[d], 1);
+        BOOST_CHECK_EQUAL(dofInfo.numIndependentDofs[d], 2 * numNodes - 1);
+
+        std::vector<int> dofNumbers;
+        for (const auto& node : nodes)
+        {
+            // the components of a node stay consecutive
+            BOOST_CHECK_EQUAL(node.GetDofNumber(1), node.GetDofNumber(0) + 1);
+            dofNumbers.push_back(node.GetDofNumber(0));
+        }
+        std::vector<int> expected(numNodes);
+        std::generate(expected.begin(), expected.end(), [n = 0]() mutable { return 2 * n++; });
+        BOOST_CHECK(IsPermutation(dofNumbers, expected));
+
+        if (ordering == eDofOrdering::RCM)
+            for (int i = 0; i + 1 < numNodes; ++i)
+                BOOST_CHECK_EQUAL(std::abs(dofNumbers[i + 1] - dofNumbers[i]), 2);
+    }
+}
@@ -50,3 +50,20 @@ BOOST_AUTO_TEST_CASE(ExtractNodeValueInstances)
     BoostUnitTest::CheckEigenMatrix(e.ExtractNodeValues(), Eigen::Vector3d::Zero());
     BoostUnitTest::CheckEigenMatrix(e.ExtractNodeValues(1), Eigen::Vector3d(42, 43, 44));
 }
+
+BOOST_AUTO_TEST_CASE(ElementSharedConnectivity)
+{
+    NuTo::ElementConnectivity connectivity(interpolation);
+    connectivity.Add({n0, n1, n2});
+    connectivity.Add(std::vector<NuTo::NodeSimple*>{&n2, &n0, &n1});
+    BOOST_CHECK_EQUAL(connectivity.Size(), 2);
+
+    NuTo::ElementFem e(&connectivity, 1);
+    BOOST_CHECK_EQUAL(e.GetNumNodes(), 3);
+    BOOST_CHECK_EQUAL(&e.GetNode(0), &n2);
+    BoostUnitTest::CheckVector(e.ExtractNodeValues(), std::vector<double>{1, 7, 1, 1, 5, 1}, 6);
+
+    // copies are views on the same nodes
+    NuTo::ElementFem copy = e;
+    BOOST_CHECK_EQUAL(&copy.GetNode(2), &n1);
+}
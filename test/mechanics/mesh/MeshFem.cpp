@@ -35,6 +35,32 @@ NuTo::MeshFem DummyMesh(NuTo::DofType dofType)
     return mesh;
 }
 
+BOOST_AUTO_TEST_CASE(MeshCreateElement)
+{
+    NuTo::DofType dof("Dof", 1);
+    NuTo::MeshFem mesh;
+    auto& interpolation = mesh.CreateInterpolation(NuTo::InterpolationTrussLinear());
+
+    auto& n0 = mesh.Nodes.Add(0);
+    auto& n1 = mesh.Nodes.Add(1);
+    auto& n2 = mesh.Nodes.Add(2);
+    mesh.Elements.Add(mesh.CreateElement({n0, n1}, interpolation));
+    mesh.Elements.Add(mesh.CreateElement({n1, n2}, interpolation));
+
+    NuTo::AddDofInterpolation(&mesh, dof);
+
+    const NuTo::ElementConnectivity& coordinates = mesh.Connectivity(boost::none, interpolation);
+    BOOST_CHECK_EQUAL(coordinates.Size(), 2);
+    BOOST_CHECK_EQUAL(&coordinates.Node(1, 0), &n1);
+    BOOST_CHECK_EQUAL(&mesh.Elements[1].CoordinateElement().GetNode(1), &n2);
+
+    // the dof elements share the nodes at x = 1 and are stored in their own connectivity
+    const NuTo::ElementConnectivity& dofs = mesh.Connectivity(dof, interpolation);
+    BOOST_CHECK_EQUAL(dofs.Size(), 2);
+    BOOST_CHECK_EQUAL(&dofs.Node(0, 1), &dofs.Node(1, 0));
+    BOOST_CHECK_EQUAL(&mesh.Elements[1].DofElement(dof).GetNode(1), &dofs.Node(1, 1));
+}
+
 BOOST_AUTO_TEST_CASE(AllocateInstances)
 {
     NuTo::DofType d("Dof", 1);
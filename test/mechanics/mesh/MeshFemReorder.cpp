@@ -0,0 +1,71 @@
+#include "BoostUnitTest.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include "nuto/mechanics/mesh/MeshFemReorder.h"
+#include "nuto/mechanics/mesh/UnitMeshFem.h"
+
+using namespace NuTo;
+
+Eigen::VectorXd Centroid(const ElementCollectionFem& element)
+{
+    const auto& coordinates = element.CoordinateElement();
+    Eigen::VectorXd centroid = Eigen::VectorXd::Zero(2);
+    for (int iNode = 0; iNode < coordinates.GetNumNodes(); ++iNode)
+        centroid += coordinates.GetNode(iNode).GetValues();
+    return centroid / coordinates.GetNumNodes();
+}
+
+//! @brief mean distance between the centroids of consecutive elements
+double MeanJump(const MeshFem& mesh)
+{
+    double sum = 0;
+    for (size_t i = 1; i < mesh.Elements.Size(); ++i)
+        sum += (Centroid(mesh.Elements[i]) - Centroid(mesh.Elements[i - 1])).norm();
+    return sum / (mesh.Elements.Size() - 1);
+}
+
+MeshFem ShuffledMesh(int n)
+{
+    MeshFem mesh = UnitMeshFem::CreateQuads(n, n);
+    std::vector<int> order(mesh.Elements.Size());
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(6174));
+    mesh.Elements.Reorder(order);
+    return mesh;
+}
+
+BOOST_AUTO_TEST_CASE(ReorderElements)
+{
+    const int n = 16;
+    const double h = 1. / n;
+    for (auto curve : {eSpaceFillingCurve::MORTON, eSpaceFillingCurve::HILBERT})
+    {
+        MeshFem mesh = ShuffledMesh(n);
+        BOOST_CHECK_GT(MeanJump(mesh), 5 * h);
+
+        const auto& firstElement = mesh.Elements[0];
+        const auto& someNode = mesh.NodeAtCoordinate(Eigen::Vector2d(0.5, 0.5));
+        ReorderAlongCurve(&mesh, curve);
+
+        BOOST_CHECK_LT(MeanJump(mesh), 2 * h);
+        BOOST_CHECK_EQUAL(mesh.Elements.Size(), n * n);
+        BOOST_CHECK_EQUAL(mesh.Nodes.Size(), (n + 1) * (n + 1));
+
+        // references stay valid
+        BOOST_CHECK(std::any_of(mesh.Elements.begin(), mesh.Elements.end(),
+                                [&](const auto& element) { return &element == &firstElement; }));
+        BOOST_CHECK_EQUAL(&mesh.NodeAtCoordinate(Eigen::Vector2d(0.5, 0.5)), &someNode);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ReorderNodes)
+{
+    MeshFem mesh = ShuffledMesh(4);
+    ReorderAlongCurve(&mesh);
+
+    // the nodes of the first element come first
+    const auto& firstElement = mesh.Elements[0].CoordinateElement();
+    for (int iNode = 0; iNode < firstElement.GetNumNodes(); ++iNode)
+        BOOST_CHECK_EQUAL(&mesh.Nodes[iNode], &firstElement.GetNode(iNode));
+}
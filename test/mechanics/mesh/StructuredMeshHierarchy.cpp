@@ -0,0 +1,125 @@
+#include "BoostUnitTest.h"
+#include "nuto/base/Exception.h"
+#include "nuto/mechanics/mesh/StructuredMeshHierarchy.h"
+#include "nuto/mechanics/mesh/MeshFemDofConvert.h"
+#include "nuto/mechanics/mesh/UnitMeshFem.h"
+
+using namespace NuTo;
+
+//! @brief numbers the dofs of `dof` consecutively
+void NumberDofs(MeshFem* rMesh, DofType dof)
+{
+    int dofNumber = 0;
+    for (NodeSimple& node : rMesh->NodesTotal(dof))
+        for (int component = 0; component < dof.GetNum(); ++component)
+            node.SetDofNumber(component, dofNumber++);
+}
+
+//! @return values of the linear `f` at the nodes of the isoparametric `dof` elements of `mesh`
+Eigen::VectorXd LinearField(const MeshFem& mesh, DofType dof, std::function<Eigen::VectorXd(Eigen::VectorXd)> f)
+{
+    int numDofs = 0;
+    std::vector<std::pair<int, double>> values;
+    for (const ElementCollectionFem& element : mesh.Elements)
+        for (int iNode = 0; iNode < element.CoordinateElement().GetNumNodes(); ++iNode)
+        {
+            const Eigen::VectorXd value = f(element.CoordinateElement().GetNode(iNode).GetValues());
+            const NodeSimple& dofNode = element.DofElement(dof).GetNode(iNode);
+            for (int component = 0; component < dof.GetNum(); ++component)
+            {
+                values.emplace_back(dofNode.GetDofNumber(component), value[component]);
+                numDofs = std::max(numDofs, dofNode.GetDofNumber(component) + 1);
+            }
+        }
+    Eigen::VectorXd field(numDofs);
+    for (const auto& value : values)
+        field[value.first] = value.second;
+    return field;
+}
+
+//! @brief checks that the prolongators reproduce a linear field and are a partition of unity
+void CheckProlongators(const StructuredMeshHierarchy& hierarchy, DofType dof,
+                       std::function<Eigen::VectorXd(Eigen::VectorXd)> f)
+{
+    for (int level = 0; level + 1 < hierarchy.NumLevels(); ++level)
+    {
+        const Eigen::SparseMatrix<double> P = hierarchy.Prolongator(level);
+        const Eigen::VectorXd fine = LinearField(hierarchy.Mesh(level), dof, f);
+        const Eigen::VectorXd coarse = LinearField(hierarchy.Mesh(level + 1), dof, f);
+        BOOST_CHECK_EQUAL(P.rows(), fine.rows());
+        BOOST_CHECK_EQUAL(P.cols(), coarse.rows());
+        BoostUnitTest::CheckEigenMatrix(P * coarse, fine, 1.e-10);
+
+        const Eigen::VectorXd rowSums = P * Eigen::VectorXd::Ones(P.cols());
+        BoostUnitTest::CheckEigenMatrix(rowSums, Eigen::VectorXd::Ones(P.rows()), 1.e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(HierarchyQuads)
+{
+    auto transformation = [](Eigen::VectorXd x) { return Eigen::Vector2d(2 * x[0] + 0.1 * x[1], x[1]); };
+    MeshFem mesh = UnitMeshFem::Transform(UnitMeshFem::CreateQuads(8, 4), transformation);
+    DofType disp("Displacements", 2);
+    AddDofInterpolation(&mesh, disp);
+    NumberDofs(&mesh, disp);
+
+    StructuredMeshHierarchy hierarchy(mesh, {8, 4}, {disp});
+    BOOST_CHECK_EQUAL(hierarchy.NumLevels(), 3);
+    BOOST_CHECK(hierarchy.Divisions(1) == std::vector<int>({4, 2}));
+    BOOST_CHECK(hierarchy.Divisions(2) == std::vector<int>({2, 1}));
+    BOOST_CHECK_EQUAL(hierarchy.Mesh(1).Elements.Size(), 8);
+
+    // the coarse vertices follow the transformation
+    for (const NodeSimple& node : hierarchy.Mesh(1).Nodes)
+    {
+        if (node.GetNumValues() != 2 or node.GetDofNumber(0) != -1)
+            continue;
+        const double y = node.GetValues()[1];
+        const double x = (node.GetValues()[0] - 0.1 * y) / 2.;
+        BOOST_CHECK_SMALL(4 * x - std::round(4 * x), 1.e-10);
+        BOOST_CHECK_SMALL(2 * y - std::round(2 * y), 1.e-10);
+    }
+
+    CheckProlongators(hierarchy, disp,
+                      [](Eigen::VectorXd x) { return Eigen::Vector2d(1 + 2 * x[0] - 3 * x[1], x[0]); });
+    BOOST_CHECK_EQUAL(hierarchy.Prolongators().size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(HierarchyBricks)
+{
+    MeshFem mesh = UnitMeshFem::CreateBricks(4, 4, 2);
+    DofType temperature("Temperature", 1);
+    DofType disp("Displacements", 3);
+    AddDofInterpolation(&mesh, temperature);
+    AddDofInterpolation(&mesh, disp);
+    NumberDofs(&mesh, temperature);
+    NumberDofs(&mesh, disp);
+
+    StructuredMeshHierarchy hierarchy(mesh, {4, 4, 2}, {temperature, disp}, 2);
+    BOOST_CHECK_EQUAL(hierarchy.NumLevels(), 2);
+
+    // block diagonal in the order of the dofs
+    const Eigen::SparseMatrix<double> P = hierarchy.Prolongator(0);
+    const int numFine = 5 * 5 * 3;
+    const int numCoarse = 3 * 3 * 2;
+    BOOST_CHECK_EQUAL(P.rows(), 4 * numFine);
+    BOOST_CHECK_EQUAL(P.cols(), 4 * numCoarse);
+    BOOST_CHECK_SMALL(Eigen::MatrixXd(P).topRightCorner(numFine, 3 * numCoarse).norm(), 1.e-14);
+
+    StructuredMeshHierarchy dispHierarchy(mesh, {4, 4, 2}, {disp});
+    CheckProlongators(dispHierarchy, disp, [](Eigen::VectorXd x) { return Eigen::Vector3d(x[0], -x[2], x[1] + x[2]); });
+}
+
+BOOST_AUTO_TEST_CASE(HierarchyErrors)
+{
+    MeshFem mesh = UnitMeshFem::CreateQuads(4, 2);
+    DofType disp("Displacements", 2);
+    BOOST_CHECK_THROW(StructuredMeshHierarchy(mesh, {4, 2}, {disp}), Exception);
+
+    AddDofInterpolation(&mesh, disp);
+    BOOST_CHECK_THROW(StructuredMeshHierarchy(mesh, {4, 4}, {disp}), Exception);
+
+    StructuredMeshHierarchy hierarchy(mesh, {4, 2}, {disp});
+    BOOST_CHECK_THROW(hierarchy.Prolongator(0), Exception);
+    BOOST_CHECK_THROW(hierarchy.Prolongator(hierarchy.NumLevels() - 1), Exception);
+}
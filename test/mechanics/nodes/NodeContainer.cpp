@@ -0,0 +1,76 @@
+#include "BoostUnitTest.h"
+#include "nuto/mechanics/nodes/NodeContainer.h"
+
+using namespace NuTo;
+
+BOOST_AUTO_TEST_CASE(NodeContainerAdd)
+{
+    NodeContainer nodes;
+    NodeSimple& n0 = nodes.Add(Eigen::Vector2d(0, 1));
+    NodeSimple& n1 = nodes.Add(42);
+    NodeSimple& n2 = nodes.Add(Eigen::Vector2d(2, 3));
+
+    BOOST_CHECK_EQUAL(nodes.Size(), 3);
+    BOOST_CHECK_EQUAL(&nodes[1], &n1);
+    BOOST_CHECK_EQUAL(n1.GetDofNumber(0), 0);
+    BoostUnitTest::CheckEigenMatrix(n2.GetValues(), Eigen::Vector2d(2, 3));
+
+    // coordinate nodes of the same dimension share a storage
+    BOOST_CHECK(n2.GetValues().data() == n0.GetValues().data() + 2);
+
+    DofType dof("dof", 2);
+    NodeSimple& d0 = nodes.AddDofNode(dof, Eigen::Vector2d(4, 5));
+    NodeSimple& d1 = nodes.AddDofNode(dof, Eigen::Vector2d(6, 7));
+    BOOST_CHECK_EQUAL(d0.Index(), 0);
+    BOOST_CHECK(d1.GetValues().data() == d0.GetValues().data() + 2);
+    BOOST_CHECK_EQUAL(d1.GetDofNumber(1), -1);
+}
+
+BOOST_AUTO_TEST_CASE(NodeContainerReorder)
+{
+    NodeContainer nodes;
+    NodeSimple& n0 = nodes.Add(Eigen::Vector2d(0, 0));
+    NodeSimple& n1 = nodes.Add(Eigen::Vector2d(1, 1));
+    NodeSimple& n2 = nodes.Add(Eigen::Vector2d(2, 2));
+    n2.SetDofNumber(0, 2);
+
+    nodes.Reorder({2, 0, 1});
+
+    // references stay valid
+    BOOST_CHECK_EQUAL(&nodes[0], &n2);
+    BOOST_CHECK_EQUAL(&nodes[1], &n0);
+    BOOST_CHECK_EQUAL(&nodes[2], &n1);
+    BoostUnitTest::CheckEigenMatrix(n2.GetValues(), Eigen::Vector2d(2, 2));
+    BOOST_CHECK_EQUAL(n2.GetDofNumber(0), 2);
+
+    // the storage follows the new order
+    BOOST_CHECK_EQUAL(n2.Index(), 0);
+    BOOST_CHECK(n0.GetValues().data() == n2.GetValues().data() + 2);
+}
+
+BOOST_AUTO_TEST_CASE(NodeContainerReorderAfterErase)
+{
+    NodeContainer nodes;
+    NodeSimple& n0 = nodes.Add(Eigen::Vector2d(0, 0));
+    nodes.Add(Eigen::Vector2d(1, 1));
+    NodeSimple& n2 = nodes.Add(Eigen::Vector2d(2, 2));
+    nodes.Erase(nodes.begin() + 1);
+
+    nodes.Reorder({1, 0});
+
+    // the values of the erased node are removed, the storage follows the new order
+    BOOST_CHECK_EQUAL(n2.Index(), 0);
+    BOOST_CHECK_EQUAL(n0.Index(), 1);
+    BoostUnitTest::CheckEigenMatrix(n2.GetValues(), Eigen::Vector2d(2, 2));
+    BoostUnitTest::CheckEigenMatrix(n0.GetValues(), Eigen::Vector2d(0, 0));
+    BOOST_CHECK(n0.GetValues().data() == n2.GetValues().data() + 2);
+}
+
+BOOST_AUTO_TEST_CASE(NodeContainerMove)
+{
+    NodeContainer nodes;
+    NodeSimple& n0 = nodes.Add(Eigen::Vector2d(0, 1));
+    NodeContainer moved = std::move(nodes);
+    BOOST_CHECK_EQUAL(&moved[0], &n0);
+    BoostUnitTest::CheckEigenMatrix(moved[0].GetValues(), Eigen::Vector2d(0, 1));
+}
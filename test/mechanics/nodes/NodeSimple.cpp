@@ -46,3 +46,53 @@ BOOST_AUTO_TEST_CASE(NodeSimpleInstances)
     node.SetValues(Eigen::Vector3d(6174, 0, 0), 2);
     BoostUnitTest::CheckEigenMatrix(node.GetValues(2), Eigen::Vector3d(6174, 0, 0));
 }
+
+BOOST_AUTO_TEST_CASE(NodeSimpleSharedStorage)
+{
+    NuTo::NodeStorage storage(2);
+    NuTo::NodeSimple node0(&storage, storage.Add(Eigen::Vector2d(1, 2)));
+    NuTo::NodeSimple node1(&storage, storage.Add(Eigen::Vector2d(3, 4)));
+
+    node1.SetValue(1, 42);
+    node1.SetDofNumber(0, 6174);
+    BoostUnitTest::CheckEigenMatrix(storage.Values(1, 0), Eigen::Vector2d(3, 42));
+    BOOST_CHECK_EQUAL(storage.DofNumber(1, 0), 6174);
+
+    // the values of both nodes are contiguous
+    BOOST_CHECK(node1.GetValues().data() == node0.GetValues().data() + 2);
+
+    // a copy owns its values
+    NuTo::NodeSimple copy = node1;
+    copy.SetValue(0, 0);
+    BoostUnitTest::CheckEigenMatrix(node1.GetValues(), Eigen::Vector2d(3, 42));
+    BOOST_CHECK_EQUAL(copy.GetDofNumber(0), 6174);
+
+    node0.AllocateInstances(3);
+    BOOST_CHECK_EQUAL(node0.GetNumInstances(), 3);
+    BOOST_CHECK_EQUAL(node1.GetNumInstances(), 1);
+    BoostUnitTest::CheckEigenMatrix(node0.GetValues(2), Eigen::Vector2d::Zero());
+}
+
+BOOST_AUTO_TEST_CASE(NodeSimpleAssignToSharedStorage)
+{
+    NuTo::NodeStorage storage(2);
+    NuTo::NodeSimple node(&storage, storage.Add(Eigen::Vector2d(1, 2)));
+
+    // assignment copies into the slot of the storage instead of detaching the node
+    NuTo::NodeSimple other(Eigen::Vector2d(3, 4));
+    other.SetDofNumber(1, 6174);
+    node = other;
+    BOOST_CHECK_EQUAL(node.Index(), 0);
+    BoostUnitTest::CheckEigenMatrix(storage.Values(0, 0), Eigen::Vector2d(3, 4));
+    BOOST_CHECK_EQUAL(storage.DofNumber(0, 1), 6174);
+
+    node = NuTo::NodeSimple(Eigen::Vector2d(5, 6));
+    BoostUnitTest::CheckEigenMatrix(storage.Values(0, 0), Eigen::Vector2d(5, 6));
+
+    BOOST_CHECK_THROW(node = NuTo::NodeSimple(42.), NuTo::Exception);
+
+    // nodes with their own storage may change their number of values
+    other = NuTo::NodeSimple(42.);
+    BOOST_CHECK_EQUAL(other.GetNumValues(), 1);
+    BOOST_CHECK_EQUAL(other.GetValues()[0], 42.);
+}
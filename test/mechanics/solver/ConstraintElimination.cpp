@@ -0,0 +1,142 @@
+#include "BoostUnitTest.h"
+#include "nuto/mechanics/solver/ConstraintElimination.h"
+#include "nuto/mechanics/nodes/NodeSimple.h"
+#include "nuto/mechanics/constraints/ConstraintCompanion.h"
+
+using namespace NuTo;
+using namespace NuTo::Constraint;
+
+const DofType dof0("Fred", 1);
+const DofType dof1("Barney", 1);
+
+//! @brief two dof types with 4 and 3 dofs
+struct TwoDofTypes
+{
+    TwoDofTypes()
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            nodes0.emplace_back(0.);
+            nodes0.back().SetDofNumber(0, i);
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            nodes1.emplace_back(0.);
+            nodes1.back().SetDofNumber(0, i);
+        }
+        sizes[dof0] = Eigen::VectorXd::Zero(4);
+        sizes[dof1] = Eigen::VectorXd::Zero(3);
+
+        K = RandomMatrix();
+    }
+
+    Eigen::SparseMatrix<double> RandomMatrix() const
+    {
+        Eigen::MatrixXd dense = Eigen::MatrixXd::Random(7, 7);
+        dense(0, 6) = 0;
+        dense(6, 0) = 0;
+        return dense.sparseView();
+    }
+
+    //! @brief C^T K C, C^T f and C u with the unit constraint matrix C
+    void CheckAgainstUnitConstraintMatrix(const Constraints& constraints)
+    {
+        Eigen::SparseMatrix<double> C0 = constraints.BuildUnitConstraintMatrix(dof0, 4);
+        Eigen::SparseMatrix<double> C1 = constraints.BuildUnitConstraintMatrix(dof1, 3);
+        Eigen::MatrixXd C = Eigen::MatrixXd::Zero(7, C0.cols() + C1.cols());
+        C.topLeftCorner(4, C0.cols()) = C0;
+        C.bottomRightCorner(3, C1.cols()) = C1;
+
+        ConstraintElimination elimination(constraints, {dof0, dof1}, sizes);
+        BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(elimination.Reduce(K)), C.transpose() * K * C);
+
+        // new values, same pattern
+        Eigen::SparseMatrix<double> K2 = 2. * K;
+        BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(elimination.Reduce(K2)), C.transpose() * K2 * C);
+
+        // new pattern
+        Eigen::SparseMatrix<double> K3 = K;
+        K3.coeffRef(0, 6) = 1.;
+        K3.makeCompressed();
+        BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(elimination.Reduce(K3)), C.transpose() * K3 * C);
+
+        Eigen::VectorXd f = Eigen::VectorXd::Random(7);
+        BoostUnitTest::CheckEigenMatrix(elimination.Restrict(f), C.transpose() * f);
+
+        Eigen::VectorXd uJ = Eigen::VectorXd::Random(C.cols());
+        BoostUnitTest::CheckEigenMatrix(elimination.Prolongate(uJ), C * uJ);
+        BoostUnitTest::CheckEigenMatrix(elimination.SelectIndependent(elimination.Prolongate(uJ)), uJ);
+    }
+
+    std::vector<NodeSimple> nodes0;
+    std::vector<NodeSimple> nodes1;
+    DofVector<double> sizes;
+    Eigen::SparseMatrix<double> K;
+};
+
+BOOST_FIXTURE_TEST_CASE(EliminationDirichlet, TwoDofTypes)
+{
+    Constraints constraints;
+    constraints.Add(dof0, Equation(nodes0[2], 0, RhsConstant(0)));
+    constraints.Add(dof0, Equation(nodes0[0], 0, RhsConstant(0)));
+    constraints.Add(dof1, Equation(nodes1[1], 0, RhsConstant(0)));
+
+    BOOST_CHECK(ConstraintElimination(constraints, {dof0, dof1}, sizes).IsDirichlet());
+    CheckAgainstUnitConstraintMatrix(constraints);
+}
+
+BOOST_FIXTURE_TEST_CASE(EliminationLinear, TwoDofTypes)
+{
+    Constraints constraints;
+    Equation periodic(nodes0[3], 0, RhsConstant(0));
+    periodic.AddIndependentTerm(Term(nodes0[1], 0, -2.));
+    constraints.Add(dof0, periodic);
+    constraints.Add(dof1, Equation(nodes1[0], 0, RhsConstant(0)));
+
+    BOOST_CHECK(not ConstraintElimination(constraints, {dof0, dof1}, sizes).IsDirichlet());
+    CheckAgainstUnitConstraintMatrix(constraints);
+}
+
+BOOST_FIXTURE_TEST_CASE(EliminationMatches, TwoDofTypes)
+{
+    Constraints constraints;
+    constraints.Add(dof0, Equation(nodes0[0], 0, RhsConstant(0)));
+    ConstraintElimination elimination(constraints, {dof0, dof1}, sizes);
+    BOOST_CHECK(elimination.Matches(constraints, sizes));
+
+    constraints.Add(dof1, Equation(nodes1[0], 0, RhsConstant(0)));
+    BOOST_CHECK(not elimination.Matches(constraints, sizes));
+
+    DofVector<double> otherSizes = sizes;
+    otherSizes[dof0] = Eigen::VectorXd::Zero(5);
+    BOOST_CHECK(not ConstraintElimination(constraints, {dof0, dof1}, sizes).Matches(constraints, otherSizes));
+}
+
+BOOST_FIXTURE_TEST_CASE(EliminationMatchesTerms, TwoDofTypes)
+{
+    Constraints constraints;
+    Equation periodic(nodes0[3], 0, RhsConstant(0));
+    periodic.AddIndependentTerm(Term(nodes0[1], 0, -2.));
+    constraints.Add(dof0, periodic);
+    ConstraintElimination elimination(constraints, {dof0, dof1}, sizes);
+    BOOST_CHECK(elimination.Matches(constraints, sizes));
+
+    // same number of equations, other coefficient
+    Constraints otherCoefficient;
+    Equation periodic2(nodes0[3], 0, RhsConstant(0));
+    periodic2.AddIndependentTerm(Term(nodes0[1], 0, -1.));
+    otherCoefficient.Add(dof0, periodic2);
+    BOOST_CHECK(not elimination.Matches(otherCoefficient, sizes));
+
+    // same number of equations, other dependent dof
+    Constraints otherNode;
+    Equation periodic3(nodes0[2], 0, RhsConstant(0));
+    periodic3.AddIndependentTerm(Term(nodes0[1], 0, -2.));
+    otherNode.Add(dof0, periodic3);
+    BOOST_CHECK(not elimination.Matches(otherNode, sizes));
+
+    // renumbering of the constrained nodes
+    nodes0[3].SetDofNumber(0, 0);
+    nodes0[0].SetDofNumber(0, 3);
+    BOOST_CHECK(not elimination.Matches(constraints, sizes));
+}
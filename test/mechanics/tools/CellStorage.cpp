@@ -0,0 +1,97 @@
+#include "BoostUnitTest.h"
+#include "nuto/mechanics/tools/CellStorage.h"
+#include "nuto/mechanics/cell/SimpleAssembler.h"
+#include "nuto/mechanics/dofs/DofNumbering.h"
+#include "nuto/mechanics/mesh/UnitMeshFem.h"
+#include "nuto/mechanics/mesh/MeshFemDofConvert.h"
+#include "nuto/mechanics/integrationtypes/IntegrationTypeTensorProduct.h"
+
+using namespace NuTo;
+
+BOOST_AUTO_TEST_CASE(CellStorageRanges)
+{
+    MeshFem mesh = UnitMeshFem::CreateLines(10);
+    IntegrationTypeTensorProduct<1> integration(2, eIntegrationMethod::GAUSS);
+
+    CellStorage storage;
+    Group<CellInterface> cells = storage.AddCells(mesh.ElementsTotal(), integration);
+    BOOST_CHECK_EQUAL(storage.Size(), 10);
+
+    std::vector<CellRange> ranges = storage.Ranges(3);
+    BOOST_CHECK_EQUAL(ranges.size(), 4);
+    BOOST_CHECK_EQUAL(ranges.back().Size(), 1);
+
+    // the ranges visit the cells in the order of their creation
+    BOOST_CHECK_EQUAL(&ranges[1][2], &cells[5]);
+    int numCells = 0;
+    for (const CellRange& range : ranges)
+        for (Cell& cell : range)
+            BOOST_CHECK_EQUAL(&cell, &cells[numCells++]);
+    BOOST_CHECK_EQUAL(numCells, 10);
+
+    // compile time specialized cells are stored in a separate pool
+    auto cellsT = storage.AddCellsT<1, 2, 2>(mesh.ElementsTotal(), integration, 10);
+    BOOST_CHECK_EQUAL(storage.Size(), 20);
+    ranges = storage.Ranges(100);
+    BOOST_CHECK_EQUAL(ranges.size(), 2);
+    BOOST_CHECK_EQUAL(&ranges[1][3], &cellsT[3]);
+    BOOST_CHECK_EQUAL(ranges[1][3].Id(), 13);
+
+    // a const storage only hands out read only cells
+    const CellStorage& constStorage = storage;
+    std::vector<ConstCellRange> constRanges = constStorage.Ranges(100);
+    BOOST_CHECK_EQUAL(constRanges.size(), 2);
+    BOOST_CHECK_EQUAL(&constRanges[1][3], &cellsT[3]);
+    static_assert(std::is_same<decltype(constRanges[0][0]), const Cell&>::value, "");
+}
+
+BOOST_AUTO_TEST_CASE(CellPoolBlocks)
+{
+    MeshFem mesh = UnitMeshFem::CreateLines(10);
+    IntegrationTypeTensorProduct<1> integration(2, eIntegrationMethod::GAUSS);
+
+    CellPool<Cell> pool(4);
+    for (auto& element : mesh.Elements)
+        pool.Add(element, integration, pool.Size());
+
+    // chunks do not span blocks
+    std::vector<CellRange> ranges = pool.Ranges(3);
+    std::vector<int> sizes;
+    for (const CellRange& range : ranges)
+        sizes.push_back(range.Size());
+    BOOST_CHECK(sizes == std::vector<int>({3, 1, 3, 1, 2}));
+    BOOST_CHECK_EQUAL(ranges[2][0].Id(), 4);
+    BOOST_CHECK_EQUAL(&ranges[4][1], &pool[9]);
+}
+
+BOOST_AUTO_TEST_CASE(CellStorageAssembleRanges)
+{
+    MeshFem mesh = UnitMeshFem::CreateLines(10);
+    DofType dof("Scalar", 1);
+    AddDofInterpolation(&mesh, dof);
+    DofInfo dofInfo = DofNumbering::Build(mesh.NodesTotal(dof), dof, Constraint::Constraints());
+
+    IntegrationTypeTensorProduct<1> integration(2, eIntegrationMethod::GAUSS);
+    CellStorage storage;
+    Group<CellInterface> cells = storage.AddCells(mesh.ElementsTotal(), integration);
+
+    auto f = [&](const CellIpData& data) {
+        DofVector<double> v;
+        v[dof] = data.N(dof).transpose() * data.GlobalCoordinates()[0];
+        return v;
+    };
+    auto k = [&](const CellIpData& data) {
+        DofMatrix<double> m;
+        m(dof, dof) = data.B(dof, Nabla::Gradient()).transpose() * data.B(dof, Nabla::Gradient());
+        return m;
+    };
+
+    SimpleAssembler assembler(dofInfo);
+    const std::vector<CellRange> ranges = storage.Ranges(3);
+    const SimpleAssembler::Coloring coloring = assembler.BuildColoring(ranges, {dof});
+    BOOST_CHECK(coloring == assembler.BuildColoring(cells, {dof}));
+    BoostUnitTest::CheckEigenMatrix(assembler.BuildVector(ranges, {dof}, f, coloring)[dof],
+                                    assembler.BuildVector(cells, {dof}, f)[dof]);
+    BoostUnitTest::CheckEigenMatrix(Eigen::MatrixXd(assembler.BuildMatrix(ranges, {dof}, k)(dof, dof)),
+                                    Eigen::MatrixXd(assembler.BuildMatrix(cells, {dof}, k)(dof, dof)));
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "nuto/mechanics/constitutive/LinearElastic.h"
+#include "nuto/mechanics/constraints/ConstraintCompanion.h"
+#include "nuto/mechanics/integrands/MomentumBalance.h"
+#include "nuto/mechanics/integrationtypes/IntegrationTypeTensorProduct.h"
+#include "nuto/mechanics/mesh/MeshFemDofConvert.h"
+#include "nuto/mechanics/mesh/UnitMeshFem.h"
+#include "nuto/mechanics/tools/CellStorage.h"
+#include "nuto/mechanics/tools/TimeDependentProblem.h"
+
+namespace NuTo
+{
+namespace Test
+{
+//! @brief 2D linear elastic plate, fixed at the left and with a linked right boundary, to compare solvers and
+//! assembly variants of its Hessian0
+//! @remark The Hessian0 is added via TimeDependentProblem::AddHessian0TangentFunction(...). `dofValues` are random
+//! values in the natural dof numbering, `C` is the unit constraint matrix of the constraints.
+struct ElasticPlate
+{
+    ElasticPlate()
+        : mesh(UnitMeshFem::Transform(UnitMeshFem::CreateQuads(6, 4),
+                                      [](Eigen::VectorXd x) { return Eigen::Vector2d(3 * x[0], x[1] + 0.2 * x[0]); }))
+        , disp("Displacements", 2)
+        , law(20000, 0.2)
+        , momentumBalance(disp, law)
+        , problem(&mesh)
+        , integrationType(2, eIntegrationMethod::GAUSS)
+    {
+        AddDofInterpolation(&mesh, disp);
+        cellGroup = cells.AddCells(mesh.ElementsTotal(), integrationType);
+        problem.AddHessian0TangentFunction(
+                cellGroup, disp,
+                [&](const CellIpData& cellIpData) -> const Eigen::MatrixXd& {
+                    return momentumBalance.Hessian0Operator(cellIpData);
+                },
+                TimeDependentProblem::Bind_dt(momentumBalance, &Integrands::MomentumBalance<2>::Hessian0Tangent));
+
+        constraints.Add(disp,
+                        Constraint::Component(mesh.NodesAtAxis(eDirection::X, disp), {eDirection::X, eDirection::Y}));
+        auto& master = mesh.NodeAtCoordinate(Eigen::Vector2d(3, 0.2), disp);
+        for (auto& node : mesh.NodesAtAxis(eDirection::X, disp, 3))
+            if (&node != &master)
+            {
+                Constraint::Equation equation(node, 0, Constraint::RhsConstant(0));
+                equation.AddIndependentTerm({master, 0, -1});
+                constraints.Add(disp, equation);
+            }
+
+        dofValues = problem.RenumberDofs(constraints, {disp}, DofVector<double>());
+        dofValues[disp].setRandom();
+        C = constraints.BuildUnitConstraintMatrix(disp, dofValues[disp].rows());
+    }
+
+    MeshFem mesh;
+    DofType disp;
+    Laws::LinearElastic<2> law;
+    Integrands::MomentumBalance<2> momentumBalance;
+    TimeDependentProblem problem;
+    IntegrationTypeTensorProduct<2> integrationType;
+    CellStorage cells;
+    Group<CellInterface> cellGroup;
+    Constraint::Constraints constraints;
+    DofVector<double> dofValues;
+    Eigen::SparseMatrix<double> C;
+};
+} /* Test */
+} /* NuTo */
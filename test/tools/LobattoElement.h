@@ -0,0 +1,63 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include "nuto/mechanics/cell/SumFactorization.h"
+#include "nuto/mechanics/constitutive/LinearElastic.h"
+#include "nuto/mechanics/elements/ElementCollection.h"
+#include "nuto/mechanics/integrationtypes/IntegrationTypeTensorProduct.h"
+
+namespace NuTo
+{
+namespace Test
+{
+//! @brief single (distorted) Lobatto element with random displacements, to compare the sum factorization with the
+//! cells, see SumFactorizedCell
+//! @remark The displacement dofs are numbered like the values of ExtractNodeValues().
+template <int TDim, typename TInterpolation>
+struct LobattoElement
+{
+    //! @param order polynomial order of the Lobatto interpolation, the integration type has order + 1 Gauss points
+    //! @param transform maps the natural coordinates of the nodes to the global coordinates
+    LobattoElement(int order,
+                   std::function<Eigen::VectorXd(Eigen::VectorXd)> transform = [](Eigen::VectorXd x) { return x; })
+        : interpolation(order)
+        , integrationType(order + 1, eIntegrationMethod::GAUSS)
+        , kernel(order, integrationType)
+        , disp("Displacements", TDim)
+        , law(20000, 0.2)
+    {
+        std::vector<NodeSimple*> coordinateNodePtrs;
+        std::vector<NodeSimple*> displacementNodePtrs;
+        for (int iNode = 0; iNode < interpolation.GetNumNodes(); ++iNode)
+        {
+            coordinateNodes.push_back(new NodeSimple(transform(interpolation.GetLocalCoords(iNode))));
+            displacementNodes.push_back(new NodeSimple(1.e-3 * Eigen::VectorXd::Random(TDim)));
+            for (int iDim = 0; iDim < TDim; ++iDim)
+                displacementNodes.back().SetDofNumber(iDim, TDim * iNode + iDim);
+            coordinateNodePtrs.push_back(&coordinateNodes.back());
+            displacementNodePtrs.push_back(&displacementNodes.back());
+        }
+        elements = std::make_unique<ElementCollectionFem>(ElementFem(coordinateNodePtrs, interpolation));
+        elements->AddDofElement(disp, ElementFem(displacementNodePtrs, interpolation));
+    }
+
+    //! @return number of displacement dofs
+    int NumDofs() const
+    {
+        return TDim * interpolation.GetNumNodes();
+    }
+
+    TInterpolation interpolation;
+    IntegrationTypeTensorProduct<TDim> integrationType;
+    SumFactorization<TDim> kernel;
+    DofType disp;
+    Laws::LinearElastic<TDim> law;
+
+    boost::ptr_vector<NodeSimple> coordinateNodes;
+    boost::ptr_vector<NodeSimple> displacementNodes;
+    std::unique_ptr<ElementCollectionFem> elements;
+};
+} /* Test */
+} /* NuTo */
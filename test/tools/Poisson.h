@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <Eigen/Sparse>
+
+namespace NuTo
+{
+namespace Test
+{
+//! @brief 5 point stencil of the Poisson equation on n x n inner grid points, Dirichlet boundaries, with
+//! `numComponents` uncoupled components per grid point
+//! @remark The grid points are numbered row by row, the components of a grid point are numbered consecutively.
+inline Eigen::SparseMatrix<double> Poisson(int n, int numComponents = 1)
+{
+    std::vector<Eigen::Triplet<double>> triplets;
+    auto index = [&](int i, int j, int c) { return (i * n + j) * numComponents + c; };
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            for (int c = 0; c < numComponents; ++c)
+            {
+                triplets.emplace_back(index(i, j, c), index(i, j, c), 4.);
+                if (i > 0)
+                    triplets.emplace_back(index(i, j, c), index(i - 1, j, c), -1.);
+                if (i < n - 1)
+                    triplets.emplace_back(index(i, j, c), index(i + 1, j, c), -1.);
+                if (j > 0)
+                    triplets.emplace_back(index(i, j, c), index(i, j - 1, c), -1.);
+                if (j < n - 1)
+                    triplets.emplace_back(index(i, j, c), index(i, j + 1, c), -1.);
+            }
+    const int size = n * n * numComponents;
+    Eigen::SparseMatrix<double> A(size, size);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+}
+} /* Test */
+} /* NuTo */